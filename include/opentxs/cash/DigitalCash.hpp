@@ -65,10 +65,10 @@ namespace opentxs
 
 #ifdef OT_CASH_USING_LUCRE
 
+// Points Lucre's dumper at stderr (or a file, in Windows debug builds) for
+// as long as any LucreDumper exists.
 class LucreDumper
 {
-    std::string m_str_dumpfile;
-
 public:
     LucreDumper();
     ~LucreDumper();
@@ -40,7 +40,9 @@
 #define OPENTXS_CASH_MINT_HPP
 
 #include <opentxs/core/Contract.hpp>
+#include <atomic>
 #include <map>
+#include <vector>
 #include <cstdint>
 #include <ctime>
 
@@ -116,7 +118,41 @@ protected:
     // all tokens will have 1-for-1 funds backing them, and any funds left over
     // after
     // the tokens expire, is the server operator's money to keep!
+
+    static int32_t __mint_key_cache_size; // Denomination keys kept open in
+                                          // memory after signing or verifying
+                                          // a token. (0 opens them every time.)
+    static int32_t __mint_generation_threads; // Denominations generated at
+                                              // once. (0 for one per core.)
+
+    // GenerateNewMint() progress. Atomic, since it's read from other threads.
+    std::atomic<int32_t> m_nDenominationsGenerated;
+    std::atomic<int32_t> m_nDenominationsToGenerate;
+    std::atomic<int64_t> m_lGenerationStarted;  // Steady clock, in ms.
+    std::atomic<int64_t> m_lGenerationFinished; // 0 while still running.
+
+    void StartGeneration(int32_t nDenominations);
+    void FinishGeneration();
+    static int64_t GetGenerationClock();
+
 public:
+    static int32_t GetMintKeyCacheSize()
+    {
+        return __mint_key_cache_size;
+    }
+    static void SetMintKeyCacheSize(int32_t nSize)
+    {
+        __mint_key_cache_size = nSize;
+    }
+    static int32_t GetMintGenerationThreads()
+    {
+        return __mint_generation_threads;
+    }
+    static void SetMintGenerationThreads(int32_t nThreads)
+    {
+        __mint_generation_threads = nThreads;
+    }
+
     inline int32_t GetSeries() const
     {
         return m_nSeries;
@@ -185,6 +221,11 @@ public:
     EXPORT int64_t GetLargestDenomination(int64_t lAmount);
     virtual bool AddDenomination(Nym& theNotary, int64_t lDenomination,
                                  int32_t nPrimeLength = 1024) = 0;
+    // Adds them in the order given, and returns how many were added. (Lucre
+    // generates the key pairs for them in parallel.)
+    virtual int32_t AddDenominations(Nym& theNotary,
+                                     const std::vector<int64_t>& vecDenoms,
+                                     int32_t nPrimeLength = 1024);
 
     inline int32_t GetDenominationCount() const
     {
@@ -214,6 +255,12 @@ public:
                                 int64_t nDenom7 = 0, int64_t nDenom8 = 0,
                                 int64_t nDenom9 = 0, int64_t nDenom10 = 0);
 
+    // How far along GenerateNewMint() is, and how long it's taken so far (or
+    // took in all). Safe to call from another thread while it runs, so mint
+    // rotation can be run in the background and watched from elsewhere.
+    EXPORT void GetGenerationProgress(int32_t& nGenerated, int32_t& nTotal,
+                                      int64_t& lElapsedMs) const;
+
     // step 2: (coin request is in Token)
 
     // Lucre step 3: mint signs token
@@ -223,6 +270,7 @@ public:
     // step 4: (unblind coin is in Token)
 
     // Lucre step 5: mint verifies token when it is redeemed by merchant.
+    // (Several tokens may be verified at once, from different threads.)
     EXPORT virtual bool VerifyToken(Nym& theNotary, String& theCleartextToken,
                                     int64_t lDenomination) = 0;
 };
@@ -41,6 +41,14 @@
 
 #include "Mint.hpp"
 
+#include <atomic>
+#include <memory>
+#include <string>
+
+#if defined(OT_CASH_USING_LUCRE)
+class Bank;
+#endif
+
 namespace opentxs
 {
 
@@ -59,6 +67,24 @@ class MintLucre : public Mint
 private: // Private prevents erroneous use by other classes.
     typedef Mint ot_super;
     friend class Mint; // for the factory.
+
+    // The denomination's bank, with its private key. From the cache if it's
+    // there, otherwise opened from m_mapPrivate. Hand it back with
+    // ReturnBank() afterwards.
+    std::unique_ptr<Bank> TakeBank(Nym& theNotary, int64_t lDenomination);
+    void ReturnBank(int64_t lDenomination, std::unique_ptr<Bank> pBank);
+    std::string GetBankPrefix() const;
+
+    std::atomic<bool> m_bCachedBanks; // Whether any of this mint's banks
+                                      // were cached.
+
+    bool CanAddDenomination(int64_t lDenomination, int32_t nPrimeLength);
+    static void SetGenerationMonitor();
+    static bool GenerateBank(int32_t nPrimeLength, String& strPrivateBank,
+                             String& strPublicBank);
+    bool AddBank(Nym& theNotary, int64_t lDenomination,
+                 const String& strPrivateBank, const String& strPublicBank);
+
 protected:
     MintLucre();
     EXPORT MintLucre(const String& strNotaryID,
@@ -69,12 +95,17 @@ protected:
 public:
     virtual bool AddDenomination(Nym& theNotary, int64_t lDenomination,
                                  int32_t nPrimeLength = 1024);
+    virtual int32_t AddDenominations(Nym& theNotary,
+                                     const std::vector<int64_t>& vecDenoms,
+                                     int32_t nPrimeLength = 1024);
 
     EXPORT virtual bool SignToken(Nym& theNotary, Token& theToken,
                                   String& theOutput, int32_t nTokenIndex);
     EXPORT virtual bool VerifyToken(Nym& theNotary, String& theCleartextToken,
                                     int64_t lDenomination);
 
+    virtual void Release();
+
     EXPORT virtual ~MintLucre();
 };
 
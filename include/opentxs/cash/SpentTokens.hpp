@@ -0,0 +1,110 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CASH_SPENTTOKENS_HPP
+#define OPENTXS_CASH_SPENTTOKENS_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+namespace opentxs
+{
+
+// Partition name ("<instrument definition ID>.<series>") to the hashes of
+// the spendable token strings in that partition.
+typedef std::map<std::string, std::set<std::string>> mapOfSpentTokens;
+
+// The spent token database.
+//
+// Each mint series has its own partition, stored as an append-only log
+// under OTFolders::Spent()/<partition>/, one token hash per line. The first
+// time a partition is used, its log is read into an in-memory hash index,
+// so checking a token never touches the disk after that.
+//
+// Tokens spent before the log existed were stored as one file per token in
+// the same folder. The log's first line records whether that folder was
+// already there when the log was started. If it was (or the line is
+// missing), a miss in the index is also checked against the old files.
+//
+// As before, every error counts as "already spent": a token can only be
+// credited once we KNOW it was not spent, and a record that may or may not
+// have reached the log fails safe in the same direction.
+//
+class SpentTokens
+{
+public:
+    EXPORT static SpentTokens* It();
+
+    EXPORT bool IsSpent(const std::string& strPartition,
+                        const std::string& strTokenHash);
+
+    // True if ANY of the tokens was already spent (or couldn't be checked.)
+    EXPORT bool AnySpent(const mapOfSpentTokens& theTokens);
+
+    // Checks the whole batch, and only if none of the tokens was spent, it
+    // appends them all with one synced write per partition. Returns false if
+    // nothing new was recorded for the caller to credit.
+    EXPORT bool RecordSpent(const mapOfSpentTokens& theTokens);
+
+private:
+    struct Partition
+    {
+        std::unordered_set<std::string> setHashes;
+        bool bLegacy = false;       // old one-file-per-token folder exists.
+        bool bNeedsNewline = false; // log ends with a partial record.
+        bool bNeedsHeader = false;  // log is empty (or not there yet.)
+    };
+
+    typedef std::map<std::string, Partition> mapOfPartitions;
+
+    mapOfPartitions m_mapPartitions;
+
+    SpentTokens()
+    {
+    }
+
+    Partition* GetPartition(const std::string& strPartition);
+    bool IsSpent(const std::string& strPartition, Partition& thePartition,
+                 const std::string& strTokenHash);
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CASH_SPENTTOKENS_HPP
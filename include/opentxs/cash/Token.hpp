@@ -295,6 +295,9 @@ public:
                                                                 // Database
     EXPORT bool RecordTokenAsSpent(String& theCleartextToken);  // Spent Token
                                                                 // Database
+    EXPORT void GetSpentTokenKey(const String& theCleartextToken,
+                                 std::string& strPartition,
+                                 std::string& strTokenHash) const;
     EXPORT void SetSignature(const OTASCIIArmor& theSignature,
                              int32_t nTokenIndex);
     EXPORT bool GetSignature(OTASCIIArmor& theSignature) const;
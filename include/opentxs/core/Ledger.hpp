@@ -41,6 +41,10 @@
 
 #include "OTTransaction.hpp"
 
+#include <map>
+#include <set>
+#include <vector>
+
 namespace opentxs
 {
 
@@ -75,6 +79,35 @@ private:
     mapOfTransactions m_mapTransactions; // a ledger contains a map of
                                          // transactions.
 
+    // Indexes m_mapTransactions by in-reference-to number. Kept in sync by
+    // InsertTransaction / EraseTransaction, and by ReindexReferenceTo when a
+    // transaction's number changes while it's here.
+    std::multimap<int64_t, OTTransaction*> m_mapTransactionsInRefTo;
+
+    // m_mapTransactions in order, for lookups by index. Cleared whenever the
+    // map changes, and rebuilt on the next lookup.
+    mutable std::vector<OTTransaction*> m_vecTransactionIndex;
+
+    friend class OTTransaction; // For ReindexReferenceTo.
+
+    void InsertTransaction(OTTransaction& theTransaction);
+    void EraseTransaction(mapOfTransactions::iterator it);
+    void ReindexReferenceTo(OTTransaction& theTransaction, int64_t lOldNum);
+    const std::vector<OTTransaction*>& GetTransactionIndexVector() const;
+
+    // Server-side, messages are appended to a journal next to the nymbox
+    // instead of rewriting it. (See AppendNymboxJournal.) These are the
+    // numbers of the transactions that were loaded from the journal, which
+    // the nymbox's own signature doesn't cover until it's signed again.
+    std::set<int64_t> m_setJournaled;
+    Identifier m_JournalBase; // Digest of the nymbox the journal builds on.
+    static bool __nymbox_journal; // Whether LoadNymbox reads the journal.
+
+    bool LoadNymboxJournal();
+    void GetNymboxJournalKey(String& strNotaryID, String& strFilename) const;
+
+    bool GenerateContents(String& strOutput); // Used by UpdateContents.
+
 protected:
     // return -1 if error, 0 if nothing, and 1 if the node was processed.
     virtual int32_t ProcessXMLNode(irr::io::IrrXMLReader*& xml);
@@ -213,6 +246,35 @@ public:
     // the hash is
     // recorded there
 
+    // Server-side. Once a nymbox has a journal, new receipts can be delivered
+    // without loading it: AppendNymboxJournal saves the box receipt and
+    // appends its number to the journal. (It also takes ownership, like
+    // AddTransaction.) LoadNymbox adds whatever was journaled, and the next
+    // SaveNymbox with anything new in it starts the journal over.
+    // Only the notary writes the journal, so only the notary reads it.
+    static bool GetNymboxJournal()
+    {
+        return __nymbox_journal;
+    }
+    static void SetNymboxJournal(bool bJournal)
+    {
+        __nymbox_journal = bJournal;
+    }
+    EXPORT bool HasNymboxJournal() const;
+    EXPORT bool StartNymboxJournal(); // Call after SaveNymbox.
+    EXPORT bool AppendNymboxJournal(OTTransaction& theTransaction);
+    // True if this holds receipts from the journal that the nymbox isn't
+    // signed with yet. (Sign and save it before sending it anywhere.)
+    EXPORT bool LoadedJournal() const
+    {
+        return !m_setJournaled.empty();
+    }
+
+    using ot_super::VerifySignature;
+    // Also verifies each receipt that was loaded from the journal.
+    EXPORT virtual bool VerifySignature(
+        const Nym& theNym, const OTPasswordData* pPWData = nullptr) const;
+
     EXPORT bool CalculateHash(Identifier& theOutput);
     EXPORT bool CalculateInboxHash(Identifier& theOutput);
     EXPORT bool CalculateOutboxHash(Identifier& theOutput);
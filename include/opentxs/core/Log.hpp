@@ -126,6 +126,10 @@ private:
 
     static bool CheckLogger(Log* pLogger);
 
+    // Disables the otOut/otInfo/etc streams whose level isn't being logged,
+    // so that formatting a message for them costs nothing.
+    static void FilterStreams();
+
 public:
     // EXPORT static OTLog& It();
 
@@ -161,7 +165,15 @@ public:
     // OTLog Functions:
     //
 
-    EXPORT static bool LogToFile(const String& strOutput);
+    // Queues the output for the background log writer, which writes it to
+    // stderr and to the log file. (Before Init, it's written to stderr right
+    // away.) If the writer falls too far behind, this waits for it, unless
+    // bMayDrop: then the line is dropped (and the drops are counted in the
+    // log.) Only ordinary output may be dropped, never errors.
+    EXPORT static bool LogToFile(const String& strOutput,
+                                 bool bMayDrop = false);
+    // Waits (briefly) until everything queued so far has been written.
+    EXPORT static bool Flush();
 
     // We keep 1024 logs in memory, to make them available via the API.
     EXPORT static int32_t GetMemlogSize();
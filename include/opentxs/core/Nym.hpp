@@ -65,8 +65,8 @@ class Tag;
 typedef std::deque<Message*> dequeOfMail;
 typedef std::map<std::string, int64_t> mapOfRequestNums;
 typedef std::map<std::string, int64_t> mapOfHighestNums;
-typedef std::deque<int64_t> dequeOfTransNums;
-typedef std::map<std::string, dequeOfTransNums*> mapOfTransNums;
+typedef std::set<int64_t> setOfTransNums;
+typedef std::map<std::string, setOfTransNums*> mapOfTransNums;
 typedef std::map<std::string, Identifier> mapOfIdentifiers;
 typedef std::map<std::string, OTCredential*> mapOfCredentials;
 typedef std::list<OTAsymmetricKey*> listOfAsymmetricKeys;
@@ -474,6 +474,11 @@ public:
                                     // or 'A'
                                     // (authentication key)
     EXPORT bool SaveCredentialIDs();
+    // Bumped every time a Nym's credentials are saved (or the Nym is deleted)
+    // in this process, so whatever was verified against the old ones can tell
+    // that they've changed. (Without reading them again.)
+    EXPORT static uint64_t GetCredentialGeneration(const String& strNymID);
+    EXPORT static void CredentialsChanged(const String& strNymID);
     EXPORT void SaveCredentialIDsToString(String& strOutput);
     EXPORT void SaveCredentialsToTag(Tag& parent,
                                      String::Map* pmapPubInfo = nullptr,
@@ -748,6 +753,12 @@ public:
     //
     EXPORT bool VerifyIssuedNumbersOnNym(Nym& THE_NYM);
     EXPORT bool VerifyTransactionStatementNumbersOnNym(Nym& THE_NYM);
+    // Bulk difference: whatever is on THE_MAP but not on OTHER_MAP (per
+    // notary) goes into mapMissing. Returns the total count missing.
+    //
+    EXPORT static int64_t GetMissingNums(
+        const mapOfTransNums& THE_MAP, const mapOfTransNums& OTHER_MAP,
+        std::map<std::string, setOfTransNums>& mapMissing);
     // These functions are for transaction numbers that were assigned to me,
     // until I accept the receipts or put stop payment onto them.
     //
@@ -755,6 +766,9 @@ public:
         GetIssuedNumCount(const Identifier& theNotaryID) const; // count
     EXPORT int64_t GetIssuedNum(const Identifier& theNotaryID,
                                 int32_t nIndex) const; // index
+    // All of them, in order. (Iterate these instead of looping on the index.)
+    EXPORT const setOfTransNums& GetIssuedNums(
+        const Identifier& theNotaryID) const;
 
     EXPORT bool AddIssuedNum(const String& strNotaryID,
                              const int64_t& lTransNum); // doesn't save
@@ -770,6 +784,8 @@ public:
         GetTransactionNumCount(const Identifier& theNotaryID) const; // count
     EXPORT int64_t GetTransactionNum(const Identifier& theNotaryID,
                                      int32_t nIndex) const; // index
+    EXPORT const setOfTransNums& GetTransactionNums(
+        const Identifier& theNotaryID) const;
 
     EXPORT bool AddTransactionNum(const String& strNotaryID,
                                   int64_t lTransNum); // doesn't save
@@ -851,6 +867,8 @@ public:
         GetAcknowledgedNumCount(const Identifier& theNotaryID) const; // count
     EXPORT int64_t GetAcknowledgedNum(const Identifier& theNotaryID,
                                       int32_t nIndex) const; // index
+    EXPORT const setOfTransNums& GetAcknowledgedNums(
+        const Identifier& theNotaryID) const;
 
     EXPORT bool AddAcknowledgedNum(const String& strNotaryID,
                                    const int64_t& lRequestNum); // doesn't save
@@ -887,6 +905,9 @@ public:
     EXPORT int64_t GetGenericNum(const mapOfTransNums& THE_MAP,
                                  const Identifier& theNotaryID,
                                  int32_t nIndex) const;
+    // Empty if there are no numbers for theNotaryID.
+    EXPORT const setOfTransNums& GetGenericNums(
+        const mapOfTransNums& THE_MAP, const Identifier& theNotaryID) const;
     // Whenever a Nym receives a message via his Nymbox, and then the Nymbox is
     // processed, (which happens automatically)
     // that processing will drop all mail messages into this deque for
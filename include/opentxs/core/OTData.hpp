@@ -64,6 +64,12 @@ public:
         return data_;
     }
 
+    // For writing the contents in place, after SetSize.
+    inline void* GetPointerWritable()
+    {
+        return data_;
+    }
+
     EXPORT OTData& operator=(OTData rhs);
     EXPORT void swap(OTData& rhs);
     EXPORT bool operator==(const OTData& rhs) const;
@@ -44,12 +44,18 @@
 #include "util/Assert.hpp"
 #include "containers/simple_ptr.hpp"
 
+#include <atomic>
 #include <deque>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <cstdint>
+#include <cstdio>
 
 #define OTDB_PROTOCOL_BUFFERS 1
 
@@ -74,10 +80,12 @@ enum PackType            // PACKING TYPE
   PACK_TYPE_ERROR        // (Should never be.)
 };
 
-// Currently supporting filesystem, with subclasses possible via API.
+// Currently supporting filesystem, and a single log-structured data file,
+// with subclasses possible via API.
 //
 enum StorageType        // STORAGE TYPE
 { STORE_FILESYSTEM = 0, // Filesystem
+  STORE_LOG,            // One log-structured data file (see StorageLog.)
   STORE_TYPE_SUBCLASS   // (Subclass provided by API client via SWIG.)
 };
 
@@ -414,14 +422,25 @@ class Storage
 private:
     OTPacker* m_pPacker;
 
+    // A batch belongs to the thread that opened it. m_lockBatchOwner is held
+    // from its outermost BeginBatch() to its outermost CommitBatch(), so any
+    // other thread's BeginBatch() waits until the batch is committed.
+    std::mutex m_lockBatchOwner;
+    std::atomic<std::thread::id> m_batchOwner;
+    int32_t m_nBatchDepth; // Only touched by m_batchOwner.
+
 protected:
     Storage()
         : m_pPacker(nullptr)
+        , m_batchOwner(std::thread::id())
+        , m_nBatchDepth(0)
     {
     }
 
     Storage(const Storage&)
         : m_pPacker(nullptr)
+        , m_batchOwner(std::thread::id())
+        , m_nBatchDepth(0)
     {
     } // We don't want to copy the pointer. Let it create its own.
 
@@ -478,6 +497,41 @@ protected:
                                    std::string twoStr = "",
                                    std::string threeStr = "") = 0;
 
+    // Like onQueryPlainString, but a value that's empty (or isn't there at
+    // all) is read as an empty string. Returns false only if the value is
+    // there and couldn't be read. The default implementation can't tell an
+    // empty value from a failed read, so it counts one as the other, unless
+    // Exists() says there's nothing there.
+    virtual bool onReadPlainString(std::string& theBuffer,
+                                   std::string strFolder,
+                                   std::string oneStr = "",
+                                   std::string twoStr = "",
+                                   std::string threeStr = "");
+
+    // Appends to whatever is already stored at the location (or creates it.)
+    // The default implementation queries and re-stores the whole value, so
+    // subclasses that can append in place should override it.
+    virtual bool onAppendPlainString(std::string& theBuffer,
+                                     std::string strFolder,
+                                     std::string oneStr = "",
+                                     std::string twoStr = "",
+                                     std::string threeStr = "");
+
+    // Like onAppendPlainString, but the record must be on disk before it
+    // returns, even with sync_writes off or a batch open. The default
+    // implementation just appends, for storage that has no way to sync.
+    virtual bool onSyncAppendPlainString(std::string& theBuffer,
+                                         std::string strFolder,
+                                         std::string oneStr = "",
+                                         std::string twoStr = "",
+                                         std::string threeStr = "");
+
+    // Called when the outermost batch begins, and when it's committed. The
+    // default implementations do nothing, since every write is already
+    // written out as it happens.
+    virtual void onBeginBatch();
+    virtual bool onCommitBatch();
+
 public:
     // Use GetPacker() to access the Packer, throughout duration of this Storage
     // object.
@@ -535,6 +589,28 @@ public:
                                         std::string twoStr = "",
                                         std::string threeStr = "");
 
+    EXPORT bool AppendPlainString(std::string strContents,
+                                  std::string strFolder,
+                                  std::string oneStr = "",
+                                  std::string twoStr = "",
+                                  std::string threeStr = "");
+
+    // Unlike QueryPlainString, tells an empty (or missing) value apart from
+    // one that couldn't be read: strContents is empty for the former, and
+    // false is returned for the latter. (For logs, which may be empty.)
+    EXPORT bool ReadPlainString(std::string& strContents,
+                                std::string strFolder, std::string oneStr = "",
+                                std::string twoStr = "",
+                                std::string threeStr = "");
+
+    // Appends and syncs straight away, outside of any open batch. For records
+    // that have to be durable before anything depends on them.
+    EXPORT bool SyncAppendPlainString(std::string strContents,
+                                      std::string strFolder,
+                                      std::string oneStr = "",
+                                      std::string twoStr = "",
+                                      std::string threeStr = "");
+
     // Store/Retrieve an object. (Storable.)
 
     EXPORT bool StoreObject(Storable& theContents, std::string strFolder,
@@ -560,6 +636,20 @@ public:
                                 std::string twoStr = "",
                                 std::string threeStr = "");
 
+    // Everything stored, appended or erased between BeginBatch() and
+    // CommitBatch() is written out together: where the storage type supports
+    // it, either all of it survives a crash or none of it does. Reads in
+    // between see the writes already made. Batches nest, and only the
+    // outermost CommitBatch() writes anything.
+    //
+    // Only one thread can have a batch open: BeginBatch() waits for any
+    // other thread's batch to be committed. (Writes made by another thread
+    // WITHOUT a batch, while one is open, still become part of it. On the
+    // server that can't happen, since everything writes under the notary
+    // lock.)
+    EXPORT void BeginBatch();
+    EXPORT bool CommitBatch();
+
     // Note:
     // Make sure to use: %newobject Factory::createObj();  IN OTAPI.i file!
     //
@@ -630,6 +720,28 @@ EXPORT std::string QueryPlainString(std::string strFolder,
                                     std::string twoStr = "",
                                     std::string threeStr = "");
 
+// Read a plain string that may be empty. (See Storage::ReadPlainString.)
+//
+EXPORT bool ReadPlainString(std::string& strContents, std::string strFolder,
+                            std::string oneStr = "", std::string twoStr = "",
+                            std::string threeStr = "");
+
+// Append to a plain string. (For journals and logs.)
+//
+EXPORT bool AppendPlainString(std::string strContents, std::string strFolder,
+                              std::string oneStr = "", std::string twoStr = "",
+                              std::string threeStr = "");
+EXPORT bool SyncAppendPlainString(std::string strContents,
+                                  std::string strFolder,
+                                  std::string oneStr = "",
+                                  std::string twoStr = "",
+                                  std::string threeStr = "");
+
+// Write batches. (See Storage::BeginBatch.)
+//
+EXPORT void BeginBatch();
+EXPORT bool CommitBatch();
+
 // Store/Retrieve an object. (Storable.)
 //
 EXPORT bool StoreObject(Storable& theContents, std::string strFolder,
@@ -1591,6 +1703,24 @@ class StorageFS : public Storage
 private:
     std::string m_strDataPath;
 
+    // Files are written to a temp file and renamed over the old one. With
+    // sync_writes, a batch's files are synced when it's committed. (Writes
+    // outside a batch, such as the client's, aren't synced either way.)
+    static bool __sync_writes;
+
+    // While a batch is open, nothing is synced or renamed until the commit.
+    // This maps each file written so far to whether it's waiting in its temp
+    // file (or was appended to in place.)
+    std::mutex m_lockBatch;
+    bool m_bBatchOpen;
+    std::map<std::string, bool> m_mapBatchFiles;
+    std::set<std::string> m_setBatchErased; // Removed once the rest is in.
+
+    bool WriteFile(const std::string& strPath, const std::string& strData);
+    bool RemoveFile(const std::string& strPath);
+    bool WritesPending(const std::string& strPath);
+    int64_t ConfirmPending(std::string& strPath, int64_t lSize);
+
 protected:
     StorageFS(); // You have to use the factory to instantiate (so it can create
                  // the Packer also.)
@@ -1646,12 +1776,43 @@ protected:
                                     std::string twoStr = "",
                                     std::string threeStr = "");
 
+    virtual bool onReadPlainString(std::string& theBuffer,
+                                   std::string strFolder,
+                                   std::string oneStr = "",
+                                   std::string twoStr = "",
+                                   std::string threeStr = "");
+
     virtual bool onEraseValueByKey(std::string strFolder,
                                    std::string oneStr = "",
                                    std::string twoStr = "",
                                    std::string threeStr = "");
 
+    virtual bool onAppendPlainString(std::string& theBuffer,
+                                     std::string strFolder,
+                                     std::string oneStr = "",
+                                     std::string twoStr = "",
+                                     std::string threeStr = "");
+
+    virtual bool onSyncAppendPlainString(std::string& theBuffer,
+                                         std::string strFolder,
+                                         std::string oneStr = "",
+                                         std::string twoStr = "",
+                                         std::string threeStr = "");
+
+    virtual void onBeginBatch();
+    virtual bool onCommitBatch();
+
 public:
+    static bool GetSyncWrites()
+    {
+        return __sync_writes;
+    }
+
+    static void SetSyncWrites(bool bSync)
+    {
+        __sync_writes = bSync;
+    }
+
     virtual bool Exists(std::string strFolder, std::string oneStr = "",
                         std::string twoStr = "", std::string threeStr = "");
 
@@ -1677,6 +1838,149 @@ public:
                      struct stat* pst = nullptr); // local to data_folder
 };
 
+// StorageLog means "Storage in a Log."
+//
+// Every value is kept in one data file (otdb.log in the data folder), which
+// is only ever appended to. Each key is the path StorageFS would have used,
+// and an index in memory maps it to where its value is in the file.
+//
+// Each write goes out as one record with a checksum, and so does each whole
+// batch, so a batch either makes it to disk entirely or not at all. On
+// startup the file is read back to rebuild the index, and whatever follows
+// the last complete record (left by a crash) is cut off. Once most of the
+// file is overwritten values, it's compacted into a new one.
+//
+// Keys that were never written here are looked up on the filesystem, the way
+// StorageFS does, so an existing data folder can be switched over as it is.
+//
+class StorageLog : public StorageFS
+{
+private:
+    enum { OpStore = 1, OpAppend = 2, OpErase = 3 };
+
+    struct Operation
+    {
+        uint8_t cType;
+        std::string strKey;
+        std::string strValue;
+    };
+    typedef std::vector<Operation> vectorOfOperations;
+
+    // Where a value is in the data file. (Each append adds a segment.)
+    typedef std::vector<std::pair<int64_t, int64_t>> vectorOfSegments;
+
+    // How a key looks to readers, while a batch is open.
+    struct Pending
+    {
+        bool bErased;
+        bool bReplaced; // Otherwise strValue is appended to the stored value.
+        std::string strValue;
+    };
+
+    std::mutex m_lock;
+    std::string m_strFolder;
+    std::string m_strFilename;
+    FILE* m_pFile;
+    int64_t m_lFileSize;
+    int64_t m_lLiveBytes; // Keys and values that haven't been overwritten.
+    std::unordered_map<std::string, vectorOfSegments> m_mapIndex;
+
+    bool m_bBatchOpen;
+    vectorOfOperations m_vecBatch;
+    std::unordered_map<std::string, Pending> m_mapPending;
+    std::vector<std::string> m_vecLegacyErased; // Files to remove afterwards.
+
+    static bool FormKey(std::string& strKey, const std::string& strFolder,
+                        const std::string& oneStr, const std::string& twoStr,
+                        const std::string& threeStr);
+
+    bool Open();
+    int64_t Replay(); // Returns the size of the complete records.
+    bool Compact();
+    // Returns the size of the record, or -1 on failure.
+    int64_t WriteRecord(FILE* pFile, const vectorOfOperations& vecOps,
+                        int64_t lOffset, std::vector<int64_t>& vecValueOffsets);
+    bool Write(const vectorOfOperations& vecOps, bool bSync);
+    void Apply(uint8_t cType, const std::string& strKey, int64_t lValueOffset,
+               int64_t lValueLength);
+    bool ReadValue(const vectorOfSegments& vecSegments, std::string& strValue);
+    void RemoveLegacyFiles();
+
+    // Returns false if the key isn't stored here. (bErased is set if it was
+    // erased in the open batch.)
+    bool Lookup(const std::string& strKey, std::string* pstrValue,
+                bool& bErased);
+    bool FormAppend(Operation& theOp, const std::string& theBuffer,
+                    const std::string& strFolder, const std::string& oneStr,
+                    const std::string& twoStr, const std::string& threeStr);
+    bool Submit(Operation theOp);
+
+protected:
+    StorageLog(); // You have to use the factory to instantiate (so it can
+                  // create the Packer also.)
+
+    virtual bool onStorePackedBuffer(PackedBuffer& theBuffer,
+                                     std::string strFolder,
+                                     std::string oneStr = "",
+                                     std::string twoStr = "",
+                                     std::string threeStr = "");
+
+    virtual bool onQueryPackedBuffer(PackedBuffer& theBuffer,
+                                     std::string strFolder,
+                                     std::string oneStr = "",
+                                     std::string twoStr = "",
+                                     std::string threeStr = "");
+
+    virtual bool onStorePlainString(std::string& theBuffer,
+                                    std::string strFolder,
+                                    std::string oneStr = "",
+                                    std::string twoStr = "",
+                                    std::string threeStr = "");
+
+    virtual bool onQueryPlainString(std::string& theBuffer,
+                                    std::string strFolder,
+                                    std::string oneStr = "",
+                                    std::string twoStr = "",
+                                    std::string threeStr = "");
+
+    virtual bool onReadPlainString(std::string& theBuffer,
+                                   std::string strFolder,
+                                   std::string oneStr = "",
+                                   std::string twoStr = "",
+                                   std::string threeStr = "");
+
+    virtual bool onEraseValueByKey(std::string strFolder,
+                                   std::string oneStr = "",
+                                   std::string twoStr = "",
+                                   std::string threeStr = "");
+
+    virtual bool onAppendPlainString(std::string& theBuffer,
+                                     std::string strFolder,
+                                     std::string oneStr = "",
+                                     std::string twoStr = "",
+                                     std::string threeStr = "");
+
+    virtual bool onSyncAppendPlainString(std::string& theBuffer,
+                                         std::string strFolder,
+                                         std::string oneStr = "",
+                                         std::string twoStr = "",
+                                         std::string threeStr = "");
+
+    virtual void onBeginBatch();
+    virtual bool onCommitBatch();
+
+public:
+    virtual bool Exists(std::string strFolder, std::string oneStr = "",
+                        std::string twoStr = "", std::string threeStr = "");
+
+    static StorageLog* Instantiate()
+    {
+        return new StorageLog;
+    }
+
+    virtual ~StorageLog();
+};
+
 } // namespace OTDB
 
 // IStorable-derived types...
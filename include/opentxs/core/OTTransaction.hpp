@@ -346,6 +346,7 @@ class Tag;
 
 class OTTransaction : public OTTransactionType
 {
+    friend class Ledger;
     friend OTTransactionType* OTTransactionType::TransactionFactory(
         String strInput);
 
@@ -479,6 +480,10 @@ public:
         m_pParent = &theParent;
     }
 
+    // Also updates the in-reference-to index of the ledger holding this
+    // transaction, if any.
+    EXPORT virtual void SetReferenceToNum(int64_t lTransactionNum);
+
     EXPORT bool AddNumbersToTransaction(const NumList& theAddition);
 
     bool IsAbbreviated() const
@@ -707,6 +712,11 @@ protected:
     // If this is not nullptr, then you can reference that object.
     const Ledger* m_pParent;
 
+    // The ledger that indexes this transaction by its in-reference-to number.
+    // (Set while the transaction is in that ledger's map; see
+    // Ledger::InsertTransaction.)
+    Ledger* m_pIndexedBy;
+
     // Transactions can be loaded in abbreviated form from a ledger, but they
     // are not considered "actually loaded"
     // until their associated "box receipt" is also loaded up from storage, and
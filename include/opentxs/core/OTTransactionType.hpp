@@ -840,7 +840,7 @@ public:
     EXPORT bool VerifyNumberOfOrigin(OTTransactionType& compareTo);
 
     EXPORT int64_t GetReferenceToNum() const;
-    EXPORT void SetReferenceToNum(int64_t lTransactionNum);
+    EXPORT virtual void SetReferenceToNum(int64_t lTransactionNum);
 
     EXPORT void GetReferenceString(String& theStr) const;
     EXPORT void SetReferenceString(const String& theStr);
@@ -43,10 +43,14 @@
 #define OPENTXS_CORE_CRON_OTCRON_HPP
 
 #include <opentxs/core/Contract.hpp>
+#include <opentxs/core/cron/OTVerificationCache.hpp>
 #include <opentxs/core/util/StringUtils.hpp>
 #include <opentxs/core/util/Assert.hpp>
 #include <opentxs/core/util/Timer.hpp>
 
+#include <set>
+#include <tuple>
+
 namespace opentxs
 {
 
@@ -61,6 +65,11 @@ class Nym;
 typedef std::map<int64_t, OTCronItem*> mapOfCronItems;
 typedef std::multimap<time64_t, OTCronItem*> multimapOfCronItems;
 
+// When each Cron Item is next due for processing: (due date, date added,
+// transaction number.) Ordered so the items due soonest come first.
+typedef std::tuple<time64_t, time64_t, int64_t> cronDueDate;
+typedef std::set<cronDueDate> setOfCronDueDates;
+
 // Mapped (uniquely) to market ID.
 typedef std::map<std::string, OTMarket*> mapOfMarkets;
 
@@ -77,6 +86,10 @@ private:
     mapOfMarkets m_mapMarkets;     // A list of all valid markets.
     mapOfCronItems m_mapCronItems; // Cron Items are found on both lists.
     multimapOfCronItems m_multimapCronItems;
+    setOfCronDueDates m_setDueDates; // Every Cron Item is on here too, so
+                                     // only the ones that are due need to
+                                     // be processed.
+    std::map<int64_t, cronDueDate> m_mapDueDates; // By transaction number.
     Identifier m_NOTARY_ID; // Always store this in any object that's
                             // associated with a specific server.
 
@@ -87,6 +100,20 @@ private:
     bool m_bIsActivated; // I don't want to start Cron processing until
                          // everything else is all loaded up and ready to go.
 
+    // Between full saves, changes are appended to a journal instead of
+    // rewriting the entire cron file. The generation ties a journal to the
+    // cron file it builds on.
+    int64_t m_lJournalGeneration;
+    int32_t m_nJournalRecords; // Records in the journal so far.
+    std::map<int64_t, time64_t> m_mapChangedItems; // Items to write out on the
+                                                   // next save, with the date
+                                                   // added (or zero.)
+    std::string m_strJournalPending; // Other records waiting for the next save.
+    int32_t m_nJournalPending;
+    std::set<int64_t> m_setJournaledItems; // Items with their own file.
+
+    OTVerificationCache m_VerificationCache; // What the items settle against.
+
     Nym* m_pServerNym;                    // I'll need this for later.
     static int32_t __trans_refill_amount; // Number of transaction numbers Cron
                                           // will grab for itself, when it gets
@@ -99,6 +126,17 @@ private:
                                              // items any given Nym can have
                                              // active at the same time.
 
+    static int32_t __cron_journal_max_records; // Journal records allowed
+                                               // before the cron file is
+                                               // saved in full again.
+
+    static int32_t __cron_verification_cache_size; // Nyms, accounts and
+                                                   // inboxes kept verified
+                                                   // between settlements.
+    static int32_t __cron_compression_level; // zlib level for the cron
+                                             // items and offers armored
+                                             // into cron and market files.
+
     static Timer tCron;
 
 public:
@@ -127,6 +165,30 @@ public:
     {
         __cron_max_items_per_nym = nMax;
     }
+    static int32_t GetCronJournalMaxRecords()
+    {
+        return __cron_journal_max_records;
+    }
+    static void SetCronJournalMaxRecords(int32_t nMax)
+    {
+        __cron_journal_max_records = nMax;
+    }
+    static int32_t GetCronVerificationCacheSize()
+    {
+        return __cron_verification_cache_size;
+    }
+    static void SetCronVerificationCacheSize(int32_t nSize)
+    {
+        __cron_verification_cache_size = nSize;
+    }
+    static int32_t GetCronCompressionLevel()
+    {
+        return __cron_compression_level;
+    }
+    static void SetCronCompressionLevel(int32_t nLevel)
+    {
+        __cron_compression_level = nLevel;
+    }
     inline bool IsActivated() const
     {
         return m_bIsActivated;
@@ -152,6 +214,11 @@ public:
     EXPORT mapOfCronItems::iterator FindItemOnMap(int64_t lTransactionNum);
     EXPORT multimapOfCronItems::iterator FindItemOnMultimap(
         int64_t lTransactionNum);
+    // Cron items call this when their state has changed, so the next
+    // SaveCron() writes them out.
+    EXPORT void SetItemChanged(const OTCronItem& theItem);
+    // Asks theItem when it's next due, and reschedules it for then.
+    EXPORT void ScheduleItem(const OTCronItem& theItem);
     // MARKETS
     //
     bool AddMarket(OTMarket& theMarket, bool bSaveMarketFile = true);
@@ -195,6 +262,14 @@ public:
     //
     EXPORT void ProcessCronItems();
 
+    // Trades and payment plans load (and save) the Nyms, accounts and
+    // inboxes they settle against through here. Cron checks everything back
+    // in after each item it processes.
+    inline OTVerificationCache& GetVerificationCache()
+    {
+        return m_VerificationCache;
+    }
+
     int64_t computeTimeout();
 
     inline void SetNotaryID(const Identifier& NOTARY_ID)
@@ -217,7 +292,8 @@ public:
     }
 
     EXPORT bool LoadCron();
-    EXPORT bool SaveCron();
+    EXPORT bool SaveCron();    // Appends whatever changed to the journal.
+    EXPORT bool CompactCron(); // Saves everything, and starts a new journal.
 
     EXPORT OTCron();
     OTCron(const Identifier& NOTARY_ID);
@@ -235,6 +311,14 @@ public:
 
     virtual void UpdateContents(); // Before transmission or serialization, this
                                    // is where the ledger saves its contents
+
+private:
+    bool LoadJournal();
+    void ForgetItem(int64_t lTransactionNum); // No hooks, just deletes it.
+    void ScheduleItem(const OTCronItem& theItem, time64_t tDateAdded);
+    void UnscheduleItem(int64_t lTransactionNum);
+    void AddJournalRecord(const char* szType, int64_t lNumber);
+    std::string JournalFilename(int64_t lGeneration) const;
 };
 
 } // namespace opentxs
@@ -111,6 +111,11 @@ protected:
     } // called by HookRemovalFromCron().
     void ClearClosingNumbers();
 
+    // For subclasses whose ProcessCron() returns right away unless
+    // GetProcessInterval() has passed since GetLastProcessDate(). (Or until
+    // GetValidTo(), if that's sooner.)
+    time64_t GetProcessIntervalDueDate() const;
+
 public:
     // To force the Nym to close out the closing number on the receipt.
     bool DropFinalReceiptToInbox(
@@ -149,10 +154,7 @@ public:
     {
         return m_bRemovalFlag;
     }
-    inline void FlagForRemoval()
-    {
-        m_bRemovalFlag = true;
-    }
+    void FlagForRemoval(); // Also lets Cron know it's due right away.
     inline void SetCronPointer(OTCron& theCron)
     {
         m_pCron = &theCron;
@@ -224,6 +226,12 @@ public:
     virtual bool ProcessCron(); // OTCron calls this regularly, which is my
                                 // chance to expire, etc.
                                 // From OTTrackable (parent class of this)
+
+    // The earliest time that ProcessCron() might do anything more than
+    // return true. OTCron doesn't call it before then. OT_TIME_ZERO means
+    // every time Cron processes. Call OTCron::ScheduleItem() if something
+    // other than ProcessCron() changes the answer.
+    virtual time64_t GetCronDueDate() const;
     virtual ~OTCronItem();
 
     void InitCronItem();
@@ -0,0 +1,132 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+// The Nyms, accounts and inboxes that cron items settle against (trades and
+// payment plans), kept in memory once verified, so the next settlement
+// doesn't verify them again.
+
+#ifndef OPENTXS_CORE_CRON_OTVERIFICATIONCACHE_HPP
+#define OPENTXS_CORE_CRON_OTVERIFICATIONCACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace opentxs
+{
+
+class Account;
+class Identifier;
+class Ledger;
+class Nym;
+
+// Once an object is loaded and verified, it stays here along with the digest
+// of the file it came from. It is only reused while that file is unchanged,
+// so whatever the notary writes in the meantime is loaded again. A hit costs
+// one read of the file, instead of parsing it and verifying the signatures
+// (and for an inbox, loading and verifying all of its box receipts.)
+//
+// This only saves verifying: it doesn't hold writes back. SaveAccount /
+// SaveInbox write straight through (into the cron item's OTDB batch), and
+// just note the digest of what was written.
+//
+// Whatever GetNym / GetAccount / GetInbox hand out is checked out until
+// CheckIn(), and the same object is returned again until then. A checked out
+// account or inbox may have been changed in memory, so unless it was saved
+// with SaveAccount / SaveInbox, CheckIn() drops it instead of keeping it.
+//
+// Cron only uses this from the thread that processes it, so it has no lock
+// of its own.
+class OTVerificationCache
+{
+public:
+    EXPORT OTVerificationCache();
+    EXPORT ~OTVerificationCache();
+
+    // These return nullptr if the object can't be loaded or doesn't verify.
+    // The cache owns what they return.
+    EXPORT Nym* GetNym(const Identifier& theNymID, Nym& theServerNym);
+    EXPORT Account* GetAccount(const Identifier& theAcctID,
+                               const Identifier& theNotaryID,
+                               Nym& theServerNym);
+    // If the inbox doesn't exist yet, it's generated.
+    EXPORT Ledger* GetInbox(const Identifier& theNymID,
+                            const Identifier& theAcctID,
+                            const Identifier& theNotaryID, Nym& theServerNym);
+
+    // Save a (signed) account or inbox that was checked out, so it can be
+    // kept.
+    EXPORT bool SaveAccount(Account& theAccount);
+    EXPORT bool SaveInbox(Account& theAccount, Ledger& theInbox);
+
+    // The end of a settlement: drops whatever was changed without being
+    // saved, and trims the cache back down to its size.
+    EXPORT void CheckIn();
+    EXPORT void Clear();
+
+private:
+    struct Entry
+    {
+        std::string strDigest; // Of the file, when loaded or last saved.
+        bool bCheckedOut;
+        bool bDirty;
+        std::unique_ptr<Nym> pNym;
+        std::unique_ptr<Account> pAccount;
+        std::unique_ptr<Ledger> pInbox;
+    };
+    // Most recently used first, keyed by "nym/", "account/" or "inbox/" and
+    // the ID.
+    typedef std::list<std::pair<std::string, Entry>> listOfEntries;
+
+    static bool GetFileDigest(const char* szFolder, const char* szOne,
+                              const char* szTwo, std::string& strDigest);
+
+    Entry* Find(const std::string& strKey, const std::string& strDigest);
+    Entry& Add(const std::string& strKey, const std::string& strDigest);
+    void Forget(const std::string& strKey);
+    void Forget(listOfEntries::iterator it);
+
+    listOfEntries m_listEntries;
+    std::map<std::string, listOfEntries::iterator> m_mapIndex;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRON_OTVERIFICATIONCACHE_HPP
@@ -41,6 +41,7 @@
 
 #include <opentxs/core/String.hpp>
 
+#include <cstdint>
 #include <memory>
 
 namespace opentxs
@@ -76,8 +77,47 @@ extern const char* OT_BEGIN_SIGNED_escaped;
 class OTASCIIArmor : public String
 {
 public:
+    // Sets the compression level SetString uses on this thread, for as long
+    // as it's in scope. (Cron and the markets armor a lot of data that's
+    // rewritten all the time, so they favor speed over size.)
+    class CompressionScope
+    {
+    public:
+        EXPORT explicit CompressionScope(int32_t nLevel);
+        EXPORT ~CompressionScope();
+
+    private:
+        int32_t m_nPrevious;
+
+        CompressionScope(const CompressionScope&) = delete;
+        CompressionScope& operator=(const CompressionScope&) = delete;
+    };
+
     static OTDB::OTPacker* GetPacker();
 
+    // The zlib level SetString uses, unless a CompressionScope says otherwise.
+    static int32_t GetCompressionLevel()
+    {
+        return __compression_level;
+    }
+
+    static void SetCompressionLevel(int32_t nLevel)
+    {
+        __compression_level = nLevel;
+    }
+
+    // Strings shorter than this are armored without compressing them.
+    // GetString reads those back, but older versions can't. (0 turns it off.)
+    static int32_t GetUncompressedBelow()
+    {
+        return __uncompressed_below;
+    }
+
+    static void SetUncompressedBelow(int32_t nLength)
+    {
+        __uncompressed_below = nLength;
+    }
+
     EXPORT OTASCIIArmor();
     EXPORT OTASCIIArmor(const char* szValue);
     EXPORT OTASCIIArmor(const OTData& theValue);
@@ -159,6 +199,9 @@ private:
     std::string decompress_string(const std::string& str) const;
 
     static std::unique_ptr<OTDB::OTPacker> s_pPacker;
+
+    static int32_t __compression_level;
+    static int32_t __uncompressed_below;
 };
 
 } // namespace opentxs
@@ -168,17 +168,21 @@ public:
                           String& strOutput) const = 0;
     // BASE 64 ENCODING
     // Caller is responsible to delete. Todo: return a unqiue pointer.
+    //
+    // OT does its own base64, the same for every crypto engine. The output
+    // matches what OpenSSL's BIO used to produce: with bLineBreaks, a newline
+    // after every 64 characters (and at the end.) Decoding skips line breaks
+    // whether or not bLineBreaks is set, and returns nullptr if the input
+    // isn't base64.
     virtual char* Base64Encode(const uint8_t* input, int32_t in_len,
-                               bool bLineBreaks) const = 0; // NOTE: the
-                                                            // 'int32_t' here is
-                                                            // very worrying to
-                                                            // me. The
-    // reason it's here is because that's what OpenSSL uses. So
-    // we may need to find another way of doing it, so we can use
-    // a safer parameter here than what it currently is. Todo
-    // security.
+                               bool bLineBreaks) const;
     virtual uint8_t* Base64Decode(const char* input, size_t* out_len,
-                                  bool bLineBreaks) const = 0;
+                                  bool bLineBreaks) const;
+    // These decode straight into the output, without an intermediate buffer.
+    bool Base64Decode(const char* input, size_t in_len,
+                      OTData& theOutput) const;
+    bool Base64Decode(const char* input, size_t in_len,
+                      std::string& strOutput) const;
     // KEY DERIVATION
     //
     // DeriveNewKey derives a 128-bit symmetric key from a passphrase.
@@ -102,15 +102,6 @@ public:
     virtual void SetIDFromEncoded(const String& strInput,
                                   Identifier& theOutput) const;
     virtual void EncodeID(const Identifier& theInput, String& strOutput) const;
-    // BASE 64 ENCODING
-    // Lower-level version:
-    // Caller is responsible to delete. Todo: return a unqiue pointer.
-    virtual char* Base64Encode(const uint8_t* input, int32_t in_len,
-                               bool bLineBreaks) const; // todo security
-                                                        // ('int32_t')
-    virtual uint8_t* Base64Decode(const char* input, size_t* out_len,
-                                  bool bLineBreaks) const;
-
     virtual OTPassword* DeriveNewKey(const OTPassword& userPassword,
                                      const OTData& dataSalt,
                                      uint32_t uIterations,
@@ -379,6 +379,7 @@ public:
     // Return False if expired or otherwise should be removed.
     virtual bool ProcessCron(); // OTCron calls this regularly, which is my
                                 // chance to expire, etc.
+    virtual time64_t GetCronDueDate() const;
 
     // From OTCronItem (parent class of OTAgreement, parent class of this)
 
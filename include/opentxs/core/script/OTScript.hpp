@@ -139,6 +139,16 @@ public:
     // respective parties.
 
     virtual bool ExecuteScript(OTVariable* pReturnVar = nullptr);
+
+    // A script engine can be reused for several executions. Once the native
+    // calls are registered, SaveBaseline() remembers the engine state, and
+    // ResetToBaseline() drops the parties, accounts and variables of the last
+    // execution and restores that state, so the next one starts clean.
+    //
+    virtual void SaveBaseline()
+    {
+    }
+    virtual void ResetToBaseline();
 };
 
 EXPORT std::shared_ptr<OTScript> OTScriptFactory(
@@ -74,7 +74,13 @@ public:
     virtual ~OTScriptChai();
 
     virtual bool ExecuteScript(OTVariable* pReturnVar = nullptr);
+    virtual void SaveBaseline();
+    virtual void ResetToBaseline();
     chaiscript::ChaiScript* const chai;
+
+private:
+    struct State;
+    State* m_pBaseline; // engine state saved by SaveBaseline(), or nullptr.
 };
 
 #endif // OT_USE_SCRIPT_CHAI
@@ -42,16 +42,21 @@
 #include <opentxs/core/AccountList.hpp>
 #include <opentxs/core/cron/OTCronItem.hpp>
 
+#include <memory>
+
 namespace opentxs
 {
 
 class Account;
+class OTBylaw;
 class OTParty;
 class Nym;
+class OTScript;
 class OTStash;
 
 typedef std::map<std::string, Account*> mapOfAccounts;
 typedef std::map<std::string, OTStash*> mapOfStashes;
+typedef std::map<std::string, std::shared_ptr<OTScript>> mapOfScripts;
 
 class OTSmartContract : public OTCronItem
 {
@@ -110,6 +115,12 @@ private:
     // contain the
     time64_t m_tNextProcessDate; // date that it WILL be, in a week. (Or zero.)
 
+    // One script engine per bylaw name, with the native OT calls already
+    // registered. Not serialized; rebuilt on first use after loading.
+    mapOfScripts m_mapScripts;
+
+    std::shared_ptr<OTScript> GetBylawScript(OTBylaw& theBylaw);
+
     // For moving money from one nym's account to another.
     // it is also nearly identically copied in OTPaymentPlan.
     bool MoveFunds(const mapOfNyms& map_NymsAlreadyLoaded,
@@ -223,6 +234,7 @@ public:
     // Return False if expired or otherwise should be removed.
     virtual bool ProcessCron(); // OTCron calls this regularly, which is my
                                 // chance to expire, etc.
+    virtual time64_t GetCronDueDate() const;
 
     virtual bool HasTransactionNum(const int64_t& lInput) const;
     virtual void GetAllTransactionNumbers(NumList& numlistOutput) const;
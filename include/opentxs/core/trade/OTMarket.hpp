@@ -45,9 +45,12 @@
 #define OPENTXS_CORE_TRADE_OTMARKET_HPP
 
 #include "OTOffer.hpp"
+#include "OTOrderBook.hpp"
 #include <opentxs/core/cron/OTCron.hpp>
 #include <opentxs/core/OTStorage.hpp>
 
+#include <set>
+
 namespace opentxs
 {
 
@@ -56,13 +59,8 @@ class OTTrade;
 #define MAX_MARKET_QUERY_DEPTH                                                 \
     50 // todo add this to the ini file. (Now that we actually have one.)
 
-// Multiple offers, mapped by price limit.
-// Using multi-map since there will be more than one offer for each single
-// price.
-// (Map would only allow a single item on the map for each price.)
-typedef std::multimap<int64_t, OTOffer*> mapOfOffers;
-
-// The same offers are also mapped (uniquely) to transaction number.
+// The offers in the order book are also mapped (uniquely) to transaction
+// number.
 typedef std::map<int64_t, OTOffer*> mapOfOffersTrnsNum;
 
 class OTMarket : public Contract
@@ -75,8 +73,8 @@ private:
 
     OTDB::TradeListMarket* m_pTradeList;
 
-    mapOfOffers m_mapBids; // The buyers, ordered by price limit
-    mapOfOffers m_mapAsks; // The sellers, ordered by price limit
+    OTOrderBook m_Bids; // The buyers, ordered by price limit
+    OTOrderBook m_Asks; // The sellers, ordered by price limit
 
     mapOfOffersTrnsNum m_mapOffers; // All of the offers on a single list,
                                     // ordered by transaction number.
@@ -102,6 +100,18 @@ private:
     int64_t m_lLastSalePrice;
     std::string m_strLastSaleDate;
 
+    // Between full saves, changes to the order book are appended to a
+    // journal instead of rewriting the entire market file. The generation
+    // ties a journal to the market file it builds on.
+    int64_t m_lJournalGeneration;
+    int32_t m_nJournalRecords; // Records in the journal so far.
+    std::set<int64_t> m_setChangedOffers; // Offers to write out on the next
+                                          // save.
+    std::string m_strJournalPending; // Other records waiting for the next save.
+    int32_t m_nJournalPending;
+    std::set<int64_t> m_setJournaledOffers; // Offers with their own file.
+    bool m_bTradeListChanged;               // Recent trades need saving.
+
     // The server stores a map of markets, one for each unique combination of
     // instrument definitions.
     // That's what this market class represents: one instrument definition being
@@ -122,13 +132,18 @@ private:
     // two are technically
     // interchangeable.
 
-    void cleanup_four_accounts(Account* p1, Account* p2, Account* p3,
-                               Account* p4);
     void rollback_four_accounts(Account& p1, bool b1, const int64_t& a1,
                                 Account& p2, bool b2, const int64_t& a2,
                                 Account& p3, bool b3, const int64_t& a3,
                                 Account& p4, bool b4, const int64_t& a4);
 
+    bool LoadJournal();
+    bool ForgetOffer(const int64_t& lTransactionNum); // Doesn't save.
+    void AddJournalRecord(const std::string& strRecord);
+    std::string JournalFilename(const String& strMarketID,
+                                int64_t lGeneration) const;
+    bool SaveTradeList(const String& strMarketID);
+
 public:
     bool ValidateOfferForMarket(OTOffer& theOffer, String* pReason = nullptr);
 
@@ -136,6 +151,9 @@ public:
     bool AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile = true,
                   time64_t tDateAddedToMarket = OT_TIME_ZERO);
     bool RemoveOffer(const int64_t& lTransactionNum);
+    // Call after re-signing an offer that's on the market, so the next
+    // SaveMarket() writes it out.
+    void SetOfferChanged(const OTOffer& theOffer);
     // returns general information about offers on the market
     EXPORT bool GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
                              int32_t& nOfferCount);
@@ -160,13 +178,13 @@ public:
     int64_t GetHighestBidPrice();
     int64_t GetLowestAskPrice();
 
-    mapOfOffers::size_type GetBidCount()
+    std::size_t GetBidCount() const
     {
-        return m_mapBids.size();
+        return m_Bids.GetCount();
     }
-    mapOfOffers::size_type GetAskCount()
+    std::size_t GetAskCount() const
     {
-        return m_mapAsks.size();
+        return m_Asks.GetCount();
     }
     void SetInstrumentDefinitionID(const Identifier& INSTRUMENT_DEFINITION_ID)
     {
@@ -240,7 +258,8 @@ public:
         return m_pCron;
     }
     bool LoadMarket();
-    bool SaveMarket();
+    bool SaveMarket();    // Appends whatever changed to the journal.
+    bool CompactMarket(); // Saves everything, and starts a new journal.
 
     void InitMarket();
 
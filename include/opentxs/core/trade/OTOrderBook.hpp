@@ -0,0 +1,132 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+// One side of a market's order book: all the bids, or all the asks.
+
+#ifndef OPENTXS_CORE_TRADE_OTORDERBOOK_HPP
+#define OPENTXS_CORE_TRADE_OTORDERBOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace opentxs
+{
+
+class OTOffer;
+
+// All the limit orders at one price, first come first served.
+//
+// The level also keeps the largest amount available and the smallest minimum
+// increment among its offers, so matching can pass over a whole level that
+// can't possibly fill an offer, without looking at each one.
+struct OTPriceLevel
+{
+    int64_t lPrice;
+    std::deque<OTOffer*> dequeOffers;
+
+    int64_t lTotalAvailable;
+    int64_t lMaxAvailable;
+    int64_t lMinIncrement;
+
+    // True if at least one offer here might trade with theOffer.
+    bool CanFill(OTOffer& theOffer) const;
+};
+
+typedef std::vector<OTPriceLevel> vectorOfPriceLevels;
+
+// The price levels are kept in one contiguous vector, sorted from the worst
+// price to the best, so the best price is always at the back: reading it is
+// O(1), and so is adding or removing a level there (which is where most of
+// the activity is.) Market orders have no price, so they wait on their own
+// queue instead.
+//
+// The book only keeps pointers. The market owns the offers.
+//
+class OTOrderBook
+{
+public:
+    // Walks the price levels from the best price to the worst.
+    typedef vectorOfPriceLevels::const_reverse_iterator const_iterator;
+
+    explicit OTOrderBook(bool bBids);
+
+    // Adds the offer to the end of the line at its price.
+    void AddOffer(OTOffer& theOffer);
+    bool RemoveOffer(const OTOffer& theOffer);
+    // Puts theNew in theOld's place in line.
+    bool ReplaceOffer(const OTOffer& theOld, OTOffer& theNew);
+    // Call after the amount available on theOffer has changed.
+    void OfferChanged(const OTOffer& theOffer);
+    void Clear();
+
+    // The best limit price, or 0 if there are no limit orders.
+    int64_t GetBestPrice() const;
+    int64_t GetTotalAvailable() const;
+
+    std::size_t GetCount() const
+    {
+        return m_nCount;
+    }
+    const_iterator begin() const
+    {
+        return m_vecLevels.rbegin();
+    }
+    const_iterator end() const
+    {
+        return m_vecLevels.rend();
+    }
+    const std::deque<OTOffer*>& GetMarketOrders() const
+    {
+        return m_dequeMarketOrders;
+    }
+
+private:
+    bool m_bBids; // Bids: higher is better. Asks: lower is better.
+    vectorOfPriceLevels m_vecLevels;
+    std::deque<OTOffer*> m_dequeMarketOrders;
+    std::size_t m_nCount;
+
+    vectorOfPriceLevels::iterator FindLevel(int64_t lPrice);
+    static void RefreshLevel(OTPriceLevel& theLevel);
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_TRADE_OTORDERBOOK_HPP
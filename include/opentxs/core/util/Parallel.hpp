@@ -0,0 +1,59 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_PARALLEL_HPP
+#define OPENTXS_CORE_PARALLEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace opentxs
+{
+
+// Calls fnItem(i) for each i from 0 to nItems - 1, on at most nThreads
+// threads (one per core if nThreads isn't positive), counting the calling
+// thread, and never more threads than items. Once a call returns false, no
+// more items are started. Returns false if any call did.
+//
+EXPORT bool ParallelFor(size_t nItems, int32_t nThreads,
+                        const std::function<bool(size_t)>& fnItem);
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_PARALLEL_HPP
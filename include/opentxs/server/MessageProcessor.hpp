@@ -56,6 +56,9 @@ class OTServer;
 
 class MessageProcessor
 {
+    // Feeds processMessage() directly, without a socket. (opentxs-bench)
+    friend class MessageProcessorBench;
+
 public:
     EXPORT explicit MessageProcessor(ServerLoader& loader);
     ~MessageProcessor();
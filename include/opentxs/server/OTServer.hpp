@@ -68,6 +68,10 @@ class OTServer
     friend class PayDividendVisitor;
     friend class Notary;
 
+    // Set up a notary without its config and contract. (unittests-opentxs)
+    friend class TransactorTest;
+    friend class UserCommandProcessorTest;
+
 public:
     EXPORT OTServer();
     EXPORT ~OTServer();
@@ -80,6 +84,7 @@ public:
     zcert_t* GetTransportKey() const;
 
     const Nym& GetServerNym() const;
+    const String& GetNotaryID() const;
 
     EXPORT void ActivateCron();
     void ProcessCron();
@@ -77,6 +77,36 @@ struct ServerSettings
         __heartbeat_ms_between_beats = value;
     }
 
+    static int32_t GetTokenVerifyThreads()
+    {
+        return __token_verify_threads;
+    }
+
+    static void SetTokenVerifyThreads(int32_t value)
+    {
+        __token_verify_threads = value;
+    }
+
+    static int32_t GetVerifiedNymCacheSize()
+    {
+        return __verified_nym_cache_size;
+    }
+
+    static void SetVerifiedNymCacheSize(int32_t value)
+    {
+        __verified_nym_cache_size = value;
+    }
+
+    static const std::string& GetStorageType()
+    {
+        return __storage_type;
+    }
+
+    static void SetStorageType(const std::string& type)
+    {
+        __storage_type = type;
+    }
+
     static const std::string& GetOverrideNymID()
     {
         return __override_nym_id;
@@ -92,6 +122,17 @@ struct ServerSettings
     static int32_t __heartbeat_no_requests;
     static int32_t __heartbeat_ms_between_beats;
 
+    // Number of threads verifying the tokens in a deposited purse. 0 means
+    // one per core.
+    static int32_t __token_verify_threads;
+
+    // How many Nyms with verified credentials are kept in memory, so their
+    // credentials aren't verified again on every request. 0 disables it.
+    static int32_t __verified_nym_cache_size;
+
+    // Where OTDB keeps the server's data: "filesystem" or "log".
+    static std::string __storage_type;
+
     // The Nym who's allowed to do certain commands even if they are turned off.
     static std::string __override_nym_id;
     // Are usage credits REQUIRED in order to use this server?
@@ -82,6 +82,10 @@ public:
         transactionNumber_ = value;
     }
 
+    // Skips past any numbers that were reserved (and possibly issued) since
+    // the main file was last saved. Call after loading the main file.
+    bool recoverTransactionNumbers();
+
     // When a user uploads an asset contract, the server adds it to the list
     // (and verifies the user's key against the
     // contract.) This way the server has a directory with all the asset
@@ -144,9 +148,16 @@ private:
     typedef std::map<std::string, AssetContract*> ContractsMap;
     typedef std::map<std::string, std::string> BasketsMap;
 
+private:
+    bool reserveTransactionNumbers();
+    std::string reservationFilename() const;
+
 private:
     // This stores the last VALID AND ISSUED transaction number.
     int64_t transactionNumber_;
+    // Numbers up to here are reserved in the reservation log, and can be
+    // issued without touching storage.
+    int64_t transactionNumberCeiling_;
     // The instrument definitions supported by this server.
     ContractsMap contractsMap_;
     // maps basketId with basketAccountId
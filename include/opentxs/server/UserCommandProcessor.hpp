@@ -40,6 +40,10 @@
 #define OPENTXS_SERVER_USERCOMMANDPROCESSOR_HPP
 
 #include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
 
 namespace opentxs
 {
@@ -52,6 +56,9 @@ class ClientConnection;
 
 class UserCommandProcessor
 {
+    // Checks the verified Nym cache directly. (unittests-opentxs)
+    friend class UserCommandProcessorTest;
+
 public:
     UserCommandProcessor(OTServer* server);
 
@@ -113,8 +120,27 @@ private:
     // Get the offers that a specific Nym has placed on a specific market.
     void UserCmdGetNymMarketOffers(Nym& nym, Message& msgIn, Message& msgOut);
 
+    // Nyms whose public credentials were already loaded and verified, most
+    // recently used first. Each is keyed by Nym ID, and only reused while its
+    // credential generation (see Nym::GetCredentialGeneration) is still the
+    // one it was verified with.
+    struct VerifiedNym
+    {
+        uint64_t credentialGeneration;
+        std::shared_ptr<Nym> nym;
+    };
+    typedef std::list<std::pair<std::string, VerifiedNym>> listOfVerifiedNyms;
+
+    std::shared_ptr<Nym> FindVerifiedNym(const std::string& nymID,
+                                         uint64_t generation);
+    void AddVerifiedNym(const std::string& nymID, uint64_t generation,
+                        std::shared_ptr<Nym> nym);
+    void ForgetVerifiedNym(const std::string& nymID);
+
 private:
     OTServer* server_;
+    listOfVerifiedNyms verifiedNyms_;
+    std::map<std::string, listOfVerifiedNyms::iterator> verifiedNymIndex_;
 };
 
 } // namespace opentxs
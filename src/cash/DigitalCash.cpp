@@ -42,6 +42,7 @@
 #include <opentxs/cash/DigitalCash.hpp>
 
 #include <fstream>
+#include <mutex>
 
 namespace opentxs
 {
@@ -86,9 +87,25 @@ void SetDumper(const char* filepathexact)
 
 #ifdef OT_CASH_USING_LUCRE
 
+namespace
+{
+
+// Lucre's dumper is a global, and tokens are verified on several threads at
+// once. So only the first LucreDumper sets it, and only the last one cleans
+// up after it.
+std::mutex s_dumperLock;
+int32_t s_nDumpers = 0;
+std::string s_strDumpFile;
+
+} // namespace
+
 // We don't need this for release builds
 LucreDumper::LucreDumper()
 {
+    std::lock_guard<std::mutex> lock(s_dumperLock);
+
+    if (0 < s_nDumpers++) return;
+
 #ifdef _WIN32
 #ifdef _DEBUG
     String strOpenSSLDumpFilename("openssl.dumpfile"), strOpenSSLDumpFilePath,
@@ -112,7 +129,7 @@ LucreDumper::LucreDumper()
                                              // withdrawing cash. (Caused by
                                              // da2ce7 removing Lucre from OT
                                              // and moving it into a dylib.)
-    m_str_dumpfile = strOpenSSLDumpFilePath.Get();
+    s_strDumpFile = strOpenSSLDumpFilePath.Get();
     strOpenSSLDumpFilePath.Set("");
 #endif
 #else
@@ -122,9 +139,13 @@ LucreDumper::LucreDumper()
 
 LucreDumper::~LucreDumper()
 {
+    std::lock_guard<std::mutex> lock(s_dumperLock);
+
+    if (0 < --s_nDumpers) return;
+
 #ifdef _WIN32
 #ifdef _DEBUG
-    CleanupDumpFile(m_str_dumpfile.c_str());
+    CleanupDumpFile(s_strDumpFile.c_str());
 #endif
 #endif
 }
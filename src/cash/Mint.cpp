@@ -50,12 +50,19 @@
 
 #include <irrxml/irrXML.hpp>
 
+#include <chrono>
+
 #if defined(OT_CASH_USING_LUCRE)
 #endif
 
 namespace opentxs
 {
 
+int32_t Mint::__mint_key_cache_size = 100; // The number of denomination keys
+                                           // (Lucre banks) kept open.
+int32_t Mint::__mint_generation_threads = 0; // The number of denominations
+                                             // generated at the same time.
+
 // static
 Mint* Mint::MintFactory()
 {
@@ -233,6 +240,10 @@ Mint::Mint(const String& strNotaryID, const String& strServerNymID,
     , m_VALID_TO(OT_TIME_ZERO)
     , m_EXPIRATION(OT_TIME_ZERO)
     , m_pReserveAcct(nullptr)
+    , m_nDenominationsGenerated(0)
+    , m_nDenominationsToGenerate(0)
+    , m_lGenerationStarted(0)
+    , m_lGenerationFinished(0)
 {
     m_strFoldername.Set(OTFolders::Mint().Get());
     m_strFilename.Format("%s%s%s", strNotaryID.Get(), Log::PathSeparator(),
@@ -253,6 +264,10 @@ Mint::Mint(const String& strNotaryID, const String& strInstrumentDefinitionID)
     , m_VALID_TO(OT_TIME_ZERO)
     , m_EXPIRATION(OT_TIME_ZERO)
     , m_pReserveAcct(nullptr)
+    , m_nDenominationsGenerated(0)
+    , m_nDenominationsToGenerate(0)
+    , m_lGenerationStarted(0)
+    , m_lGenerationFinished(0)
 {
     m_strFoldername.Set(OTFolders::Mint().Get());
     m_strFilename.Format("%s%s%s", strNotaryID.Get(), Log::PathSeparator(),
@@ -271,6 +286,10 @@ Mint::Mint()
     , m_VALID_TO(OT_TIME_ZERO)
     , m_EXPIRATION(OT_TIME_ZERO)
     , m_pReserveAcct(nullptr)
+    , m_nDenominationsGenerated(0)
+    , m_nDenominationsToGenerate(0)
+    , m_lGenerationStarted(0)
+    , m_lGenerationFinished(0)
 {
     InitMint();
 }
@@ -831,46 +850,74 @@ void Mint::GenerateNewMint(int32_t nSeries, time64_t VALID_FROM,
         otErr << "Error creating cash reserve account for new mint.\n";
     }
 
-    if (nDenom1) {
-        AddDenomination(theNotary,
-                        nDenom1); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom2) {
-        AddDenomination(theNotary,
-                        nDenom2); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom3) {
-        AddDenomination(theNotary,
-                        nDenom3); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom4) {
-        AddDenomination(theNotary,
-                        nDenom4); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom5) {
-        AddDenomination(theNotary,
-                        nDenom5); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom6) {
-        AddDenomination(theNotary,
-                        nDenom6); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom7) {
-        AddDenomination(theNotary,
-                        nDenom7); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom8) {
-        AddDenomination(theNotary,
-                        nDenom8); // int32_t nPrimeLength default = 1024
+    std::vector<int64_t> vecDenoms;
+    for (int64_t lDenom : {nDenom1, nDenom2, nDenom3, nDenom4, nDenom5,
+                           nDenom6, nDenom7, nDenom8, nDenom9, nDenom10}) {
+        if (lDenom) vecDenoms.push_back(lDenom);
     }
-    if (nDenom9) {
-        AddDenomination(theNotary,
-                        nDenom9); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom10) {
-        AddDenomination(theNotary,
-                        nDenom10); // int32_t nPrimeLength default = 1024
+
+    AddDenominations(theNotary, vecDenoms); // nPrimeLength default = 1024
+}
+
+// One at a time, unless the subclass knows better.
+int32_t Mint::AddDenominations(Nym& theNotary,
+                               const std::vector<int64_t>& vecDenoms,
+                               int32_t nPrimeLength)
+{
+    int32_t nAdded = 0;
+
+    StartGeneration(static_cast<int32_t>(vecDenoms.size()));
+
+    for (int64_t lDenom : vecDenoms) {
+        if (AddDenomination(theNotary, lDenom, nPrimeLength)) nAdded++;
+
+        m_nDenominationsGenerated++;
     }
+
+    FinishGeneration();
+
+    return nAdded;
+}
+
+void Mint::GetGenerationProgress(int32_t& nGenerated, int32_t& nTotal,
+                                 int64_t& lElapsedMs) const
+{
+    const int64_t lStarted = m_lGenerationStarted;
+    const int64_t lFinished = m_lGenerationFinished;
+
+    nGenerated = m_nDenominationsGenerated;
+    nTotal = m_nDenominationsToGenerate;
+
+    if (0 == lStarted)
+        lElapsedMs = 0;
+    else
+        lElapsedMs =
+            ((0 == lFinished) ? GetGenerationClock() : lFinished) - lStarted;
+}
+
+void Mint::StartGeneration(int32_t nDenominations)
+{
+    m_lGenerationFinished = 0;
+    m_nDenominationsGenerated = 0;
+    m_nDenominationsToGenerate = nDenominations;
+    m_lGenerationStarted = GetGenerationClock();
+}
+
+void Mint::FinishGeneration()
+{
+    m_lGenerationFinished = GetGenerationClock();
+
+    otWarn << "Generated " << m_nDenominationsGenerated << " denominations in "
+           << (m_lGenerationFinished - m_lGenerationStarted) << " ms.\n";
+}
+
+// static
+int64_t Mint::GetGenerationClock()
+{
+    // Never 0, since that means "not yet."
+    return 1 + std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+                   .count();
 }
 
 } // namespace opentxs
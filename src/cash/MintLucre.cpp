@@ -49,9 +49,15 @@
 #include <opentxs/core/crypto/OpenSSL_BIO.hpp>
 #endif
 
+#include <opentxs/core/util/Parallel.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Nym.hpp>
 
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <vector>
+
 #ifdef __APPLE__
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #endif
@@ -61,36 +67,201 @@ namespace opentxs
 
 #if defined(OT_CASH_USING_LUCRE)
 
+namespace
+{
+
+// Denomination banks that were already opened, so that signing or verifying
+// a token doesn't also cost an envelope open (an RSA decryption) and a parse
+// of the bank. Most recently used first.
+//
+// A bank is taken out of the cache while it's in use, since a Lucre bank
+// can't be used by two threads at once. (So there may be more than one bank
+// cached for the same denomination.) Lucre keeps the private key in an
+// OpenSSL DH, which clears it when it's freed, so deleting the bank is what
+// zeroes the key. That happens when it's evicted, when its mint is released,
+// and once its tokens have expired.
+class BankCache
+{
+public:
+    static std::unique_ptr<Bank> Take(const std::string& strKey);
+    static void Put(const std::string& strKey, time64_t tValidTo,
+                    std::unique_ptr<Bank> pBank);
+    static void Forget(const std::string& strPrefix);
+
+private:
+    struct Entry
+    {
+        std::string strKey;
+        time64_t tValidTo;
+        std::unique_ptr<Bank> pBank;
+    };
+    typedef std::list<Entry> listOfEntries;
+
+    static void RemoveExpired();
+
+    static std::mutex s_lock;
+    static listOfEntries s_listEntries; // Never longer than the cache size,
+                                        // so it's just searched.
+};
+
+std::mutex BankCache::s_lock;
+BankCache::listOfEntries BankCache::s_listEntries;
+
+// VerifyToken() may be called for several tokens at once, and opening a
+// sealed bank uses the notary's private key, which isn't safe to use from
+// two threads at the same time.
+std::mutex s_openBankLock;
+
+std::unique_ptr<Bank> BankCache::Take(const std::string& strKey)
+{
+    std::lock_guard<std::mutex> lock(s_lock);
+
+    RemoveExpired();
+
+    for (auto it = s_listEntries.begin(); it != s_listEntries.end(); ++it) {
+        if (it->strKey == strKey) {
+            std::unique_ptr<Bank> pBank(std::move(it->pBank));
+            s_listEntries.erase(it);
+
+            return pBank;
+        }
+    }
+
+    return nullptr;
+}
+
+void BankCache::Put(const std::string& strKey, time64_t tValidTo,
+                    std::unique_ptr<Bank> pBank)
+{
+    const size_t nSize = static_cast<size_t>(
+        std::max<int32_t>(0, Mint::GetMintKeyCacheSize()));
+
+    if (0 == nSize) return;
+
+    std::lock_guard<std::mutex> lock(s_lock);
+
+    Entry theEntry;
+    theEntry.strKey = strKey;
+    theEntry.tValidTo = tValidTo;
+    theEntry.pBank = std::move(pBank);
+    s_listEntries.push_front(std::move(theEntry));
+
+    while (s_listEntries.size() > nSize) s_listEntries.pop_back();
+}
+
+void BankCache::Forget(const std::string& strPrefix)
+{
+    std::lock_guard<std::mutex> lock(s_lock);
+
+    s_listEntries.remove_if([&strPrefix](const Entry& theEntry) {
+        return 0 == theEntry.strKey.compare(0, strPrefix.size(), strPrefix);
+    });
+}
+
+// Tokens past their valid-to date can't be deposited anymore, so there's
+// nothing left for their bank to do.
+void BankCache::RemoveExpired()
+{
+    const time64_t CURRENT_TIME = OTTimeGetCurrentTime();
+
+    s_listEntries.remove_if([CURRENT_TIME](const Entry& theEntry) {
+        return CURRENT_TIME > theEntry.tValidTo;
+    });
+}
+
+} // namespace
+
 MintLucre::MintLucre()
     : ot_super()
+    , m_bCachedBanks(false)
 {
 }
 
 MintLucre::MintLucre(const String& strNotaryID,
                      const String& strInstrumentDefinitionID)
     : ot_super(strNotaryID, strInstrumentDefinitionID)
+    , m_bCachedBanks(false)
 {
 }
 
 MintLucre::MintLucre(const String& strNotaryID, const String& strServerNymID,
                      const String& strInstrumentDefinitionID)
     : ot_super(strNotaryID, strServerNymID, strInstrumentDefinitionID)
+    , m_bCachedBanks(false)
 {
 }
 
+// Only a mint that cached its banks forgets them. (Otherwise every copy of a
+// mint that's loaded just to be sent to a client would empty the cache for
+// the notary's own copy of it.)
+void MintLucre::Release()
+{
+    if (m_bCachedBanks.exchange(false)) BankCache::Forget(GetBankPrefix());
+
+    ot_super::Release();
+}
+
 MintLucre::~MintLucre()
 {
+    if (m_bCachedBanks) BankCache::Forget(GetBankPrefix());
 }
 
-// The mint has a different key pair for each denomination.
-// Pass the actual denomination such as 5, 10, 20, 50, 100...
-bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
-                                int32_t nPrimeLength)
+// Same as the mint's filename: instrument definition ID and series.
+std::string MintLucre::GetBankPrefix() const
 {
-    OT_ASSERT(nullptr != m_pKeyPublic);
+    String strPrefix;
+    strPrefix.Format("%s.%d.", String(m_InstrumentDefinitionID).Get(),
+                     m_nSeries);
 
-    bool bReturnValue = false;
+    return strPrefix.Get();
+}
+
+std::unique_ptr<Bank> MintLucre::TakeBank(Nym& theNotary,
+                                          int64_t lDenomination)
+{
+    const std::string strKey = GetBankPrefix() + std::to_string(lDenomination);
+
+    std::unique_ptr<Bank> pBank(BankCache::Take(strKey));
+    if (pBank) return pBank;
+
+    // The Mint private info is encrypted in m_mapPrivate[lDenomination].
+    // So I need to extract that first before I can use it.
+    OTASCIIArmor thePrivate;
+    if (!GetPrivate(thePrivate, lDenomination)) return nullptr;
+
+    OTEnvelope theEnvelope(thePrivate);
+
+    String strContents; // output from opening the envelope.
+    {
+        std::lock_guard<std::mutex> lock(s_openBankLock);
 
+        // Decrypt the Envelope into strContents
+        if (!theEnvelope.Open(theNotary, strContents)) return nullptr;
+    }
+
+    // copy strContents to a BIO
+    OpenSSL_BIO bioBank = BIO_new(BIO_s_mem());
+    BIO_puts(bioBank, strContents.Get());
+
+    // Instantiate the Bank with its private key
+    pBank.reset(new Bank(bioBank));
+
+    return pBank;
+}
+
+void MintLucre::ReturnBank(int64_t lDenomination, std::unique_ptr<Bank> pBank)
+{
+    if (!pBank) return;
+
+    const std::string strKey = GetBankPrefix() + std::to_string(lDenomination);
+
+    m_bCachedBanks = true;
+    BankCache::Put(strKey, m_VALID_TO, std::move(pBank));
+}
+
+// Whether lDenomination can be added, with a prime of nPrimeLength bits.
+bool MintLucre::CanAddDenomination(int64_t lDenomination, int32_t nPrimeLength)
+{
     // Let's make sure it doesn't already exist
     OTASCIIArmor theArmor;
     if (GetPublic(theArmor, lDenomination)) {
@@ -115,6 +286,12 @@ bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
         return false;
     }
 
+    return true;
+}
+
+// static
+void MintLucre::SetGenerationMonitor()
+{
 #ifdef _WIN32
     BIO* out = BIO_new_file("openssl.dump", "w");
     assert(out);
@@ -122,7 +299,16 @@ bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
 #else
     SetMonitor(stderr);
 #endif
+}
 
+// Generates a new key pair: the private and public bank info. Searching for
+// the prime is nearly all the time spent generating a mint. This doesn't
+// touch the mint, so it runs on any thread.
+//
+// static
+bool MintLucre::GenerateBank(int32_t nPrimeLength, String& strPrivateBank,
+                             String& strPublicBank)
+{
     OpenSSL_BIO bio = BIO_new(BIO_s_mem());
     OpenSSL_BIO bioPublic = BIO_new(BIO_s_mem());
 
@@ -144,50 +330,155 @@ bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
         BIO_read(bioPublic, publicBankBuffer,
                  4000); // Just makes me feel more comfortable for some reason.
 
-    if (privatebankLen && publicbankLen) {
-        // With this, we have the Lucre public and private bank info converted
-        // to OTStrings
-        String strPublicBank;
-        strPublicBank.Set(publicBankBuffer, publicbankLen);
+    if (!privatebankLen || !publicbankLen) return false;
+
+    // With this, we have the Lucre public and private bank info converted
+    // to OTStrings
+    strPublicBank.Set(publicBankBuffer, publicbankLen);
+    strPrivateBank.Set(privateBankBuffer, privatebankLen);
+
+    return true;
+}
+
+// Seals the private bank info and adds the key pair to the mint.
+bool MintLucre::AddBank(Nym& theNotary, int64_t lDenomination,
+                        const String& strPrivateBank,
+                        const String& strPublicBank)
+{
+    OTASCIIArmor* pPublic = new OTASCIIArmor();
+    OTASCIIArmor* pPrivate = new OTASCIIArmor();
+
+    OT_ASSERT(nullptr != pPublic);
+    OT_ASSERT(nullptr != pPrivate);
+
+    // Set the public bank info onto pPublic
+    pPublic->SetString(strPublicBank, true); // linebreaks = true
+
+    // Seal the private bank info up into an encrypted Envelope
+    // and set it onto pPrivate
+    OTEnvelope theEnvelope;
+    theEnvelope.Seal(theNotary, strPrivateBank); // Todo check the return
+                                                 // values on these two
+                                                 // functions
+    theEnvelope.GetAsciiArmoredData(*pPrivate);
+
+    // Add the new key pair to the maps, using denomination as the key
+    m_mapPublic[lDenomination] = pPublic;
+    m_mapPrivate[lDenomination] = pPrivate;
+
+    // Grab the Server Nym ID and save it with this Mint
+    theNotary.GetIdentifier(m_ServerNymID);
+
+    // Grab the Server's public key and save it with this Mint
+    //
+    const OTAsymmetricKey& theNotaryPubKey = theNotary.GetPublicSignKey();
+    delete m_pKeyPublic;
+    m_pKeyPublic = theNotaryPubKey.ClonePubKey();
+
+    m_nDenominationCount++;
+    otWarn << "Successfully added denomination: " << lDenomination << "\n";
+
+    return true;
+}
+
+// The mint has a different key pair for each denomination.
+// Pass the actual denomination such as 5, 10, 20, 50, 100...
+bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
+                                int32_t nPrimeLength)
+{
+    OT_ASSERT(nullptr != m_pKeyPublic);
+
+    if (!CanAddDenomination(lDenomination, nPrimeLength)) return false;
+
+    SetGenerationMonitor();
+
+    String strPrivateBank, strPublicBank;
+    if (!GenerateBank(nPrimeLength, strPrivateBank, strPublicBank))
+        return false;
+
+    return AddBank(theNotary, lDenomination, strPrivateBank, strPublicBank);
+}
+
+// Generates the key pairs on up to GetMintGenerationThreads() threads. Only
+// that happens in parallel: they're sealed and added afterwards, on this
+// thread and in the order given, so the mint comes out the same however the
+// threads were scheduled.
+int32_t MintLucre::AddDenominations(Nym& theNotary,
+                                    const std::vector<int64_t>& vecDenoms,
+                                    int32_t nPrimeLength)
+{
+    OT_ASSERT(nullptr != m_pKeyPublic);
+
+    struct NewBank
+    {
+        int64_t lDenomination;
         String strPrivateBank;
-        strPrivateBank.Set(privateBankBuffer, privatebankLen);
+        String strPublicBank;
+        bool bGenerated;
+        int64_t lGenerationMs;
+    };
 
-        OTASCIIArmor* pPublic = new OTASCIIArmor();
-        OTASCIIArmor* pPrivate = new OTASCIIArmor();
+    std::vector<NewBank> vecBanks;
 
-        OT_ASSERT(nullptr != pPublic);
-        OT_ASSERT(nullptr != pPrivate);
+    for (int64_t lDenomination : vecDenoms) {
+        bool bDuplicate = false;
+        for (const auto& theBank : vecBanks) {
+            if (theBank.lDenomination == lDenomination) bDuplicate = true;
+        }
 
-        // Set the public bank info onto pPublic
-        pPublic->SetString(strPublicBank, true); // linebreaks = true
+        if (bDuplicate) {
+            otErr << "Error: Denomination " << lDenomination
+                  << " is listed twice in MintLucre::AddDenominations\n";
+            continue;
+        }
+
+        if (!CanAddDenomination(lDenomination, nPrimeLength)) continue;
+
+        NewBank theBank;
+        theBank.lDenomination = lDenomination;
+        theBank.bGenerated = false;
+        theBank.lGenerationMs = 0;
+        vecBanks.push_back(theBank);
+    }
 
-        // Seal the private bank info up into an encrypted Envelope
-        // and set it onto pPrivate
-        OTEnvelope theEnvelope;
-        theEnvelope.Seal(theNotary, strPrivateBank); // Todo check the return
-                                                     // values on these two
-                                                     // functions
-        theEnvelope.GetAsciiArmoredData(*pPrivate);
+    StartGeneration(static_cast<int32_t>(vecBanks.size()));
 
-        // Add the new key pair to the maps, using denomination as the key
-        m_mapPublic[lDenomination] = pPublic;
-        m_mapPrivate[lDenomination] = pPrivate;
+    SetGenerationMonitor();
 
-        // Grab the Server Nym ID and save it with this Mint
-        theNotary.GetIdentifier(m_ServerNymID);
+    ParallelFor(vecBanks.size(), GetMintGenerationThreads(), [&](size_t i) {
+        NewBank& theBank = vecBanks[i];
+        const int64_t lStarted = GetGenerationClock();
 
-        // Grab the Server's public key and save it with this Mint
-        //
-        const OTAsymmetricKey& theNotaryPubKey = theNotary.GetPublicSignKey();
-        delete m_pKeyPublic;
-        m_pKeyPublic = theNotaryPubKey.ClonePubKey();
+        theBank.bGenerated = GenerateBank(nPrimeLength, theBank.strPrivateBank,
+                                          theBank.strPublicBank);
+        theBank.lGenerationMs = GetGenerationClock() - lStarted;
 
-        m_nDenominationCount++;
-        bReturnValue = true;
-        otWarn << "Successfully added denomination: " << lDenomination << "\n";
+        m_nDenominationsGenerated++;
+
+        return true; // A failed denomination doesn't stop the others.
+    });
+
+    int32_t nAdded = 0;
+
+    for (const auto& theBank : vecBanks) {
+        if (!theBank.bGenerated) {
+            otErr << "Error: Failed generating denomination "
+                  << theBank.lDenomination
+                  << " in MintLucre::AddDenominations\n";
+            continue;
+        }
+
+        otWarn << "Generated denomination " << theBank.lDenomination << " in "
+               << theBank.lGenerationMs << " ms.\n";
+
+        if (AddBank(theNotary, theBank.lDenomination, theBank.strPrivateBank,
+                    theBank.strPublicBank))
+            nAdded++;
     }
 
-    return bReturnValue;
+    FinishGeneration();
+
+    return nAdded;
 }
 
 #if defined(OT_CRYPTO_USING_OPENSSL)
@@ -201,27 +492,13 @@ bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
 
     LucreDumper setDumper;
 
-    OpenSSL_BIO bioBank = BIO_new(BIO_s_mem());      // input
     OpenSSL_BIO bioRequest = BIO_new(BIO_s_mem());   // input
     OpenSSL_BIO bioSignature = BIO_new(BIO_s_mem()); // output
 
-    OTASCIIArmor thePrivate;
-    GetPrivate(thePrivate, theToken.GetDenomination());
-
-    // The Mint private info is encrypted in
-    // m_mapPrivates[theToken.GetDenomination()].
-    // So I need to extract that first before I can use it.
-    OTEnvelope theEnvelope(thePrivate);
-
-    String strContents; // output from opening the envelope.
-    // Decrypt the Envelope into strContents
-    if (!theEnvelope.Open(theNotary, strContents)) return false;
-
-    // copy strContents to a BIO
-    BIO_puts(bioBank, strContents.Get());
-
-    // Instantiate the Bank with its private key
-    Bank bank(bioBank);
+    // The Bank, with its private key
+    std::unique_ptr<Bank> pBank(
+        TakeBank(theNotary, theToken.GetDenomination()));
+    if (!pBank) return false;
 
     // I need the request. the prototoken.
     OTASCIIArmor ascPrototoken;
@@ -239,7 +516,7 @@ bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
 
         // Sign it with the bank we previously instantiated.
         // results will be in bnSignature (BIGNUM)
-        BIGNUM* bnSignature = bank.SignRequest(req);
+        BIGNUM* bnSignature = pBank->SignRequest(req);
 
         if (nullptr == bnSignature) {
             otErr << "MAJOR ERROR!: Bank.SignRequest failed in "
@@ -292,6 +569,8 @@ bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
         }
     }
 
+    ReturnBank(theToken.GetDenomination(), std::move(pBank));
+
     return bReturnValue;
 }
 
@@ -304,31 +583,20 @@ bool MintLucre::VerifyToken(Nym& theNotary, String& theCleartextToken,
     bool bReturnValue = false;
     LucreDumper setDumper;
 
-    OpenSSL_BIO bioBank = BIO_new(BIO_s_mem()); // input
     OpenSSL_BIO bioCoin = BIO_new(BIO_s_mem()); // input
 
     // --- copy theCleartextToken to bioCoin so lucre can load it
     BIO_puts(bioCoin, theCleartextToken.Get());
 
-    // --- The Mint private info is encrypted in m_mapPrivate[lDenomination].
-    // So I need to extract that first before I can use it.
-    OTASCIIArmor theArmor;
-    GetPrivate(theArmor, lDenomination);
-    OTEnvelope theEnvelope(theArmor);
+    std::unique_ptr<Bank> pBank(TakeBank(theNotary, lDenomination));
 
-    String strContents; // will contain output from opening the envelope.
-    // Decrypt the Envelope into strContents
-    if (theEnvelope.Open(theNotary, strContents)) {
-        // copy strContents to a BIO
-        BIO_puts(bioBank, strContents.Get());
+    if (pBank) {
+        // ---- Now the bank and coin are both ready to go...
 
-        // ---- Now the bank and coin bios are both ready to go...
-
-        Bank bank(bioBank);
         Coin coin(bioCoin);
 
-        if (bank.Verify(coin)) // Here's the boolean output: coin is verified!
-        {
+        // Here's the boolean output: coin is verified!
+        if (pBank->Verify(coin)) {
             bReturnValue = true;
 
             // (Done): When a token is redeemed, need to store it in the spent
@@ -355,6 +623,8 @@ bool MintLucre::VerifyToken(Nym& theNotary, String& theCleartextToken,
             // amount, as an additional level of security after the blind
             // signature itself.)
         }
+
+        ReturnBank(lDenomination, std::move(pBank));
     }
 
     return bReturnValue;
@@ -0,0 +1,226 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+#include <opentxs/cash/SpentTokens.hpp>
+
+#include <opentxs/core/util/OTFolders.hpp>
+#include <opentxs/core/util/OTPaths.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/OTStorage.hpp>
+
+#include <sstream>
+
+#define SPENT_TOKEN_LOG "spent.log"
+
+// The first line of every log. It says whether the partition folder already
+// held tokens, one file per token, when the log was started.
+#define SPENT_TOKEN_HEADER "# spent tokens"
+#define SPENT_TOKEN_HEADER_LEGACY "# spent tokens (legacy)"
+
+namespace opentxs
+{
+
+// static
+SpentTokens* SpentTokens::It()
+{
+    static SpentTokens s_theSingleton;
+
+    return &s_theSingleton;
+}
+
+// Returns nullptr if the partition's log exists but couldn't be read. (An
+// empty log is just an empty partition.)
+//
+SpentTokens::Partition* SpentTokens::GetPartition(
+    const std::string& strPartition)
+{
+    auto it = m_mapPartitions.find(strPartition);
+
+    if (m_mapPartitions.end() != it) return &(it->second);
+
+    std::string strLog;
+
+    if (!OTDB::ReadPlainString(strLog, OTFolders::Spent().Get(), strPartition,
+                               SPENT_TOKEN_LOG)) {
+        otErr << __FUNCTION__ << ": Failed reading spent token log: "
+              << OTFolders::Spent() << Log::PathSeparator() << strPartition
+              << Log::PathSeparator() << SPENT_TOKEN_LOG << "\n";
+        return nullptr;
+    }
+
+    Partition thePartition;
+
+    if (strLog.empty()) {
+        // No log yet. If the partition folder is there anyway, it may hold
+        // tokens recorded one file per token, before the log existed. The
+        // header written with the first record keeps track of that.
+        //
+        std::string strPath;
+        OTDB::FormPathString(strPath, OTFolders::Spent().Get(), strPartition);
+
+        thePartition.bLegacy =
+            !strPath.empty() && OTPaths::PathExists(String(strPath + "/"));
+        thePartition.bNeedsHeader = true;
+    }
+    else {
+        // A crash while appending can leave a partial record at the end.
+        // It's ignored here, and the next append starts on a new line.
+        //
+        std::istringstream theLog(strLog);
+        std::string strLine;
+        bool bHeader = false;
+
+        while (std::getline(theLog, strLine) && !theLog.eof()) {
+            if (strLine.empty()) continue;
+
+            if ('#' == strLine[0]) {
+                if (!bHeader && thePartition.setHashes.empty()) {
+                    bHeader = true;
+                    thePartition.bLegacy =
+                        (strLine == SPENT_TOKEN_HEADER_LEGACY);
+                }
+                continue;
+            }
+
+            thePartition.setHashes.insert(strLine);
+        }
+
+        // Without a header, there's no telling what the folder held before
+        // the log was started, so the old files are checked as well.
+        if (!bHeader) thePartition.bLegacy = true;
+
+        thePartition.bNeedsNewline = ('\n' != *strLog.rbegin());
+    }
+
+    otLog3 << __FUNCTION__ << ": Loaded " << thePartition.setHashes.size()
+           << " spent tokens for " << strPartition
+           << (thePartition.bLegacy ? " (legacy folder).\n" : ".\n");
+
+    return &(m_mapPartitions[strPartition] = std::move(thePartition));
+}
+
+bool SpentTokens::IsSpent(const std::string& strPartition,
+                          Partition& thePartition,
+                          const std::string& strTokenHash)
+{
+    if (thePartition.setHashes.end() !=
+        thePartition.setHashes.find(strTokenHash))
+        return true;
+
+    return thePartition.bLegacy &&
+           OTDB::Exists(OTFolders::Spent().Get(), strPartition, strTokenHash);
+}
+
+bool SpentTokens::IsSpent(const std::string& strPartition,
+                          const std::string& strTokenHash)
+{
+    Partition* pPartition = GetPartition(strPartition);
+
+    if (nullptr == pPartition) return true; // all errors must return true.
+
+    return IsSpent(strPartition, *pPartition, strTokenHash);
+}
+
+bool SpentTokens::AnySpent(const mapOfSpentTokens& theTokens)
+{
+    for (auto& it : theTokens) {
+        Partition* pPartition = GetPartition(it.first);
+
+        if (nullptr == pPartition) return true;
+
+        for (auto& strTokenHash : it.second) {
+            if (IsSpent(it.first, *pPartition, strTokenHash)) {
+                otOut << __FUNCTION__ << ": Token was already spent: "
+                      << OTFolders::Spent() << Log::PathSeparator() << it.first
+                      << Log::PathSeparator() << strTokenHash << "\n";
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool SpentTokens::RecordSpent(const mapOfSpentTokens& theTokens)
+{
+    if (AnySpent(theTokens)) return false;
+
+    for (auto& it : theTokens) {
+        Partition& thePartition = m_mapPartitions[it.first];
+
+        std::string strRecords(thePartition.bNeedsNewline ? "\n" : "");
+
+        if (thePartition.bNeedsHeader) {
+            strRecords += thePartition.bLegacy ? SPENT_TOKEN_HEADER_LEGACY
+                                               : SPENT_TOKEN_HEADER;
+            strRecords += "\n";
+        }
+
+        for (auto& strTokenHash : it.second) {
+            strRecords += strTokenHash;
+            strRecords += "\n";
+        }
+
+        // The records have to be on disk before the deposit is acknowledged,
+        // so this is synced even in the middle of the notary's batch.
+        //
+        if (!OTDB::SyncAppendPlainString(strRecords, OTFolders::Spent().Get(),
+                                         it.first, SPENT_TOKEN_LOG)) {
+            // Some of the records may have made it into the log, so this
+            // batch can't be spent again after a restart. Tokens in any
+            // partition that was already appended stay spent as well.
+            //
+            otErr << __FUNCTION__ << ": Error appending to spent token log: "
+                  << OTFolders::Spent() << Log::PathSeparator() << it.first
+                  << Log::PathSeparator() << SPENT_TOKEN_LOG << "\n";
+            thePartition.bNeedsNewline = true;
+            thePartition.bNeedsHeader = false;
+            thePartition.setHashes.insert(it.second.begin(), it.second.end());
+            return false;
+        }
+
+        thePartition.bNeedsNewline = false;
+        thePartition.bNeedsHeader = false;
+        thePartition.setHashes.insert(it.second.begin(), it.second.end());
+    }
+
+    return true;
+}
+
+} // namespace opentxs
@@ -40,6 +40,7 @@
 #include <opentxs/cash/Token.hpp>
 #include <opentxs/cash/Mint.hpp>
 #include <opentxs/cash/Purse.hpp>
+#include <opentxs/cash/SpentTokens.hpp>
 
 #if defined(OT_CASH_USING_LUCRE)
 #include <opentxs/cash/TokenLucre.hpp>
@@ -49,7 +50,6 @@
 #include <opentxs/core/crypto/OTNymOrSymmetricKey.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
 #include <opentxs/core/Log.hpp>
-#include <opentxs/core/OTStorage.hpp>
 
 #include <opentxs/core/util/Tag.hpp>
 
@@ -454,27 +454,36 @@ Token* Token::TokenFactory(String strInput)
 // submit
 // it again later and it will work.
 //
-bool Token::IsTokenAlreadySpent(String& theCleartextToken)
+// The spent token database is partitioned by instrument definition and mint
+// series, and keyed by a hash of the Lucre cleartext token ID.
+//
+void Token::GetSpentTokenKey(const String& theCleartextToken,
+                             std::string& strPartition,
+                             std::string& strTokenHash) const
 {
     String strInstrumentDefinitionID(GetInstrumentDefinitionID());
 
-    // Calculate the filename (a hash of the Lucre cleartext token ID)
     Identifier theTokenHash;
     theTokenHash.CalculateDigest(theCleartextToken);
 
-    // Grab the new hash into a string (for use as a filename)
-    String strTokenHash(theTokenHash);
+    String strHash(theTokenHash);
 
     String strAssetFolder;
     strAssetFolder.Format("%s.%d", strInstrumentDefinitionID.Get(),
                           GetSeries());
 
-    bool bTokenIsPresent = OTDB::Exists(
-        OTFolders::Spent().Get(), strAssetFolder.Get(), strTokenHash.Get());
+    strPartition = strAssetFolder.Get();
+    strTokenHash = strHash.Get();
+}
+
+bool Token::IsTokenAlreadySpent(String& theCleartextToken)
+{
+    std::string strPartition, strTokenHash;
+    GetSpentTokenKey(theCleartextToken, strPartition, strTokenHash);
 
-    if (bTokenIsPresent) {
+    if (SpentTokens::It()->IsSpent(strPartition, strTokenHash)) {
         otOut << "\nToken::IsTokenAlreadySpent: Token was already spent: "
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
+              << OTFolders::Spent() << Log::PathSeparator() << strPartition
               << Log::PathSeparator() << strTokenHash << "\n";
         return true; // all errors must return true in this function.
                      // But this is not an error. Token really WAS already
@@ -488,62 +497,24 @@ bool Token::IsTokenAlreadySpent(String& theCleartextToken)
     return false;
 }
 
+// To record a whole purse at once, see SpentTokens::RecordSpent.
+//
 bool Token::RecordTokenAsSpent(String& theCleartextToken)
 {
-    String strInstrumentDefinitionID(GetInstrumentDefinitionID());
-
-    // Calculate the filename (a hash of the Lucre cleartext token ID)
-    Identifier theTokenHash;
-    theTokenHash.CalculateDigest(theCleartextToken);
-
-    // Grab the new hash into a string (for use as a filename)
-    String strTokenHash(theTokenHash);
+    mapOfSpentTokens theTokens;
+    std::string strPartition, strTokenHash;
+    GetSpentTokenKey(theCleartextToken, strPartition, strTokenHash);
 
-    String strAssetFolder;
-    strAssetFolder.Format("%s.%d", strInstrumentDefinitionID.Get(),
-                          GetSeries());
-
-    // See if the spent token file ALREADY EXISTS...
-    bool bTokenIsPresent = OTDB::Exists(
-        OTFolders::Spent().Get(), strAssetFolder.Get(), strTokenHash.Get());
-
-    // If so, we're trying to record a token that was already recorded...
-    if (bTokenIsPresent) {
-        otErr << "Token::RecordTokenAsSpent: Trying to record token as spent,"
-                 " but it was already recorded: " << OTFolders::Spent()
-              << Log::PathSeparator() << strAssetFolder << Log::PathSeparator()
-              << strTokenHash << "\n";
-        return false;
-    }
+    theTokens[strPartition].insert(strTokenHash);
 
-    // FINISHED:
-    //
-    // We actually save the token itself into the file, which is named based
-    // on a hash of the Lucre data.
-    // The success of that operation is also now the success of this one.
-
-    String strFinal;
-    OTASCIIArmor ascTemp(m_strRawFile);
-
-    if (false ==
-        ascTemp.WriteArmoredString(strFinal, m_strContractType.Get())) {
-        otErr << "Token::RecordTokenAsSpent: Error recording token as "
-                 "spent (failed writing armored string):\n"
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
+    if (!SpentTokens::It()->RecordSpent(theTokens)) {
+        otErr << "Token::RecordTokenAsSpent: Failed recording token as spent: "
+              << OTFolders::Spent() << Log::PathSeparator() << strPartition
               << Log::PathSeparator() << strTokenHash << "\n";
         return false;
     }
 
-    const bool bSaved =
-        OTDB::StorePlainString(strFinal.Get(), OTFolders::Spent().Get(),
-                               strAssetFolder.Get(), strTokenHash.Get());
-    if (!bSaved) {
-        otErr << "Token::RecordTokenAsSpent: Error saving file: "
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
-              << Log::PathSeparator() << strTokenHash << "\n";
-    }
-
-    return bSaved;
+    return true;
 }
 
 // OTSymmetricKey:
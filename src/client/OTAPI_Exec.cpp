@@ -10975,8 +10975,7 @@ std::string OTAPI_Exec::Ledger_FinalizeResponse(const std::string& NOTARY_ID,
     // numbers, so I can remove them from my Nym and them add them again after
     // generating the statement.
     //
-    for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(theNotaryID); i++) {
-        int64_t lTemp = theTempNym.GetIssuedNum(theNotaryID, i);
+    for (const int64_t& lTemp : theTempNym.GetIssuedNums(theNotaryID)) {
         pNym->RemoveIssuedNum(strNotaryID, lTemp);
     }
     // BALANCE AGREEMENT
@@ -10993,8 +10992,7 @@ std::string OTAPI_Exec::Ledger_FinalizeResponse(const std::string& NOTARY_ID,
     // really were removed. theTempNym then I have to keep them and use them for
     // my balance agreements.)
     //
-    for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(theNotaryID); i++) {
-        int64_t lTemp = theTempNym.GetIssuedNum(theNotaryID, i);
+    for (const int64_t& lTemp : theTempNym.GetIssuedNums(theNotaryID)) {
         pNym->AddIssuedNum(strNotaryID, lTemp);
     }
 
@@ -64,7 +64,10 @@
 #include <sstream>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <iomanip>
+#include <unordered_set>
+#include <vector>
 
 using namespace irr;
 using namespace io;
@@ -492,121 +495,342 @@ bool AssetContract::SaveContractWallet(Tag& parent) const
     return true;
 }
 
-// currently only "user" accounts (normal user asset accounts) are added to
-// this list Any "special" accounts, such as basket reserve accounts, or voucher
-// reserve accounts, or cash reserve accounts, are not included on this list.
-bool AssetContract::VisitAccountRecords(AccountVisitor& visitor) const
+#define ACCOUNT_RECORD_SLACK 1024 // Erased records allowed in a log before
+                                  // it's rewritten, on top of one per account.
+
+namespace
 {
-    String strInstrumentDefinitionID, strAcctRecordFile;
-    GetIdentifier(strInstrumentDefinitionID);
-    strAcctRecordFile.Format("%s.a", strInstrumentDefinitionID.Get());
 
-    std::unique_ptr<OTDB::Storable> pStorable(OTDB::QueryObject(
-        OTDB::STORED_OBJ_STRING_MAP, OTFolders::Contract().Get(),
-        strAcctRecordFile.Get()));
+// The account records for each instrument definition, in an append-only log
+// next to its contract: "<instrument definition ID>.a.log". Each line is
+// "+ACCT_ID" when the account was added, or "-ACCT_ID" when it was erased.
+//
+// The first time an instrument definition is used, its log is read into an
+// in-memory index, so adding or erasing an account is one append after that.
+// Once the log holds too many erased records, it's rewritten with just the
+// accounts that are left.
+//
+// Before the log, the account records were a StringMap in
+// "<instrument definition ID>.a". That file is read once, when the log is
+// first created, and it's never written to again.
+//
+class AccountRecords
+{
+public:
+    static AccountRecords* It()
+    {
+        static AccountRecords s_theSingleton;
 
-    OTDB::StringMap* pMap = dynamic_cast<OTDB::StringMap*>(pStorable.get());
+        return &s_theSingleton;
+    }
 
-    // There was definitely a StringMap loaded from local storage.
-    // (Even an empty one, possibly.) This is the only block that matters in
-    // this function.
-    //
-    if (nullptr != pMap) {
-        Identifier* pNotaryID = visitor.GetNotaryID();
-        OT_ASSERT_MSG(nullptr != pNotaryID,
-                      "Assert: nullptr Notary ID on functor. "
-                      "(How did you even construct the "
-                      "thing?)");
-
-        auto& theMap = pMap->the_map;
-
-        // todo: optimize: will probably have to use a database for this,
-        // int64_t term.
-        // (What if there are a million acct IDs in this flat file? Not
-        // scaleable.)
+    bool Add(const std::string& strInstrumentDefinitionID,
+             const std::string& strAcctID);
+    bool Erase(const std::string& strInstrumentDefinitionID,
+               const std::string& strAcctID);
+
+    // The accounts as of now. (So the caller can add or erase accounts while
+    // it goes through them.)
+    bool GetAccounts(const std::string& strInstrumentDefinitionID,
+                     std::vector<std::string>& vecAccounts);
+
+private:
+    struct Records
+    {
+        std::unordered_set<std::string> setAccounts;
+        size_t nLogRecords = 0;     // Lines in the log, erased or not.
+        bool bNeedsNewline = false; // log ends with a partial record.
+    };
+
+    std::mutex m_lock; // Accounts are added and erased from several
+                       // threads.
+    std::map<std::string, Records> m_mapRecords;
+
+    AccountRecords()
+    {
+    }
+
+    static std::string LogFilename(const std::string& strInstrumentDefinitionID)
+    {
+        return strInstrumentDefinitionID + ".a.log";
+    }
+
+    Records* GetRecords(const std::string& strInstrumentDefinitionID);
+    bool Append(const std::string& strInstrumentDefinitionID,
+                Records& theRecords, const std::string& strRecord);
+    bool Compact(const std::string& strInstrumentDefinitionID,
+                 Records& theRecords);
+};
+
+// Returns nullptr if the records exist but couldn't be read.
+//
+AccountRecords::Records* AccountRecords::GetRecords(
+    const std::string& strInstrumentDefinitionID)
+{
+    auto it = m_mapRecords.find(strInstrumentDefinitionID);
+
+    if (m_mapRecords.end() != it) return &(it->second);
+
+    const std::string strLog = LogFilename(strInstrumentDefinitionID);
+    const std::string strLegacy = strInstrumentDefinitionID + ".a";
+    Records theRecords;
+
+    if (OTDB::Exists(OTFolders::Contract().Get(), strLog)) {
+        std::string strContents;
+
+        // (An empty log is just an instrument definition without accounts.)
+        if (!OTDB::ReadPlainString(strContents, OTFolders::Contract().Get(),
+                                   strLog)) {
+            otErr << __FUNCTION__ << ": Failed reading account records: "
+                  << OTFolders::Contract() << Log::PathSeparator() << strLog
+                  << "\n";
+            return nullptr;
+        }
+
+        // A crash while appending can leave a partial record at the end.
+        // It's ignored here, and the next append starts on a new line.
         //
-        for (auto& it : theMap) {
-            const std::string& str_acct_id =
-                it.first; // Containing the account ID.
-            const std::string& str_instrument_definition_id =
-                it.second; // Containing the instrument definition ID. (Just in
-                           // case
-                           // someone copied the wrong file here...)
-
-            if (!strInstrumentDefinitionID.Compare(
-                    str_instrument_definition_id.c_str())) {
-                otErr << "OTAssetContract::VisitAccountRecords: Error: wrong "
-                         "instrument definition ID ("
-                      << str_instrument_definition_id
+        std::istringstream theLog(strContents);
+        std::string strLine;
+
+        while (std::getline(theLog, strLine) && !theLog.eof()) {
+            if (strLine.size() < 2) continue;
+
+            ++theRecords.nLogRecords;
+
+            if ('+' == strLine[0])
+                theRecords.setAccounts.insert(strLine.substr(1));
+            else if ('-' == strLine[0])
+                theRecords.setAccounts.erase(strLine.substr(1));
+        }
+
+        theRecords.bNeedsNewline =
+            !strContents.empty() && ('\n' != *strContents.rbegin());
+    }
+    else if (OTDB::Exists(OTFolders::Contract().Get(), strLegacy)) {
+        std::unique_ptr<OTDB::Storable> pStorable(
+            OTDB::QueryObject(OTDB::STORED_OBJ_STRING_MAP,
+                              OTFolders::Contract().Get(), strLegacy));
+        OTDB::StringMap* pMap = dynamic_cast<OTDB::StringMap*>(pStorable.get());
+
+        if (nullptr == pMap) {
+            otErr << __FUNCTION__ << ": Failed loading account records file: "
+                  << OTFolders::Contract() << Log::PathSeparator() << strLegacy
+                  << "\n";
+            return nullptr;
+        }
+
+        for (auto& it_legacy : pMap->the_map) {
+            // Every account should map to the SAME instrument definition ID.
+            // (Just in case someone copied the wrong file here...)
+            if (strInstrumentDefinitionID != it_legacy.second) {
+                otErr << __FUNCTION__ << ": Error: wrong instrument definition "
+                                         "ID (" << it_legacy.second
                       << ") when expecting: " << strInstrumentDefinitionID
                       << "\n";
+                continue;
             }
-            else {
-                Account* pAccount = nullptr;
-                std::unique_ptr<Account> theAcctAngel;
 
-                const Identifier theAccountID(str_acct_id.c_str());
+            theRecords.setAccounts.insert(it_legacy.first);
+        }
 
-                // Before loading it from local storage, let's first make sure
-                // it's not already loaded.
-                // (visitor functor has a list of 'already loaded' accounts,
-                // just in case.)
-                //
-                mapOfAccounts* pLoadedAccounts = visitor.GetLoadedAccts();
-
-                if (nullptr !=
-                    pLoadedAccounts) // there are some accounts already loaded,
-                { // let's see if the one we're looking for is there...
-                    auto found_it = pLoadedAccounts->find(str_acct_id);
-
-                    if (pLoadedAccounts->end() != found_it) // FOUND IT.
-                    {
-                        pAccount = found_it->second;
-                        OT_ASSERT(nullptr != pAccount);
-
-                        if (theAccountID != pAccount->GetPurportedAccountID()) {
-                            otErr << "Error: the actual account didn't have "
-                                     "the ID that the std::map SAID it had! "
-                                     "(Should never happen.)\n";
-                            pAccount = nullptr;
-                        }
-                    }
-                }
+        if (!Compact(strInstrumentDefinitionID, theRecords)) return nullptr;
+    }
 
-                // I guess it wasn't already loaded...
-                // Let's try to load it.
-                //
-                if (nullptr == pAccount) {
-                    pAccount =
-                        Account::LoadExistingAccount(theAccountID, *pNotaryID);
-                    theAcctAngel.reset(pAccount);
-                }
+    otLog3 << __FUNCTION__ << ": Loaded " << theRecords.setAccounts.size()
+           << " account records for " << strInstrumentDefinitionID << "\n";
 
-                bool bSuccessLoadingAccount =
-                    ((pAccount != nullptr) ? true : false);
-                if (bSuccessLoadingAccount) {
-                    bool bTriggerSuccess = visitor.Trigger(*pAccount);
-                    if (!bTriggerSuccess)
-                        otErr << __FUNCTION__ << ": Error: Trigger Failed.";
-                }
-                else {
-                    otErr << __FUNCTION__ << ": Error: Failed Loading Account!";
+    return &(m_mapRecords[strInstrumentDefinitionID] = std::move(theRecords));
+}
+
+bool AccountRecords::Append(const std::string& strInstrumentDefinitionID,
+                            Records& theRecords, const std::string& strRecord)
+{
+    const std::string strLog = LogFilename(strInstrumentDefinitionID);
+
+    if (!OTDB::AppendPlainString(
+            (theRecords.bNeedsNewline ? "\n" : "") + strRecord + "\n",
+            OTFolders::Contract().Get(), strLog)) {
+        otErr << __FUNCTION__ << ": Error appending to account records: "
+              << OTFolders::Contract() << Log::PathSeparator() << strLog
+              << "\n";
+        theRecords.bNeedsNewline = true;
+        return false;
+    }
+
+    theRecords.bNeedsNewline = false;
+    ++theRecords.nLogRecords;
+
+    return true;
+}
+
+bool AccountRecords::Compact(const std::string& strInstrumentDefinitionID,
+                             Records& theRecords)
+{
+    const std::string strLog = LogFilename(strInstrumentDefinitionID);
+    std::string strContents;
+
+    for (auto& strAcctID : theRecords.setAccounts) {
+        strContents += "+";
+        strContents += strAcctID;
+        strContents += "\n";
+    }
+
+    if (!OTDB::StorePlainString(strContents, OTFolders::Contract().Get(),
+                                strLog)) {
+        otErr << __FUNCTION__ << ": Error writing account records: "
+              << OTFolders::Contract() << Log::PathSeparator() << strLog
+              << "\n";
+        return false;
+    }
+
+    theRecords.nLogRecords = theRecords.setAccounts.size();
+    theRecords.bNeedsNewline = false;
+
+    return true;
+}
+
+bool AccountRecords::Add(const std::string& strInstrumentDefinitionID,
+                         const std::string& strAcctID)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Records* pRecords = GetRecords(strInstrumentDefinitionID);
+
+    if (nullptr == pRecords) return false;
+
+    // Already there. (No need to add.)
+    if (pRecords->setAccounts.end() != pRecords->setAccounts.find(strAcctID))
+        return true;
+
+    if (!Append(strInstrumentDefinitionID, *pRecords, "+" + strAcctID))
+        return false;
+
+    pRecords->setAccounts.insert(strAcctID);
+
+    return true;
+}
+
+bool AccountRecords::Erase(const std::string& strInstrumentDefinitionID,
+                           const std::string& strAcctID)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Records* pRecords = GetRecords(strInstrumentDefinitionID);
+
+    if (nullptr == pRecords) return false;
+
+    // If it wasn't on the list, it's like success: either way, the acct ID
+    // is definitely not there now.
+    auto it = pRecords->setAccounts.find(strAcctID);
+
+    if (pRecords->setAccounts.end() == it) return true;
+
+    if (!Append(strInstrumentDefinitionID, *pRecords, "-" + strAcctID))
+        return false;
+
+    pRecords->setAccounts.erase(it);
+
+    if (pRecords->nLogRecords >
+        (2 * pRecords->setAccounts.size()) + ACCOUNT_RECORD_SLACK)
+        Compact(strInstrumentDefinitionID, *pRecords);
+
+    return true;
+}
+
+bool AccountRecords::GetAccounts(const std::string& strInstrumentDefinitionID,
+                                 std::vector<std::string>& vecAccounts)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Records* pRecords = GetRecords(strInstrumentDefinitionID);
+
+    if (nullptr == pRecords) return false;
+
+    vecAccounts.assign(pRecords->setAccounts.begin(),
+                       pRecords->setAccounts.end());
+
+    return true;
+}
+
+} // namespace
+
+// currently only "user" accounts (normal user asset accounts) are added to
+// this list Any "special" accounts, such as basket reserve accounts, or voucher
+// reserve accounts, or cash reserve accounts, are not included on this list.
+bool AssetContract::VisitAccountRecords(AccountVisitor& visitor) const
+{
+    String strInstrumentDefinitionID;
+    GetIdentifier(strInstrumentDefinitionID);
+
+    std::vector<std::string> vecAccounts;
+
+    if (!AccountRecords::It()->GetAccounts(strInstrumentDefinitionID.Get(),
+                                           vecAccounts))
+        return true;
+
+    Identifier* pNotaryID = visitor.GetNotaryID();
+    OT_ASSERT_MSG(nullptr != pNotaryID, "Assert: nullptr Notary ID on functor. "
+                                        "(How did you even construct the "
+                                        "thing?)");
+
+    for (auto& str_acct_id : vecAccounts) {
+        Account* pAccount = nullptr;
+        std::unique_ptr<Account> theAcctAngel;
+
+        const Identifier theAccountID(str_acct_id.c_str());
+
+        // Before loading it from local storage, let's first make sure
+        // it's not already loaded.
+        // (visitor functor has a list of 'already loaded' accounts,
+        // just in case.)
+        //
+        mapOfAccounts* pLoadedAccounts = visitor.GetLoadedAccts();
+
+        if (nullptr != pLoadedAccounts) // there are some accounts already
+                                        // loaded,
+        { // let's see if the one we're looking for is there...
+            auto found_it = pLoadedAccounts->find(str_acct_id);
+
+            if (pLoadedAccounts->end() != found_it) // FOUND IT.
+            {
+                pAccount = found_it->second;
+                OT_ASSERT(nullptr != pAccount);
+
+                if (theAccountID != pAccount->GetPurportedAccountID()) {
+                    otErr << "Error: the actual account didn't have "
+                             "the ID that the std::map SAID it had! "
+                             "(Should never happen.)\n";
+                    pAccount = nullptr;
                 }
             }
         }
-        return true;
+
+        // I guess it wasn't already loaded...
+        // Let's try to load it.
+        //
+        if (nullptr == pAccount) {
+            pAccount = Account::LoadExistingAccount(theAccountID, *pNotaryID);
+            theAcctAngel.reset(pAccount);
+        }
+
+        bool bSuccessLoadingAccount = ((pAccount != nullptr) ? true : false);
+        if (bSuccessLoadingAccount) {
+            bool bTriggerSuccess = visitor.Trigger(*pAccount);
+            if (!bTriggerSuccess)
+                otErr << __FUNCTION__ << ": Error: Trigger Failed.";
+        }
+        else {
+            otErr << __FUNCTION__ << ": Error: Failed Loading Account!";
+        }
     }
+
     return true;
 }
 
 // Adds the account to the list. (When account is created.)
 bool AssetContract::AddAccountRecord(const Account& theAccount) const
 {
-    //  Load up account list StringMap. Create it if doesn't already exist.
-    //  See if account is already there in the map. Add it otherwise.
-    //  Save the StringMap back again. (The account records list for a given
-    // instrument definition.)
-
     const char* szFunc = "OTAssetContract::AddAccountRecord";
 
     if (theAccount.GetInstrumentDefinitionID() != m_ID) {
@@ -618,175 +842,38 @@ bool AssetContract::AddAccountRecord(const Account& theAccount) const
     const Identifier theAcctID(theAccount);
     const String strAcctID(theAcctID);
 
-    String strInstrumentDefinitionID, strAcctRecordFile;
+    String strInstrumentDefinitionID;
     GetIdentifier(strInstrumentDefinitionID);
-    strAcctRecordFile.Format("%s.a", strInstrumentDefinitionID.Get());
-
-    OTDB::Storable* pStorable = nullptr;
-    std::unique_ptr<OTDB::Storable> theAngel;
-    OTDB::StringMap* pMap = nullptr;
-
-    if (OTDB::Exists(OTFolders::Contract().Get(),
-                     strAcctRecordFile.Get())) // the file already exists; let's
-                                               // try to load it up.
-        pStorable = OTDB::QueryObject(OTDB::STORED_OBJ_STRING_MAP,
-                                      OTFolders::Contract().Get(),
-                                      strAcctRecordFile.Get());
-    else // the account records file (for this instrument definition) doesn't
-         // exist.
-        pStorable = OTDB::CreateObject(
-            OTDB::STORED_OBJ_STRING_MAP); // this asserts already, on failure.
-
-    theAngel.reset(pStorable);
-    pMap = (nullptr == pStorable) ? nullptr
-                                  : dynamic_cast<OTDB::StringMap*>(pStorable);
-
-    // It exists.
-    //
-    if (nullptr == pMap) {
-        otErr << szFunc
-              << ": Error: failed trying to load or create the account records "
-                 "file for instrument definition: " << strInstrumentDefinitionID
-              << "\n";
-        return false;
-    }
-
-    auto& theMap = pMap->the_map;
-    auto map_it = theMap.find(strAcctID.Get());
-
-    if (theMap.end() != map_it) // we found it.
-    {                           // We were ADDING IT, but it was ALREADY THERE.
-        // (Thus, we're ALREADY DONE.)
-        // Let's just make sure the right instrument definition ID is associated
-        // with this
-        // account
-        // (it better be, since we loaded the account records file based on the
-        // instrument definition ID as its filename...)
-        //
-        const std::string& str2 = map_it->second; // Containing the instrument
-                                                  // definition ID. (Just in
-                                                  // case
-        // someone copied the wrong file here,
-        // --------------------------------          // every account should map
-        // to the SAME instrument definition id.)
-
-        if (false == strInstrumentDefinitionID.Compare(str2.c_str())) // should
-                                                                      // never
-                                                                      // happen.
-        {
-            otErr << szFunc << ": Error: wrong instrument definition found in "
-                               "account records "
-                               "file...\n For instrument definition: "
-                  << strInstrumentDefinitionID << "\n "
-                                                  "For account: " << strAcctID
-                  << "\n Found wrong instrument definition: " << str2 << "\n";
-            return false;
-        }
 
-        return true; // already there (no need to add.) + the instrument
-                     // definition ID
-                     // matches.
-    }
-
-    // it wasn't already on the list...
-
-    // ...so add it.
-    //
-    theMap[strAcctID.Get()] = strInstrumentDefinitionID.Get();
-
-    // Then save it back to local storage:
-    //
-    if (!OTDB::StoreObject(*pMap, OTFolders::Contract().Get(),
-                           strAcctRecordFile.Get())) {
-        otErr << szFunc
-              << ": Failed trying to StoreObject, while saving updated "
-                 "account records file for instrument definition: "
-              << strInstrumentDefinitionID
-              << "\n to contain account ID: " << strAcctID << "\n";
+    if (!AccountRecords::It()->Add(strInstrumentDefinitionID.Get(),
+                                   strAcctID.Get())) {
+        otErr << szFunc << ": Failed trying to add account ID: " << strAcctID
+              << "\n to the account records for instrument definition: "
+              << strInstrumentDefinitionID << "\n";
         return false;
     }
 
-    // Okay, we saved the updated file, with the account added. (done, success.)
-    //
     return true;
 }
 
 // Removes the account from the list. (When account is deleted.)
 bool AssetContract::EraseAccountRecord(const Identifier& theAcctID) const
 {
-    //  Load up account list StringMap. Create it if doesn't already exist.
-    //  See if account is already there in the map. Erase it, if it is.
-    //  Save the StringMap back again. (The account records list for a given
-    // instrument definition.)
-
     const char* szFunc = "OTAssetContract::EraseAccountRecord";
 
     const String strAcctID(theAcctID);
 
-    String strInstrumentDefinitionID, strAcctRecordFile;
+    String strInstrumentDefinitionID;
     GetIdentifier(strInstrumentDefinitionID);
-    strAcctRecordFile.Format("%s.a", strInstrumentDefinitionID.Get());
-
-    OTDB::Storable* pStorable = nullptr;
-    std::unique_ptr<OTDB::Storable> theAngel;
-    OTDB::StringMap* pMap = nullptr;
-
-    if (OTDB::Exists(OTFolders::Contract().Get(),
-                     strAcctRecordFile.Get())) // the file already exists; let's
-                                               // try to load it up.
-        pStorable = OTDB::QueryObject(OTDB::STORED_OBJ_STRING_MAP,
-                                      OTFolders::Contract().Get(),
-                                      strAcctRecordFile.Get());
-    else // the account records file (for this instrument definition) doesn't
-         // exist.
-        pStorable = OTDB::CreateObject(
-            OTDB::STORED_OBJ_STRING_MAP); // this asserts already, on failure.
-
-    theAngel.reset(pStorable);
-    pMap = (nullptr == pStorable) ? nullptr
-                                  : dynamic_cast<OTDB::StringMap*>(pStorable);
-
-    // It exists.
-    //
-    if (nullptr == pMap) {
-        otErr << szFunc
-              << ": Error: failed trying to load or create the account records "
-                 "file for instrument definition: " << strInstrumentDefinitionID
-              << "\n";
-        return false;
-    }
-
-    // Before we can erase it, let's see if it's even there....
-    //
-    auto& theMap = pMap->the_map;
-    auto map_it = theMap.find(strAcctID.Get());
-
-    // we found it!
-    if (theMap.end() != map_it) //  Acct ID was already there...
-    {
-        theMap.erase(map_it); // remove it
-    }
-
-    // it wasn't already on the list...
-    // (So it's like success, since the end result is, acct ID will not appear
-    // on this list--whether
-    // it was there or not beforehand, it's definitely not there now.)
 
-    // Then save it back to local storage:
-    //
-    if (!OTDB::StoreObject(*pMap, OTFolders::Contract().Get(),
-                           strAcctRecordFile.Get())) {
-        otErr << szFunc
-              << ": Failed trying to StoreObject, while saving updated "
-                 "account records file for instrument definition: "
-              << strInstrumentDefinitionID
-              << "\n to erase account ID: " << strAcctID << "\n";
+    if (!AccountRecords::It()->Erase(strInstrumentDefinitionID.Get(),
+                                     strAcctID.Get())) {
+        otErr << szFunc << ": Failed trying to erase account ID: " << strAcctID
+              << "\n from the account records for instrument definition: "
+              << strInstrumentDefinitionID << "\n";
         return false;
     }
 
-    // Okay, we saved the updated file, with the account removed. (done,
-    // success.)
-    //
     return true;
 }
 
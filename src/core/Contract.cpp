@@ -52,6 +52,7 @@
 #include <cstring>
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 
@@ -67,6 +68,77 @@ String trim(const String& str)
     return String(String::trim(s));
 }
 
+// ParseRawFile used to read lines with String::sgets() into a 2048-byte
+// buffer, which cuts longer lines into pieces. The hash of a contract depends
+// on that, so lines are still cut at the same length.
+#define OT_CONTRACT_MAX_LINE 2047
+
+namespace
+{
+
+// Where String::trim() would cut the data: [nBegin, nEnd).
+void TrimBounds(const char* data, size_t length, size_t& nBegin, size_t& nEnd)
+{
+    const char* whitespace = " \t\f\v\n\r";
+
+    nBegin = 0;
+    nEnd = length;
+
+    while ((nBegin < length) && (nullptr != strchr(whitespace, data[nBegin])))
+        ++nBegin;
+
+    // (All whitespace: trim() leaves it alone.)
+    if (nBegin == length) {
+        nBegin = 0;
+        return;
+    }
+
+    while ((nEnd > nBegin) && (nullptr != strchr(whitespace, data[nEnd - 1])))
+        --nEnd;
+}
+
+// Reads lines straight out of a buffer, the same way String::sgets() does.
+class RawLineReader
+{
+public:
+    RawLineReader(const char* data, size_t length)
+        : pos_(data)
+        , end_(data + length)
+    {
+    }
+
+    // Returns false if this was the last line.
+    bool Next(const char*& szLine, size_t& nLength)
+    {
+        szLine = pos_;
+        nLength = 0;
+
+        if (pos_ >= end_) return false;
+
+        const size_t nMax =
+            std::min<size_t>(end_ - pos_, OT_CONTRACT_MAX_LINE);
+        const char* pNewline =
+            static_cast<const char*>(memchr(pos_, '\n', nMax));
+
+        if (nullptr == pNewline) {
+            nLength = nMax;
+            pos_ += nMax;
+        }
+        else {
+            nLength = pNewline - pos_;
+            pos_ = pNewline + 1;
+        }
+
+        return pos_ < end_;
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+};
+
+} // namespace
+
 // static
 bool Contract::DearmorAndTrim(const String& strInput, String& strOutput,
                               String& strFirstLine)
@@ -275,13 +347,20 @@ bool Contract::VerifyContract()
 
 void Contract::CalculateContractID(Identifier& newID) const
 {
-    // may be redundant...
-    std::string str_Trim(m_strRawFile.Get());
-    std::string str_Trim2 = String::trim(str_Trim);
+    // may be redundant... (ParseRawFile has usually trimmed it already.)
+    size_t nBegin = 0, nEnd = 0;
+    TrimBounds(m_strRawFile.Get(), m_strRawFile.GetLength(), nBegin, nEnd);
 
-    String strTemp(str_Trim2.c_str());
+    bool bSuccess = false;
+
+    if ((0 == nBegin) && (m_strRawFile.GetLength() == nEnd))
+        bSuccess = newID.CalculateDigest(m_strRawFile);
+    else {
+        const std::string str_Trim(m_strRawFile.Get() + nBegin, nEnd - nBegin);
+        bSuccess = newID.CalculateDigest(String(str_Trim.c_str()));
+    }
 
-    if (!newID.CalculateDigest(strTemp))
+    if (!bSuccess)
         otErr << __FUNCTION__ << ": Error calculating Contract digest.\n";
 }
 
@@ -1203,18 +1282,25 @@ bool Contract::LoadContractFromString(const String& theStr)
         return false;
     }
 
-    String strContract(theStr);
+    // Most contracts aren't armored, and ParseRawFile does the trimming, so
+    // those are copied in just once.
+    if (!theStr.Contains(OT_BEGIN_ARMORED))
+        m_strRawFile.Set(theStr);
+    else {
+        String strContract(theStr);
 
-    if (false ==
-        strContract.DecodeIfArmored()) // bEscapedIsAllowed=true by default.
-    {
-        otErr << __FUNCTION__ << ": ERROR: Input string apparently was encoded "
-                                 "and then failed decoding. "
-                                 "Contents: \n" << theStr << "\n";
-        return false;
-    }
+        if (false ==
+            strContract.DecodeIfArmored()) // bEscapedIsAllowed=true by default.
+        {
+            otErr << __FUNCTION__
+                  << ": ERROR: Input string apparently was encoded "
+                     "and then failed decoding. "
+                     "Contents: \n" << theStr << "\n";
+            return false;
+        }
 
-    m_strRawFile.Set(strContract);
+        m_strRawFile.Set(strContract);
+    }
 
     // This populates m_xmlUnsigned with the contents of m_strRawFile (minus
     // bookends, signatures, etc. JUST the XML.)
@@ -1242,7 +1328,6 @@ bool Contract::LoadContractFromString(const String& theStr)
 
 bool Contract::ParseRawFile()
 {
-    char buffer1[2100]; // a bit bigger than 2048, just for safety reasons.
     OTSignature* pSig = nullptr;
 
     std::string line;
@@ -1260,25 +1345,30 @@ bool Contract::ParseRawFile()
 
     // This is redundant (I thought) but the problem hasn't cleared up yet.. so
     // trying to really nail it now.
-    std::string str_Trim(m_strRawFile.Get());
-    std::string str_Trim2 = String::trim(str_Trim);
-    m_strRawFile.Set(str_Trim2.c_str());
+    size_t nBegin = 0, nEnd = 0;
+    TrimBounds(m_strRawFile.Get(), m_strRawFile.GetLength(), nBegin, nEnd);
+
+    if ((0 != nBegin) || (m_strRawFile.GetLength() != nEnd)) {
+        const std::string str_Trim(m_strRawFile.Get() + nBegin, nEnd - nBegin);
+        m_strRawFile.Set(str_Trim.c_str());
+    }
+
+    // The lines are read in place, and the XML contents and each signature
+    // are collected here, then set all at once.
+    RawLineReader theReader(m_strRawFile.Get(), m_strRawFile.GetLength());
+    const char* szLine = nullptr;
+    size_t nLength = 0;
+    std::string strXML, strSignature;
+    strXML.reserve(m_strRawFile.GetLength());
 
     bool bIsEOF = false;
-    m_strRawFile.reset();
 
     do {
-        // Just a fresh start at the top of the loop block... probably
-        // unnecessary.
-        memset(buffer1, 0, 2100); // todo remove this in optimization. (might be
-                                  // removed already...)
-
         // the call returns true if there's more to read, and false if there
         // isn't.
-        bIsEOF = !(m_strRawFile.sgets(buffer1, 2048));
+        bIsEOF = !theReader.Next(szLine, nLength);
 
-        line = buffer1;
-        const char* pBuf = line.c_str();
+        line.assign(szLine, nLength);
 
         if (line.length() < 2) {
             if (bSignatureMode) continue;
@@ -1289,6 +1379,8 @@ bool Contract::ParseRawFile()
             if (bSignatureMode) {
                 // we just reached the end of a signature
                 //    otErr << "%s\n", pSig->Get());
+                pSig->Set(strSignature.c_str());
+                strSignature.clear();
                 pSig = nullptr;
                 bSignatureMode = false;
                 continue;
@@ -1367,7 +1459,7 @@ bool Contract::ParseRawFile()
                     if (line.length() < 2) {
                         otLog3 << "Skipping short line...\n";
 
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
+                        if (bIsEOF || !theReader.Next(szLine, nLength)) {
                             otOut << "Error in signature for contract "
                                   << m_strFilename
                                   << ": Unexpected EOF after short line.\n";
@@ -1379,7 +1471,7 @@ bool Contract::ParseRawFile()
                     else if (line.compare(0, 8, "Version:") == 0) {
                         otLog3 << "Skipping version section...\n";
 
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
+                        if (bIsEOF || !theReader.Next(szLine, nLength)) {
                             otOut << "Error in signature for contract "
                                   << m_strFilename
                                   << ": Unexpected EOF after \"Version:\"\n";
@@ -1391,7 +1483,7 @@ bool Contract::ParseRawFile()
                     else if (line.compare(0, 8, "Comment:") == 0) {
                         otLog3 << "Skipping comment section...\n";
 
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
+                        if (bIsEOF || !theReader.Next(szLine, nLength)) {
                             otOut << "Error in signature for contract "
                                   << m_strFilename
                                   << ": Unexpected EOF after \"Comment:\"\n";
@@ -1429,7 +1521,7 @@ bool Contract::ParseRawFile()
                             return false;
                         }
 
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
+                        if (bIsEOF || !theReader.Next(szLine, nLength)) {
                             otOut << "Error in signature for contract "
                                   << m_strFilename
                                   << ": Unexpected EOF after \"Meta:\"\n";
@@ -1448,7 +1540,7 @@ bool Contract::ParseRawFile()
                         m_strSigHashType = strTemp.c_str();
                         m_strSigHashType.ConvertToUpperCase();
 
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
+                        if (bIsEOF || !theReader.Next(szLine, nLength)) {
                             otOut << "Error in contract " << m_strFilename
                                   << ": Unexpected EOF after \"Hash:\"\n";
                             return false;
@@ -1465,11 +1557,19 @@ bool Contract::ParseRawFile()
                           "processing signature, in "
                           "OTContract::ParseRawFile");
 
-            pSig->Concatenate("%s\n", pBuf);
+            strSignature.append(line).push_back('\n');
         }
         else if (bContentMode)
-            m_xmlUnsigned.Concatenate("%s\n", pBuf);
+            strXML.append(line).push_back('\n');
     } while (!bIsEOF);
+
+    if (nullptr != pSig) pSig->Set(strSignature.c_str());
+
+    if (!strXML.empty()) {
+        if (m_xmlUnsigned.Exists()) strXML.insert(0, m_xmlUnsigned.Get());
+
+        m_xmlUnsigned.Set(strXML.c_str());
+    }
     //    while(!bIsEOF && (!bHaveEnteredContentMode || bContentMode ||
     // bSignatureMode));
 
@@ -1788,20 +1888,20 @@ bool Contract::LoadEncodedTextField(IrrXMLReader*& xml, OTASCIIArmor& ascOutput)
     if (EXN_TEXT == xml->getNodeType()) // SHOULD always be true, in fact this
                                         // could be an assert().
     {
-        String strNodeData = xml->getNodeData();
+        // (Read in place. Copying it into a String first costs a copy of
+        // every armored field.)
+        const char* szNodeData = xml->getNodeData();
 
         // Sometimes the XML reads up the data with a prepended newline.
         // This screws up my own objects which expect a consistent in/out
         // So I'm checking here for that prepended newline, and removing it.
         //
-        char cNewline;
-        if (strNodeData.Exists() && strNodeData.GetLength() > 2 &&
-            strNodeData.At(0, cNewline)) {
-            if ('\n' == cNewline) {
-                ascOutput.Set(strNodeData.Get() + 1);
+        if ((nullptr != szNodeData) && (strlen(szNodeData) > 2)) {
+            if ('\n' == szNodeData[0]) {
+                ascOutput.Set(szNodeData + 1);
             }
             else {
-                ascOutput.Set(strNodeData.Get());
+                ascOutput.Set(szNodeData);
             }
 
             // SkipAfterLoadingField() only skips ahead if it's not ALREADY
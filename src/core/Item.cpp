@@ -755,14 +755,14 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
     //
     for (auto& it : THE_NYM.GetMapIssuedNum()) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
+        setOfTransNums* pSet = it.second;
+        OT_ASSERT(nullptr != pSet);
 
         const Identifier theNotaryID(strNotaryID.c_str());
 
-        if (!(pDeque->empty()) && (theNotaryID == GetPurportedNotaryID())) {
+        if (!(pSet->empty()) && (theNotaryID == GetPurportedNotaryID())) {
             nNumberOfTransactionNumbers1 +=
-                static_cast<int32_t>(pDeque->size());
+                static_cast<int32_t>(pSet->size());
             break; // There's only one, in this loop, that would/could/should
                    // match. (Therefore, break after finding it.)
         }
@@ -778,18 +778,18 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
         theMessageNym.LoadFromString(strMessageNym)) {
         for (auto& it : theMessageNym.GetMapIssuedNum()) {
             std::string strNotaryID = it.first;
-            dequeOfTransNums* pDeque = it.second;
-            OT_ASSERT(nullptr != pDeque);
+            setOfTransNums* pSet = it.second;
+            OT_ASSERT(nullptr != pSet);
 
             const Identifier theNotaryID(strNotaryID.c_str());
             const String OTstrNotaryID(theNotaryID);
 
-            if (!(pDeque->empty()) && (theNotaryID == GetPurportedNotaryID())) {
+            if (!(pSet->empty()) && (theNotaryID == GetPurportedNotaryID())) {
                 nNumberOfTransactionNumbers2 +=
-                    static_cast<int32_t>(pDeque->size());
+                    static_cast<int32_t>(pSet->size());
 
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    int64_t lTransactionNumber = pDeque->at(i);
+                for (const int64_t& lNum : *pSet) {
+                    int64_t lTransactionNumber = lNum;
                     if (false ==
                         THE_NYM.VerifyIssuedNum(OTstrNotaryID,
                                                 lTransactionNumber)) // FAILURE
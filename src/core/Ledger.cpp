@@ -52,11 +52,15 @@
 
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <sstream>
 
 namespace opentxs
 {
 
+bool Ledger::__nymbox_journal = false;
+
 char const* const __TypeStringsLedger[] = {
     "nymbox", // the nymbox is per user account (versus per asset account) and
               // is used to receive new transaction numbers (and messages.)
@@ -554,6 +558,11 @@ bool Ledger::LoadGeneric(Ledger::ledgerType theType, const String* pString)
                << szFilename << "\n";
     }
 
+    // Whatever was delivered since the nymbox was saved is in its journal.
+    if ((nullptr == pString) && (Ledger::nymbox == theType) &&
+        GetNymboxJournal())
+        LoadNymboxJournal();
+
     return bSuccess;
 }
 
@@ -662,7 +671,19 @@ bool Ledger::CalculateHash(Identifier& theOutput)
 {
     theOutput.Release();
 
-    bool bCalcDigest = theOutput.CalculateDigest(m_xmlUnsigned);
+    bool bCalcDigest = false;
+
+    // Receipts from the nymbox journal aren't in m_xmlUnsigned until the
+    // ledger is signed again. But they're in the hash either way, or it
+    // wouldn't match the ledger the client ends up with.
+    if (!m_setJournaled.empty()) {
+        String strContents;
+        bCalcDigest = GenerateContents(strContents) &&
+                      theOutput.CalculateDigest(strContents);
+    }
+    else
+        bCalcDigest = theOutput.CalculateDigest(m_xmlUnsigned);
+
     if (!bCalcDigest) {
         theOutput.Release();
         otErr << "OTLedger::CalculateHash: Failed trying to calculate hash "
@@ -716,6 +737,16 @@ bool Ledger::SaveNymbox(Identifier* pNymboxHash) // If you pass
 
     const bool bSaved = SaveGeneric(m_Type);
 
+    // The journal builds on the nymbox as it was. Unless that's what was just
+    // saved (nothing was signed since it was loaded), everything in the
+    // journal is in the nymbox now, and it starts over from here.
+    if (bSaved && GetNymboxJournal() && HasNymboxJournal()) {
+        Identifier theBase;
+        theBase.CalculateDigest(m_xmlUnsigned);
+
+        if (theBase != m_JournalBase) StartNymboxJournal();
+    }
+
     // Sometimes the caller, when saving the Nymbox, wants to know what the
     // latest Nymbox hash is. FYI, the NymboxHash is calculated on the UNSIGNED
     // contents of the Nymbox. So if pNymboxHash is not nullptr, then that is
@@ -737,6 +768,207 @@ bool Ledger::SaveNymbox(Identifier* pNymboxHash) // If you pass
     return bSaved;
 }
 
+/*
+ The nymbox journal is stored next to the nymbox, at
+ "nymbox/NOTARY_ID/NYM_ID.jrn". Its first line is "base DIGEST", the digest
+ of the (unsigned) nymbox it builds on. Every line after that is the number
+ of a transaction whose box receipt was saved before the line was appended.
+ */
+void Ledger::GetNymboxJournalKey(String& strNotaryID,
+                                 String& strFilename) const
+{
+    String strID;
+    GetIdentifier(strID);
+
+    GetRealNotaryID().GetString(strNotaryID);
+    strFilename.Format("%s.jrn", strID.Get());
+}
+
+bool Ledger::HasNymboxJournal() const
+{
+    String strNotaryID, strFilename;
+    GetNymboxJournalKey(strNotaryID, strFilename);
+
+    return OTDB::Exists(OTFolders::Nymbox().Get(), strNotaryID.Get(),
+                        strFilename.Get());
+}
+
+bool Ledger::StartNymboxJournal()
+{
+    if (m_Type != Ledger::nymbox) {
+        otErr << "Wrong ledger type passed to OTLedger::StartNymboxJournal.\n";
+        return false;
+    }
+
+    String strNotaryID, strFilename;
+    GetNymboxJournalKey(strNotaryID, strFilename);
+
+    Identifier theBase;
+    theBase.CalculateDigest(m_xmlUnsigned);
+
+    const String strBase(theBase);
+    String strHeader;
+    strHeader.Format("base %s\n", strBase.Get());
+
+    if (!OTDB::StorePlainString(strHeader.Get(), OTFolders::Nymbox().Get(),
+                                strNotaryID.Get(), strFilename.Get())) {
+        otErr << "OTLedger::StartNymboxJournal: Error writing journal: "
+              << OTFolders::Nymbox() << Log::PathSeparator() << strNotaryID
+              << Log::PathSeparator() << strFilename << "\n";
+        return false;
+    }
+
+    m_JournalBase = theBase;
+    m_setJournaled.clear();
+
+    return true;
+}
+
+bool Ledger::AppendNymboxJournal(OTTransaction& theTransaction)
+{
+    m_Type = Ledger::nymbox;
+
+    const int64_t lTransactionNum = theTransaction.GetTransactionNum();
+
+    if (!AddTransaction(theTransaction)) return false;
+
+    // The receipt has to be there before anything refers to it.
+    if (!theTransaction.SaveBoxReceipt(*this)) {
+        otErr << "OTLedger::AppendNymboxJournal: Failed saving box receipt "
+              << lTransactionNum << "\n";
+        return false;
+    }
+
+    String strNotaryID, strFilename;
+    GetNymboxJournalKey(strNotaryID, strFilename);
+
+    if (!OTDB::AppendPlainString(std::to_string(lTransactionNum) + "\n",
+                                 OTFolders::Nymbox().Get(), strNotaryID.Get(),
+                                 strFilename.Get())) {
+        otErr << "OTLedger::AppendNymboxJournal: Error appending to journal: "
+              << OTFolders::Nymbox() << Log::PathSeparator() << strNotaryID
+              << Log::PathSeparator() << strFilename << "\n";
+        return false;
+    }
+
+    m_setJournaled.insert(lTransactionNum);
+
+    return true;
+}
+
+// Adds the receipts listed in the journal, if it builds on the nymbox that
+// was just loaded. (If the nymbox was saved since the journal was started,
+// whatever was in the journal is in the nymbox already.)
+bool Ledger::LoadNymboxJournal()
+{
+    String strNotaryID, strFilename;
+    GetNymboxJournalKey(strNotaryID, strFilename);
+
+    const char* szFolder = OTFolders::Nymbox().Get();
+
+    if (!OTDB::Exists(szFolder, strNotaryID.Get(), strFilename.Get()))
+        return true;
+
+    std::istringstream streamJournal(
+        OTDB::QueryPlainString(szFolder, strNotaryID.Get(), strFilename.Get()));
+
+    Identifier theBase;
+    theBase.CalculateDigest(m_xmlUnsigned);
+    const String strBase(theBase);
+
+    std::string strLine;
+
+    if (!std::getline(streamJournal, strLine) ||
+        (strLine != std::string("base ") + strBase.Get())) {
+        otWarn << "OTLedger::LoadNymboxJournal: Ignoring journal for an older "
+                  "nymbox: " << szFolder << Log::PathSeparator() << strNotaryID
+               << Log::PathSeparator() << strFilename << "\n";
+        return true;
+    }
+
+    m_JournalBase = theBase;
+
+    String strNymID;
+    GetIdentifier(strNymID);
+
+    // A line without its newline is a partial record, and is ignored.
+    while (std::getline(streamJournal, strLine) && !streamJournal.eof()) {
+        const int64_t lTransactionNum = String::StringToLong(strLine);
+
+        // (Skips anything the nymbox has already.)
+        if ((lTransactionNum <= 0) ||
+            (m_mapTransactions.end() !=
+             m_mapTransactions.find(lTransactionNum)))
+            continue;
+
+        String strFolder1name, strFolder2name, strFolder3name, strReceipt;
+
+        if (!SetupBoxReceiptFilename(0, strNymID, strNotaryID, lTransactionNum,
+                                     __FUNCTION__, strFolder1name,
+                                     strFolder2name, strFolder3name,
+                                     strReceipt))
+            continue;
+
+        const std::string strContents(OTDB::QueryPlainString(
+            strFolder1name.Get(), strFolder2name.Get(), strFolder3name.Get(),
+            strReceipt.Get()));
+
+        std::unique_ptr<OTTransactionType> pTransType(
+            (strContents.length() < 2)
+                ? nullptr
+                : OTTransactionType::TransactionFactory(String(strContents)));
+        OTTransaction* pReceipt =
+            dynamic_cast<OTTransaction*>(pTransType.get());
+
+        if ((nullptr == pReceipt) ||
+            (pReceipt->GetTransactionNum() != lTransactionNum) ||
+            (pReceipt->GetPurportedAccountID() != GetRealAccountID()) ||
+            (pReceipt->GetPurportedNotaryID() != GetRealNotaryID())) {
+            otErr << "OTLedger::LoadNymboxJournal: Failed loading journaled "
+                     "box receipt: " << strFolder1name << Log::PathSeparator()
+                  << strFolder2name << Log::PathSeparator() << strFolder3name
+                  << Log::PathSeparator() << strReceipt << "\n";
+            continue;
+        }
+
+        pTransType.release();
+        AddTransaction(*pReceipt); // takes ownership.
+        m_setJournaled.insert(lTransactionNum);
+    }
+
+    if (!m_setJournaled.empty())
+        otInfo << "OTLedger::LoadNymboxJournal: Loaded "
+               << m_setJournaled.size() << " receipts from the journal.\n";
+
+    return true;
+}
+
+// The ledger's own signature only covers what it held when it was signed.
+// Receipts loaded from the journal were each signed when they were added.
+bool Ledger::VerifySignature(const Nym& theNym,
+                             const OTPasswordData* pPWData) const
+{
+    if (!ot_super::VerifySignature(theNym, pPWData)) return false;
+
+    for (auto& it : m_setJournaled) {
+        auto it_transaction = m_mapTransactions.find(it);
+
+        // (Unless it was removed since.)
+        if (m_mapTransactions.end() == it_transaction) continue;
+
+        OTTransaction* pTransaction = it_transaction->second;
+        OT_ASSERT(nullptr != pTransaction);
+
+        if (!pTransaction->VerifySignature(theNym, pPWData)) {
+            otErr << "OTLedger::VerifySignature: Failed verifying journaled "
+                     "receipt " << it << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // If you're going to save this, make sure you sign it first.
 bool Ledger::SaveInbox(Identifier* pInboxHash) // If you pass the
                                                // identifier in,
@@ -1065,6 +1297,73 @@ const mapOfTransactions& Ledger::GetTransactionMap() const
     return m_mapTransactions;
 }
 
+// All insertions into m_mapTransactions go through here, so the indexes stay
+// in sync with it.
+void Ledger::InsertTransaction(OTTransaction& theTransaction)
+{
+    // Replacing an existing entry: drop it from the indexes first.
+    auto it = m_mapTransactions.find(theTransaction.GetTransactionNum());
+    if (it != m_mapTransactions.end()) EraseTransaction(it);
+
+    m_mapTransactions[theTransaction.GetTransactionNum()] = &theTransaction;
+    m_mapTransactionsInRefTo.insert(std::pair<int64_t, OTTransaction*>(
+        theTransaction.GetReferenceToNum(), &theTransaction));
+    m_vecTransactionIndex.clear();
+    theTransaction.SetParent(*this); // for convenience
+    theTransaction.m_pIndexedBy = this;
+}
+
+void Ledger::EraseTransaction(mapOfTransactions::iterator it)
+{
+    OTTransaction* pTransaction = it->second;
+    OT_ASSERT(nullptr != pTransaction);
+
+    auto range =
+        m_mapTransactionsInRefTo.equal_range(pTransaction->GetReferenceToNum());
+    auto it_ref = std::find_if(
+        range.first, range.second,
+        [&](const std::pair<const int64_t, OTTransaction*>& entry) {
+            return entry.second == pTransaction;
+        });
+    OT_ASSERT(it_ref != range.second);
+
+    m_mapTransactionsInRefTo.erase(it_ref);
+    m_mapTransactions.erase(it);
+    m_vecTransactionIndex.clear();
+    pTransaction->m_pIndexedBy = nullptr;
+}
+
+// Called by OTTransaction::SetReferenceToNum, once the number has changed.
+void Ledger::ReindexReferenceTo(OTTransaction& theTransaction, int64_t lOldNum)
+{
+    auto range = m_mapTransactionsInRefTo.equal_range(lOldNum);
+    auto it_ref = std::find_if(
+        range.first, range.second,
+        [&](const std::pair<const int64_t, OTTransaction*>& entry) {
+            return entry.second == &theTransaction;
+        });
+    OT_ASSERT(it_ref != range.second);
+
+    m_mapTransactionsInRefTo.erase(it_ref);
+    m_mapTransactionsInRefTo.insert(std::pair<int64_t, OTTransaction*>(
+        theTransaction.GetReferenceToNum(), &theTransaction));
+}
+
+const std::vector<OTTransaction*>& Ledger::GetTransactionIndexVector() const
+{
+    if (m_vecTransactionIndex.size() != m_mapTransactions.size()) {
+        m_vecTransactionIndex.clear();
+        m_vecTransactionIndex.reserve(m_mapTransactions.size());
+
+        for (auto& it : m_mapTransactions) {
+            OT_ASSERT(nullptr != it.second);
+            m_vecTransactionIndex.push_back(it.second);
+        }
+    }
+
+    return m_vecTransactionIndex;
+}
+
 /// If transaction #87, in reference to #74, is in the inbox, you can remove it
 /// by calling this function and passing in 87. Deletes.
 ///
@@ -1084,7 +1383,7 @@ bool Ledger::RemoveTransaction(int64_t lTransactionNum, bool bDeleteIt)
     else {
         OTTransaction* pTransaction = it->second;
         OT_ASSERT(nullptr != pTransaction);
-        m_mapTransactions.erase(it);
+        EraseTransaction(it);
 
         if (bDeleteIt) {
             delete pTransaction;
@@ -1102,8 +1401,7 @@ bool Ledger::AddTransaction(OTTransaction& theTransaction)
 
     // If it's not already on the list, then add it...
     if (it == m_mapTransactions.end()) {
-        m_mapTransactions[theTransaction.GetTransactionNum()] = &theTransaction;
-        theTransaction.SetParent(*this); // for convenience
+        InsertTransaction(theTransaction);
         return true;
     }
     // Otherwise, if it was already there, log an error.
@@ -1132,39 +1430,38 @@ OTTransaction* Ledger::GetTransaction(OTTransaction::transactionType theType)
 // if not found, returns -1
 int32_t Ledger::GetTransactionIndex(int64_t lTransactionNum)
 {
-    // loop through the transactions inside this ledger
     // If a specific transaction is found, returns its index inside the ledger
     //
-    int32_t nIndex = -1;
-
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
-
-        ++nIndex; // 0 on first iteration.
-
-        if (pTransaction->GetTransactionNum() == lTransactionNum) {
-            return nIndex;
-        }
-    }
-    return -1;
+    if (m_mapTransactions.end() == m_mapTransactions.find(lTransactionNum))
+        return -1;
+
+    // The index is in transaction number order, same as the map.
+    const std::vector<OTTransaction*>& vecIndex = GetTransactionIndexVector();
+    auto it = std::lower_bound(
+        vecIndex.begin(), vecIndex.end(), lTransactionNum,
+        [](const OTTransaction* pTransaction, int64_t lNum) {
+            return pTransaction->GetTransactionNum() < lNum;
+        });
+
+    if ((it == vecIndex.end()) ||
+        ((*it)->GetTransactionNum() != lTransactionNum))
+        return -1;
+
+    return static_cast<int32_t>(it - vecIndex.begin());
 }
 
 // Look up a transaction by transaction number and see if it is in the ledger.
 // If it is, return a pointer to it, otherwise return nullptr.
 OTTransaction* Ledger::GetTransaction(int64_t lTransactionNum) const
 {
-    // loop through the transactions inside this ledger
+    auto it = m_mapTransactions.find(lTransactionNum);
 
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
+    if (it == m_mapTransactions.end()) return nullptr;
 
-        if (pTransaction->GetTransactionNum() == lTransactionNum) {
-            return pTransaction;
-        }
-    }
-    return nullptr;
+    OTTransaction* pTransaction = it->second;
+    OT_ASSERT(nullptr != pTransaction);
+
+    return pTransaction;
 }
 
 // Return a count of all the transactions in this ledger that are IN REFERENCE
@@ -1174,16 +1471,7 @@ OTTransaction* Ledger::GetTransaction(int64_t lTransactionNum) const
 //
 int32_t Ledger::GetTransactionCountInRefTo(int64_t lReferenceNum) const
 {
-    int32_t nCount = 0;
-
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
-
-        if (pTransaction->GetReferenceToNum() == lReferenceNum) nCount++;
-    }
-
-    return nCount;
+    return static_cast<int32_t>(m_mapTransactionsInRefTo.count(lReferenceNum));
 }
 
 // Look up a transaction by transaction number and see if it is in the ledger.
@@ -1193,20 +1481,7 @@ OTTransaction* Ledger::GetTransactionByIndex(int32_t nIndex) const
     // Out of bounds.
     if ((nIndex < 0) || (nIndex >= GetTransactionCount())) return nullptr;
 
-    int32_t nIndexCount = -1;
-
-    for (auto& it : m_mapTransactions) {
-        nIndexCount++; // On first iteration, this is now 0, same as nIndex.
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT((nullptr != pTransaction)); // Should always be good.
-
-        // If this transaction is the one at the requested index
-        if (nIndexCount == nIndex) return pTransaction;
-    }
-
-    return nullptr; // Should never reach this point, since bounds are checked
-                    // at
-                    // the top.
+    return GetTransactionIndexVector().at(static_cast<size_t>(nIndex));
 }
 
 // Nymbox-only.
@@ -1408,9 +1683,11 @@ OTTransaction* Ledger::GetChequeReceipt(int64_t lChequeNum,
 //
 OTTransaction* Ledger::GetFinalReceipt(int64_t lReferenceNum)
 {
-    // loop through the transactions that make up this ledger.
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
+    // loop through the transactions in reference to lReferenceNum.
+    auto range = m_mapTransactionsInRefTo.equal_range(lReferenceNum);
+
+    for (auto it = range.first; it != range.second; ++it) {
+        OTTransaction* pTransaction = it->second;
         OT_ASSERT(nullptr != pTransaction);
 
         if (OTTransaction::finalReceipt != pTransaction->GetType()) // <=======
@@ -1680,6 +1957,13 @@ bool Ledger::LoadLedgerFromString(const String& theStr)
 // SignContract will call this function at the right time.
 void Ledger::UpdateContents() // Before transmission or serialization, this is
                               // where the ledger saves its contents
+{
+    GenerateContents(m_xmlUnsigned);
+}
+
+// Writes the ledger's contents to strOutput. (False, and strOutput is left
+// alone, if the ledger is of an unexpected type.)
+bool Ledger::GenerateContents(String& strOutput)
 {
     switch (GetType()) {
     case Ledger::message:
@@ -1693,7 +1977,7 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
     default:
         otErr << "OTLedger::UpdateContents: Error: unexpected box type (1st "
                  "block). (This should never happen.)\n";
-        return;
+        return false;
     }
 
     // Abbreviated for all types but OTLedger::message.
@@ -1724,7 +2008,7 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
         strLedgerAcctNotaryID(GetPurportedNotaryID()), strNymID(GetNymID());
 
     // I release this because I'm about to repopulate it.
-    m_xmlUnsigned.Release();
+    strOutput.Release();
 
     Tag tag("accountLedger");
 
@@ -1794,7 +2078,9 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
     std::string str_result;
     tag.output(str_result);
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    strOutput.Concatenate("%s", str_result.c_str());
+
+    return true;
 }
 
 // LoadContract will call this function at the right time.
@@ -2070,9 +2356,7 @@ int32_t Ledger::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
                     if (pTransaction->VerifyContractID()) {
                         // Add it to the ledger...
                         //
-                        m_mapTransactions[pTransaction->GetTransactionNum()] =
-                            pTransaction;
-                        pTransaction->SetParent(*this);
+                        InsertTransaction(*pTransaction);
                         //                      otLog5 << "Loaded abbreviated
                         // transaction and adding to m_mapTransactions in
                         // OTLedger\n");
@@ -2239,9 +2523,7 @@ int32_t Ledger::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
                 // (Below this point, no need to delete pTransaction upon
                 // returning.)
                 //
-                m_mapTransactions[pTransaction->GetTransactionNum()] =
-                    pTransaction;
-                pTransaction->SetParent(*this);
+                InsertTransaction(*pTransaction);
                 //                otLog5 << "Loaded full transaction and adding
                 // to m_mapTransactions in OTLedger\n");
 
@@ -2338,6 +2620,10 @@ void Ledger::ReleaseTransactions()
         delete pTransaction;
         pTransaction = nullptr;
     }
+    m_mapTransactionsInRefTo.clear();
+    m_vecTransactionIndex.clear();
+    m_setJournaled.clear();
+    m_JournalBase.Release();
 }
 
 void Ledger::Release_Ledger()
@@ -43,8 +43,13 @@
 #include <opentxs/core/util/stacktrace.h>
 #include <opentxs/core/Version.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #ifndef _WIN32
 #include <cerrno>
@@ -70,6 +75,9 @@
 #endif
 
 #define LOG_DEQUE_SIZE 1024
+#define LOG_RING_SIZE 8192      // lines; must be a power of two.
+#define LOG_WRITER_WAKE_MS 100  // writer wakes up at least this often.
+#define LOG_FLUSH_TIMEOUT_MS 2000
 
 extern "C" {
 
@@ -132,6 +140,227 @@ struct sigcontext
 namespace opentxs
 {
 
+// The background log writer.
+//
+// Any thread can push a line into a bounded ring buffer without taking a
+// lock (Vyukov's bounded queue.) A single writer thread drains the ring in
+// batches and writes each batch to stderr and to the log file, which stays
+// open, with one flush per batch. When the ring is full, ordinary output is
+// dropped rather than blocking the caller, and the writer reports how many
+// lines were dropped. Errors wait for room instead.
+//
+class LogWriter
+{
+public:
+    LogWriter()
+        : m_vecRing(LOG_RING_SIZE)
+        , m_nEnqueuePos(0)
+        , m_nDequeuePos(0)
+        , m_nWritten(0)
+        , m_nDropped(0)
+        , m_bStop(false)
+    {
+        for (size_t i = 0; i < LOG_RING_SIZE; ++i)
+            m_vecRing[i].nSequence.store(i, std::memory_order_relaxed);
+
+        m_Thread = std::thread(&LogWriter::Run, this);
+    }
+
+    ~LogWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_bStop = true;
+        }
+        m_Wake.notify_one();
+        m_Thread.join();
+    }
+
+    bool Push(const char* szOutput, bool bMayDrop)
+    {
+        uint64_t nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+        Cell* pCell = nullptr;
+
+        for (;;) {
+            pCell = &m_vecRing[nPos & (LOG_RING_SIZE - 1)];
+            const uint64_t nSequence =
+                pCell->nSequence.load(std::memory_order_acquire);
+            const int64_t lDiff =
+                static_cast<int64_t>(nSequence) - static_cast<int64_t>(nPos);
+
+            if (0 == lDiff) {
+                if (m_nEnqueuePos.compare_exchange_weak(
+                        nPos, nPos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (lDiff < 0) { // full
+                if (bMayDrop) {
+                    m_nDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                WaitForRoom();
+                nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+            }
+            else
+                nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+        }
+
+        pCell->strLine = szOutput;
+        pCell->nSequence.store(nPos + 1, std::memory_order_release);
+
+        m_Wake.notify_one();
+        return true;
+    }
+
+    bool Flush()
+    {
+        const uint64_t nTarget = m_nEnqueuePos.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        m_Wake.notify_one();
+
+        return m_Written.wait_for(
+            lock, std::chrono::milliseconds(LOG_FLUSH_TIMEOUT_MS), [&] {
+                return m_nWritten.load(std::memory_order_acquire) >= nTarget;
+            });
+    }
+
+    void SetLogFilePath(const std::string& strPath)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_strPath = strPath;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint64_t> nSequence;
+        std::string strLine;
+    };
+
+    std::vector<Cell> m_vecRing;
+    std::atomic<uint64_t> m_nEnqueuePos;
+    uint64_t m_nDequeuePos; // only touched by the writer thread.
+    std::atomic<uint64_t> m_nWritten;
+    std::atomic<uint64_t> m_nDropped;
+
+    std::mutex m_Mutex; // for the members below, and for waiting.
+    std::condition_variable m_Wake;
+    std::condition_variable m_Written;
+    std::string m_strPath;
+    bool m_bStop;
+    std::thread m_Thread;
+
+    // Wakes the writer and waits until it has written a batch (or for a
+    // little while, in case the batch was written before we started waiting.)
+    void WaitForRoom()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        m_Wake.notify_one();
+        m_Written.wait_for(lock, std::chrono::milliseconds(LOG_WRITER_WAKE_MS));
+    }
+
+    bool Pop(std::string& strLine)
+    {
+        Cell& theCell = m_vecRing[m_nDequeuePos & (LOG_RING_SIZE - 1)];
+
+        if (theCell.nSequence.load(std::memory_order_acquire) !=
+            m_nDequeuePos + 1)
+            return false;
+
+        strLine.swap(theCell.strLine);
+        theCell.nSequence.store(m_nDequeuePos + LOG_RING_SIZE,
+                                std::memory_order_release);
+        ++m_nDequeuePos;
+        return true;
+    }
+
+    void Run()
+    {
+        std::ofstream logfile;
+        std::string strOpenPath;
+        std::string strBatch;
+        std::string strLine;
+        bool bStop = false;
+
+        while (!bStop) {
+            std::string strPath;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+
+                m_Wake.wait_for(lock,
+                                std::chrono::milliseconds(LOG_WRITER_WAKE_MS));
+                bStop = m_bStop;
+                strPath = m_strPath;
+            }
+
+            const uint64_t nDropped =
+                m_nDropped.exchange(0, std::memory_order_relaxed);
+
+            if (0 < nDropped)
+                strBatch += "(Log: dropped " + std::to_string(nDropped) +
+                            " lines, writer fell behind.)\n";
+
+            uint64_t nCount = 0;
+
+            while (Pop(strLine)) {
+                strBatch += strLine;
+                ++nCount;
+            }
+
+            if (strPath != strOpenPath) {
+                if (logfile.is_open()) logfile.close();
+
+                strOpenPath = strPath;
+
+                if (!strOpenPath.empty())
+                    logfile.open(strOpenPath.c_str(), std::ios::app);
+            }
+
+            if (!strBatch.empty()) {
+                std::cerr << strBatch;
+                std::cerr.flush();
+
+                if (logfile.is_open()) {
+                    logfile << strBatch;
+                    logfile.flush();
+                }
+
+                strBatch.clear();
+            }
+
+            if (0 < nCount) {
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    m_nWritten.fetch_add(nCount, std::memory_order_release);
+                }
+                m_Written.notify_all();
+            }
+        }
+    }
+};
+
+// Created on first use, and never destroyed before the end of the program.
+//
+static std::atomic<bool> s_bLogWriterGone(false);
+
+static LogWriter* GetLogWriter()
+{
+    static struct Holder
+    {
+        LogWriter theWriter;
+
+        ~Holder()
+        {
+            s_bLogWriterGone = true;
+        }
+    } s_theHolder;
+
+    return s_bLogWriterGone ? nullptr : &s_theHolder.theWriter;
+}
+
 Log* Log::pLogger = nullptr;
 
 const String Log::m_strVersion = OPENTXS_VERSION_STRING;
@@ -151,6 +380,8 @@ OTLogStream::OTLogStream(int _logLevel)
     , next(0)
     , pBuffer(new char[1024])
 {
+    // Log::LogLevel() is 0 until the logger is initialized.
+    if (logLevel > 0) setstate(std::ios::badbit);
 }
 
 OTLogStream::~OTLogStream()
@@ -238,6 +469,13 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
 
         pLogger->m_bInitialized = true;
 
+        LogWriter* pWriter = GetLogWriter();
+
+        if (nullptr != pWriter)
+            pWriter->SetLogFilePath(pLogger->m_strLogFilePath.Get());
+
+        FilterStreams();
+
         // Set the new log-assert function pointer.
         Assert* pLogAssert = new Assert(Log::logAssert);
         std::swap(pLogAssert, Assert::s_pAssert);
@@ -261,6 +499,13 @@ bool Log::IsInitialized()
 bool Log::Cleanup()
 {
     if (nullptr != pLogger) {
+        LogWriter* pWriter = GetLogWriter();
+
+        if (nullptr != pWriter) {
+            pWriter->Flush();
+            pWriter->SetLogFilePath("");
+        }
+
         delete pLogger;
         pLogger = nullptr;
         return true;
@@ -331,6 +576,7 @@ bool Log::SetLogLevel(const int32_t& nLogLevel)
     }
     else {
         pLogger->m_nLogLevel = nLogLevel;
+        FilterStreams();
         return true;
     }
 }
@@ -343,40 +589,44 @@ bool Log::SetLogLevel(const int32_t& nLogLevel)
 // if I was actually writing to stdout.)
 //
 // static
-bool Log::LogToFile(const String& strOutput)
+bool Log::LogToFile(const String& strOutput, bool bMayDrop)
 {
-    // We now do this either way.
-    {
-        std::cerr << strOutput;
-        std::cerr.flush();
-    }
+    if (!strOutput.Exists()) return false;
 
-    // now log to file, if we can.
+    // Before Init (or after Cleanup) there's no log file, and it goes
+    // straight to stderr, as it always did.
+    LogWriter* pWriter = IsInitialized() ? GetLogWriter() : nullptr;
 
-    bool bHaveLogger(false);
-    if (nullptr != pLogger)
-        if (pLogger->IsInitialized()) bHaveLogger = true;
+    if (nullptr != pWriter) return pWriter->Push(strOutput.Get(), bMayDrop);
 
-    // lets check if we are Initialized in this context
-    if (bHaveLogger) CheckLogger(Log::pLogger);
+    // No logger, or the writer is already gone (static destruction.)
+    std::cerr << strOutput;
+    std::cerr.flush();
 
-    bool bSuccess = false;
+    return true;
+}
 
-    if (bHaveLogger) {
-        // Append to logfile
-        if ((strOutput.Exists()) && (Log::pLogger->m_strLogFilePath.Exists())) {
-            std::ofstream logfile;
-            logfile.open(Log::LogFilePath(), std::ios::app);
+// static
+void Log::FilterStreams()
+{
+    OTLogStream* streams[] = {&otOut, &otWarn, &otInfo,
+                              &otLog3, &otLog4, &otLog5};
+    const int32_t levels[] = {0, 1, 2, 3, 4, 5};
 
-            if (!logfile.fail()) {
-                logfile << strOutput;
-                logfile.close();
-                bSuccess = true;
-            }
-        }
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); ++i) {
+        if ((levels[i] > LogLevel()) || (LogLevel() == (-1)))
+            streams[i]->setstate(std::ios::badbit);
+        else
+            streams[i]->clear();
     }
+}
+
+// static
+bool Log::Flush()
+{
+    LogWriter* pWriter = GetLogWriter();
 
-    return bSuccess;
+    return (nullptr == pWriter) || pWriter->Flush();
 }
 
 String Log::GetMemlogAtIndex(int32_t nIndex)
@@ -536,6 +786,7 @@ size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
                             szMessage);
 #endif
 
+        Flush(); // the program is probably about to end.
         print_stacktrace();
     }
 
@@ -558,6 +809,7 @@ size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
 #endif
     }
 
+    Flush();
     print_stacktrace();
 
     return 1; // normal
@@ -587,7 +839,7 @@ void Log::Output(int32_t nVerbosity, const char* szOutput)
 
 #ifndef ANDROID // if NOT android
 
-    LogToFile(szOutput);
+    LogToFile(szOutput, true);
 
 #else // if IS Android
     /*
@@ -633,10 +885,11 @@ void Log::vOutput(int32_t nVerbosity, const char* szOutput, ...)
     // lets check if we are Initialized in this context
     if (bHaveLogger) CheckLogger(Log::pLogger);
 
+    if (nullptr == szOutput) return;
+
     // If log level is 0, and verbosity of this message is 2, don't bother
-    // logging it.
-    if (((0 != LogLevel()) && (nVerbosity > LogLevel())) ||
-        (nullptr == szOutput))
+    // logging it. (Or even formatting it.) Before Init, Output decides.
+    if (bHaveLogger && ((nVerbosity > LogLevel()) || (LogLevel() == (-1))))
         return;
 
     va_list args;
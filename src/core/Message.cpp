@@ -177,17 +177,17 @@ void Message::SetAcknowledgments(Nym& theNym)
 
     for (auto& it : theNym.GetMapAcknowledgedNum()) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
+        setOfTransNums* pSet = it.second;
+        OT_ASSERT(nullptr != pSet);
 
         String OTstrNotaryID = strNotaryID.c_str();
         const Identifier theTempID(OTstrNotaryID);
 
-        if (!(pDeque->empty()) &&
+        if (!(pSet->empty()) &&
             (theNotaryID == theTempID)) // only for the matching notaryID.
         {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                const int64_t lAckRequestNumber = pDeque->at(i);
+            for (const int64_t& lNum : *pSet) {
+                const int64_t lAckRequestNumber = lNum;
 
                 m_AcknowledgedReplies.Add(lAckRequestNumber);
             }
@@ -56,13 +56,25 @@
 
 #include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <memory>
+#include <mutex>
 
 // static
 
 namespace opentxs
 {
 
+namespace
+{
+
+// See Nym::GetCredentialGeneration.
+std::mutex s_lockCredentialGenerations;
+std::map<std::string, uint64_t> s_mapCredentialGenerations;
+uint64_t s_nCredentialGeneration = 0;
+
+} // namespace
+
 Nym* Nym::LoadPublicNym(const Identifier& NYM_ID, const String* pstrName,
                         const char* szFuncName)
 {
@@ -1431,15 +1443,15 @@ bool Nym::SetIdentifierByPubkey()
 // If an ID is passed in, that means remove all numbers FOR THAT SERVER ID.
 // If passed in, and current map doesn't match, then skip it (continue).
 
-#ifndef CLEAR_MAP_AND_DEQUE
-#define CLEAR_MAP_AND_DEQUE(the_map)                                           \
+#ifndef CLEAR_MAP_AND_SET
+#define CLEAR_MAP_AND_SET(the_map)                                             \
     for (auto& it : the_map) {                                                 \
         if ((nullptr != pstrNotaryID) && (str_NotaryID != it.first)) continue; \
-        dequeOfTransNums* pDeque = (it.second);                                \
-        OT_ASSERT(nullptr != pDeque);                                          \
-        if (!(pDeque->empty())) pDeque->clear();                               \
+        setOfTransNums* pSet = (it.second);                                    \
+        OT_ASSERT(nullptr != pSet);                                            \
+        if (!(pSet->empty())) pSet->clear();                                   \
     }
-#endif // CLEAR_MAP_AND_DEQUE
+#endif // CLEAR_MAP_AND_SET
 
 // Sometimes for testing I need to clear out all the transaction numbers from a
 // nym.
@@ -1455,10 +1467,10 @@ void Nym::RemoveAllNumbers(const String* pstrNotaryID,
 
     // These use str_NotaryID (above)
     //
-    CLEAR_MAP_AND_DEQUE(m_mapIssuedNum)
-    CLEAR_MAP_AND_DEQUE(m_mapTransNum)
-    CLEAR_MAP_AND_DEQUE(m_mapTentativeNum)
-    CLEAR_MAP_AND_DEQUE(m_mapAcknowledgedNum)
+    CLEAR_MAP_AND_SET(m_mapIssuedNum)
+    CLEAR_MAP_AND_SET(m_mapTransNum)
+    CLEAR_MAP_AND_SET(m_mapTentativeNum)
+    CLEAR_MAP_AND_SET(m_mapAcknowledgedNum)
 
     std::list<mapOfHighestNums::iterator> listOfHighestNums;
     std::list<mapOfIdentifiers::iterator> listOfNymboxHash;
@@ -1742,23 +1754,23 @@ bool Nym::UnRegisterAtServer(const String& strNotaryID)
     return bRetVal;
 }
 
-#ifndef WIPE_MAP_AND_DEQUE
-#define WIPE_MAP_AND_DEQUE(the_map)                                            \
+#ifndef WIPE_MAP_AND_SET
+#define WIPE_MAP_AND_SET(the_map)                                              \
     while (!the_map.empty()) {                                                 \
-        dequeOfTransNums* pDeque = the_map.begin()->second;                    \
-        OT_ASSERT(nullptr != pDeque);                                          \
+        setOfTransNums* pSet = the_map.begin()->second;                        \
+        OT_ASSERT(nullptr != pSet);                                            \
         the_map.erase(the_map.begin());                                        \
-        delete pDeque;                                                         \
-        pDeque = nullptr;                                                      \
+        delete pSet;                                                           \
+        pSet = nullptr;                                                        \
     }
-#endif // WIPE_MAP_AND_DEQUE
+#endif // WIPE_MAP_AND_SET
 
 void Nym::ReleaseTransactionNumbers()
 {
-    WIPE_MAP_AND_DEQUE(m_mapTransNum)
-    WIPE_MAP_AND_DEQUE(m_mapIssuedNum)
-    WIPE_MAP_AND_DEQUE(m_mapTentativeNum)
-    WIPE_MAP_AND_DEQUE(m_mapAcknowledgedNum)
+    WIPE_MAP_AND_SET(m_mapTransNum)
+    WIPE_MAP_AND_SET(m_mapIssuedNum)
+    WIPE_MAP_AND_SET(m_mapTentativeNum)
+    WIPE_MAP_AND_SET(m_mapAcknowledgedNum)
 }
 
 /*
@@ -1858,10 +1870,10 @@ for this Nym. Infinite if negative.
 
 
 
- CLEAR_MAP_AND_DEQUE(m_mapIssuedNum)
- CLEAR_MAP_AND_DEQUE(m_mapTransNum)
- CLEAR_MAP_AND_DEQUE(m_mapTentativeNum)
- CLEAR_MAP_AND_DEQUE(m_mapAcknowledgedNum)
+ CLEAR_MAP_AND_SET(m_mapIssuedNum)
+ CLEAR_MAP_AND_SET(m_mapTransNum)
+ CLEAR_MAP_AND_SET(m_mapTentativeNum)
+ CLEAR_MAP_AND_SET(m_mapAcknowledgedNum)
 
  m_mapHighTransNo.erase(listOfHighestNums.back());
  m_mapNymboxHash.erase(listOfNymboxHash.back());
@@ -1895,11 +1907,6 @@ bool Nym::ResyncWithServer(const Ledger& theNymbox, const Nym& theMessageNym)
     const String strNotaryID(theNotaryID);
     const String strNymID(m_nymID);
 
-    const int32_t nIssuedNumCount =
-        theMessageNym.GetIssuedNumCount(theNotaryID);
-    const int32_t nTransNumCount =
-        theMessageNym.GetTransactionNumCount(theNotaryID);
-
     // Remove all issued, transaction, and tentative numbers for a specific
     // server ID,
     // as well as all acknowledgedNums, and the highest transaction number for
@@ -1927,8 +1934,7 @@ bool Nym::ResyncWithServer(const Ledger& theNymbox, const Nym& theMessageNym)
     //
     // Copy the issued and transaction numbers from theMessageNym onto *this.
     //
-    for (int32_t n1 = 0; n1 < nIssuedNumCount; ++n1) {
-        const int64_t lNum = theMessageNym.GetIssuedNum(theNotaryID, n1);
+    for (const int64_t& lNum : theMessageNym.GetIssuedNums(theNotaryID)) {
 
         if (!AddIssuedNum(strNotaryID, lNum)) // Add to list of
                                               // numbers that
@@ -1949,8 +1955,7 @@ bool Nym::ResyncWithServer(const Ledger& theNymbox, const Nym& theMessageNym)
         }
     }
 
-    for (int32_t n2 = 0; n2 < nTransNumCount; ++n2) {
-        const int64_t lNum = theMessageNym.GetTransactionNum(theNotaryID, n2);
+    for (const int64_t& lNum : theMessageNym.GetTransactionNums(theNotaryID)) {
 
         if (!AddTransactionNum(strNotaryID, lNum)) // Add to list of
                                                    // available-to-use
@@ -2058,8 +2063,8 @@ bool Nym::ResyncWithServer(const Ledger& theNymbox, const Nym& theMessageNym)
 }
 
 /*
-typedef std::deque<int64_t>                            dequeOfTransNums;
-typedef std::map<std::string, dequeOfTransNums *>    mapOfTransNums;
+typedef std::set<int64_t>                          setOfTransNums;
+typedef std::map<std::string, setOfTransNums *>    mapOfTransNums;
 */
 
 // Verify whether a certain transaction number appears on a certain list.
@@ -2070,32 +2075,20 @@ bool Nym::VerifyGenericNum(const mapOfTransNums& THE_MAP,
 {
     std::string strID = strNotaryID.Get();
 
-    // The Pseudonym has a deque of transaction numbers for each servers.
-    // These deques are mapped by Notary ID.
+    // The Pseudonym has a set of transaction numbers for each server.
+    // These sets are mapped by Notary ID.
     //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then find the transaction
-    // number on
-    // that list, and then return true. Else return false.
+    // So look up the set for the Notary ID that was passed in, then find the
+    // transaction number on that set, and return true. Else return false.
     //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
+    auto it = THE_MAP.find(strID);
 
-            if (!(pDeque->empty())) // there are some numbers for that server ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (lTransNum == pDeque->at(i)) {
-                        return true;
-                    }
-                }
-            }
-            break;
+    if (THE_MAP.end() != it) {
+        setOfTransNums* pSet = (it->second);
+        OT_ASSERT(nullptr != pSet);
+
+        if (pSet->find(lTransNum) != pSet->end()) {
+            return true;
         }
     }
 
@@ -2124,42 +2117,16 @@ bool Nym::RemoveGenericNum(mapOfTransNums& THE_MAP, Nym& SIGNER_NYM,
 bool Nym::RemoveGenericNum(mapOfTransNums& THE_MAP, const String& strNotaryID,
                            const int64_t& lTransNum)
 {
-    bool bRetVal = false;
-    std::string strID = strNotaryID.Get();
+    // The Pseudonym has a set of transaction numbers for each server, mapped
+    // by Notary ID.
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    // The Pseudonym has a deque of transaction numbers for each servers.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then find the transaction
-    // number on
-    // that list, and then remove it, and return true. Else return false.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
+    if (THE_MAP.end() == it) return false;
 
-            OT_ASSERT(nullptr != pDeque);
+    setOfTransNums* pSet = it->second;
+    OT_ASSERT(nullptr != pSet);
 
-            if (!(pDeque->empty())) // there are some numbers for that server ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (lTransNum == pDeque->at(i)) {
-                        pDeque->erase(pDeque->begin() + i);
-                        bRetVal = true;
-                        break;
-                    }
-                }
-            }
-            break;
-        }
-    }
-
-    return bRetVal;
+    return pSet->erase(lTransNum) > 0; // Found it!
 }
 
 // No signer needed for this one, and save is false.
@@ -2167,50 +2134,15 @@ bool Nym::RemoveGenericNum(mapOfTransNums& THE_MAP, const String& strNotaryID,
 bool Nym::AddGenericNum(mapOfTransNums& THE_MAP, const String& strNotaryID,
                         int64_t lTransNum)
 {
-    bool bSuccessFindingNotaryID = false, bSuccess = false;
-    std::string strID = strNotaryID.Get();
-
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then add the transaction
-    // number.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            auto iter = std::find(pDeque->begin(), pDeque->end(), lTransNum);
-
-            if (iter == pDeque->end()) // Only add it if it's not already there.
-                                       // No duplicates!
-                pDeque->push_front(lTransNum);
-
-            bSuccess = true;
-            bSuccessFindingNotaryID = true;
-
-            break;
-        }
-    }
+    setOfTransNums*& pSet = THE_MAP[strNotaryID.Get()];
 
-    // Apparently there is not yet a deque stored for this specific notaryID.
-    // Fine. Let's create it then, and then add the transaction num to that new
-    // deque.
-    if (!bSuccessFindingNotaryID) {
-        dequeOfTransNums* pDeque = new dequeOfTransNums;
+    // Apparently there is not yet a set stored for this specific notaryID.
+    // Fine. Let's create it then.
+    if (nullptr == pSet) pSet = new setOfTransNums;
 
-        OT_ASSERT(nullptr != pDeque);
-
-        THE_MAP[strID] = pDeque;
-        pDeque->push_front(lTransNum);
-        bSuccess = true;
-    }
+    pSet->insert(lTransNum); // The set already refuses duplicates.
 
-    return bSuccess;
+    return true;
 }
 
 // Returns count of transaction numbers available for a given server.
@@ -2223,7 +2155,7 @@ int32_t Nym::GetGenericNumCount(const mapOfTransNums& THE_MAP,
     const String strNotaryID(theNotaryID);
     std::string strID = strNotaryID.Get();
 
-    dequeOfTransNums* pDeque = nullptr;
+    setOfTransNums* pSet = nullptr;
 
     // The Pseudonym has a deque of transaction numbers for each server.
     // These deques are mapped by Notary ID.
@@ -2234,8 +2166,8 @@ int32_t Nym::GetGenericNumCount(const mapOfTransNums& THE_MAP,
     for (auto& it : THE_MAP) {
         // if the NotaryID passed in matches the notaryID for the current deque
         if (strID == it.first) {
-            pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
+            pSet = (it.second);
+            OT_ASSERT(nullptr != pSet);
 
             break;
         }
@@ -2243,51 +2175,41 @@ int32_t Nym::GetGenericNumCount(const mapOfTransNums& THE_MAP,
 
     // We found the right server, so let's count the transaction numbers
     // that this nym has already stored for it.
-    if (nullptr != pDeque) {
-        nReturnValue = static_cast<int32_t>(pDeque->size());
+    if (nullptr != pSet) {
+        nReturnValue = static_cast<int32_t>(pSet->size());
     }
 
     return nReturnValue;
 }
 
 // by index.
+//
+// The numbers are kept in a set, so this walks it to nIndex. Looping over
+// every index is quadratic: use GetGenericNums for that.
 int64_t Nym::GetGenericNum(const mapOfTransNums& THE_MAP,
                            const Identifier& theNotaryID, int32_t nIndex) const
 {
-    int64_t lRetVal = 0;
+    const setOfTransNums& theSet = GetGenericNums(THE_MAP, theNotaryID);
+
+    if ((nIndex >= 0) && (static_cast<uint32_t>(nIndex) < theSet.size()))
+        return *std::next(theSet.begin(), nIndex); // <==== Got the number here.
+
+    return 0;
+}
+
+const setOfTransNums& Nym::GetGenericNums(const mapOfTransNums& THE_MAP,
+                                          const Identifier& theNotaryID) const
+{
+    static const setOfTransNums theEmptySet;
 
     const String strNotaryID(theNotaryID);
-    std::string strID = strNotaryID.Get();
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    // The Pseudonym has a deque of numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // maps matches the Notary ID that was passed in, then find the number on
-    // that list, and then return it.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
+    if (THE_MAP.end() == it) return theEmptySet;
 
-            if (!(pDeque->empty())) // there are some numbers for that server ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (static_cast<uint32_t>(nIndex) == i) {
-                        lRetVal = pDeque->at(i); // <==== Got the number here.
-                        break;
-                    }
-                }
-            }
-            break;
-        }
-    }
+    OT_ASSERT(nullptr != it->second);
 
-    return lRetVal;
+    return *it->second;
 }
 
 // by index.
@@ -2310,6 +2232,23 @@ int64_t Nym::GetAcknowledgedNum(const Identifier& theNotaryID,
     return GetGenericNum(m_mapAcknowledgedNum, theNotaryID, nIndex);
 }
 
+const setOfTransNums& Nym::GetIssuedNums(const Identifier& theNotaryID) const
+{
+    return GetGenericNums(m_mapIssuedNum, theNotaryID);
+}
+
+const setOfTransNums& Nym::GetTransactionNums(
+    const Identifier& theNotaryID) const
+{
+    return GetGenericNums(m_mapTransNum, theNotaryID);
+}
+
+const setOfTransNums& Nym::GetAcknowledgedNums(
+    const Identifier& theNotaryID) const
+{
+    return GetGenericNums(m_mapAcknowledgedNum, theNotaryID);
+}
+
 // TRANSACTION NUM
 
 // On the server side: A user has submitted a specific transaction number.
@@ -2482,42 +2421,21 @@ bool Nym::AddAcknowledgedNum(const String& strNotaryID,
                                                          // save.
 {
     // We're going to call AddGenericNum, but first, let's enforce a cap on the
-    // total
-    // number of ackNums allowed...
-    //
-    std::string strID = strNotaryID.Get();
+    // total number of ackNums allowed for this server. The oldest go first.
+    // (This fixes knotwork's issue where he had thousands of ack nums somehow
+    // never getting cleared out.)
+    auto it = m_mapAcknowledgedNum.find(strNotaryID.Get());
 
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then we'll pop the size of the
-    // deque
-    // down to our max size (off the back) before then calling AddGenericNum
-    // which will
-    // push the new request number onto the front.
-    //
-    for (auto& it : m_mapAcknowledgedNum) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            while (pDeque->size() > OT_MAX_ACK_NUMS) {
-                pDeque->pop_back(); // This fixes knotwork's issue where he had
-                                    // thousands of ack nums somehow never
-                                    // getting cleared out. Now we have a MAX
-                                    // and always keep it clean otherwise.
-            }
-            break;
-        }
+    if (m_mapAcknowledgedNum.end() != it) {
+        setOfTransNums* pSet = it->second;
+        OT_ASSERT(nullptr != pSet);
+
+        while (pSet->size() > OT_MAX_ACK_NUMS) pSet->erase(pSet->begin());
     }
 
-    return AddGenericNum(m_mapAcknowledgedNum, strNotaryID,
-                         lRequestNum); // <=== Here we finally add the new
-                                       // request number, the actual purpose of
-                                       // this function.
+    // Here we finally add the new request number, the actual purpose of this
+    // function.
+    return AddGenericNum(m_mapAcknowledgedNum, strNotaryID, lRequestNum);
 }
 
 // HIGHER LEVEL...
@@ -2643,18 +2561,18 @@ void Nym::HarvestTransactionNumbers(const Identifier& theNotaryID,
 
     for (auto& it : theOtherNym.GetMapIssuedNum()) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
         String OTstrNotaryID = strNotaryID.c_str();
         const Identifier theTempID(OTstrNotaryID);
 
-        if (!(pDeque->empty()) &&
+        if (!(pSet->empty()) &&
             (theNotaryID == theTempID)) // only for the matching notaryID.
         {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+            for (const int64_t& lNum : *pSet) {
+                lTransactionNumber = lNum;
 
                 // If number wasn't already on issued list, then add to BOTH
                 // lists.
@@ -2775,17 +2693,17 @@ void Nym::HarvestIssuedNumbers(const Identifier& theNotaryID, Nym& SIGNER_NYM,
 
     for (auto& it : theOtherNym.GetMapIssuedNum()) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
         String OTstrNotaryID =
             ((strNotaryID.size()) > 0 ? strNotaryID.c_str() : "");
         const Identifier theTempID(OTstrNotaryID);
 
-        if (!(pDeque->empty()) && (theNotaryID == theTempID)) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+        if (!(pSet->empty()) && (theNotaryID == theTempID)) {
+            for (const int64_t& lNum : *pSet) {
+                lTransactionNumber = lNum;
 
                 // If number wasn't already on issued list, then add to BOTH
                 // lists.
@@ -2863,13 +2781,14 @@ bool Nym::GetNextTransactionNum(Nym& SIGNER_NYM, const String& strNotaryID,
     for (auto& it : m_mapTransNum) {
         // if the NotaryID passed in matches the notaryID for the current deque
         if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
+            setOfTransNums* pSet = (it.second);
+            OT_ASSERT(nullptr != pSet);
 
-            if (!(pDeque->empty())) {
-                lTransNum = pDeque->back();
+            if (!(pSet->empty())) {
+                // Lowest (i.e. oldest) number goes out first.
+                lTransNum = *(pSet->begin());
 
-                pDeque->pop_back();
+                pSet->erase(pSet->begin());
 
                 // The call has succeeded
                 bRetVal = true;
@@ -3642,20 +3561,21 @@ void Nym::DisplayStatistics(String& strOutput)
 
     for (auto& it : m_mapIssuedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
-        if (!(pDeque->empty())) {
+        if (!(pSet->empty())) {
             strOutput.Concatenate(
                 "---- Transaction numbers still signed out from server: %s\n",
                 strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lTransactionNumber = pDeque->at(i);
+            for (const int64_t& lNum : *pSet) {
+                int64_t lTransactionNumber = lNum;
 
-                strOutput.Concatenate(0 == i ? "%" PRId64 : ", %" PRId64,
-                                      lTransactionNumber);
+                strOutput.Concatenate(
+                    (lNum == *(pSet->begin())) ? "%" PRId64 : ", %" PRId64,
+                    lTransactionNumber);
             }
             strOutput.Concatenate("\n");
         }
@@ -3663,19 +3583,20 @@ void Nym::DisplayStatistics(String& strOutput)
 
     for (auto& it : m_mapTransNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
-        if (!(pDeque->empty())) {
+        if (!(pSet->empty())) {
             strOutput.Concatenate(
                 "---- Transaction numbers still usable on server: %s\n",
                 strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lTransactionNumber = pDeque->at(i);
-                strOutput.Concatenate(0 == i ? "%" PRId64 : ", %" PRId64,
-                                      lTransactionNumber);
+            for (const int64_t& lNum : *pSet) {
+                int64_t lTransactionNumber = lNum;
+                strOutput.Concatenate(
+                    (lNum == *(pSet->begin())) ? "%" PRId64 : ", %" PRId64,
+                    lTransactionNumber);
             }
             strOutput.Concatenate("\n");
         }
@@ -3683,19 +3604,20 @@ void Nym::DisplayStatistics(String& strOutput)
 
     for (auto& it : m_mapAcknowledgedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
-        if (!(pDeque->empty())) {
+        if (!(pSet->empty())) {
             strOutput.Concatenate("---- Request numbers for which Nym has "
                                   "already received a reply from server: %s\n",
                                   strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lRequestNumber = pDeque->at(i);
-                strOutput.Concatenate(0 == i ? "%" PRId64 : ", %" PRId64,
-                                      lRequestNumber);
+            for (const int64_t& lNum : *pSet) {
+                int64_t lRequestNumber = lNum;
+                strOutput.Concatenate(
+                    (lNum == *(pSet->begin())) ? "%" PRId64 : ", %" PRId64,
+                    lRequestNumber);
             }
             strOutput.Concatenate("\n");
         }
@@ -3934,6 +3856,24 @@ void Nym::SaveCredentialIDsToString(String& strOutput)
     strOutput.Concatenate("%s", str_result.c_str());
 }
 
+// static
+uint64_t Nym::GetCredentialGeneration(const String& strNymID)
+{
+    std::lock_guard<std::mutex> lock(s_lockCredentialGenerations);
+
+    auto it = s_mapCredentialGenerations.find(strNymID.Get());
+
+    return (s_mapCredentialGenerations.end() == it) ? 0 : it->second;
+}
+
+// static
+void Nym::CredentialsChanged(const String& strNymID)
+{
+    std::lock_guard<std::mutex> lock(s_lockCredentialGenerations);
+
+    s_mapCredentialGenerations[strNymID.Get()] = ++s_nCredentialGeneration;
+}
+
 bool Nym::SaveCredentialIDs()
 {
     String strNymID, strOutput;
@@ -3964,6 +3904,8 @@ bool Nym::SaveCredentialIDs()
                 return false;
             }
 
+            CredentialsChanged(strNymID);
+
             return true;
         }
     }
@@ -4147,15 +4089,15 @@ bool Nym::SavePseudonym(String& strNym)
 
     for (auto& it : m_mapTransNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!(pSet->empty()) && (strNotaryID.size() > 0)) {
             NumList theList;
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+            for (const int64_t& lNum : *pSet) {
+                lTransactionNumber = lNum;
                 theList.Add(lTransactionNumber);
             }
             String strTemp;
@@ -4176,15 +4118,15 @@ bool Nym::SavePseudonym(String& strNym)
 
     for (auto& it : m_mapIssuedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!(pSet->empty()) && (strNotaryID.size() > 0)) {
             NumList theList;
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+            for (const int64_t& lNum : *pSet) {
+                lTransactionNumber = lNum;
                 theList.Add(lTransactionNumber);
             }
             String strTemp;
@@ -4205,15 +4147,15 @@ bool Nym::SavePseudonym(String& strNym)
 
     for (auto& it : m_mapTentativeNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!(pSet->empty()) && (strNotaryID.size() > 0)) {
             NumList theList;
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+            for (const int64_t& lNum : *pSet) {
+                lTransactionNumber = lNum;
                 theList.Add(lTransactionNumber);
             }
             String strTemp;
@@ -4239,15 +4181,15 @@ bool Nym::SavePseudonym(String& strNym)
     //
     for (auto& it : m_mapAcknowledgedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        setOfTransNums* pSet = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
+        OT_ASSERT(nullptr != pSet);
 
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!(pSet->empty()) && (strNotaryID.size() > 0)) {
             NumList theList;
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                const int64_t lRequestNumber = pDeque->at(i);
+            for (const int64_t& lNum : *pSet) {
+                const int64_t lRequestNumber = lNum;
                 theList.Add(lRequestNumber);
             }
             String strTemp;
@@ -5488,61 +5430,80 @@ bool Nym::SaveSignedNymfile(Nym& SIGNER_NYM)
     return false;
 }
 
+// Static. For each notary in THE_MAP, collects the numbers that do NOT appear
+// on OTHER_MAP for that same notary. Both lists are sorted, so this is a single
+// linear merge per notary instead of a lookup per number. Returns the total
+// count of missing numbers (0 means THE_MAP is a subset of OTHER_MAP.)
+//
+int64_t Nym::GetMissingNums(const mapOfTransNums& THE_MAP,
+                            const mapOfTransNums& OTHER_MAP,
+                            std::map<std::string, setOfTransNums>& mapMissing)
+{
+    int64_t lMissing = 0;
+
+    for (auto& it : THE_MAP) {
+        const setOfTransNums* pSet = it.second;
+        OT_ASSERT(nullptr != pSet);
+
+        if (pSet->empty()) continue;
+
+        auto it_other = OTHER_MAP.find(it.first);
+        const setOfTransNums* pOther =
+            (OTHER_MAP.end() == it_other) ? nullptr : it_other->second;
+
+        setOfTransNums& setMissing = mapMissing[it.first];
+
+        if ((nullptr == pOther) || pOther->empty())
+            setMissing.insert(pSet->begin(), pSet->end());
+        else
+            std::set_difference(pSet->begin(), pSet->end(), pOther->begin(),
+                                pOther->end(),
+                                std::inserter(setMissing, setMissing.end()));
+
+        if (setMissing.empty())
+            mapMissing.erase(it.first);
+        else
+            lMissing += static_cast<int64_t>(setMissing.size());
+    }
+
+    return lMissing;
+}
+
 /// See if two nyms have identical lists of issued transaction numbers (#s
 /// currently signed for.)
 bool Nym::VerifyIssuedNumbersOnNym(Nym& THE_NYM)
 {
-    int64_t lTransactionNumber = 0; // Used in the loop below.
-
-    int32_t nNumberOfTransactionNumbers1 = 0; // *this
-    int32_t nNumberOfTransactionNumbers2 = 0; // THE_NYM.
+    int64_t nNumberOfTransactionNumbers1 = 0; // *this
+    int64_t nNumberOfTransactionNumbers2 = 0; // THE_NYM.
 
-    std::string strNotaryID;
-
-    // First, loop through the Nym on my side (*this), and count how many
-    // numbers total he has...
+    // First, loop through both Nyms and count how many numbers total each
+    // one has...
     //
     for (auto& it : GetMapIssuedNum()) {
-        dequeOfTransNums* pDeque = (it.second);
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty())) {
-            nNumberOfTransactionNumbers1 +=
-                static_cast<int32_t>(pDeque->size());
-        }
-    } // for
+        setOfTransNums* pSet = (it.second);
+        OT_ASSERT(nullptr != pSet);
+        nNumberOfTransactionNumbers1 += static_cast<int64_t>(pSet->size());
+    }
 
-    // Next, loop through THE_NYM, and count his numbers as well...
-    // But ALSO verify that each one exists on *this, so that each individual
-    // number is checked.
-    //
     for (auto& it : THE_NYM.GetMapIssuedNum()) {
-        strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
-
-        String OTstrNotaryID = strNotaryID.c_str();
-
-        if (!(pDeque->empty())) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+        setOfTransNums* pSet = (it.second);
+        OT_ASSERT(nullptr != pSet);
+        nNumberOfTransactionNumbers2 += static_cast<int64_t>(pSet->size());
+    }
 
-                //                if ()
-                {
-                    nNumberOfTransactionNumbers2++;
+    // Next, verify that each number on THE_NYM exists on *this, so that each
+    // individual number is checked.
+    //
+    std::map<std::string, setOfTransNums> mapMissing;
 
-                    if (false ==
-                        VerifyIssuedNum(OTstrNotaryID, lTransactionNumber)) {
-                        otOut << "OTPseudonym::" << __FUNCTION__
-                              << ": Issued transaction # " << lTransactionNumber
-                              << " from THE_NYM not found on *this.\n";
+    if (GetMissingNums(THE_NYM.GetMapIssuedNum(), GetMapIssuedNum(),
+                       mapMissing) > 0) {
+        otOut << "OTPseudonym::" << __FUNCTION__ << ": Issued transaction # "
+              << *(mapMissing.begin()->second.begin())
+              << " from THE_NYM not found on *this.\n";
 
-                        return false;
-                    }
-                }
-            }
-        }
-    } // for
+        return false;
+    }
 
     // Finally, verify that the counts match...
     if (nNumberOfTransactionNumbers1 != nNumberOfTransactionNumbers2) {
@@ -5580,36 +5541,18 @@ bool Nym::VerifyTransactionStatementNumbersOnNym(Nym& THE_NYM) // THE_NYM is
                                                                // from the
                                                                // receipt.
 {
-    int64_t lTransactionNumber = 0; // Used in the loop below.
-
-    std::string strNotaryID;
-
-    // First, loop through the Nym on my side (*this), and verify that all those
-    // #s appear on the last receipt (THE_NYM)
+    // Verify that all the #s on my side (*this) appear on the last receipt
+    // (THE_NYM)
     //
-    for (auto& it : GetMapIssuedNum()) {
-        strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        String OTstrNotaryID = strNotaryID.c_str();
-
-        OT_ASSERT(nullptr != pDeque);
+    std::map<std::string, setOfTransNums> mapMissing;
 
-        if (!(pDeque->empty())) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-
-                if (false ==
-                    THE_NYM.VerifyIssuedNum(OTstrNotaryID,
-                                            lTransactionNumber)) {
-                    otOut << "OTPseudonym::" << __FUNCTION__
-                          << ": Issued transaction # " << lTransactionNumber
-                          << " from *this not found on THE_NYM.\n";
-                    return false;
-                }
-            }
-        }
-    } // for
+    if (GetMissingNums(GetMapIssuedNum(), THE_NYM.GetMapIssuedNum(),
+                       mapMissing) > 0) {
+        otOut << "OTPseudonym::" << __FUNCTION__ << ": Issued transaction # "
+              << *(mapMissing.begin()->second.begin())
+              << " from *this not found on THE_NYM.\n";
+        return false;
+    }
 
     // Getting here means that, though issued numbers may have been removed from
     // my responsibility
@@ -6167,6 +6110,11 @@ void Nym::ClearAll()
     ClearOutmail();
     ClearOutpayments();
 
+    // Loading the nymfile again into the same Nym (as the server does with
+    // the Nyms it keeps verified) must not leave these over from before.
+    m_bMarkForDeletion = false;
+    m_NymboxHash.Release();
+
     // We load the Nym twice... once just to load the credentials up from the
     // .cred file, and a second
     // time to load the rest of the Nym up from the Nymfile. LoadFromString
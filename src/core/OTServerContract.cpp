@@ -240,7 +240,7 @@ int32_t OTServerContract::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
         if (!transportKeyB64) return -1;
         std::string transportKeyB64Trimmed(transportKeyB64);
         String::trim(transportKeyB64Trimmed);
-        size_t outLen;
+        size_t outLen = 0;
         m_transportKey = OTCrypto::It()->Base64Decode(
             transportKeyB64Trimmed.c_str(), &outLen, false);
         
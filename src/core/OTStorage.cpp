@@ -49,6 +49,39 @@
 #include <sstream>
 #include <fstream>
 #include <typeinfo>
+#include <chrono>
+
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#define OTDB_SEEK _fseeki64
+#define OTDB_TELL _ftelli64
+#define OTDB_SYNC(pFile) _commit(_fileno(pFile))
+#define OTDB_TRUNCATE(pFile, lSize) _chsize_s(_fileno(pFile), lSize)
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define OTDB_SEEK fseeko
+#define OTDB_TELL ftello
+#define OTDB_SYNC(pFile) fsync(fileno(pFile))
+#define OTDB_TRUNCATE(pFile, lSize) ftruncate(fileno(pFile), lSize)
+#endif
+
+// StorageFS writes each file here first, then renames it into place.
+#define OTDB_TEMP_SUFFIX ".tmp"
+
+// StorageLog keeps everything in this file, in the data folder.
+#define OTDB_LOG_FILENAME "otdb.log"
+#define OTDB_LOG_MAGIC "OTDB"
+#define OTDB_LOG_HEADER_SIZE 16
+#define OTDB_LOG_OP_HEADER_SIZE 13
+// The data file is compacted once it's at least this big, and less than half
+// of it is still live.
+#define OTDB_LOG_COMPACT_MIN_SIZE (64 * 1024 * 1024)
+// Compaction writes the live values out in records of about this size.
+#define OTDB_LOG_COMPACT_RECORD_SIZE (4 * 1024 * 1024)
 
 /*
  // We want to store EXISTING OT OBJECTS (Usually signed contracts)
@@ -663,6 +696,96 @@ std::string QueryPlainString(std::string strFolder, std::string oneStr,
     return pStorage->QueryPlainString(strFolder, oneStr, twoStr, threeStr);
 }
 
+bool ReadPlainString(std::string& strContents, std::string strFolder,
+                     std::string oneStr, std::string twoStr,
+                     std::string threeStr)
+{
+    {
+        String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
+            ot_threeStr(threeStr);
+        OT_ASSERT_MSG(ot_strFolder.Exists(),
+                      "OTDB::ReadPlainString: strFolder is null");
+
+        if (!ot_oneStr.Exists()) {
+            OT_ASSERT_MSG((!ot_twoStr.Exists() && !ot_threeStr.Exists()),
+                          "OTDB::ReadPlainString: bad options");
+            oneStr = strFolder;
+            strFolder = ".";
+        }
+    }
+    Storage* pStorage = details::s_pStorage;
+
+    OT_ASSERT((strFolder.length() > 3) || (0 == strFolder.compare(0, 1, ".")));
+    OT_ASSERT((oneStr.length() < 1) || (oneStr.length() > 3));
+
+    if (nullptr == pStorage) {
+        return false;
+    }
+
+    return pStorage->ReadPlainString(strContents, strFolder, oneStr, twoStr,
+                                     threeStr);
+}
+
+bool AppendPlainString(std::string strContents, std::string strFolder,
+                       std::string oneStr, std::string twoStr,
+                       std::string threeStr)
+{
+    {
+        String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
+            ot_threeStr(threeStr);
+        OT_ASSERT_MSG(ot_strFolder.Exists(),
+                      "OTDB::AppendPlainString: strFolder is null");
+
+        if (!ot_oneStr.Exists()) {
+            OT_ASSERT_MSG((!ot_twoStr.Exists() && !ot_threeStr.Exists()),
+                          "OTDB::AppendPlainString: bad options");
+            oneStr = strFolder;
+            strFolder = ".";
+        }
+    }
+    Storage* pStorage = details::s_pStorage;
+
+    OT_ASSERT((strFolder.length() > 3) || (0 == strFolder.compare(0, 1, ".")));
+    OT_ASSERT((oneStr.length() < 1) || (oneStr.length() > 3));
+
+    if (nullptr == pStorage) {
+        return false;
+    }
+
+    return pStorage->AppendPlainString(strContents, strFolder, oneStr, twoStr,
+                                       threeStr);
+}
+
+bool SyncAppendPlainString(std::string strContents, std::string strFolder,
+                           std::string oneStr, std::string twoStr,
+                           std::string threeStr)
+{
+    {
+        String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
+            ot_threeStr(threeStr);
+        OT_ASSERT_MSG(ot_strFolder.Exists(),
+                      "OTDB::SyncAppendPlainString: strFolder is null");
+
+        if (!ot_oneStr.Exists()) {
+            OT_ASSERT_MSG((!ot_twoStr.Exists() && !ot_threeStr.Exists()),
+                          "OTDB::SyncAppendPlainString: bad options");
+            oneStr = strFolder;
+            strFolder = ".";
+        }
+    }
+    Storage* pStorage = details::s_pStorage;
+
+    OT_ASSERT((strFolder.length() > 3) || (0 == strFolder.compare(0, 1, ".")));
+    OT_ASSERT((oneStr.length() < 1) || (oneStr.length() > 3));
+
+    if (nullptr == pStorage) {
+        return false;
+    }
+
+    return pStorage->SyncAppendPlainString(strContents, strFolder, oneStr,
+                                           twoStr, threeStr);
+}
+
 // Store/Retrieve an object. (Storable.)
 
 bool StoreObject(Storable& theContents, std::string strFolder,
@@ -763,6 +886,24 @@ bool EraseValueByKey(std::string strFolder, std::string oneStr,
     return pStorage->EraseValueByKey(strFolder, oneStr, twoStr, threeStr);
 }
 
+// Write batches.
+
+void BeginBatch()
+{
+    Storage* pStorage = details::s_pStorage;
+
+    if (nullptr != pStorage) pStorage->BeginBatch();
+}
+
+bool CommitBatch()
+{
+    Storage* pStorage = details::s_pStorage;
+
+    if (nullptr == pStorage) return false;
+
+    return pStorage->CommitBatch();
+}
+
 // Used internally. Creates the right subclass for any stored object type,
 // based on which packer is needed.
 
@@ -2060,6 +2201,10 @@ Storage* Storage::Create(StorageType eStorageType, PackType ePackType)
         pStore = StorageFS::Instantiate();
         OT_ASSERT(nullptr != pStore);
         break;
+    case STORE_LOG:
+        pStore = StorageLog::Instantiate();
+        OT_ASSERT(nullptr != pStore);
+        break;
     //            case STORE_COUCH_DB:
     //                pStore = new StorageCouchDB; OT_ASSERT(nullptr != pStore);
     // break;
@@ -2100,6 +2245,7 @@ StorageType Storage::GetType() const
     // that this is a custom Storage type invented by the API user.
 
     if (typeid(*this) == typeid(StorageFS)) return STORE_FILESYSTEM;
+    if (typeid(*this) == typeid(StorageLog)) return STORE_LOG;
     //    else if (typeid(*this) == typeid(StorageCouchDB))
     //        return STORE_COUCH_DB;
     //  Etc.
@@ -2207,6 +2353,105 @@ std::string Storage::QueryPlainString(std::string strFolder, std::string oneStr,
     return theString;
 }
 
+bool Storage::ReadPlainString(std::string& strContents,
+                              std::string strFolder, std::string oneStr,
+                              std::string twoStr, std::string threeStr)
+{
+    strContents.clear();
+
+    return onReadPlainString(strContents, strFolder, oneStr, twoStr, threeStr);
+}
+
+bool Storage::onReadPlainString(std::string& theBuffer, std::string strFolder,
+                                std::string oneStr, std::string twoStr,
+                                std::string threeStr)
+{
+    if (onQueryPlainString(theBuffer, strFolder, oneStr, twoStr, threeStr))
+        return true;
+
+    theBuffer.clear();
+
+    return !Exists(strFolder, oneStr, twoStr, threeStr);
+}
+
+bool Storage::AppendPlainString(std::string strContents,
+                                std::string strFolder, std::string oneStr,
+                                std::string twoStr, std::string threeStr)
+{
+    return onAppendPlainString(strContents, strFolder, oneStr, twoStr,
+                               threeStr);
+}
+
+bool Storage::onAppendPlainString(std::string& theBuffer, std::string strFolder,
+                                  std::string oneStr, std::string twoStr,
+                                  std::string threeStr)
+{
+    std::string strContents;
+
+    if (Exists(strFolder, oneStr, twoStr, threeStr))
+        strContents = QueryPlainString(strFolder, oneStr, twoStr, threeStr);
+
+    strContents += theBuffer;
+
+    return onStorePlainString(strContents, strFolder, oneStr, twoStr,
+                              threeStr);
+}
+
+bool Storage::SyncAppendPlainString(std::string strContents,
+                                    std::string strFolder, std::string oneStr,
+                                    std::string twoStr, std::string threeStr)
+{
+    return onSyncAppendPlainString(strContents, strFolder, oneStr, twoStr,
+                                   threeStr);
+}
+
+bool Storage::onSyncAppendPlainString(std::string& theBuffer,
+                                      std::string strFolder, std::string oneStr,
+                                      std::string twoStr, std::string threeStr)
+{
+    return onAppendPlainString(theBuffer, strFolder, oneStr, twoStr, threeStr);
+}
+
+void Storage::onBeginBatch()
+{
+}
+
+bool Storage::onCommitBatch()
+{
+    return true;
+}
+
+void Storage::BeginBatch()
+{
+    // Only this thread can have set the owner to itself.
+    if (std::this_thread::get_id() != m_batchOwner.load()) {
+        m_lockBatchOwner.lock(); // Waits for another thread's batch.
+        m_batchOwner = std::this_thread::get_id();
+
+        OT_ASSERT(0 == m_nBatchDepth);
+
+        onBeginBatch();
+    }
+
+    ++m_nBatchDepth;
+}
+
+bool Storage::CommitBatch()
+{
+    OT_ASSERT_MSG(std::this_thread::get_id() == m_batchOwner.load(),
+                  "Storage::CommitBatch: this thread has no batch open.");
+    OT_ASSERT(0 < m_nBatchDepth);
+
+    if (0 < --m_nBatchDepth) return true; // Still inside an outer batch.
+
+    const bool bSuccess = onCommitBatch();
+
+    m_batchOwner = std::thread::id();
+    m_lockBatchOwner.unlock();
+
+    return bSuccess;
+}
+
 bool Storage::StoreObject(Storable& theContents, std::string strFolder,
                           std::string oneStr, std::string twoStr,
                           std::string threeStr)
@@ -2407,6 +2652,64 @@ bool Storage::EraseValueByKey(std::string strFolder, std::string oneStr,
 
 // STORAGE FS  (OTDB::StorageFS is the filesystem version of OTDB::Storage.)
 
+static bool SyncFile(FILE* pFile)
+{
+    return (0 == fflush(pFile)) && (0 == OTDB_SYNC(pFile));
+}
+
+static bool SyncPath(const std::string& strPath)
+{
+#ifdef _WIN32
+    const int nFile = _open(strPath.c_str(), _O_RDWR | _O_BINARY);
+
+    if (0 > nFile) return false;
+
+    const bool bSynced = (0 == _commit(nFile));
+    _close(nFile);
+#else
+    const int nFile = open(strPath.c_str(), O_RDONLY);
+
+    if (0 > nFile) return false;
+
+    const bool bSynced = (0 == fsync(nFile));
+    close(nFile);
+#endif
+
+    return bSynced;
+}
+
+// So a rename (or remove) in this folder survives a crash.
+//
+static bool SyncFolder(const std::string& strFolder)
+{
+#ifdef _WIN32
+    return !strFolder.empty(); // Windows can't sync a folder.
+#else
+    return SyncPath(strFolder);
+#endif
+}
+
+static std::string FolderOf(const std::string& strPath)
+{
+    const size_t nPos = strPath.find_last_of("/\\");
+
+    return (std::string::npos == nPos) ? std::string(".")
+                                       : strPath.substr(0, nPos);
+}
+
+static bool RenameFile(const std::string& strFrom, const std::string& strTo)
+{
+#ifdef _WIN32
+    remove(strTo.c_str()); // rename() won't replace it here.
+#endif
+
+    if (0 == rename(strFrom.c_str(), strTo.c_str())) return true;
+
+    otErr << "OTDB: Failed renaming " << strFrom << " to " << strTo << "\n";
+
+    return false;
+}
+
 // ConfirmOrCreateFolder()
 // Used for making sure that certain necessary folders actually exist. (Creates
 // them otherwise.)
@@ -2617,18 +2920,16 @@ bool StorageFS::onStorePackedBuffer(PackedBuffer& theBuffer,
 
     // TODO: If not, next I should actually create a .lock file for myself right
     // here..
-    
+
     // SAVE to the file here
-    std::ofstream ofs(strOutput.c_str(), std::ios::out | std::ios::binary);
+    std::ostringstream ostr(std::ios::out | std::ios::binary);
 
-    if (ofs.fail()) {
-        otErr << __FUNCTION__ << ": Error opening file: " << strOutput << "\n";
+    if (!theBuffer.WriteToOStream(ostr)) {
+        otErr << __FUNCTION__ << ": Error packing: " << strOutput << "\n";
         return false;
     }
 
-    ofs.clear();
-    bool bSuccess = theBuffer.WriteToOStream(ofs);
-    ofs.close();
+    const bool bSuccess = WriteFile(strOutput, ostr.str());
 
     // TODO: Remove the .lock file.
 
@@ -2644,6 +2945,8 @@ bool StorageFS::onQueryPackedBuffer(PackedBuffer& theBuffer,
     int64_t lRet =
         ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr, threeStr);
 
+    if (0 <= lRet) lRet = ConfirmPending(strOutput, lRet);
+
     if (0 > lRet) {
         otErr << "StorageFS::" << __FUNCTION__ << ": Error with " << strOutput
               << ".\n";
@@ -2698,17 +3001,7 @@ bool StorageFS::onStorePlainString(std::string& theBuffer,
     // In a key/value database, szFilename is the "key" and strFinal.Get() is
     // the "value".
     //
-    std::ofstream ofs(strOutput.c_str(), std::ios::out | std::ios::binary);
-
-    if (ofs.fail()) {
-        otErr << __FUNCTION__ << ": Error opening file: " << strOutput << "\n";
-        return false;
-    }
-
-    ofs.clear();
-    ofs << theBuffer;
-    bool bSuccess = ofs.good();
-    ofs.close();
+    const bool bSuccess = WriteFile(strOutput, theBuffer);
 
     // TODO: Remove the .lock file.
 
@@ -2724,6 +3017,8 @@ bool StorageFS::onQueryPlainString(std::string& theBuffer,
     int64_t lRet =
         ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr, threeStr);
 
+    if (0 <= lRet) lRet = ConfirmPending(strOutput, lRet);
+
     if (0 > lRet) {
         otErr << "StorageFS::" << __FUNCTION__ << ": Error with " << strOutput
               << ".\n";
@@ -2765,90 +3060,424 @@ bool StorageFS::onQueryPlainString(std::string& theBuffer,
     return bSuccess;
 }
 
-// Erase a value by location.
-//
-bool StorageFS::onEraseValueByKey(std::string strFolder, std::string oneStr,
+bool StorageFS::onReadPlainString(std::string& theBuffer,
+                                  std::string strFolder, std::string oneStr,
                                   std::string twoStr, std::string threeStr)
 {
     std::string strOutput;
 
-    if (0 > ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr,
-                                    threeStr)) {
-        otErr << "Error: " << __FUNCTION__
-              << ": Failed calling ConstructAndConfirmPath with:\n"
-                 "strOutput: " << strOutput << " | strFolder: " << strFolder
-              << " | oneStr: " << oneStr << " | twoStr: " << twoStr
-              << " | threeStr: " << threeStr << " \n";
+    int64_t lRet =
+        ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr, threeStr);
 
+    if (0 <= lRet) lRet = ConfirmPending(strOutput, lRet);
+
+    if (0 > lRet) {
+        otErr << "StorageFS::" << __FUNCTION__ << ": Error with " << strOutput
+              << ".\n";
         return false;
     }
 
-    // TODO: Should check here to see if there is a .lock file for the target...
+    theBuffer.clear();
 
-    // TODO: If not, next I should actually create a .lock file for myself right
-    // here..
+    // Missing, or there but empty: either way, nothing to read.
+    if (0 == lRet) return true;
 
-    // SAVE to the file here. (a blank string.)
-    //
-    // Here's where the serialization code would be changed to CouchDB or
-    // whatever.
-    // In a key/value database, szFilename is the "key" and strFinal.Get() is
-    // the "value".
-    //
-    std::ofstream ofs(strOutput.c_str(), std::ios::out | std::ios::binary);
+    std::ifstream fin(strOutput.c_str(), std::ios::in | std::ios::binary);
 
-    if (ofs.fail()) {
-        otErr << "Error opening file in StorageFS::onEraseValueByKey: "
-              << strOutput << "\n";
+    if (!fin.is_open()) {
+        otErr << __FUNCTION__ << ": Error opening file: " << strOutput << "\n";
         return false;
     }
 
-    ofs.clear();
-    ofs << "(This space intentionally left blank.)\n";
-    bool bSuccess = ofs.good() ? true : false;
-    ofs.close();
-    // Note: I bet you think I should be overwriting the file 7 times here with
-    // random data, right? Wrong: YOU need to override OTStorage and create your
-    // own subclass, where you can override onEraseValueByKey and do that stuff
-    // yourself. It's outside of the scope of OT.
+    std::stringstream buffer;
+    buffer << fin.rdbuf();
 
-    if (remove(strOutput.c_str()) != 0) {
-        bSuccess = false;
-        otErr << "** Failed trying to delete file:  " << strOutput << " \n";
-    }
-    else {
-        bSuccess = true;
-        otInfo << "** Success deleting file:  " << strOutput << " \n";
+    if (!fin.good()) {
+        otErr << __FUNCTION__ << ": Error reading file: " << strOutput << "\n";
+        return false;
     }
 
-    // TODO: Remove the .lock file.
-
-    return bSuccess;
-}
-
-// Constructor for Filesystem storage context.
-//
-StorageFS::StorageFS()
-    : Storage()
-{
-    String strDataPath;
-    OTDataFolder::Get(strDataPath);
-    m_strDataPath = strDataPath.Get();
-}
+    theBuffer = buffer.str();
 
-StorageFS::~StorageFS()
-{
+    return true;
 }
 
-// See if the file is there.
-
-bool StorageFS::Exists(std::string strFolder, std::string oneStr,
-                       std::string twoStr, std::string threeStr)
+bool StorageFS::onAppendPlainString(std::string& theBuffer,
+                                    std::string strFolder, std::string oneStr,
+                                    std::string twoStr, std::string threeStr)
 {
     std::string strOutput;
 
-    return (0 < ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr,
-                                        threeStr));
+    if (0 > ConstructAndCreatePath(strOutput, strFolder, oneStr, twoStr,
+                                   threeStr)) {
+        otErr << "StorageFS::" << __FUNCTION__ << ": Error writing to "
+              << strOutput << ".\n";
+        return false;
+    }
+
+    // Unlike onStorePlainString, the existing contents are never truncated.
+    // A crash can at worst leave a partial record at the end of the file.
+    // (If the file is still waiting in its temp file in this batch, that's
+    // where the record goes.)
+    //
+    std::lock_guard<std::mutex> lock(m_lockBatch);
+
+    const bool bPending = WritesPending(strOutput);
+    const std::string strPath(bPending ? strOutput + OTDB_TEMP_SUFFIX
+                                       : strOutput);
+
+    FILE* pFile = fopen(strPath.c_str(), "ab");
+
+    if (nullptr == pFile) {
+        otErr << __FUNCTION__ << ": Error opening file: " << strPath << "\n";
+        return false;
+    }
+
+    bool bSuccess = (theBuffer.size() ==
+                     fwrite(theBuffer.data(), 1, theBuffer.size(), pFile));
+
+    bSuccess = (0 == fclose(pFile)) && bSuccess;
+
+    if (m_bBatchOpen && !bPending) m_mapBatchFiles[strOutput] = false;
+
+    return bSuccess;
+}
+
+// The record goes straight into the file and is synced, batch or no batch.
+// (Unless the batch already replaced or erased the file: then it goes into
+// the temp file like any other append, and is synced when the temp file is
+// renamed into place.)
+//
+bool StorageFS::onSyncAppendPlainString(std::string& theBuffer,
+                                        std::string strFolder,
+                                        std::string oneStr, std::string twoStr,
+                                        std::string threeStr)
+{
+    std::string strOutput;
+
+    if (0 > ConstructAndCreatePath(strOutput, strFolder, oneStr, twoStr,
+                                   threeStr)) {
+        otErr << "StorageFS::" << __FUNCTION__ << ": Error writing to "
+              << strOutput << ".\n";
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lockBatch);
+
+        if (WritesPending(strOutput)) {
+            std::string strPending(strOutput + OTDB_TEMP_SUFFIX);
+            FILE* pFile = fopen(strPending.c_str(), "ab");
+
+            if (nullptr == pFile) {
+                otErr << __FUNCTION__ << ": Error opening file: " << strPending
+                      << "\n";
+                return false;
+            }
+
+            const bool bSuccess =
+                (theBuffer.size() ==
+                 fwrite(theBuffer.data(), 1, theBuffer.size(), pFile));
+
+            return (0 == fclose(pFile)) && bSuccess;
+        }
+    }
+
+    const bool bCreated = !OTPaths::PathExists(strOutput.c_str());
+    FILE* pFile = fopen(strOutput.c_str(), "ab");
+
+    if (nullptr == pFile) {
+        otErr << __FUNCTION__ << ": Error opening file: " << strOutput << "\n";
+        return false;
+    }
+
+    bool bSuccess = (theBuffer.size() ==
+                     fwrite(theBuffer.data(), 1, theBuffer.size(), pFile)) &&
+                    SyncFile(pFile);
+
+    bSuccess = (0 == fclose(pFile)) && bSuccess;
+
+    // A new file isn't there after a crash until its folder is synced.
+    if (bSuccess && bCreated) bSuccess = SyncFolder(FolderOf(strOutput));
+
+    if (!bSuccess)
+        otErr << "StorageFS::" << __FUNCTION__ << ": Failed syncing "
+              << strOutput << "\n";
+
+    return bSuccess;
+}
+
+// Erase a value by location.
+//
+bool StorageFS::onEraseValueByKey(std::string strFolder, std::string oneStr,
+                                  std::string twoStr, std::string threeStr)
+{
+    std::string strOutput;
+
+    if (0 > ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr,
+                                    threeStr)) {
+        otErr << "Error: " << __FUNCTION__
+              << ": Failed calling ConstructAndConfirmPath with:\n"
+                 "strOutput: " << strOutput << " | strFolder: " << strFolder
+              << " | oneStr: " << oneStr << " | twoStr: " << twoStr
+              << " | threeStr: " << threeStr << " \n";
+
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_lockBatch);
+
+    // A write from earlier in this batch is dropped along with the file.
+    auto it = m_mapBatchFiles.find(strOutput);
+
+    if (m_mapBatchFiles.end() != it) {
+        if (it->second) remove((strOutput + OTDB_TEMP_SUFFIX).c_str());
+        m_mapBatchFiles.erase(it);
+    }
+
+    // Inside a batch, the file goes once everything the batch wrote is in
+    // place. (Such as a snapshot that replaces the journal being erased.)
+    if (m_bBatchOpen) {
+        m_setBatchErased.insert(strOutput);
+        return true;
+    }
+
+    return RemoveFile(strOutput);
+}
+
+bool StorageFS::RemoveFile(const std::string& strPath)
+{
+    // TODO: Should check here to see if there is a .lock file for the target...
+
+    // TODO: If not, next I should actually create a .lock file for myself right
+    // here..
+
+    // SAVE to the file here. (a blank string.)
+    //
+    // Here's where the serialization code would be changed to CouchDB or
+    // whatever.
+    // In a key/value database, szFilename is the "key" and strFinal.Get() is
+    // the "value".
+    //
+    std::ofstream ofs(strPath.c_str(), std::ios::out | std::ios::binary);
+
+    if (ofs.fail()) {
+        otErr << "Error opening file in StorageFS::onEraseValueByKey: "
+              << strPath << "\n";
+        return false;
+    }
+
+    ofs.clear();
+    ofs << "(This space intentionally left blank.)\n";
+    bool bSuccess = ofs.good() ? true : false;
+    ofs.close();
+    // Note: I bet you think I should be overwriting the file 7 times here with
+    // random data, right? Wrong: YOU need to override OTStorage and create your
+    // own subclass, where you can override onEraseValueByKey and do that stuff
+    // yourself. It's outside of the scope of OT.
+
+    if (remove(strPath.c_str()) != 0) {
+        bSuccess = false;
+        otErr << "** Failed trying to delete file:  " << strPath << " \n";
+    }
+    else {
+        bSuccess = true;
+        otInfo << "** Success deleting file:  " << strPath << " \n";
+    }
+
+    // TODO: Remove the .lock file.
+
+    return bSuccess;
+}
+
+// Writes the file to strPath + ".tmp" and renames it into place, so a crash
+// leaves either the old file or the new one (never half of it.)
+//
+// While a batch is open, the temp file waits for the commit, so every file
+// the batch writes is synced (with sync_writes on) in one pass. (Until then,
+// reads of it go to the temp file.)
+//
+bool StorageFS::WriteFile(const std::string& strPath,
+                          const std::string& strData)
+{
+    const std::string strTemp(strPath + OTDB_TEMP_SUFFIX);
+
+    std::lock_guard<std::mutex> lock(m_lockBatch);
+
+    FILE* pFile = fopen(strTemp.c_str(), "wb");
+
+    if (nullptr == pFile) {
+        otErr << "StorageFS::" << __FUNCTION__
+              << ": Error opening file: " << strTemp << "\n";
+        return false;
+    }
+
+    bool bSuccess =
+        (strData.size() == fwrite(strData.data(), 1, strData.size(), pFile));
+
+    bSuccess = (0 == fclose(pFile)) && bSuccess;
+
+    if (!bSuccess) {
+        otErr << "StorageFS::" << __FUNCTION__
+              << ": Error writing file: " << strTemp << "\n";
+        remove(strTemp.c_str());
+        return false;
+    }
+
+    if (m_bBatchOpen) {
+        m_mapBatchFiles[strPath] = true;
+        m_setBatchErased.erase(strPath); // The rename replaces it anyway.
+        return true;
+    }
+
+    return RenameFile(strTemp, strPath);
+}
+
+// Call with m_lockBatch held. True if writes to strPath go to its temp file
+// in this batch. (A file the batch erased starts over in its temp file.)
+//
+bool StorageFS::WritesPending(const std::string& strPath)
+{
+    if (0 < m_setBatchErased.erase(strPath)) {
+        m_mapBatchFiles[strPath] = true;
+        return true;
+    }
+
+    auto it = m_mapBatchFiles.find(strPath);
+
+    return (m_mapBatchFiles.end() != it) && it->second;
+}
+
+// If the file is waiting in its temp file, points strPath there and returns
+// its size. If the batch erased it, returns 0. Otherwise returns lSize.
+//
+int64_t StorageFS::ConfirmPending(std::string& strPath, int64_t lSize)
+{
+    std::lock_guard<std::mutex> lock(m_lockBatch);
+
+    if (m_setBatchErased.end() != m_setBatchErased.find(strPath)) return 0;
+
+    auto it = m_mapBatchFiles.find(strPath);
+
+    if ((m_mapBatchFiles.end() == it) || !it->second) return lSize;
+
+    strPath += OTDB_TEMP_SUFFIX;
+
+    int64_t lPendingSize = 0;
+
+    return OTPaths::FileExists(strPath.c_str(), lPendingSize) ? lPendingSize
+                                                              : 0;
+}
+
+void StorageFS::onBeginBatch()
+{
+    std::lock_guard<std::mutex> lock(m_lockBatch);
+
+    m_bBatchOpen = true;
+}
+
+// Group commit: every file the batch wrote is synced first, then they're all
+// renamed into place, then each folder is synced once. So nothing is renamed
+// before its contents are on disk, and the whole batch costs one pass of
+// syncs however many times it saved the same file. The files the batch
+// erased go last, once all of that is on disk.
+//
+bool StorageFS::onCommitBatch()
+{
+    std::lock_guard<std::mutex> lock(m_lockBatch);
+
+    m_bBatchOpen = false;
+
+    if (m_mapBatchFiles.empty() && m_setBatchErased.empty()) return true;
+
+    const auto tStart = std::chrono::steady_clock::now();
+    std::set<std::string> setFolders;
+    bool bSuccess = true;
+
+    if (GetSyncWrites()) {
+        for (auto& it : m_mapBatchFiles) {
+            const std::string strPath(it.second ? it.first + OTDB_TEMP_SUFFIX
+                                                : it.first);
+
+            if (!SyncPath(strPath)) {
+                otErr << "StorageFS::" << __FUNCTION__
+                      << ": Failed syncing " << strPath << "\n";
+                bSuccess = false;
+            }
+        }
+    }
+
+    for (auto& it : m_mapBatchFiles) {
+        if (!it.second) continue;
+
+        if (RenameFile(it.first + OTDB_TEMP_SUFFIX, it.first))
+            setFolders.insert(FolderOf(it.first));
+        else
+            bSuccess = false;
+    }
+
+    if (GetSyncWrites()) {
+        for (auto& it : setFolders) SyncFolder(it);
+    }
+
+    // If the writes didn't all make it, neither do the erases.
+    if (bSuccess && !m_setBatchErased.empty()) {
+        setFolders.clear();
+
+        for (auto& it : m_setBatchErased) {
+            if (RemoveFile(it))
+                setFolders.insert(FolderOf(it));
+            else
+                bSuccess = false;
+        }
+
+        if (GetSyncWrites()) {
+            for (auto& it : setFolders) SyncFolder(it);
+        }
+    }
+
+    otInfo << "StorageFS::" << __FUNCTION__ << ": Committed "
+           << (m_mapBatchFiles.size() + m_setBatchErased.size())
+           << " files in "
+           << std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - tStart).count()
+           << " microseconds.\n";
+
+    m_mapBatchFiles.clear();
+    m_setBatchErased.clear();
+
+    return bSuccess;
+}
+
+// Constructor for Filesystem storage context.
+//
+// (static)
+bool StorageFS::__sync_writes = true;
+
+StorageFS::StorageFS()
+    : Storage()
+    , m_bBatchOpen(false)
+{
+    String strDataPath;
+    OTDataFolder::Get(strDataPath);
+    m_strDataPath = strDataPath.Get();
+}
+
+StorageFS::~StorageFS()
+{
+}
+
+// See if the file is there.
+
+bool StorageFS::Exists(std::string strFolder, std::string oneStr,
+                       std::string twoStr, std::string threeStr)
+{
+    std::string strOutput;
+
+    const int64_t lRet =
+        ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr, threeStr);
+
+    return (0 <= lRet) && (0 < ConfirmPending(strOutput, lRet));
 }
 
 // Returns path size, plus path in strOutput.
@@ -2861,6 +3490,780 @@ int64_t StorageFS::FormPathString(std::string& strOutput, std::string strFolder,
                                    threeStr);
 }
 
+
+// STORAGE LOG  (OTDB::StorageLog)
+//
+// Everything goes into one data file, as a series of records. Each record is
+// written (and synced) in one go, so a batch is all-or-nothing. The layout,
+// with every number in little-endian order:
+//
+//   "OTDB"                     4 bytes
+//   number of operations       4 bytes
+//   length of the operations   8 bytes
+//   the operations, each one:
+//       type                   1 byte   (store, append or erase)
+//       key length             4 bytes
+//       value length           8 bytes
+//       key, value
+//   CRC-32 of the operations   4 bytes
+
+static void PutUint(std::string& strOutput, uint64_t lValue, int32_t nBytes)
+{
+    for (int32_t i = 0; i < nBytes; ++i)
+        strOutput.push_back(static_cast<char>((lValue >> (8 * i)) & 0xff));
+}
+
+static uint64_t GetUint(const char* pData, int32_t nBytes)
+{
+    uint64_t lValue = 0;
+
+    for (int32_t i = 0; i < nBytes; ++i)
+        lValue |= static_cast<uint64_t>(static_cast<uint8_t>(pData[i]))
+                  << (8 * i);
+
+    return lValue;
+}
+
+static uint32_t Checksum(const std::string& strData)
+{
+    return static_cast<uint32_t>(
+        crc32(0L, reinterpret_cast<const Bytef*>(strData.data()),
+              static_cast<uInt>(strData.size())));
+}
+
+StorageLog::StorageLog()
+    : StorageFS()
+    , m_pFile(nullptr)
+    , m_lFileSize(0)
+    , m_lLiveBytes(0)
+    , m_bBatchOpen(false)
+{
+    String strDataPath, strFilename;
+    OTDataFolder::Get(strDataPath);
+    OTPaths::AppendFile(strFilename, strDataPath, OTDB_LOG_FILENAME);
+
+    m_strFolder = strDataPath.Get();
+    m_strFilename = strFilename.Get();
+
+    if (!Open()) {
+        otErr << "StorageLog::StorageLog: Unable to open the data file: "
+              << m_strFilename << "\n";
+        OT_FAIL;
+    }
+}
+
+StorageLog::~StorageLog()
+{
+    // A batch that's still open here was never committed, so it's dropped.
+    if (nullptr != m_pFile) fclose(m_pFile);
+    m_pFile = nullptr;
+}
+
+// The same path StorageFS would use, relative to the data folder.
+//
+// static
+bool StorageLog::FormKey(std::string& strKey, const std::string& strFolder,
+                         const std::string& oneStr, const std::string& twoStr,
+                         const std::string& threeStr)
+{
+    // Same rules as StorageFS: anything shorter than 3 characters counts as
+    // empty (except a "." folder) and there's no "three" without a "two".
+    const bool bHaveZero = (2 < strFolder.length());
+    const bool bHaveOne = (2 < oneStr.length());
+    const bool bHaveTwo = (2 < twoStr.length());
+    const bool bHaveThree = (2 < threeStr.length());
+
+    if ((!bHaveZero && (0 != strFolder.compare("."))) || !bHaveOne ||
+        (!bHaveTwo && bHaveThree)) {
+        otErr << "StorageLog::" << __FUNCTION__ << ": Bad key: \"" << strFolder
+              << "\" \"" << oneStr << "\" \"" << twoStr << "\" \"" << threeStr
+              << "\"\n";
+        return false;
+    }
+
+    strKey = bHaveZero ? (strFolder + "/") : std::string("");
+    strKey += oneStr;
+    if (bHaveTwo) strKey += "/" + twoStr;
+    if (bHaveThree) strKey += "/" + threeStr;
+
+    return true;
+}
+
+bool StorageLog::Open()
+{
+    const std::string strCompact(m_strFilename + ".compact");
+
+    // A compaction may have been cut off after the old file was removed
+    // (Windows can't rename over it.) The new one is complete by then.
+    if (!OTPaths::PathExists(m_strFilename.c_str()) &&
+        OTPaths::PathExists(strCompact.c_str()))
+        rename(strCompact.c_str(), m_strFilename.c_str());
+    else
+        remove(strCompact.c_str());
+
+    m_pFile = fopen(m_strFilename.c_str(), "a+b");
+
+    if (nullptr == m_pFile) return false;
+
+    if (0 != OTDB_SEEK(m_pFile, 0, SEEK_END)) return false;
+
+    const int64_t lSize = OTDB_TELL(m_pFile);
+    m_lFileSize = Replay();
+
+    if (m_lFileSize < lSize) {
+        otErr << "StorageLog::" << __FUNCTION__ << ": Discarding "
+              << (lSize - m_lFileSize)
+              << " bytes after the last complete record in " << m_strFilename
+              << "\n";
+
+        if ((0 != OTDB_TRUNCATE(m_pFile, m_lFileSize)) || !SyncFile(m_pFile))
+            return false;
+    }
+
+    otInfo << "StorageLog::" << __FUNCTION__ << ": Loaded " << m_mapIndex.size()
+           << " keys from " << m_strFilename << "\n";
+
+    if ((OTDB_LOG_COMPACT_MIN_SIZE <= m_lFileSize) &&
+        (m_lFileSize > 2 * m_lLiveBytes))
+        Compact();
+
+    return true;
+}
+
+int64_t StorageLog::Replay()
+{
+    struct Entry
+    {
+        uint8_t cType;
+        std::string strKey;
+        int64_t lValueOffset;
+        int64_t lValueLength;
+    };
+
+    if (0 != OTDB_SEEK(m_pFile, 0, SEEK_END)) return 0;
+
+    const int64_t lSize = OTDB_TELL(m_pFile);
+    int64_t lOffset = 0;
+    std::string strHeader(OTDB_LOG_HEADER_SIZE, '\0');
+    std::string strOps, strChecksum(4, '\0');
+    std::vector<Entry> vecEntries;
+
+    if (0 != OTDB_SEEK(m_pFile, 0, SEEK_SET)) return 0;
+
+    while (OTDB_LOG_HEADER_SIZE ==
+           fread(&strHeader[0], 1, OTDB_LOG_HEADER_SIZE, m_pFile)) {
+        if (0 != strHeader.compare(0, 4, OTDB_LOG_MAGIC)) break;
+
+        const uint64_t lCount = GetUint(&strHeader[4], 4);
+        const uint64_t lLength = GetUint(&strHeader[8], 8);
+        const int64_t lRecordSize = OTDB_LOG_HEADER_SIZE + lLength + 4;
+
+        // (A torn header could claim anything.)
+        if ((lLength > static_cast<uint64_t>(lSize)) ||
+            (lOffset + lRecordSize > lSize))
+            break;
+
+        strOps.resize(lLength);
+
+        if ((lLength != fread(&strOps[0], 1, lLength, m_pFile)) ||
+            (4 != fread(&strChecksum[0], 1, 4, m_pFile)) ||
+            (GetUint(strChecksum.data(), 4) != Checksum(strOps)))
+            break;
+
+        // The checksum matched, but check the operations all fit before
+        // applying any of them.
+        //
+        bool bValid = true;
+        uint64_t lPos = 0;
+        vecEntries.clear();
+
+        for (uint64_t i = 0; bValid && (i < lCount); ++i) {
+            if (lPos + OTDB_LOG_OP_HEADER_SIZE > lLength) {
+                bValid = false;
+                break;
+            }
+
+            Entry theEntry;
+            theEntry.cType = static_cast<uint8_t>(strOps[lPos]);
+            const uint64_t lKeyLength = GetUint(&strOps[lPos + 1], 4);
+            const uint64_t lValueLength = GetUint(&strOps[lPos + 5], 8);
+            lPos += OTDB_LOG_OP_HEADER_SIZE;
+
+            if ((lKeyLength > lLength - lPos) ||
+                (lValueLength > lLength - lPos - lKeyLength)) {
+                bValid = false;
+                break;
+            }
+
+            theEntry.strKey = strOps.substr(lPos, lKeyLength);
+            lPos += lKeyLength;
+            theEntry.lValueOffset = lOffset + OTDB_LOG_HEADER_SIZE + lPos;
+            theEntry.lValueLength = lValueLength;
+            lPos += lValueLength;
+
+            vecEntries.push_back(theEntry);
+        }
+
+        if (!bValid || (lPos != lLength)) break;
+
+        for (auto& it : vecEntries)
+            Apply(it.cType, it.strKey, it.lValueOffset, it.lValueLength);
+
+        lOffset += lRecordSize;
+    }
+
+    return lOffset;
+}
+
+int64_t StorageLog::WriteRecord(FILE* pFile, const vectorOfOperations& vecOps,
+                                int64_t lOffset,
+                                std::vector<int64_t>& vecValueOffsets)
+{
+    std::string strOps;
+    vecValueOffsets.clear();
+
+    for (auto& it : vecOps) {
+        strOps.push_back(static_cast<char>(it.cType));
+        PutUint(strOps, it.strKey.size(), 4);
+        PutUint(strOps, it.strValue.size(), 8);
+        strOps += it.strKey;
+        vecValueOffsets.push_back(lOffset + OTDB_LOG_HEADER_SIZE +
+                                  strOps.size());
+        strOps += it.strValue;
+    }
+
+    std::string strRecord(OTDB_LOG_MAGIC);
+    PutUint(strRecord, vecOps.size(), 4);
+    PutUint(strRecord, strOps.size(), 8);
+    strRecord += strOps;
+    PutUint(strRecord, Checksum(strOps), 4);
+
+    if (strRecord.size() != fwrite(strRecord.data(), 1, strRecord.size(),
+                                   pFile))
+        return -1;
+
+    return static_cast<int64_t>(strRecord.size());
+}
+
+// Appends one record (and syncs it, if bSync), then updates the index.
+//
+bool StorageLog::Write(const vectorOfOperations& vecOps, bool bSync)
+{
+    if (nullptr == m_pFile) return false;
+
+    std::vector<int64_t> vecValueOffsets;
+
+    const int64_t lWritten =
+        (0 != OTDB_SEEK(m_pFile, 0, SEEK_END))
+            ? -1
+            : WriteRecord(m_pFile, vecOps, m_lFileSize, vecValueOffsets);
+
+    if ((0 > lWritten) || (0 != fflush(m_pFile)) ||
+        (bSync && (0 != OTDB_SYNC(m_pFile)))) {
+        otErr << "StorageLog::" << __FUNCTION__ << ": Failed writing to "
+              << m_strFilename << "\n";
+        // Cut off whatever made it out, so the next record starts clean.
+        fflush(m_pFile);
+        OTDB_TRUNCATE(m_pFile, m_lFileSize);
+        return false;
+    }
+
+    m_lFileSize += lWritten;
+
+    for (size_t i = 0; i < vecOps.size(); ++i)
+        Apply(vecOps[i].cType, vecOps[i].strKey, vecValueOffsets[i],
+              vecOps[i].strValue.size());
+
+    if ((OTDB_LOG_COMPACT_MIN_SIZE <= m_lFileSize) &&
+        (m_lFileSize > 2 * m_lLiveBytes))
+        Compact();
+
+    return true;
+}
+
+void StorageLog::Apply(uint8_t cType, const std::string& strKey,
+                       int64_t lValueOffset, int64_t lValueLength)
+{
+    auto it = m_mapIndex.find(strKey);
+
+    if ((m_mapIndex.end() != it) && (OpAppend != cType)) {
+        for (auto& itSegment : it->second) m_lLiveBytes -= itSegment.second;
+
+        if (OpErase == cType) {
+            m_lLiveBytes -= strKey.size();
+            m_mapIndex.erase(it);
+            return;
+        }
+
+        it->second.clear();
+    }
+    else if (m_mapIndex.end() == it) {
+        if (OpErase == cType) return;
+
+        it = m_mapIndex.insert(std::make_pair(strKey, vectorOfSegments()))
+                 .first;
+        m_lLiveBytes += strKey.size();
+    }
+
+    it->second.push_back(std::make_pair(lValueOffset, lValueLength));
+    m_lLiveBytes += lValueLength;
+}
+
+bool StorageLog::ReadValue(const vectorOfSegments& vecSegments,
+                           std::string& strValue)
+{
+    strValue.clear();
+
+    for (auto& it : vecSegments) {
+        const size_t nStart = strValue.size();
+        strValue.resize(nStart + it.second);
+
+        if ((0 != OTDB_SEEK(m_pFile, it.first, SEEK_SET)) ||
+            (static_cast<size_t>(it.second) !=
+             fread(&strValue[nStart], 1, it.second, m_pFile))) {
+            otErr << "StorageLog::" << __FUNCTION__ << ": Failed reading from "
+                  << m_strFilename << "\n";
+            strValue.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Rewrites the live values into a new file, then swaps it in.
+//
+bool StorageLog::Compact()
+{
+    const std::string strCompact(m_strFilename + ".compact");
+    FILE* pCompact = fopen(strCompact.c_str(), "wb");
+
+    if (nullptr == pCompact) {
+        otErr << "StorageLog::" << __FUNCTION__ << ": Unable to create "
+              << strCompact << "\n";
+        return false;
+    }
+
+    std::unordered_map<std::string, vectorOfSegments> mapIndex;
+    vectorOfOperations vecOps;
+    std::vector<int64_t> vecValueOffsets;
+    int64_t lOpsSize = 0, lOffset = 0, lLiveBytes = 0;
+
+    auto flush = [&]() -> bool {
+        if (vecOps.empty()) return true;
+
+        const int64_t lWritten =
+            WriteRecord(pCompact, vecOps, lOffset, vecValueOffsets);
+
+        if (0 > lWritten) return false;
+
+        for (size_t i = 0; i < vecOps.size(); ++i) {
+            const int64_t lLength = vecOps[i].strValue.size();
+            mapIndex[vecOps[i].strKey].assign(
+                1, std::make_pair(vecValueOffsets[i], lLength));
+            lLiveBytes += vecOps[i].strKey.size() + lLength;
+        }
+
+        lOffset += lWritten;
+        lOpsSize = 0;
+        vecOps.clear();
+
+        return true;
+    };
+
+    bool bSuccess = true;
+
+    for (auto& it : m_mapIndex) {
+        Operation theOp;
+        theOp.cType = OpStore;
+        theOp.strKey = it.first;
+
+        if (!ReadValue(it.second, theOp.strValue)) {
+            bSuccess = false;
+            break;
+        }
+
+        lOpsSize += theOp.strKey.size() + theOp.strValue.size();
+        vecOps.push_back(theOp);
+
+        if ((OTDB_LOG_COMPACT_RECORD_SIZE <= lOpsSize) && !flush()) {
+            bSuccess = false;
+            break;
+        }
+    }
+
+    bSuccess = bSuccess && flush() && SyncFile(pCompact);
+    fclose(pCompact);
+
+    if (!bSuccess) {
+        otErr << "StorageLog::" << __FUNCTION__ << ": Failed writing "
+              << strCompact << "\n";
+        remove(strCompact.c_str());
+        return false;
+    }
+
+    fclose(m_pFile);
+    m_pFile = nullptr;
+
+    if (!RenameFile(strCompact, m_strFilename)) {
+        remove(strCompact.c_str());
+        m_pFile = fopen(m_strFilename.c_str(), "a+b");
+        OT_ASSERT(nullptr != m_pFile);
+        return false;
+    }
+
+    SyncFolder(m_strFolder);
+
+    m_pFile = fopen(m_strFilename.c_str(), "a+b");
+    OT_ASSERT(nullptr != m_pFile);
+
+    otInfo << "StorageLog::" << __FUNCTION__ << ": Compacted " << m_strFilename
+           << " from " << m_lFileSize << " to " << lOffset << " bytes.\n";
+
+    m_mapIndex.swap(mapIndex);
+    m_lFileSize = lOffset;
+    m_lLiveBytes = lLiveBytes;
+
+    return true;
+}
+
+bool StorageLog::Lookup(const std::string& strKey, std::string* pstrValue,
+                        bool& bErased)
+{
+    bErased = false;
+
+    auto itPending = m_mapPending.find(strKey);
+    const Pending* pPending =
+        (m_mapPending.end() == itPending) ? nullptr : &itPending->second;
+
+    if ((nullptr != pPending) && pPending->bErased) {
+        bErased = true;
+        return false;
+    }
+
+    auto it = m_mapIndex.find(strKey);
+
+    if ((nullptr != pPending) &&
+        (pPending->bReplaced || (m_mapIndex.end() == it))) {
+        if (nullptr != pstrValue) *pstrValue = pPending->strValue;
+        return true;
+    }
+
+    if (m_mapIndex.end() == it) return false;
+
+    if (nullptr != pstrValue) {
+        if (!ReadValue(it->second, *pstrValue)) return false;
+
+        if (nullptr != pPending) *pstrValue += pPending->strValue;
+    }
+
+    return true;
+}
+
+// Writes the operation now, or adds it to the open batch.
+//
+bool StorageLog::Submit(Operation theOp)
+{
+    if (!m_bBatchOpen) return Write(vectorOfOperations(1, theOp), false);
+
+    auto it = m_mapPending.find(theOp.strKey);
+
+    if (m_mapPending.end() == it) {
+        Pending thePending;
+        thePending.bErased = false;
+        thePending.bReplaced = false;
+        it = m_mapPending.insert(std::make_pair(theOp.strKey, thePending))
+                 .first;
+    }
+
+    Pending& thePending = it->second;
+
+    switch (theOp.cType) {
+    case OpStore:
+        thePending.bErased = false;
+        thePending.bReplaced = true;
+        thePending.strValue = theOp.strValue;
+        break;
+    case OpAppend:
+        if (thePending.bErased) {
+            thePending.bErased = false;
+            thePending.bReplaced = true;
+            thePending.strValue.clear();
+        }
+        thePending.strValue += theOp.strValue;
+        break;
+    case OpErase:
+        thePending.bErased = true;
+        thePending.bReplaced = false;
+        thePending.strValue.clear();
+        break;
+    }
+
+    m_vecBatch.push_back(theOp);
+
+    return true;
+}
+
+void StorageLog::RemoveLegacyFiles()
+{
+    for (auto& it : m_vecLegacyErased) remove(it.c_str());
+
+    m_vecLegacyErased.clear();
+}
+
+void StorageLog::onBeginBatch()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    m_bBatchOpen = true;
+}
+
+bool StorageLog::onCommitBatch()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    const bool bSuccess =
+        m_vecBatch.empty() || Write(m_vecBatch, GetSyncWrites());
+
+    if (bSuccess)
+        RemoveLegacyFiles();
+    else
+        m_vecLegacyErased.clear();
+
+    m_bBatchOpen = false;
+    m_vecBatch.clear();
+    m_mapPending.clear();
+
+    return bSuccess;
+}
+
+bool StorageLog::Exists(std::string strFolder, std::string oneStr,
+                        std::string twoStr, std::string threeStr)
+{
+    std::string strKey;
+
+    if (!FormKey(strKey, strFolder, oneStr, twoStr, threeStr)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        bool bErased = false;
+
+        if (Lookup(strKey, nullptr, bErased)) return true;
+        if (bErased) return false;
+    }
+
+    // Not written here yet, but it may still be on the filesystem.
+    return StorageFS::Exists(strFolder, oneStr, twoStr, threeStr);
+}
+
+bool StorageLog::onStorePackedBuffer(PackedBuffer& theBuffer,
+                                     std::string strFolder, std::string oneStr,
+                                     std::string twoStr, std::string threeStr)
+{
+    std::ostringstream ostr(std::ios::out | std::ios::binary);
+
+    if (!theBuffer.WriteToOStream(ostr)) {
+        otErr << "StorageLog::" << __FUNCTION__
+              << ": Failed packing the buffer.\n";
+        return false;
+    }
+
+    std::string strValue(ostr.str());
+
+    return onStorePlainString(strValue, strFolder, oneStr, twoStr, threeStr);
+}
+
+bool StorageLog::onQueryPackedBuffer(PackedBuffer& theBuffer,
+                                     std::string strFolder, std::string oneStr,
+                                     std::string twoStr, std::string threeStr)
+{
+    std::string strKey, strValue;
+
+    if (!FormKey(strKey, strFolder, oneStr, twoStr, threeStr)) return false;
+
+    bool bFound = false, bErased = false;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        bFound = Lookup(strKey, &strValue, bErased);
+    }
+
+    if (!bFound)
+        return !bErased && StorageFS::onQueryPackedBuffer(
+                               theBuffer, strFolder, oneStr, twoStr, threeStr);
+
+    std::istringstream istr(strValue, std::ios::in | std::ios::binary);
+
+    return theBuffer.ReadFromIStream(istr, strValue.size());
+}
+
+bool StorageLog::onStorePlainString(std::string& theBuffer,
+                                    std::string strFolder, std::string oneStr,
+                                    std::string twoStr, std::string threeStr)
+{
+    Operation theOp;
+    theOp.cType = OpStore;
+    theOp.strValue = theBuffer;
+
+    if (!FormKey(theOp.strKey, strFolder, oneStr, twoStr, threeStr))
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    return Submit(theOp);
+}
+
+bool StorageLog::onQueryPlainString(std::string& theBuffer,
+                                    std::string strFolder, std::string oneStr,
+                                    std::string twoStr, std::string threeStr)
+{
+    std::string strKey;
+
+    if (!FormKey(strKey, strFolder, oneStr, twoStr, threeStr)) return false;
+
+    bool bFound = false, bErased = false;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        bFound = Lookup(strKey, &theBuffer, bErased);
+    }
+
+    if (!bFound)
+        return !bErased && StorageFS::onQueryPlainString(
+                               theBuffer, strFolder, oneStr, twoStr, threeStr);
+
+    return !theBuffer.empty();
+}
+
+bool StorageLog::onReadPlainString(std::string& theBuffer,
+                                   std::string strFolder, std::string oneStr,
+                                   std::string twoStr, std::string threeStr)
+{
+    std::string strKey;
+
+    if (!FormKey(strKey, strFolder, oneStr, twoStr, threeStr)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        bool bErased = false;
+
+        theBuffer.clear();
+
+        if (Lookup(strKey, &theBuffer, bErased)) return true;
+
+        if (bErased) return true;
+
+        // In the log, but the record couldn't be read back.
+        if (m_mapIndex.end() != m_mapIndex.find(strKey)) {
+            otErr << "StorageLog::" << __FUNCTION__ << ": Error reading "
+                  << strKey << " from the log.\n";
+            return false;
+        }
+    }
+
+    return StorageFS::onReadPlainString(theBuffer, strFolder, oneStr, twoStr,
+                                        threeStr);
+}
+
+// Call with m_lock held.
+//
+bool StorageLog::FormAppend(Operation& theOp, const std::string& theBuffer,
+                            const std::string& strFolder,
+                            const std::string& oneStr,
+                            const std::string& twoStr,
+                            const std::string& threeStr)
+{
+    theOp.cType = OpAppend;
+    theOp.strValue = theBuffer;
+
+    if (!FormKey(theOp.strKey, strFolder, oneStr, twoStr, threeStr))
+        return false;
+
+    bool bErased = false;
+
+    if (!Lookup(theOp.strKey, nullptr, bErased) && !bErased) {
+        // Only on the filesystem so far? Then bring it over first.
+        std::string strPath, strExisting;
+
+        if (0 < StorageFS::FormPathString(strPath, strFolder, oneStr, twoStr,
+                                          threeStr)) {
+            if (!StorageFS::onQueryPlainString(strExisting, strFolder, oneStr,
+                                               twoStr, threeStr))
+                return false;
+
+            theOp.cType = OpStore;
+            theOp.strValue = strExisting + theBuffer;
+        }
+    }
+
+    return true;
+}
+
+bool StorageLog::onAppendPlainString(std::string& theBuffer,
+                                     std::string strFolder, std::string oneStr,
+                                     std::string twoStr, std::string threeStr)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    Operation theOp;
+
+    if (!FormAppend(theOp, theBuffer, strFolder, oneStr, twoStr, threeStr))
+        return false;
+
+    return Submit(theOp);
+}
+
+// Written as a record of its own, ahead of the open batch. (Unless the batch
+// has already touched the key: then the append has to follow it, so it goes
+// out with the batch.)
+//
+bool StorageLog::onSyncAppendPlainString(std::string& theBuffer,
+                                         std::string strFolder,
+                                         std::string oneStr, std::string twoStr,
+                                         std::string threeStr)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    Operation theOp;
+
+    if (!FormAppend(theOp, theBuffer, strFolder, oneStr, twoStr, threeStr))
+        return false;
+
+    if (m_bBatchOpen && (m_mapPending.end() != m_mapPending.find(theOp.strKey)))
+        return Submit(theOp);
+
+    return Write(vectorOfOperations(1, theOp), true);
+}
+
+bool StorageLog::onEraseValueByKey(std::string strFolder, std::string oneStr,
+                                   std::string twoStr, std::string threeStr)
+{
+    Operation theOp;
+    theOp.cType = OpErase;
+
+    if (!FormKey(theOp.strKey, strFolder, oneStr, twoStr, threeStr))
+        return false;
+
+    std::string strPath;
+    const bool bLegacy = (0 < StorageFS::FormPathString(strPath, strFolder,
+                                                        oneStr, twoStr,
+                                                        threeStr));
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    bool bErased = false;
+
+    // The filesystem copy goes once the erase is committed.
+    if (bLegacy) m_vecLegacyErased.push_back(strPath);
+
+    const bool bSuccess =
+        !Lookup(theOp.strKey, nullptr, bErased) || Submit(theOp);
+
+    if (!m_bBatchOpen) {
+        if (bSuccess)
+            RemoveLegacyFiles();
+        else
+            m_vecLegacyErased.clear();
+    }
+
+    return bSuccess;
+}
+
 } // namespace OTDB
 
 } // namespace opentxs
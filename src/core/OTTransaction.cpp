@@ -3124,6 +3124,7 @@ transfer, deposit, withdrawal, trade, etc.
 OTTransaction::OTTransaction()
     : OTTransactionType()
     , m_pParent(nullptr)
+    , m_pIndexedBy(nullptr)
     , m_bIsAbbreviated(false)
     , m_lAbbrevAmount(0)
     , m_lDisplayAmount(0)
@@ -3149,6 +3150,7 @@ OTTransaction::OTTransaction(const Ledger& theOwner)
     : OTTransactionType(theOwner.GetNymID(), theOwner.GetPurportedAccountID(),
                         theOwner.GetPurportedNotaryID())
     , m_pParent(&theOwner)
+    , m_pIndexedBy(nullptr)
     , m_bIsAbbreviated(false)
     , m_lAbbrevAmount(0)
     , m_lDisplayAmount(0)
@@ -3178,6 +3180,7 @@ OTTransaction::OTTransaction(const Identifier& theNymID,
                              const Identifier& theNotaryID)
     : OTTransactionType(theNymID, theAccountID, theNotaryID)
     , m_pParent(nullptr)
+    , m_pIndexedBy(nullptr)
     , m_bIsAbbreviated(false)
     , m_lAbbrevAmount(0)
     , m_lDisplayAmount(0)
@@ -3203,6 +3206,7 @@ OTTransaction::OTTransaction(const Identifier& theNymID,
                              int64_t lTransactionNum)
     : OTTransactionType(theNymID, theAccountID, theNotaryID, lTransactionNum)
     , m_pParent(nullptr)
+    , m_pIndexedBy(nullptr)
     , m_bIsAbbreviated(false)
     , m_lAbbrevAmount(0)
     , m_lDisplayAmount(0)
@@ -3254,6 +3258,7 @@ OTTransaction::OTTransaction(
     const int64_t& lRequestNum, bool bReplyTransSuccess, NumList* pNumList)
     : OTTransactionType(theNymID, theAccountID, theNotaryID, lTransactionNum)
     , m_pParent(nullptr)
+    , m_pIndexedBy(nullptr)
     , m_bIsAbbreviated(true)
     , m_lAbbrevAmount(lAdjustment)
     , m_lDisplayAmount(lDisplayValue)
@@ -3387,6 +3392,16 @@ OTTransaction* OTTransaction::GenerateTransaction(
     return pTransaction;
 }
 
+void OTTransaction::SetReferenceToNum(int64_t lTransactionNum)
+{
+    const int64_t lOldNum = GetReferenceToNum();
+
+    OTTransactionType::SetReferenceToNum(lTransactionNum);
+
+    if ((nullptr != m_pIndexedBy) && (lOldNum != lTransactionNum))
+        m_pIndexedBy->ReindexReferenceTo(*this, lOldNum);
+}
+
 OTTransaction::~OTTransaction()
 {
     while (!m_listItems.empty()) {
@@ -3404,7 +3419,16 @@ void OTTransaction::Release()
         delete pItem;
     }
 
+    const int64_t lOldNum = GetReferenceToNum();
+
+    // This resets the in-reference-to number directly, without going through
+    // SetReferenceToNum.
     OTTransactionType::Release();
+
+    // Still in a ledger (say, being reloaded), so it has to move to its new
+    // number in that ledger's index, the same as SetReferenceToNum does.
+    if ((nullptr != m_pIndexedBy) && (lOldNum != GetReferenceToNum()))
+        m_pIndexedBy->ReindexReferenceTo(*this, lOldNum);
 }
 
 // You have to allocate the item on the heap and then pass it in as a reference.
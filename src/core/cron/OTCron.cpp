@@ -42,11 +42,21 @@
 #include <opentxs/core/util/OTFolders.hpp>
 #include <opentxs/core/util/Tag.hpp>
 #include <opentxs/core/Log.hpp>
+#include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/trade/OTMarket.hpp>
 
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <sstream>
+#include <vector>
+
+#define CRON_FILENAME "OT-CRON.crn" // todo stop hardcoding filenames.
+#define CRON_ITEM_FOLDER "current"  // cron/current/TRANSACTION_NUM.crn
+
+// Even with nothing due, Cron still wakes up this often.
+#define CRON_MAX_TIMEOUT_MS 3600000
 
 // Note: these are only code defaults -- the values are actually loaded from
 // ~/.ot/server.cfg.
@@ -65,6 +75,19 @@ int32_t OTCron::__cron_max_items_per_nym = 10; // The maximum number of cron
                                                // items any given Nym can have
                                                // active at the same time.
 
+int32_t OTCron::__cron_journal_max_records = 1000; // The number of journal
+                                                   // records before Cron saves
+                                                   // its file in full again.
+
+int32_t OTCron::__cron_verification_cache_size = 1000; // The number of Nyms,
+                                                       // accounts and inboxes
+                                                       // kept verified between
+                                                       // settlements.
+
+int32_t OTCron::__cron_compression_level = 1; // The zlib level for the items
+                                              // armored into the cron and
+                                              // market files. (Z_BEST_SPEED)
+
 Timer OTCron::tCron(true);
 
 // Make sure Server Nym is set on this cron object before loading or saving,
@@ -73,7 +96,7 @@ Timer OTCron::tCron(true);
 bool OTCron::LoadCron()
 {
     const char* szFoldername = OTFolders::Cron().Get();
-    const char* szFilename = "OT-CRON.crn"; // todo stop hardcoding filenames.
+    const char* szFilename = CRON_FILENAME;
 
     OT_ASSERT(nullptr != GetServerNym());
 
@@ -81,16 +104,87 @@ bool OTCron::LoadCron()
 
     if (bSuccess) bSuccess = VerifySignature(*(GetServerNym()));
 
+    // Whatever changed since the cron file was last saved in full.
+    if (bSuccess) bSuccess = LoadJournal();
+
     return bSuccess;
 }
 
+// Saving the entire cron file means re-serializing every cron item, so
+// normally we only append what changed since the last save: changed items
+// are each written to their own file, and the journal records which ones,
+// along with removals and transaction numbers added to or used from Cron.
+// Once the journal gets long enough, CompactCron() saves it all in full.
+//
 bool OTCron::SaveCron()
 {
     const char* szFoldername = OTFolders::Cron().Get();
-    const char* szFilename = "OT-CRON.crn"; // todo stop hardcoding filenames.
+    const char* szFilename = CRON_FILENAME;
+
+    OT_ASSERT(nullptr != GetServerNym());
+
+    if ((m_nJournalRecords >= OTCron::GetCronJournalMaxRecords()) ||
+        !OTDB::Exists(szFoldername, szFilename))
+        return CompactCron();
+
+    std::string strRecords;
+    int32_t nRecords = 0;
+
+    // The item is saved BEFORE the journal refers to it.
+    for (auto& it : m_mapChangedItems) {
+        OTCronItem* pItem = GetItemByOfficialNum(it.first);
+
+        if (nullptr == pItem) continue; // Already removed.
+
+        const String strItem(*pItem);
+        const std::string str_Filename = formatLong(it.first) + ".crn";
+
+        if (!OTDB::StorePlainString(strItem.Get(), szFoldername,
+                                    CRON_ITEM_FOLDER, str_Filename)) {
+            otErr << __FUNCTION__ << ": Error saving cron item: "
+                  << szFoldername << Log::PathSeparator() << CRON_ITEM_FOLDER
+                  << Log::PathSeparator() << str_Filename << "\n";
+            return false;
+        }
+        m_setJournaledItems.insert(it.first);
+
+        strRecords += "item " + formatLong(it.first) + " " +
+                      formatLong(OTTimeGetSecondsFromTime(it.second)) + "\n";
+        nRecords++;
+    }
+
+    strRecords += m_strJournalPending;
+    nRecords += m_nJournalPending;
+
+    if (0 == nRecords) return true; // Nothing changed.
+
+    const std::string strJournal = JournalFilename(m_lJournalGeneration);
+
+    if (!OTDB::AppendPlainString(strRecords, szFoldername, strJournal)) {
+        otErr << __FUNCTION__ << ": Error appending to cron journal:\n"
+              << szFoldername << Log::PathSeparator() << strJournal << "\n";
+        return false;
+    }
+
+    m_mapChangedItems.clear();
+    m_strJournalPending.clear();
+    m_nJournalPending = 0;
+    m_nJournalRecords += nRecords;
+
+    return true;
+}
+
+bool OTCron::CompactCron()
+{
+    const char* szFoldername = OTFolders::Cron().Get();
+    const char* szFilename = CRON_FILENAME;
 
     OT_ASSERT(nullptr != GetServerNym());
 
+    // The new cron file starts a new journal. Until it's safely saved, the
+    // old cron file and journal are still the ones that get loaded.
+    const int64_t lOldGeneration = m_lJournalGeneration++;
+
     ReleaseSignatures();
 
     // Sign it, save it internally to string, and then save that out to the
@@ -99,10 +193,192 @@ bool OTCron::SaveCron()
         !SaveContract(szFoldername, szFilename)) {
         otErr << "Error saving main Cronfile:\n" << szFoldername
               << Log::PathSeparator() << szFilename << "\n";
+        m_lJournalGeneration = lOldGeneration;
         return false;
     }
-    else
-        return true;
+
+    // Everything in the old journal is in the cron file now.
+    for (auto& lTransactionNum : m_setJournaledItems) {
+        const std::string str_Filename = formatLong(lTransactionNum) + ".crn";
+
+        if (OTDB::Exists(szFoldername, CRON_ITEM_FOLDER, str_Filename))
+            OTDB::EraseValueByKey(szFoldername, CRON_ITEM_FOLDER,
+                                  str_Filename);
+    }
+
+    const std::string strJournal = JournalFilename(lOldGeneration);
+
+    if (OTDB::Exists(szFoldername, strJournal))
+        OTDB::EraseValueByKey(szFoldername, strJournal);
+
+    m_setJournaledItems.clear();
+    m_mapChangedItems.clear();
+    m_strJournalPending.clear();
+    m_nJournalPending = 0;
+    m_nJournalRecords = 0;
+
+    return true;
+}
+
+// Each journal record is one newline-terminated line: "item", "remove",
+// "num" or "used", followed by a transaction number (and for "item", the
+// date it was added to Cron, in seconds, or zero if it already was.) A crash
+// while appending can only leave a partial record at the end, which is
+// ignored.
+//
+bool OTCron::LoadJournal()
+{
+    const char* szFoldername = OTFolders::Cron().Get();
+    const std::string strJournal = JournalFilename(m_lJournalGeneration);
+
+    if (!OTDB::Exists(szFoldername, strJournal)) return true;
+
+    std::istringstream journal(
+        OTDB::QueryPlainString(szFoldername, strJournal));
+    std::string strLine;
+
+    while (std::getline(journal, strLine) && !journal.eof()) {
+        std::istringstream record(strLine);
+        std::string strType;
+        int64_t lNumber = 0, lDateAdded = 0;
+
+        if (!(record >> strType >> lNumber)) {
+            otErr << __FUNCTION__ << ": Skipping bad journal record: "
+                  << strLine << "\n";
+            continue;
+        }
+        m_nJournalRecords++;
+
+        if ("num" == strType) {
+            m_listTransactionNumbers.push_back(lNumber);
+        }
+        else if ("used" == strType) {
+            m_listTransactionNumbers.remove(lNumber);
+        }
+        else if ("remove" == strType) {
+            // The removal hooks already ran before this was recorded.
+            ForgetItem(lNumber);
+            m_setJournaledItems.insert(lNumber); // Its file may still exist.
+        }
+        else if ("item" == strType) {
+            record >> lDateAdded;
+            m_setJournaledItems.insert(lNumber);
+
+            const std::string str_Filename = formatLong(lNumber) + ".crn";
+
+            std::unique_ptr<OTCronItem> pItem;
+
+            if (OTDB::Exists(szFoldername, CRON_ITEM_FOLDER, str_Filename)) {
+                const String strItem(OTDB::QueryPlainString(
+                    szFoldername, CRON_ITEM_FOLDER, str_Filename));
+                pItem.reset(OTCronItem::NewCronItem(strItem));
+            }
+
+            if ((nullptr == pItem) ||
+                (pItem->GetTransactionNum() != lNumber) ||
+                !pItem->VerifySignature(*m_pServerNym)) {
+                otErr << __FUNCTION__ << ": ERROR loading or verifying cron "
+                                         "item from journal: " << lNumber
+                      << " (Keeping the previous version, if any.)\n";
+                continue;
+            }
+
+            // Newer than the version from the cron file, so it takes the
+            // place of that one, on the same date.
+            auto it_multimap = FindItemOnMultimap(lNumber);
+
+            time64_t tDateAdded = OTTimeGetTimeFromSeconds(lDateAdded);
+            if (m_multimapCronItems.end() != it_multimap)
+                tDateAdded = it_multimap->first;
+
+            ForgetItem(lNumber);
+
+            if (AddCronItem(*pItem, nullptr, false, tDateAdded))
+                pItem.release(); // Cron owns it now.
+            else
+                otErr << __FUNCTION__ << ": Unable to add cron item from "
+                                         "journal to cron list: " << lNumber
+                      << "\n";
+        }
+        else {
+            otErr << __FUNCTION__ << ": Skipping bad journal record: "
+                  << strLine << "\n";
+        }
+    }
+
+    return true;
+}
+
+void OTCron::AddJournalRecord(const char* szType, int64_t lNumber)
+{
+    m_strJournalPending += std::string(szType) + " " + formatLong(lNumber) +
+                           "\n";
+    m_nJournalPending++;
+}
+
+std::string OTCron::JournalFilename(int64_t lGeneration) const
+{
+    return std::string(CRON_FILENAME) + "." + formatLong(lGeneration) + ".jrn";
+}
+
+void OTCron::SetItemChanged(const OTCronItem& theItem)
+{
+    // Doesn't replace the date, if the item was just added.
+    m_mapChangedItems.insert(std::pair<int64_t, time64_t>(
+        theItem.GetTransactionNum(), OT_TIME_ZERO));
+
+    // Whatever changed may also change when it's due.
+    ScheduleItem(theItem);
+}
+
+void OTCron::ForgetItem(int64_t lTransactionNum)
+{
+    auto it_map = FindItemOnMap(lTransactionNum);
+
+    if (m_mapCronItems.end() == it_map) return;
+
+    OTCronItem* pItem = it_map->second;
+
+    auto it_multimap = FindItemOnMultimap(lTransactionNum);
+    OT_ASSERT(m_multimapCronItems.end() != it_multimap);
+
+    m_mapCronItems.erase(it_map);
+    m_multimapCronItems.erase(it_multimap);
+    UnscheduleItem(lTransactionNum);
+
+    delete pItem;
+}
+
+void OTCron::ScheduleItem(const OTCronItem& theItem)
+{
+    auto it = m_mapDueDates.find(theItem.GetTransactionNum());
+
+    // Not (yet) on Cron.
+    if (m_mapDueDates.end() == it) return;
+
+    ScheduleItem(theItem, std::get<1>(it->second));
+}
+
+void OTCron::ScheduleItem(const OTCronItem& theItem, time64_t tDateAdded)
+{
+    const int64_t lTransactionNum = theItem.GetTransactionNum();
+
+    UnscheduleItem(lTransactionNum);
+
+    const cronDueDate theDueDate(theItem.GetCronDueDate(), tDateAdded,
+                                 lTransactionNum);
+    m_mapDueDates[lTransactionNum] = theDueDate;
+    m_setDueDates.insert(theDueDate);
+}
+
+void OTCron::UnscheduleItem(int64_t lTransactionNum)
+{
+    auto it = m_mapDueDates.find(lTransactionNum);
+
+    if (m_mapDueDates.end() == it) return;
+
+    m_setDueDates.erase(it->second);
+    m_mapDueDates.erase(it);
 }
 
 // Loops through ALL markets, and calls pMarket->GetNym_OfferList(NYM_ID,
@@ -237,13 +513,11 @@ bool OTCron::GetMarketList(OTASCIIArmor& ascOutput, int32_t& nMarketCount)
 
         pMarketData->last_sale_date = pMarket->GetLastSaleDate();
 
-        const mapOfOffers::size_type theBidCount = pMarket->GetBidCount();
-        const mapOfOffers::size_type theAskCount = pMarket->GetAskCount();
+        const std::size_t theBidCount = pMarket->GetBidCount();
+        const std::size_t theAskCount = pMarket->GetAskCount();
 
-        pMarketData->number_bids =
-            to_string<mapOfOffers::size_type>(theBidCount);
-        pMarketData->number_asks =
-            to_string<mapOfOffers::size_type>(theAskCount);
+        pMarketData->number_bids = to_string<std::size_t>(theBidCount);
+        pMarketData->number_asks = to_string<std::size_t>(theAskCount);
 
         // In the past 24 hours.
         // (I'm not collecting this data yet, (maybe never), so these values
@@ -325,6 +599,7 @@ int32_t OTCron::GetTransactionCount() const
 void OTCron::AddTransactionNumber(const int64_t& lTransactionNum)
 {
     m_listTransactionNumbers.push_back(lTransactionNum);
+    AddJournalRecord("num", lTransactionNum);
 }
 
 // Once this starts returning 0, OTCron can no longer process trades and
@@ -336,6 +611,7 @@ int64_t OTCron::GetNextTransactionNumber()
     int64_t lTransactionNum = m_listTransactionNumbers.front();
 
     m_listTransactionNumbers.pop_front();
+    AddJournalRecord("used", lTransactionNum);
 
     return lTransactionNum;
 }
@@ -365,6 +641,11 @@ int32_t OTCron::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
 
         m_NOTARY_ID.SetString(strNotaryID);
 
+        // Older cron files have no journal attribute.
+        const String strGeneration(xml->getAttributeValue("journal"));
+        m_lJournalGeneration =
+            strGeneration.Exists() ? strGeneration.ToLong() : 0;
+
         otOut << "\n\nLoading OTCron for NotaryID: " << strNotaryID << "\n";
 
         nReturnVal = 1;
@@ -376,9 +657,9 @@ int32_t OTCron::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
         otWarn << "Transaction Number " << lTransactionNum
                << " available for Cron.\n";
 
-        AddTransactionNumber(lTransactionNum); // This doesn't save to disk.
-                                               // Make sure to save Cron when it
-                                               // changes.
+        // Already saved, so this doesn't go through AddTransactionNumber
+        // (which would journal it again.)
+        m_listTransactionNumbers.push_back(lTransactionNum);
 
         nReturnVal = 1;
     }
@@ -507,6 +788,7 @@ void OTCron::UpdateContents()
 
     tag.add_attribute("version", m_strVersion.Get());
     tag.add_attribute("notaryID", NOTARY_ID.Get());
+    tag.add_attribute("journal", formatLong(m_lJournalGeneration));
 
     // Save the Market entries (the markets themselves are saved in a markets
     // folder.)
@@ -532,6 +814,8 @@ void OTCron::UpdateContents()
     }
 
     // Save the Cron Items
+    OTASCIIArmor::CompressionScope theScope(OTCron::GetCronCompressionLevel());
+
     for (auto& it : m_multimapCronItems) {
         OTCronItem* pItem = it.second;
         OT_ASSERT(nullptr != pItem);
@@ -560,9 +844,31 @@ void OTCron::UpdateContents()
     m_xmlUnsigned.Concatenate("%s", str_result.c_str());
 }
 
+// The time left until the next round, in milliseconds. Rounds are never
+// closer together than GetCronMsBetweenProcess(), but if nothing is due by
+// then, Cron can wait until something is.
+//
 int64_t OTCron::computeTimeout()
 {
-    return OTCron::GetCronMsBetweenProcess() - tCron.getElapsedTimeInMilliSec();
+    const int64_t lTimeout =
+        OTCron::GetCronMsBetweenProcess() - tCron.getElapsedTimeInMilliSec();
+
+    if (!m_bIsActivated) return lTimeout;
+
+    // New items (such as an offer that may cross the market) are due as soon
+    // as they're added, so they only wait for the minimum spacing.
+    int64_t lUntilDue = CRON_MAX_TIMEOUT_MS;
+
+    if (!m_setDueDates.empty()) {
+        const time64_t tNextDue = std::get<0>(*m_setDueDates.begin());
+        const int64_t lSeconds =
+            OTTimeGetTimeInterval(tNextDue, OTTimeGetCurrentTime());
+
+        if (lSeconds < (CRON_MAX_TIMEOUT_MS / 1000))
+            lUntilDue = lSeconds * 1000;
+    }
+
+    return std::max(lTimeout, lUntilDue);
 }
 
 // Make sure to call this regularly so the CronItems get a chance to process and
@@ -596,11 +902,23 @@ void OTCron::ProcessCronItems()
     }
     bool bNeedToSave = false;
 
-    // loop through the cron items and tell each one to ProcessCron().
+    // Only the items that are due get processed. They are processed in the
+    // order they were added to Cron, same as if we looped through all of
+    // them.
+    const time64_t tNow = OTTimeGetCurrentTime();
+    std::vector<std::pair<time64_t, int64_t>> vecDueItems;
+
+    for (auto& it : m_setDueDates) {
+        if (std::get<0>(it) > tNow) break;
+
+        vecDueItems.push_back(std::make_pair(std::get<1>(it), std::get<2>(it)));
+    }
+    std::sort(vecDueItems.begin(), vecDueItems.end());
+
+    // Tell each one to ProcessCron().
     // If the item returns true, that means leave it on the list. Otherwise,
     // if it returns false, that means "it's done: remove it."
-    for (auto it = m_multimapCronItems.begin();
-         it != m_multimapCronItems.end();) {
+    for (auto& it : vecDueItems) {
         if (GetTransactionCount() <= nTwentyPercent) {
             otErr << "WARNING: Cron has fewer than 20 percent of its normal "
                      "transaction "
@@ -615,30 +933,65 @@ void OTCron::ProcessCronItems()
                      "SCHEDULED FOR THIS ROUND!!!\n\n";
             break;
         }
-        OTCronItem* pItem = it->second;
-        OT_ASSERT(nullptr != pItem);
+        OTCronItem* pItem = GetItemByOfficialNum(it.second);
+
+        if (nullptr == pItem) continue; // Removed while processing another.
+
         otInfo << "OTCron::" << __FUNCTION__
                << ": Processing item number: " << pItem->GetTransactionNum()
                << " \n";
 
-        if (pItem->ProcessCron()) {
-            it++;
+        // Everything this item writes (receipts, boxes, accounts) is
+        // committed together.
+        OTDB::BeginBatch();
+
+        const bool bKeepItem = pItem->ProcessCron();
+
+        // Whatever it settled against has been saved by now. (Or else it's
+        // dropped from the cache.)
+        m_VerificationCache.CheckIn();
+
+        if (bKeepItem) {
+            if (!OTDB::CommitBatch()) {
+                otErr << "OTCron::" << __FUNCTION__
+                      << ": Failed committing the writes for item number: "
+                      << pItem->GetTransactionNum()
+                      << ". SKIPPING THE REST OF THIS ROUND.\n";
+                break;
+            }
+            ScheduleItem(*pItem, it.first); // Whenever it's due next.
             continue;
         }
         pItem->HookRemovalFromCron(nullptr, GetNextTransactionNumber());
+
+        if (!OTDB::CommitBatch()) {
+            otErr << "OTCron::" << __FUNCTION__
+                  << ": Failed committing the removal of item number: "
+                  << pItem->GetTransactionNum()
+                  << ". SKIPPING THE REST OF THIS ROUND.\n";
+            break;
+        }
         otOut << "OTCron::" << __FUNCTION__
               << ": Removing cron item: " << pItem->GetTransactionNum() << "\n";
-        it = m_multimapCronItems.erase(it);
+        auto it_multimap = FindItemOnMultimap(pItem->GetTransactionNum());
+        OT_ASSERT(m_multimapCronItems.end() != it_multimap);
+        m_multimapCronItems.erase(it_multimap);
         auto it_map = FindItemOnMap(pItem->GetTransactionNum());
         OT_ASSERT(m_mapCronItems.end() != it_map);
         m_mapCronItems.erase(it_map);
+        UnscheduleItem(pItem->GetTransactionNum());
+
+        m_mapChangedItems.erase(pItem->GetTransactionNum());
+        AddJournalRecord("remove", pItem->GetTransactionNum());
 
         delete pItem;
         pItem = nullptr;
 
         bNeedToSave = true;
     }
-    if (bNeedToSave) SaveCron();
+    // Items that changed while they were processed are saved too, even if
+    // nothing was removed.
+    if (bNeedToSave || !m_mapChangedItems.empty()) SaveCron();
 }
 
 // OTCron IS responsible for cleaning up theItem, and takes ownership.
@@ -691,6 +1044,11 @@ bool OTCron::AddCronItem(OTCronItem& theItem, Nym* pActivator,
             m_multimapCronItems.upper_bound(tDateAdded),
             std::pair<time64_t, OTCronItem*>(tDateAdded, &theItem));
 
+        // Due right away, so it gets a chance to tell Cron otherwise.
+        m_mapDueDates[theItem.GetTransactionNum()] = cronDueDate(
+            OT_TIME_ZERO, tDateAdded, theItem.GetTransactionNum());
+        m_setDueDates.insert(m_mapDueDates[theItem.GetTransactionNum()]);
+
         theItem.SetCronPointer(*this);
         theItem.setServerNym(m_pServerNym);
         theItem.setNotaryID(&m_NOTARY_ID);
@@ -728,12 +1086,14 @@ bool OTCron::AddCronItem(OTCronItem& theItem, Nym* pActivator,
             //            theItem.SaveContract();
 
             // Since we added an item to the Cron, we SAVE it.
+            m_mapChangedItems[theItem.GetTransactionNum()] = tDateAdded;
             bSuccess = SaveCron();
 
-            if (bSuccess)
+            if (bSuccess) {
                 otOut << __FUNCTION__
                       << ": New CronItem has been added to Cron: "
                       << theItem.GetTransactionNum() << "\n";
+            }
             else
                 otErr << __FUNCTION__
                       << ": Error saving while adding new CronItem to Cron: "
@@ -780,6 +1140,10 @@ bool OTCron::RemoveCronItem(int64_t lTransactionNum,
 
         m_mapCronItems.erase(it_map);           // Remove from MAP.
         m_multimapCronItems.erase(it_multimap); // Remove from MULTIMAP.
+        UnscheduleItem(lTransactionNum);
+
+        m_mapChangedItems.erase(lTransactionNum);
+        AddJournalRecord("remove", lTransactionNum);
 
         delete pItem;
 
@@ -829,6 +1193,22 @@ mapOfCronItems::iterator OTCron::FindItemOnMap(int64_t lTransactionNum)
 multimapOfCronItems::iterator OTCron::FindItemOnMultimap(
     int64_t lTransactionNum)
 {
+    // The schedule knows the date it was added, so normally we only have to
+    // look through the items added on that same date.
+    auto it_due = m_mapDueDates.find(lTransactionNum);
+
+    if (m_mapDueDates.end() != it_due) {
+        auto range =
+            m_multimapCronItems.equal_range(std::get<1>(it_due->second));
+
+        for (auto itt = range.first; itt != range.second; ++itt) {
+            OTCronItem* pItem = itt->second;
+            OT_ASSERT((nullptr != pItem));
+
+            if (pItem->GetTransactionNum() == lTransactionNum) return itt;
+        }
+    }
+
     auto itt = m_multimapCronItems.begin();
 
     while (m_multimapCronItems.end() != itt) {
@@ -1057,6 +1437,9 @@ OTMarket* OTCron::GetMarket(const Identifier& MARKET_ID)
 OTCron::OTCron()
     : Contract()
     , m_bIsActivated(false)
+    , m_lJournalGeneration(0)
+    , m_nJournalRecords(0)
+    , m_nJournalPending(0)
     , m_pServerNym(nullptr) // just here for convenience, not responsible to
                             // cleanup this pointer.
 {
@@ -1067,6 +1450,9 @@ OTCron::OTCron()
 OTCron::OTCron(const Identifier& NOTARY_ID)
     : Contract()
     , m_bIsActivated(false)
+    , m_lJournalGeneration(0)
+    , m_nJournalRecords(0)
+    , m_nJournalPending(0)
     , m_pServerNym(nullptr) // just here for convenience, not responsible to
                             // cleanup this pointer.
 {
@@ -1078,6 +1464,9 @@ OTCron::OTCron(const Identifier& NOTARY_ID)
 OTCron::OTCron(const char* szFilename)
     : Contract()
     , m_bIsActivated(false)
+    , m_lJournalGeneration(0)
+    , m_nJournalRecords(0)
+    , m_nJournalPending(0)
     , m_pServerNym(nullptr) // just here for convenience, not responsible to
                             // cleanup this pointer.
 {
@@ -1135,6 +1524,17 @@ void OTCron::Release_Cron()
         delete pMarket;
         pMarket = nullptr;
     }
+
+    m_setDueDates.clear();
+    m_mapDueDates.clear();
+    m_VerificationCache.Clear();
+
+    m_lJournalGeneration = 0;
+    m_nJournalRecords = 0;
+    m_mapChangedItems.clear();
+    m_strJournalPending.clear();
+    m_nJournalPending = 0;
+    m_setJournaledItems.clear();
 }
 
 } // namespace opentxs
@@ -694,6 +694,38 @@ bool OTCronItem::ProcessCron()
     return true;
 }
 
+// Unless a subclass knows better, Cron calls ProcessCron() every time it
+// processes, so expiration and removal are noticed right away.
+//
+time64_t OTCronItem::GetCronDueDate() const
+{
+    return OT_TIME_ZERO;
+}
+
+time64_t OTCronItem::GetProcessIntervalDueDate() const
+{
+    if (IsFlaggedForRemoval() || (GetLastProcessDate() <= OT_TIME_ZERO))
+        return OT_TIME_ZERO;
+
+    // ProcessCron() returns right away until MORE than the interval passes.
+    time64_t tDueDate = OTTimeAddTimeInterval(GetLastProcessDate(),
+                                              GetProcessInterval() + 1);
+
+    // Unless it expires first: then it's due to be removed.
+    if ((GetValidTo() > OT_TIME_ZERO) && (GetValidTo() < tDueDate))
+        tDueDate = GetValidTo();
+
+    return tDueDate;
+}
+
+void OTCronItem::FlagForRemoval()
+{
+    m_bRemovalFlag = true;
+
+    // If it's on Cron, it's due to be removed on the next round.
+    if (nullptr != m_pCron) m_pCron->ScheduleItem(*this);
+}
+
 // OTCron calls this when a cron item is added.
 // bForTheFirstTime=true means that this cron item is being
 // activated for the very first time. (Versus being re-added
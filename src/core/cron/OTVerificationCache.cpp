@@ -0,0 +1,329 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/cron/OTVerificationCache.hpp>
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/Account.hpp>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Ledger.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <iterator>
+#include <utility>
+
+namespace opentxs
+{
+
+OTVerificationCache::OTVerificationCache()
+{
+}
+
+OTVerificationCache::~OTVerificationCache()
+{
+    Clear();
+}
+
+// static
+bool OTVerificationCache::GetFileDigest(const char* szFolder,
+                                        const char* szOne, const char* szTwo,
+                                        std::string& strDigest)
+{
+    if (!OTDB::Exists(szFolder, szOne, szTwo)) return false;
+
+    const String strContents(OTDB::QueryPlainString(szFolder, szOne, szTwo));
+
+    if (!strContents.Exists()) return false;
+
+    Identifier theDigest;
+    theDigest.CalculateDigest(strContents);
+
+    const String strTheDigest(theDigest);
+    strDigest = strTheDigest.Get();
+
+    return true;
+}
+
+OTVerificationCache::Entry* OTVerificationCache::Find(
+    const std::string& strKey, const std::string& strDigest)
+{
+    auto it = m_mapIndex.find(strKey);
+
+    if (m_mapIndex.end() == it) return nullptr;
+
+    Entry& theEntry = it->second->second;
+
+    // Within a settlement, the same object is handed out every time, since
+    // the caller may already be holding on to it. Otherwise the file must not
+    // have changed since it was verified.
+    if (!theEntry.bCheckedOut &&
+        (strDigest.empty() || (theEntry.strDigest != strDigest))) {
+        Forget(it->second);
+        return nullptr;
+    }
+
+    // Most recently used goes to the front.
+    m_listEntries.splice(m_listEntries.begin(), m_listEntries, it->second);
+
+    return &theEntry;
+}
+
+OTVerificationCache::Entry& OTVerificationCache::Add(
+    const std::string& strKey, const std::string& strDigest)
+{
+    Forget(strKey);
+
+    m_listEntries.push_front(std::make_pair(strKey, Entry()));
+    m_mapIndex[strKey] = m_listEntries.begin();
+
+    Entry& theEntry = m_listEntries.front().second;
+    theEntry.strDigest = strDigest;
+    theEntry.bCheckedOut = true;
+    theEntry.bDirty = false;
+
+    return theEntry;
+}
+
+void OTVerificationCache::Forget(const std::string& strKey)
+{
+    auto it = m_mapIndex.find(strKey);
+
+    if (m_mapIndex.end() != it) Forget(it->second);
+}
+
+void OTVerificationCache::Forget(listOfEntries::iterator it)
+{
+    m_mapIndex.erase(it->first);
+    m_listEntries.erase(it);
+}
+
+// The credential list is what the Nym is verified against. (The nymfile is
+// loaded and verified too, the first time, but nothing in a settlement uses
+// it.)
+Nym* OTVerificationCache::GetNym(const Identifier& theNymID, Nym& theServerNym)
+{
+    const String strNymID(theNymID);
+    const std::string strKey = std::string("nym/") + strNymID.Get();
+
+    String strFilename;
+    strFilename.Format("%s.cred", strNymID.Get());
+
+    std::string strDigest;
+    GetFileDigest(OTFolders::Pubcred().Get(), strNymID.Get(),
+                  strFilename.Get(), strDigest);
+
+    Entry* pEntry = Find(strKey, strDigest);
+
+    if (nullptr != pEntry) {
+        pEntry->bCheckedOut = true;
+        return pEntry->pNym.get();
+    }
+
+    std::unique_ptr<Nym> pNym(new Nym(theNymID));
+
+    if (!pNym->LoadPublicKey() || !pNym->VerifyPseudonym() ||
+        !pNym->LoadSignedNymfile(theServerNym)) {
+        otInfo << "OTVerificationCache::GetNym: Unable to load or verify Nym: "
+               << strNymID << "\n";
+        return nullptr;
+    }
+
+    Entry& theEntry = Add(strKey, strDigest);
+    theEntry.pNym = std::move(pNym);
+    // Without a credential list, there's nothing to check it against next
+    // time.
+    theEntry.bDirty = strDigest.empty();
+
+    return theEntry.pNym.get();
+}
+
+Account* OTVerificationCache::GetAccount(const Identifier& theAcctID,
+                                         const Identifier& theNotaryID,
+                                         Nym& theServerNym)
+{
+    const String strAcctID(theAcctID);
+    const std::string strKey = std::string("account/") + strAcctID.Get();
+
+    std::string strDigest;
+    GetFileDigest(OTFolders::Account().Get(), strAcctID.Get(), "", strDigest);
+
+    Entry* pEntry = Find(strKey, strDigest);
+
+    if (nullptr != pEntry) {
+        pEntry->bCheckedOut = true;
+        pEntry->bDirty = true;
+        return pEntry->pAccount.get();
+    }
+
+    if (strDigest.empty()) return nullptr; // The account doesn't exist.
+
+    // LoadExistingAccount() already calls VerifyContractID().
+    std::unique_ptr<Account> pAccount(
+        Account::LoadExistingAccount(theAcctID, theNotaryID));
+
+    if ((nullptr == pAccount) || !pAccount->VerifySignature(theServerNym)) {
+        otInfo << "OTVerificationCache::GetAccount: Unable to load or verify "
+                  "account: " << strAcctID << "\n";
+        return nullptr;
+    }
+
+    Entry& theEntry = Add(strKey, strDigest);
+    theEntry.pAccount = std::move(pAccount);
+    theEntry.bDirty = true;
+
+    return theEntry.pAccount.get();
+}
+
+Ledger* OTVerificationCache::GetInbox(const Identifier& theNymID,
+                                      const Identifier& theAcctID,
+                                      const Identifier& theNotaryID,
+                                      Nym& theServerNym)
+{
+    const String strAcctID(theAcctID), strNotaryID(theNotaryID);
+    const std::string strKey = std::string("inbox/") + strAcctID.Get();
+
+    std::string strDigest;
+    GetFileDigest(OTFolders::Inbox().Get(), strNotaryID.Get(), strAcctID.Get(),
+                  strDigest);
+
+    Entry* pEntry = Find(strKey, strDigest);
+
+    if (nullptr != pEntry) {
+        pEntry->bCheckedOut = true;
+        pEntry->bDirty = true;
+        return pEntry->pInbox.get();
+    }
+
+    std::unique_ptr<Ledger> pInbox(
+        new Ledger(theNymID, theAcctID, theNotaryID));
+
+    // VerifyAccount() also loads the box receipts.
+    const bool bLoaded =
+        strDigest.empty()
+            ? pInbox->GenerateLedger(theAcctID, theNotaryID, Ledger::inbox,
+                                     true) // bGenerateFile=true
+            : (pInbox->LoadInbox() && pInbox->VerifyAccount(theServerNym));
+
+    if (!bLoaded) {
+        otInfo << "OTVerificationCache::GetInbox: Unable to load, verify or "
+                  "generate inbox: " << strAcctID << "\n";
+        return nullptr;
+    }
+
+    Entry& theEntry = Add(strKey, strDigest);
+    theEntry.pInbox = std::move(pInbox);
+    theEntry.bDirty = true;
+
+    return theEntry.pInbox.get();
+}
+
+bool OTVerificationCache::SaveAccount(Account& theAccount)
+{
+    const bool bSaved = theAccount.SaveAccount();
+
+    const String strAcctID(theAccount.GetRealAccountID());
+    const std::string strKey = std::string("account/") + strAcctID.Get();
+
+    auto it = m_mapIndex.find(strKey);
+
+    if ((m_mapIndex.end() == it) ||
+        (it->second->second.pAccount.get() != &theAccount))
+        return bSaved;
+
+    Entry& theEntry = it->second->second;
+
+    if (bSaved && GetFileDigest(OTFolders::Account().Get(), strAcctID.Get(),
+                                "", theEntry.strDigest))
+        theEntry.bDirty = false;
+
+    return bSaved;
+}
+
+bool OTVerificationCache::SaveInbox(Account& theAccount, Ledger& theInbox)
+{
+    // This also updates the inbox hash on the account, so the account is
+    // still dirty until it's saved as well.
+    const bool bSaved = theAccount.SaveInbox(theInbox);
+
+    const String strAcctID(theInbox.GetRealAccountID()),
+        strNotaryID(theInbox.GetRealNotaryID());
+    const std::string strKey = std::string("inbox/") + strAcctID.Get();
+
+    auto it = m_mapIndex.find(strKey);
+
+    if ((m_mapIndex.end() == it) ||
+        (it->second->second.pInbox.get() != &theInbox))
+        return bSaved;
+
+    Entry& theEntry = it->second->second;
+
+    if (bSaved && GetFileDigest(OTFolders::Inbox().Get(), strNotaryID.Get(),
+                                strAcctID.Get(), theEntry.strDigest))
+        theEntry.bDirty = false;
+
+    return bSaved;
+}
+
+void OTVerificationCache::CheckIn()
+{
+    for (auto it = m_listEntries.begin(); it != m_listEntries.end();) {
+        auto itCurrent = it++;
+        itCurrent->second.bCheckedOut = false;
+
+        if (itCurrent->second.bDirty) Forget(itCurrent);
+    }
+
+    const int32_t nMaxSize = OTCron::GetCronVerificationCacheSize();
+
+    while (!m_listEntries.empty() &&
+           (static_cast<int64_t>(m_listEntries.size()) > nMaxSize))
+        Forget(std::prev(m_listEntries.end()));
+}
+
+void OTVerificationCache::Clear()
+{
+    m_mapIndex.clear();
+    m_listEntries.clear();
+}
+
+} // namespace opentxs
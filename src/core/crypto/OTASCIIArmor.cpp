@@ -46,6 +46,7 @@
 
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 #include <cstring>
 #include <zlib.h>
 
@@ -179,81 +180,167 @@ OTASCIIArmor& OTASCIIArmor::operator=(const OTASCIIArmor& strValue)
     return *this;
 }
 
-// Source for these two functions: http://panthema.net/2007/0328-ZLibString.html
+// An armored string that starts with this byte wasn't compressed. (No zlib
+// stream can start with it.)
+#define OT_ARMOR_UNCOMPRESSED '\0'
+// Stands for "no CompressionScope on this thread".
+#define OT_ARMOR_NO_SCOPE (-100)
+
+// (static)
+int32_t OTASCIIArmor::__compression_level = Z_BEST_COMPRESSION;
+int32_t OTASCIIArmor::__uncompressed_below = 0;
+
+namespace
+{
+
+// Each thread keeps its zlib streams and resets them between strings, instead
+// of setting up new ones every time.
+class ZlibStreams
+{
+public:
+    ZlibStreams()
+        : bDeflate_(false)
+        , bInflate_(false)
+        , nLevel_(0)
+    {
+        memset(&deflate_, 0, sizeof(deflate_));
+        memset(&inflate_, 0, sizeof(inflate_));
+    }
+
+    ~ZlibStreams()
+    {
+        if (bDeflate_) deflateEnd(&deflate_);
+        if (bInflate_) inflateEnd(&inflate_);
+    }
+
+    z_stream* GetDeflate(int32_t nLevel)
+    {
+        if (!bDeflate_) {
+            if (Z_OK != deflateInit(&deflate_, nLevel)) return nullptr;
+
+            bDeflate_ = true;
+            nLevel_ = nLevel;
+        }
+        else if ((Z_OK != deflateReset(&deflate_)) ||
+                 ((nLevel != nLevel_) &&
+                  (Z_OK != deflateParams(&deflate_, nLevel,
+                                         Z_DEFAULT_STRATEGY))))
+            return nullptr;
+
+        nLevel_ = nLevel;
+
+        return &deflate_;
+    }
+
+    z_stream* GetInflate()
+    {
+        if (!bInflate_) {
+            if (Z_OK != inflateInit(&inflate_)) return nullptr;
+
+            bInflate_ = true;
+        }
+        else if (Z_OK != inflateReset(&inflate_))
+            return nullptr;
+
+        return &inflate_;
+    }
+
+private:
+    z_stream deflate_;
+    z_stream inflate_;
+    bool bDeflate_;
+    bool bInflate_;
+    int32_t nLevel_;
+};
+
+thread_local ZlibStreams t_zlibStreams;
+thread_local int32_t t_nScopeLevel = OT_ARMOR_NO_SCOPE;
+
+} // namespace
+
+OTASCIIArmor::CompressionScope::CompressionScope(int32_t nLevel)
+    : m_nPrevious(t_nScopeLevel)
+{
+    t_nScopeLevel = nLevel;
+}
+
+OTASCIIArmor::CompressionScope::~CompressionScope()
+{
+    t_nScopeLevel = m_nPrevious;
+}
+
+// Originally based on: http://panthema.net/2007/0328-ZLibString.html
 
 /** Compress a STL string using zlib with given compression level and return
  * the binary data. */
-std::string OTASCIIArmor::compress_string(
-    const std::string& str, int32_t compressionlevel = Z_BEST_COMPRESSION) const
+std::string OTASCIIArmor::compress_string(const std::string& str,
+                                          int32_t compressionlevel) const
 {
-    z_stream zs; // z_stream is zlib's control structure
-    memset(&zs, 0, sizeof(zs));
+    if (static_cast<int64_t>(str.size()) < GetUncompressedBelow())
+        return OT_ARMOR_UNCOMPRESSED + str;
 
-    if (deflateInit(&zs, compressionlevel) != Z_OK)
+    z_stream* pStream = t_zlibStreams.GetDeflate(compressionlevel);
+
+    if (nullptr == pStream)
         throw(std::runtime_error("deflateInit failed while compressing."));
 
+    z_stream& zs = *pStream;
+
     zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
     zs.avail_in = static_cast<uInt>(str.size()); // set the z_stream's input
 
-    int32_t ret;
-    char outbuffer[32768];
-    std::string outstring;
+    // deflateBound is enough room to finish in one call.
+    std::string outstring(deflateBound(&zs, zs.avail_in), '\0');
 
-    // retrieve the compressed bytes blockwise
-    do {
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
+    zs.next_out = reinterpret_cast<Bytef*>(&outstring[0]);
+    zs.avail_out = static_cast<uInt>(outstring.size());
 
-        ret = deflate(&zs, Z_FINISH);
-
-        if (outstring.size() < zs.total_out) {
-            // append the block to the output string
-            outstring.append(outbuffer, zs.total_out - outstring.size());
-        }
-    } while (ret == Z_OK);
-
-    deflateEnd(&zs);
+    const int32_t ret = deflate(&zs, Z_FINISH);
 
     if (ret != Z_STREAM_END) { // an error occurred that was not EOF
         std::ostringstream oss;
-        oss << "Exception during zlib compression: (" << ret << ") " << zs.msg;
+        oss << "Exception during zlib compression: (" << ret << ")";
+        if (zs.msg != nullptr) {
+            oss << " " << zs.msg;
+        }
         throw(std::runtime_error(oss.str()));
     }
 
+    outstring.resize(zs.total_out);
+
     return outstring;
 }
 
 /** Decompress an STL string using zlib and return the original data. */
 std::string OTASCIIArmor::decompress_string(const std::string& str) const
 {
-    z_stream zs; // z_stream is zlib's control structure
-    memset(&zs, 0, sizeof(zs));
+    if (!str.empty() && (OT_ARMOR_UNCOMPRESSED == str[0]))
+        return str.substr(1);
+
+    z_stream* pStream = t_zlibStreams.GetInflate();
 
-    if (inflateInit(&zs) != Z_OK)
+    if (nullptr == pStream)
         throw(std::runtime_error("inflateInit failed while decompressing."));
 
+    z_stream& zs = *pStream;
+
     zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
     zs.avail_in = static_cast<uInt>(str.size());
 
     int32_t ret;
-    char outbuffer[32768];
-    std::string outstring;
+    std::string outstring(std::max<size_t>(4 * str.size(), 1024), '\0');
 
-    // get the decompressed bytes blockwise using repeated calls to inflate
+    // Inflate straight into outstring, growing it whenever it fills up.
     do {
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
-
-        ret = inflate(&zs, 0);
+        if (zs.total_out == outstring.size())
+            outstring.resize(2 * outstring.size());
 
-        if (outstring.size() < zs.total_out) {
-            outstring.append(outbuffer, zs.total_out - outstring.size());
-        }
+        zs.next_out = reinterpret_cast<Bytef*>(&outstring[zs.total_out]);
+        zs.avail_out = static_cast<uInt>(outstring.size() - zs.total_out);
 
+        ret = inflate(&zs, 0);
     } while (ret == Z_OK);
 
-    inflateEnd(&zs);
-
     if (ret != Z_STREAM_END) { // an error occurred that was not EOF
         std::ostringstream oss;
         oss << "Exception during zlib decompression: (" << ret << ")";
@@ -263,27 +350,24 @@ std::string OTASCIIArmor::decompress_string(const std::string& str) const
         throw(std::runtime_error(oss.str()));
     }
 
+    outstring.resize(zs.total_out);
+
     return outstring;
 }
 
 // Base64-decode
 bool OTASCIIArmor::GetData(OTData& theData,
-                           bool bLineBreaks) const // linebreaks=true
+                           bool) const // linebreaks=true
 {
     theData.Release();
 
     if (GetLength() < 1) return true;
 
-    size_t outSize = 0;
-    uint8_t* pData = OTCrypto::It()->Base64Decode(Get(), &outSize, bLineBreaks);
-
-    if (!pData) {
+    if (!OTCrypto::It()->Base64Decode(Get(), GetLength(), theData)) {
         otErr << __FUNCTION__ << "Base64Decode fail\n";
         return false;
     }
 
-    theData.Assign(pData, outSize);
-    delete[] pData;
     return true;
 }
 
@@ -310,7 +394,7 @@ bool OTASCIIArmor::SetData(const OTData& theData, bool bLineBreaks)
 
 // Base64-decode an decompress
 bool OTASCIIArmor::GetString(String& strData,
-                             bool bLineBreaks) const // bLineBreaks=true
+                             bool) const // bLineBreaks=true
 {
     strData.Release();
 
@@ -318,18 +402,13 @@ bool OTASCIIArmor::GetString(String& strData,
         return true;
     }
 
-    size_t outSize = 0;
-    uint8_t* pData = OTCrypto::It()->Base64Decode(Get(), &outSize, bLineBreaks);
+    std::string str_decoded;
 
-    if (!pData) {
+    if (!OTCrypto::It()->Base64Decode(Get(), GetLength(), str_decoded)) {
         otErr << __FUNCTION__ << "Base64Decode fail\n";
         return false;
     }
 
-    std::string str_decoded(pData, pData + outSize);
-
-    delete[] pData;
-
     std::string str_uncompressed;
     try {
         str_uncompressed = decompress_string(str_decoded);
@@ -351,8 +430,18 @@ bool OTASCIIArmor::SetString(const String& strData, bool bLineBreaks) //=true
 
     if (strData.GetLength() < 1) return true;
 
-    std::string stdstring = std::string(strData.Get());
-    std::string str_compressed = compress_string(stdstring);
+    const std::string stdstring(strData.Get(), strData.GetLength());
+    std::string str_compressed;
+    try {
+        str_compressed = compress_string(
+            stdstring, (OT_ARMOR_NO_SCOPE == t_nScopeLevel)
+                           ? GetCompressionLevel()
+                           : t_nScopeLevel);
+    }
+    catch (const std::runtime_error&) {
+        otErr << "OTASCIIArmor::" << __FUNCTION__ << ": compression fail.\n";
+        return false;
+    }
 
     // "Success"
     if (str_compressed.size() == 0) {
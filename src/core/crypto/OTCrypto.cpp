@@ -46,6 +46,7 @@
 // Perhaps error out here...
 #endif
 
+#include <cstring>
 #include <iostream>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/crypto/OTPassword.hpp>
@@ -237,6 +238,249 @@ bool OTCrypto::IsBase62(const std::string& str) const
                                  "JKLMNOPQRSTUVWXYZ") == std::string::npos;
 }
 
+// BASE 64 ENCODING
+//
+// (Same line length as OpenSSL, so the armored output doesn't change.)
+#define OT_BASE64_LINE_GROUPS 16 // 16 groups of 4 characters per line.
+
+namespace
+{
+
+const char s_Base64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// The decode table holds each character's 6 bits. The other values are all
+// 64 or more, so OR-ing four lookups together tells if a group is clean.
+enum { Base64Space = 64, Base64Pad = 65, Base64Invalid = 255 };
+
+struct Base64Table
+{
+    uint8_t value_[256];
+
+    Base64Table()
+    {
+        for (int32_t i = 0; i < 256; ++i) value_[i] = Base64Invalid;
+        for (int32_t i = 0; i < 64; ++i)
+            value_[static_cast<uint8_t>(s_Base64Chars[i])] =
+                static_cast<uint8_t>(i);
+
+        value_[static_cast<uint8_t>('=')] = Base64Pad;
+        value_[static_cast<uint8_t>('\n')] = Base64Space;
+        value_[static_cast<uint8_t>('\r')] = Base64Space;
+        value_[static_cast<uint8_t>(' ')] = Base64Space;
+        value_[static_cast<uint8_t>('\t')] = Base64Space;
+    }
+};
+
+const Base64Table s_Base64Table;
+
+size_t Base64EncodedSize(size_t in_len, bool bLineBreaks)
+{
+    const size_t nGroups = (in_len + 2) / 3;
+    const size_t nLines =
+        (nGroups + OT_BASE64_LINE_GROUPS - 1) / OT_BASE64_LINE_GROUPS;
+
+    return 4 * nGroups + (bLineBreaks ? nLines : 0);
+}
+
+// Writes exactly Base64EncodedSize(in_len, bLineBreaks) characters.
+//
+void Base64EncodeTo(const uint8_t* input, size_t in_len, char* output,
+                    bool bLineBreaks)
+{
+    size_t nGroups = 0;
+    size_t i = 0;
+
+    for (; i + 3 <= in_len; i += 3) {
+        const uint32_t n = (static_cast<uint32_t>(input[i]) << 16) |
+                           (static_cast<uint32_t>(input[i + 1]) << 8) |
+                           input[i + 2];
+
+        *output++ = s_Base64Chars[n >> 18];
+        *output++ = s_Base64Chars[(n >> 12) & 0x3f];
+        *output++ = s_Base64Chars[(n >> 6) & 0x3f];
+        *output++ = s_Base64Chars[n & 0x3f];
+
+        if (bLineBreaks && (0 == (++nGroups % OT_BASE64_LINE_GROUPS)))
+            *output++ = '\n';
+    }
+
+    if (i < in_len) {
+        const bool bTwo = (i + 1 < in_len);
+        const uint32_t n = (static_cast<uint32_t>(input[i]) << 16) |
+                           (bTwo ? (static_cast<uint32_t>(input[i + 1]) << 8)
+                                 : 0);
+
+        *output++ = s_Base64Chars[n >> 18];
+        *output++ = s_Base64Chars[(n >> 12) & 0x3f];
+        *output++ = bTwo ? s_Base64Chars[(n >> 6) & 0x3f] : '=';
+        *output++ = '=';
+
+        if (bLineBreaks && (0 == (++nGroups % OT_BASE64_LINE_GROUPS)))
+            *output++ = '\n';
+    }
+
+    if (bLineBreaks && (0 != (nGroups % OT_BASE64_LINE_GROUPS)))
+        *output++ = '\n';
+}
+
+// Pass nullptr for output to just count the bytes. Whitespace is skipped
+// anywhere in the input, and decoding stops at the padding.
+//
+bool Base64DecodeTo(const char* input, size_t in_len, uint8_t* output,
+                    size_t& out_len)
+{
+    const uint8_t* table = s_Base64Table.value_;
+    const uint8_t* pos = reinterpret_cast<const uint8_t*>(input);
+    const uint8_t* end = pos + in_len;
+    uint32_t nBits = 0;
+    int32_t nCount = 0;
+    size_t nOut = 0;
+
+    while (pos != end) {
+        // Most of the input is whole groups, between the line breaks.
+        if ((0 == nCount) && (4 <= end - pos)) {
+            const uint8_t a = table[pos[0]], b = table[pos[1]];
+            const uint8_t c = table[pos[2]], d = table[pos[3]];
+
+            if (64 > (a | b | c | d)) {
+                if (nullptr != output) {
+                    output[nOut] = static_cast<uint8_t>((a << 2) | (b >> 4));
+                    output[nOut + 1] =
+                        static_cast<uint8_t>((b << 4) | (c >> 2));
+                    output[nOut + 2] = static_cast<uint8_t>((c << 6) | d);
+                }
+
+                nOut += 3;
+                pos += 4;
+                continue;
+            }
+        }
+
+        const uint8_t value = table[*pos++];
+
+        if (64 > value) {
+            nBits = (nBits << 6) | value;
+
+            if (4 == ++nCount) {
+                if (nullptr != output) {
+                    output[nOut] = static_cast<uint8_t>(nBits >> 16);
+                    output[nOut + 1] = static_cast<uint8_t>(nBits >> 8);
+                    output[nOut + 2] = static_cast<uint8_t>(nBits);
+                }
+
+                nOut += 3;
+                nBits = 0;
+                nCount = 0;
+            }
+        }
+        else if (Base64Pad == value)
+            break;
+        else if (Base64Space != value)
+            return false;
+    }
+
+    // Nothing but padding and whitespace may follow the padding.
+    for (; pos != end; ++pos) {
+        const uint8_t value = table[*pos];
+
+        if ((Base64Pad != value) && (Base64Space != value)) return false;
+    }
+
+    switch (nCount) {
+    case 0:
+        break;
+    case 2:
+        if (nullptr != output)
+            output[nOut] = static_cast<uint8_t>(nBits >> 4);
+        nOut += 1;
+        break;
+    case 3:
+        if (nullptr != output) {
+            output[nOut] = static_cast<uint8_t>(nBits >> 10);
+            output[nOut + 1] = static_cast<uint8_t>(nBits >> 2);
+        }
+        nOut += 2;
+        break;
+    default: // A single leftover character isn't a whole byte.
+        return false;
+    }
+
+    out_len = nOut;
+
+    return true;
+}
+
+} // namespace
+
+// Caller responsible to delete.
+char* OTCrypto::Base64Encode(const uint8_t* input, int32_t in_len,
+                             bool bLineBreaks) const
+{
+    OT_ASSERT_MSG(in_len >= 0,
+                  "OT_base64_encode: Abort: in_len is a negative number!");
+
+    const size_t nSize = Base64EncodedSize(in_len, bLineBreaks);
+    char* buf = new char[nSize + 1];
+    OT_ASSERT(nullptr != buf);
+
+    Base64EncodeTo(input, in_len, buf, bLineBreaks);
+    buf[nSize] = '\0';
+
+    return buf;
+}
+
+// Caller responsible to delete.
+uint8_t* OTCrypto::Base64Decode(const char* input, size_t* out_len,
+                                bool) const
+{
+    OT_ASSERT(nullptr != input);
+    OT_ASSERT(nullptr != out_len);
+
+    const size_t in_len = strlen(input);
+    size_t nSize = 0;
+
+    if (!Base64DecodeTo(input, in_len, nullptr, nSize)) return nullptr;
+
+    uint8_t* buf = new uint8_t[nSize + 1]; // (+1 so it's never zero.)
+    OT_ASSERT(nullptr != buf);
+
+    Base64DecodeTo(input, in_len, buf, *out_len);
+
+    return buf;
+}
+
+bool OTCrypto::Base64Decode(const char* input, size_t in_len,
+                            OTData& theOutput) const
+{
+    size_t nSize = 0;
+
+    theOutput.Release();
+
+    if (!Base64DecodeTo(input, in_len, nullptr, nSize)) return false;
+
+    theOutput.SetSize(static_cast<uint32_t>(nSize));
+
+    return Base64DecodeTo(
+        input, in_len, static_cast<uint8_t*>(theOutput.GetPointerWritable()),
+        nSize);
+}
+
+bool OTCrypto::Base64Decode(const char* input, size_t in_len,
+                            std::string& strOutput) const
+{
+    size_t nSize = 0;
+
+    strOutput.clear();
+
+    if (!Base64DecodeTo(input, in_len, nullptr, nSize)) return false;
+
+    strOutput.resize(nSize);
+
+    return Base64DecodeTo(input, in_len,
+                          reinterpret_cast<uint8_t*>(&strOutput[0]), nSize);
+}
+
 // get pass phrase, length 'len' into 'tmp'
 /*
 int32_t len=0;
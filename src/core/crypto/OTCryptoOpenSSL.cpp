@@ -393,91 +393,6 @@ void ot_openssl_locking_callback(int32_t mode, int32_t type, const char*,
 }
 } // extern "C"
 
-// Caller responsible to delete.
-char* OTCrypto_OpenSSL::Base64Encode(const uint8_t* input, int32_t in_len,
-                                     bool bLineBreaks) const
-{
-    char* buf = nullptr;
-    BUF_MEM* bptr = nullptr;
-
-    OT_ASSERT_MSG(in_len >= 0,
-                  "OT_base64_encode: Abort: in_len is a negative number!");
-
-    OpenSSL_BIO b64 = BIO_new(BIO_f_base64());
-
-    if (!b64) return buf;
-
-    if (!bLineBreaks) BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-
-    OpenSSL_BIO bmem = BIO_new(BIO_s_mem());
-
-    if (bmem) {
-        OpenSSL_BIO b64join = BIO_push(b64, bmem);
-        b64.release();
-        bmem.release();
-
-        if (BIO_write(b64join, input, in_len) == in_len) {
-            (void)BIO_flush(b64join);
-#ifndef _WIN32
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-#endif
-            BIO_get_mem_ptr(b64join, &bptr);
-#ifndef _WIN32
-#pragma GCC diagnostic pop
-#endif
-            //    otLog5 << "DEBUG base64_encode size: %" PRId64 ",  in_len:
-            // %" PRId64 "\n", bptr->length+1, in_len);
-            buf = new char[bptr->length + 1];
-            OT_ASSERT(nullptr != buf);
-            memcpy(buf, bptr->data, bptr->length); // Safe.
-            buf[bptr->length] = '\0';              // Forcing null terminator.
-        }
-    }
-    else {
-        OT_FAIL_MSG("Failed creating new Bio in base64_encode.\n");
-    }
-
-    return buf;
-}
-
-// Caller responsible to delete.
-uint8_t* OTCrypto_OpenSSL::Base64Decode(const char* input, size_t* out_len,
-                                        bool bLineBreaks) const
-{
-
-    OT_ASSERT(nullptr != input);
-
-    int32_t in_len =
-        static_cast<int32_t>(strlen(input)); // todo security (strlen)
-    int32_t out_max_len = (in_len * 6 + 7) / 8;
-    uint8_t* buf = new uint8_t[out_max_len];
-    OT_ASSERT(nullptr != buf);
-    memset(buf, 0, out_max_len); // todo security
-
-    OpenSSL_BIO b64 = BIO_new(BIO_f_base64());
-
-    if (b64) {
-        if (!bLineBreaks) BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-
-        OpenSSL_BIO bmem = BIO_new_mem_buf(const_cast<char*>(input), in_len);
-        OT_ASSERT(nullptr != bmem);
-
-        OpenSSL_BIO b64join = BIO_push(b64, bmem);
-        b64.release();
-        bmem.release();
-        OT_ASSERT(nullptr != b64join);
-
-        *out_len = BIO_read(b64join, buf, out_max_len);
-
-    }
-    else {
-        OT_FAIL_MSG("Failed creating new Bio in base64_decode.\n");
-    }
-
-    return buf;
-}
-
 // Decode formatted OT ID to the binary hash ID.
 void OTCrypto_OpenSSL::SetIDFromEncoded(const String& strInput,
                                         Identifier& theOutput) const
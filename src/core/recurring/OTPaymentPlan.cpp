@@ -538,7 +538,7 @@ bool OTPaymentPlan::SetInitialPaymentDone()
 //
 bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
 {
-    const OTCron* pCron = GetCron();
+    OTCron* pCron = GetCron();
     OT_ASSERT(nullptr != pCron);
 
     Nym* pServerNym = pCron->GetServerNym();
@@ -595,6 +595,11 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
     String strOrigPlan(*pOrigCronItem); // <====== Farther down in the code, I
                                         // attach this string to the receipts.
 
+    // The Nyms, accounts and inboxes are checked out of here, and whatever
+    // was changed is saved through it too. Every way out of this function
+    // (once something is checked out) checks them back in.
+    OTVerificationCache& theCache = pCron->GetVerificationCache();
+
     // -------------- Make sure have both nyms loaded and checked out.
     // --------------------------------------------------
     // WARNING: 1 or both of the Nyms could be also the Server Nym. They could
@@ -605,10 +610,6 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
     // the pointers accordingly, and then operate
     // using the pointers from there.
 
-    Nym theSenderNym, theRecipientNym; // We MIGHT use ONE, OR BOTH, of
-                                       // these, or none. (But probably
-                                       // both.)
-
     // Find out if either Nym is actually also the server.
     bool bSenderNymIsServerNym =
         ((SENDER_NYM_ID == NOTARY_NYM_ID) ? true : false);
@@ -629,31 +630,15 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
         // If the First Nym is the server, then just point to that.
         pSenderNym = pServerNym;
     }
-    else // Else load the First Nym from storage.
+    else // Else load the First Nym from storage. (Or from the cache.)
     {
-        theSenderNym.SetIdentifier(SENDER_NYM_ID); // theSenderNym is pSenderNym
-
-        if (!theSenderNym.LoadPublicKey()) {
-            String strNymID(SENDER_NYM_ID);
-            otErr << "Failure loading Sender Nym public key in "
-                     "OTPaymentPlan::ProcessPayment: " << strNymID << "\n";
-            FlagForRemoval(); // Remove it from future Cron processing, please.
-            return false;
-        }
+        pSenderNym = theCache.GetNym(SENDER_NYM_ID, *pServerNym);
 
-        if (theSenderNym.VerifyPseudonym() &&
-            theSenderNym.LoadSignedNymfile(*pServerNym)) // ServerNym here is
-                                                         // not theSenderNym's
-                                                         // identity, but merely
-                                                         // the signer on this
-                                                         // file.
-        {
-            pSenderNym = &theSenderNym; //  <=====
-        }
-        else {
+        if (nullptr == pSenderNym) {
             String strNymID(SENDER_NYM_ID);
             otErr << "Failure loading or verifying Sender Nym public key in "
                      "OTPaymentPlan::ProcessPayment: " << strNymID << "\n";
+            theCache.CheckIn();
             FlagForRemoval(); // Remove it from future Cron processing, please.
             return false;
         }
@@ -667,28 +652,17 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
     else if (bUsersAreSameNym) // Else if the participants are the same Nym,
                                  // point to the one we already loaded.
     {
-        pRecipientNym = pSenderNym; // theSenderNym is pSenderNym
+        pRecipientNym = pSenderNym;
     }
     else // Otherwise load the Other Nym from Disk and point to that.
     {
-        theRecipientNym.SetIdentifier(RECIPIENT_NYM_ID);
+        pRecipientNym = theCache.GetNym(RECIPIENT_NYM_ID, *pServerNym);
 
-        if (!theRecipientNym.LoadPublicKey()) {
-            String strNymID(RECIPIENT_NYM_ID);
-            otErr << "Failure loading Recipient Nym public key in "
-                     "OTPaymentPlan::ProcessPayment: " << strNymID << "\n";
-            FlagForRemoval(); // Remove it from future Cron processing, please.
-            return false;
-        }
-
-        if (theRecipientNym.VerifyPseudonym() &&
-            theRecipientNym.LoadSignedNymfile(*pServerNym)) {
-            pRecipientNym = &theRecipientNym; //  <=====
-        }
-        else {
+        if (nullptr == pRecipientNym) {
             String strNymID(RECIPIENT_NYM_ID);
             otErr << "Failure loading or verifying Recipient Nym public key in "
                      "OTPaymentPlan::ProcessPayment: " << strNymID << "\n";
+            theCache.CheckIn();
             FlagForRemoval(); // Remove it from future Cron processing, please.
             return false;
         }
@@ -706,6 +680,7 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
         !pOrigCronItem->VerifySignature(*pRecipientNym)) {
         otErr << "Failed authorization: Payment plan (while attempting to "
                  "process...)\n";
+        theCache.CheckIn();
         FlagForRemoval(); // Remove it from Cron.
         return false;
     }
@@ -729,30 +704,33 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
     // deleting it, either.)
     // I know for a fact they have both signed pOrigCronItem...
 
-    std::unique_ptr<Account> pSourceAcct(
-        Account::LoadExistingAccount(SOURCE_ACCT_ID, NOTARY_ID));
+    // The cache has already verified the signatures on these.
+    Account* pSourceAcct =
+        theCache.GetAccount(SOURCE_ACCT_ID, NOTARY_ID, *pServerNym);
 
     if (nullptr == pSourceAcct) {
         otOut << "ERROR verifying existence of source account during attempted "
                  "payment plan processing.\n";
+        theCache.CheckIn();
         FlagForRemoval(); // Remove it from future Cron processing, please.
         return false;
     }
 
-    std::unique_ptr<Account> pRecipientAcct(
-        Account::LoadExistingAccount(RECIPIENT_ACCT_ID, NOTARY_ID));
+    Account* pRecipientAcct =
+        theCache.GetAccount(RECIPIENT_ACCT_ID, NOTARY_ID, *pServerNym);
 
     if (nullptr == pRecipientAcct) {
         otOut << "ERROR verifying existence of recipient account during "
                  "attempted payment plan processing.\n";
+        theCache.CheckIn();
         FlagForRemoval(); // Remove it from future Cron processing, please.
         return false;
     }
 
     // BY THIS POINT, both accounts are successfully loaded, and I don't have to
     // worry about
-    // cleaning either one of them up, either. But I can now use pSourceAcct and
-    // pRecipientAcct...
+    // cleaning either one of them up, either. (The cache owns them.) But I can
+    // now use pSourceAcct and pRecipientAcct...
 
     // A few verification if/elses...
 
@@ -766,26 +744,24 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
         // true.
         otOut << "ERROR - attempted payment between accounts of different "
                  "instrument definitions in OTPaymentPlan::ProcessPayment\n";
+        theCache.CheckIn();
         FlagForRemoval(); // Remove it from future Cron processing, please.
         return false;
     }
 
-    // Make sure all accounts are signed by the server and have the owner they
-    // are expected to have.
-
-    // I call VerifySignature here since VerifyContractID was already called in
-    // LoadExistingAccount().
-    else if (!pSourceAcct->VerifyOwner(*pSenderNym) ||
-             !pSourceAcct->VerifySignature(*pServerNym)) {
-        otOut << "ERROR verifying ownership or signature on source account in "
+    // Make sure all accounts have the owner they are expected to have. (The
+    // cache already verified their signatures and contract IDs.)
+    else if (!pSourceAcct->VerifyOwner(*pSenderNym)) {
+        otOut << "ERROR verifying ownership on source account in "
                  "OTPaymentPlan::ProcessPayment\n";
+        theCache.CheckIn();
         FlagForRemoval(); // Remove it from future Cron processing, please.
         return false;
     }
-    else if (!pRecipientAcct->VerifyOwner(*pRecipientNym) ||
-               !pRecipientAcct->VerifySignature(*pServerNym)) {
-        otOut << "ERROR verifying ownership or signature on recipient account "
+    else if (!pRecipientAcct->VerifyOwner(*pRecipientNym)) {
+        otOut << "ERROR verifying ownership on recipient account "
                  "in OTPaymentPlan::ProcessPayment\n";
+        theCache.CheckIn();
         FlagForRemoval(); // Remove it from future Cron processing, please.
         return false;
     }
@@ -802,39 +778,22 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
         // outbox and the recipient's inbox.
         // IF they can be loaded up from file, or generated, that is.
 
-        // Load the inbox/outbox in case they already exist
-        Ledger theSenderInbox(SENDER_NYM_ID, SOURCE_ACCT_ID, NOTARY_ID),
-            theRecipientInbox(RECIPIENT_NYM_ID, RECIPIENT_ACCT_ID, NOTARY_ID);
-
-        // ALL inboxes -- no outboxes. All will receive notification of
-        // something ALREADY DONE.
-        bool bSuccessLoadingSenderInbox = theSenderInbox.LoadInbox();
-        bool bSuccessLoadingRecipientInbox = theRecipientInbox.LoadInbox();
+        // Load the inboxes in case they already exist, or generate them
+        // otherwise. ALL inboxes -- no outboxes. All will receive notification
+        // of something ALREADY DONE.
+        Ledger* pSenderInbox = theCache.GetInbox(
+            SENDER_NYM_ID, SOURCE_ACCT_ID, NOTARY_ID, *pServerNym);
+        Ledger* pRecipientInbox = theCache.GetInbox(
+            RECIPIENT_NYM_ID, RECIPIENT_ACCT_ID, NOTARY_ID, *pServerNym);
 
-        // ...or generate them otherwise...
-        //
-        if (true == bSuccessLoadingSenderInbox)
-            bSuccessLoadingSenderInbox =
-                theSenderInbox.VerifyAccount(*pServerNym);
-        else
-            bSuccessLoadingSenderInbox = theSenderInbox.GenerateLedger(
-                SOURCE_ACCT_ID, NOTARY_ID, Ledger::inbox,
-                true); // bGenerateFile=true
-
-        if (true == bSuccessLoadingRecipientInbox)
-            bSuccessLoadingRecipientInbox =
-                theRecipientInbox.VerifyAccount(*pServerNym);
-        else
-            bSuccessLoadingRecipientInbox = theRecipientInbox.GenerateLedger(
-                RECIPIENT_ACCT_ID, NOTARY_ID, Ledger::inbox,
-                true); // bGenerateFile=true
-
-        if ((false == bSuccessLoadingSenderInbox) ||
-            (false == bSuccessLoadingRecipientInbox)) {
+        if ((nullptr == pSenderInbox) || (nullptr == pRecipientInbox)) {
             otErr << __FUNCTION__
                   << ": ERROR loading or generating inbox ledger.\n";
         }
         else {
+            Ledger& theSenderInbox = *pSenderInbox;
+            Ledger& theRecipientInbox = *pRecipientInbox;
+
             // Generate new transaction numbers for these new transactions
             int64_t lNewTransactionNumber =
                 GetCron()->GetNextTransactionNumber();
@@ -844,6 +803,7 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
             if (0 == lNewTransactionNumber) {
                 otOut << "WARNING: Payment plan is unable to process because "
                          "there are no more transaction numbers available.\n";
+                theCache.CheckIn();
                 // (Here I do NOT flag for removal.)
                 return false;
             }
@@ -1155,8 +1115,8 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
             theRecipientInbox.SaveContract();
 
             // Save both inboxes to storage. (File, DB, wherever it goes.)
-            pSourceAcct->SaveInbox(theSenderInbox);
-            pRecipientAcct->SaveInbox(theRecipientInbox);
+            theCache.SaveInbox(*pSourceAcct, theSenderInbox);
+            theCache.SaveInbox(*pRecipientAcct, theRecipientInbox);
 
             // These correspond to the AddTransaction() calls just above. These
             // are stored
@@ -1187,8 +1147,8 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
                 // TODO: Better rollback capabilities in case of failures here:
 
                 // Save both accounts to storage.
-                pSourceAcct->SaveAccount();
-                pRecipientAcct->SaveAccount();
+                theCache.SaveAccount(*pSourceAcct);
+                theCache.SaveAccount(*pRecipientAcct);
 
                 // NO NEED TO LOG HERE, since success / failure is already
                 // logged above.
@@ -1197,6 +1157,8 @@ bool OTPaymentPlan::ProcessPayment(const int64_t& lAmount)
     } // By the time we enter this block, accounts and nyms are already loaded.
       // As we begin, inboxes are instantiated.
 
+    theCache.CheckIn();
+
     return bSuccess;
 }
 
@@ -1235,6 +1197,7 @@ void OTPaymentPlan::ProcessInitialPayment()
     // if it is dirty, or instruct it to update itself if it is.  Anyway, let's
     // save Cron...
 
+    GetCron()->SetItemChanged(*this);
     GetCron()->SaveCron();
 
     // Todo: put the actual Cron items in separate files, so I don't have to
@@ -1316,12 +1279,19 @@ void OTPaymentPlan::ProcessPaymentPlan()
     // and re-sign it and save it, no matter what. So I just
     // call this here to keep it simple:
 
+    GetCron()->SetItemChanged(*this);
     GetCron()->SaveCron();
 }
 
 // OTCron calls this regularly, which is my chance to expire, etc.
 // Return True if I should stay on the Cron list for more processing.
 // Return False if I should be removed and deleted.
+// Payment plans only process once per GetProcessInterval().
+time64_t OTPaymentPlan::GetCronDueDate() const
+{
+    return GetProcessIntervalDueDate();
+}
+
 bool OTPaymentPlan::ProcessCron()
 {
     OT_ASSERT(nullptr != GetCron());
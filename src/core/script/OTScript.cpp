@@ -321,6 +321,20 @@ void OTScript::RemoveVariable(OTVariable& theVar)
     }
 }
 
+void OTScript::ResetToBaseline()
+{
+    m_mapParties.clear();
+    m_mapAccounts.clear();
+
+    for (auto& it : m_mapVariables) {
+        OTVariable* pVar = it.second;
+        OT_ASSERT(nullptr != pVar);
+
+        pVar->UnregisterScript(); // We don't own it, see the destructor.
+    }
+    m_mapVariables.clear();
+}
+
 bool OTScript::ExecuteScript(OTVariable*)
 {
     otErr << "OTScript::ExecuteScript: Scripting has been disabled.\n";
@@ -53,6 +53,37 @@
 namespace opentxs
 {
 
+// The engine state (registered functions, types and globals) plus the
+// locals, as they were right after the OT native calls were registered.
+//
+struct OTScriptChai::State
+{
+    chaiscript::ChaiScript::State state;
+    std::map<std::string, chaiscript::Boxed_Value> locals;
+};
+
+void OTScriptChai::SaveBaseline()
+{
+    OT_ASSERT(nullptr != chai);
+
+    if (nullptr == m_pBaseline) m_pBaseline = new State;
+
+    m_pBaseline->state = chai->get_state();
+    m_pBaseline->locals = chai->get_locals();
+}
+
+void OTScriptChai::ResetToBaseline()
+{
+    OTScript::ResetToBaseline();
+
+    OT_ASSERT(nullptr != chai);
+
+    if (nullptr == m_pBaseline) return;
+
+    chai->set_state(m_pBaseline->state);
+    chai->set_locals(m_pBaseline->locals);
+}
+
 bool OTScriptChai::ExecuteScript(OTVariable* pReturnVar)
 {
     using namespace chaiscript;
@@ -351,30 +382,35 @@ bool OTScriptChai::ExecuteScript(OTVariable* pReturnVar)
 OTScriptChai::OTScriptChai()
     : OTScript()
     , chai(new chaiscript::ChaiScript())
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const OTString& strValue)
     : OTScript(strValue)
     , chai(new chaiscript::ChaiScript())
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const char* new_string)
     : OTScript(new_string)
     , chai(new chaiscript::ChaiScript())
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const char* new_string, size_t sizeLength)
     : OTScript(new_string, sizeLength)
     , chai(new chaiscript::ChaiScript())
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const std::string& new_string)
     : OTScript(new_string)
     , chai(new chaiscript::ChaiScript())
+    , m_pBaseline(nullptr)
 {
 }
 
@@ -383,30 +419,35 @@ OTScriptChai::OTScriptChai(const std::string& new_string)
 OTScriptChai::OTScriptChai()
     : OTScript()
     , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const String& strValue)
     : OTScript(strValue)
     , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const char* new_string)
     : OTScript(new_string)
     , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const char* new_string, size_t sizeLength)
     : OTScript(new_string, sizeLength)
     , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , m_pBaseline(nullptr)
 {
 }
 
 OTScriptChai::OTScriptChai(const std::string& new_string)
     : OTScript(new_string)
     , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , m_pBaseline(nullptr)
 {
 }
 
@@ -414,6 +455,7 @@ OTScriptChai::OTScriptChai(const std::string& new_string)
 
 OTScriptChai::~OTScriptChai()
 {
+    if (nullptr != m_pBaseline) delete m_pBaseline;
     if (nullptr != chai) delete chai;
 }
 
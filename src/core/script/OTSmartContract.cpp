@@ -990,6 +990,9 @@ void OTSmartContract::SetRemainingTimer(
             SetNextProcessDate(OT_TIME_ZERO); // This way, you can deactivate
                                               // the timer, by setting the next
                                               // process date to 0.
+
+        // The timer decides when Cron processes this next.
+        if (nullptr != GetCron()) GetCron()->ScheduleItem(*this);
     }
 }
 
@@ -2988,6 +2991,7 @@ bool OTSmartContract::StashFunds(const mapOfNyms& map_NymsAlreadyLoaded,
     // and re-sign it and save it, no matter what. So I just
     // call this here to keep it simple:
 
+    pCron->SetItemChanged(*this);
     pCron->SaveCron(); // TODO No need to call this here if I can make sure it's
                        // being called higher up somewhere
     // (Imagine a script that has 10 account moves in it -- maybe don't need to
@@ -3539,6 +3543,21 @@ void OTSmartContract::onFinalReceipt(OTCronItem& theOrigCronItem,
 // OTCron calls this regularly, which is my chance to expire, etc.
 // Return True if I should stay on the Cron list for more processing.
 // Return False if I should be removed and deleted.
+// Smart contracts only process once per GetProcessInterval(), and not
+// before the script's timer pops, if it has set one.
+time64_t OTSmartContract::GetCronDueDate() const
+{
+    const time64_t tDueDate = GetProcessIntervalDueDate();
+
+    if ((OT_TIME_ZERO == tDueDate) || (GetNextProcessDate() <= OT_TIME_ZERO))
+        return tDueDate;
+
+    const time64_t tTimerDate =
+        OTTimeAddTimeInterval(GetNextProcessDate(), 1);
+
+    return (tTimerDate > tDueDate) ? tTimerDate : tDueDate;
+}
+
 bool OTSmartContract::ProcessCron()
 {
     OT_ASSERT(nullptr != GetCron());
@@ -3651,6 +3670,36 @@ void OTSmartContract::SetDisplayLabel(const std::string* pstrLabel)
                       (nullptr != pstrLabel) ? pstrLabel->c_str() : "");
 }
 
+// Creating a script engine and registering all the native OT calls with it
+// costs far more than most clauses do, so each bylaw keeps its own engine for
+// as long as this smart contract is loaded. The engine is saved right after
+// registration, and is reset to that state after every execution.
+//
+std::shared_ptr<OTScript> OTSmartContract::GetBylawScript(OTBylaw& theBylaw)
+{
+    const std::string str_bylaw_name = theBylaw.GetName().Get();
+
+    auto it = m_mapScripts.find(str_bylaw_name);
+
+    if (m_mapScripts.end() != it) return it->second;
+
+    std::shared_ptr<OTScript> pScript =
+        OTScriptFactory(theBylaw.GetLanguage()); // Default is "chai"
+
+    if (pScript) {
+        // Register the special server-side native OT calls we make
+        // available to all scripts.
+        //
+        RegisterOTNativeCallsWithScript(*pScript);
+        pScript->SaveBaseline();
+
+        m_mapScripts.insert(std::pair<std::string, std::shared_ptr<OTScript>>(
+            str_bylaw_name, pScript));
+    }
+
+    return pScript;
+}
+
 void OTSmartContract::ExecuteClauses(mapOfClauses& theClauses,
                                      String* pParam) // someday
                                                      // pParam could
@@ -3660,6 +3709,10 @@ void OTSmartContract::ExecuteClauses(mapOfClauses& theClauses,
                                                      // single
                                                      // param.
 {
+    // Whether any clause changed any variable. (Each clause starts from
+    // clean variables, so this has to be checked after each one.)
+    bool bChangedVariables = false;
+
     // Loop through the clauses passed in, and execute them all.
     for (auto& it_clauses : theClauses) {
         const std::string str_clause_name = it_clauses.first;
@@ -3673,23 +3726,20 @@ void OTSmartContract::ExecuteClauses(mapOfClauses& theClauses,
 
         const std::string str_code =
             pClause->GetCode(); // source code for the script.
-        const std::string str_language =
-            pBylaw->GetLanguage(); // language it's in. (Default is "chai")
 
-        std::shared_ptr<OTScript> pScript =
-            OTScriptFactory(str_language, str_code);
+        // The engine for this bylaw's language already has the native OT
+        // calls registered. (See GetBylawScript.)
+        //
+        std::shared_ptr<OTScript> pScript = GetBylawScript(*pBylaw);
 
         std::unique_ptr<OTVariable> theVarAngel;
 
         //
-        // SET UP THE NATIVE CALLS, REGISTER THE PARTIES, REGISTER THE
-        // VARIABLES, AND EXECUTE THE SCRIPT.
+        // REGISTER THE PARTIES, REGISTER THE VARIABLES, AND EXECUTE THE
+        // SCRIPT.
         //
         if (pScript) {
-            // Register the special server-side native OT calls we make
-            // available to all scripts.
-            //
-            RegisterOTNativeCallsWithScript(*pScript);
+            pScript->SetScript(str_code);
 
             // Register all the parties with the script.
             //
@@ -3777,6 +3827,14 @@ void OTSmartContract::ExecuteClauses(mapOfClauses& theClauses,
                          "smartcontract trans# " << GetTransactionNum()
                       << ", clause: " << str_clause_name << " \n\n";
 
+            if (IsDirty()) bChangedVariables = true;
+
+            // Drop the parties and variables again, so the cached engine
+            // doesn't keep pointers to them once this clause is done.
+            //
+            theVarAngel.reset();
+            pScript->ResetToBaseline();
+
             //            For now, I've decided to allow ALL clauses to trigger
             // on the hook. The flag only matters after
             //            they are done, and not between scripts. Otherwise
@@ -3842,6 +3900,10 @@ void OTSmartContract::ExecuteClauses(mapOfClauses& theClauses,
                   << " dropping notifications into all parties' nymboxes.\n";
         }
     }
+
+    // The variables are saved along with the contract. (So is the server's
+    // signature, if it was just re-signed above.)
+    if (bChangedVariables) GetCron()->SetItemChanged(*this);
 }
 
 // The server calls this when it wants to know if a certain party is allowed to
@@ -5276,6 +5338,8 @@ void OTSmartContract::ReleaseStashes()
 
 void OTSmartContract::Release_SmartContract()
 {
+    // The cached engines reference the bylaws' variables, so they go first.
+    m_mapScripts.clear();
 
     ReleaseStashes();
 }
@@ -6529,6 +6593,7 @@ bool OTSmartContract::MoveFunds(
     // and re-sign it and save it, no matter what. So I just
     // call this here to keep it simple:
 
+    GetCron()->SetItemChanged(*this);
     GetCron()->SaveCron();
 
     return bSuccess;
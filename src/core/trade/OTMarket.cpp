@@ -42,6 +42,8 @@
 #include <opentxs/core/trade/OTOffer.hpp>
 #include <opentxs/core/trade/OTTrade.hpp>
 #include <opentxs/core/Account.hpp>
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
 #include <opentxs/core/Ledger.hpp>
 #include <opentxs/core/util/Tag.hpp>
 #include <opentxs/core/Log.hpp>
@@ -51,6 +53,9 @@
 #include <irrxml/irrXML.hpp>
 
 #include <memory>
+#include <sstream>
+
+#define MARKET_OFFER_FOLDER "offers" // markets/offers/TRANSACTION_NUM.off
 
 // return -1 if error, 0 if nothing, and 1 if the node was processed.
 
@@ -79,6 +84,11 @@ int32_t OTMarket::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
             String::StringToLong(xml->getAttributeValue("lastSalePrice"));
         m_strLastSaleDate = xml->getAttributeValue("lastSaleDate");
 
+        // Older market files have no journal attribute.
+        const String strGeneration(xml->getAttributeValue("journal"));
+        m_lJournalGeneration =
+            strGeneration.Exists() ? strGeneration.ToLong() : 0;
+
         const String strNotaryID(xml->getAttributeValue("notaryID")),
             strInstrumentDefinitionID(
                 xml->getAttributeValue("instrumentDefinitionID")),
@@ -159,10 +169,11 @@ void OTMarket::UpdateContents()
     tag.add_attribute("marketScale", formatLong(m_lScale));
     tag.add_attribute("lastSaleDate", m_strLastSaleDate);
     tag.add_attribute("lastSalePrice", formatLong(m_lLastSalePrice));
+    tag.add_attribute("journal", formatLong(m_lJournalGeneration));
 
-    // Save the offers for sale.
-    for (auto& it : m_mapAsks) {
-        OTOffer* pOffer = it.second;
+    OTASCIIArmor::CompressionScope theScope(OTCron::GetCronCompressionLevel());
+
+    auto saveOffer = [&tag](OTOffer* pOffer) {
         OT_ASSERT(nullptr != pOffer);
 
         String strOffer(
@@ -173,21 +184,16 @@ void OTMarket::UpdateContents()
         tagOffer->add_attribute(
             "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
         tag.add_tag(tagOffer);
-    }
+    };
 
-    // Save the bids.
-    for (auto& it : m_mapBids) {
-        OTOffer* pOffer = it.second;
-        OT_ASSERT(nullptr != pOffer);
-
-        String strOffer(
-            *pOffer); // Extract the offer contract into string form.
-        OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
+    // Save the offers for sale, and then the bids. Within each price, they
+    // are saved in the order they will be filled, so they load back in that
+    // order.
+    for (const OTOrderBook* pBook : {&m_Asks, &m_Bids}) {
+        for (auto& theLevel : *pBook)
+            for (auto& pOffer : theLevel.dequeOffers) saveOffer(pOffer);
 
-        TagPtr tagOffer(new Tag("offer", ascOffer.Get()));
-        tagOffer->add_attribute(
-            "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
-        tag.add_tag(tagOffer);
+        for (auto& pOffer : pBook->GetMarketOrders()) saveOffer(pOffer);
     }
 
     std::string str_result;
@@ -198,16 +204,7 @@ void OTMarket::UpdateContents()
 
 int64_t OTMarket::GetTotalAvailableAssets()
 {
-    int64_t lTotal = 0;
-
-    for (auto& it : m_mapAsks) {
-        OTOffer* pOffer = it.second;
-        OT_ASSERT(nullptr != pOffer);
-
-        lTotal += pOffer->GetAmountAvailable();
-    }
-
-    return lTotal;
+    return m_Asks.GetTotalAvailable();
 }
 
 // Get list of offers for a particular Nym, to send that Nym
@@ -395,77 +392,87 @@ bool OTMarket::GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
         dynamic_cast<OTDB::OfferListMarket*>(
             OTDB::CreateObject(OTDB::STORED_OBJ_OFFER_LIST_MARKET)));
 
-    //    mapOfOffers            m_mapBids;        // The buyers, ordered by
-    // price limit
-    //    mapOfOffers            m_mapAsks;        // The sellers, ordered by
-    // price limit
-
+    // Each side is listed from the best price down. Market orders have no
+    // price, so they aren't listed.
     int32_t nTempDepth = 0;
 
-    for (auto& it : m_mapBids) {
-        if (nTempDepth++ > lDepth) break;
+    for (auto& theLevel : m_Bids) {
+        if (nTempDepth > lDepth) break;
 
-        OTOffer* pOffer = it.second;
-        OT_ASSERT(nullptr != pOffer);
-
-        const int64_t& lPriceLimit = pOffer->GetPriceLimit();
+        for (auto& pOffer : theLevel.dequeOffers) {
+            if (nTempDepth++ > lDepth) break;
 
-        if (0 == lPriceLimit) // Skipping any market orders.
-            continue;
-
-        // OfferDataMarket
-        std::unique_ptr<OTDB::BidData> pOfferData(dynamic_cast<OTDB::BidData*>(
-            OTDB::CreateObject(OTDB::STORED_OBJ_BID_DATA)));
-
-        const int64_t& lTransactionNum = pOffer->GetTransactionNum();
-        const int64_t lAvailableAssets = pOffer->GetAmountAvailable();
-        const int64_t& lMinimumIncrement = pOffer->GetMinimumIncrement();
-        const time64_t tDateAddedToMarket = pOffer->GetDateAddedToMarket();
-
-        pOfferData->transaction_id = to_string<int64_t>(lTransactionNum);
-        pOfferData->price_per_scale = to_string<int64_t>(lPriceLimit);
-        pOfferData->available_assets = to_string<int64_t>(lAvailableAssets);
-        pOfferData->minimum_increment = to_string<int64_t>(lMinimumIncrement);
-        pOfferData->date = to_string<time64_t>(tDateAddedToMarket);
+            OT_ASSERT(nullptr != pOffer);
 
-        // *pOfferData is CLONED at this time (I'm still responsible to delete.)
-        // That's also why I add it here, below: So the data is set right before
-        // the cloning occurs.
-        //
-        pOfferList->AddBidData(*pOfferData);
-        nOfferCount++;
+            const int64_t& lPriceLimit = pOffer->GetPriceLimit();
+
+            // OfferDataMarket
+            std::unique_ptr<OTDB::BidData> pOfferData(
+                dynamic_cast<OTDB::BidData*>(
+                    OTDB::CreateObject(OTDB::STORED_OBJ_BID_DATA)));
+
+            const int64_t& lTransactionNum = pOffer->GetTransactionNum();
+            const int64_t lAvailableAssets = pOffer->GetAmountAvailable();
+            const int64_t& lMinimumIncrement =
+                pOffer->GetMinimumIncrement();
+            const time64_t tDateAddedToMarket =
+                pOffer->GetDateAddedToMarket();
+
+            pOfferData->transaction_id = to_string<int64_t>(lTransactionNum);
+            pOfferData->price_per_scale = to_string<int64_t>(lPriceLimit);
+            pOfferData->available_assets =
+                to_string<int64_t>(lAvailableAssets);
+            pOfferData->minimum_increment =
+                to_string<int64_t>(lMinimumIncrement);
+            pOfferData->date = to_string<time64_t>(tDateAddedToMarket);
+
+            // *pOfferData is CLONED at this time (I'm still responsible to
+            // delete.) That's also why I add it here, below: So the data is
+            // set right before the cloning occurs.
+            //
+            pOfferList->AddBidData(*pOfferData);
+            nOfferCount++;
+        }
     }
 
     nTempDepth = 0;
 
-    for (auto& it : m_mapAsks) {
-        if (nTempDepth++ > lDepth) break;
-
-        OTOffer* pOffer = it.second;
-        OT_ASSERT(nullptr != pOffer);
-
-        // OfferDataMarket
-        std::unique_ptr<OTDB::AskData> pOfferData(dynamic_cast<OTDB::AskData*>(
-            OTDB::CreateObject(OTDB::STORED_OBJ_ASK_DATA)));
+    for (auto& theLevel : m_Asks) {
+        if (nTempDepth > lDepth) break;
 
-        const int64_t& lTransactionNum = pOffer->GetTransactionNum();
-        const int64_t& lPriceLimit = pOffer->GetPriceLimit();
-        const int64_t lAvailableAssets = pOffer->GetAmountAvailable();
-        const int64_t& lMinimumIncrement = pOffer->GetMinimumIncrement();
-        const time64_t tDateAddedToMarket = pOffer->GetDateAddedToMarket();
+        for (auto& pOffer : theLevel.dequeOffers) {
+            if (nTempDepth++ > lDepth) break;
 
-        pOfferData->transaction_id = to_string<int64_t>(lTransactionNum);
-        pOfferData->price_per_scale = to_string<int64_t>(lPriceLimit);
-        pOfferData->available_assets = to_string<int64_t>(lAvailableAssets);
-        pOfferData->minimum_increment = to_string<int64_t>(lMinimumIncrement);
-        pOfferData->date = to_string<time64_t>(tDateAddedToMarket);
+            OT_ASSERT(nullptr != pOffer);
 
-        // *pOfferData is CLONED at this time (I'm still responsible to delete.)
-        // That's also why I add it here, below: So the data is set right before
-        // the cloning occurs.
-        //
-        pOfferList->AddAskData(*pOfferData);
-        nOfferCount++;
+            // OfferDataMarket
+            std::unique_ptr<OTDB::AskData> pOfferData(
+                dynamic_cast<OTDB::AskData*>(
+                    OTDB::CreateObject(OTDB::STORED_OBJ_ASK_DATA)));
+
+            const int64_t& lTransactionNum = pOffer->GetTransactionNum();
+            const int64_t& lPriceLimit = pOffer->GetPriceLimit();
+            const int64_t lAvailableAssets = pOffer->GetAmountAvailable();
+            const int64_t& lMinimumIncrement =
+                pOffer->GetMinimumIncrement();
+            const time64_t tDateAddedToMarket =
+                pOffer->GetDateAddedToMarket();
+
+            pOfferData->transaction_id = to_string<int64_t>(lTransactionNum);
+            pOfferData->price_per_scale = to_string<int64_t>(lPriceLimit);
+            pOfferData->available_assets =
+                to_string<int64_t>(lAvailableAssets);
+            pOfferData->minimum_increment =
+                to_string<int64_t>(lMinimumIncrement);
+            pOfferData->date = to_string<time64_t>(tDateAddedToMarket);
+
+            // *pOfferData is CLONED at this time (I'm still responsible to
+            // delete.) That's also why I add it here, below: So the data is
+            // set right before the cloning occurs.
+            //
+            pOfferList->AddAskData(*pOfferData);
+            nOfferCount++;
+        }
     }
 
     // Now pack the list into strOutput...
@@ -514,18 +521,6 @@ bool OTMarket::GetOfferList(OTASCIIArmor& ascOutput, int64_t lDepth,
     return false;
 }
 
-// To insure that offers of a specific price are always inserted at the upper
-// bound,
-// use this:  my_mmap.insert(my_mmap.upper_bound(key), my_mmap::value_type(key,
-// val));
-// This way I can read them from the lower bound later, and always get them in
-// the
-// order received for that price.
-//
-// typedef std::multimap<int64_t, OTOffer *>    mapOfOffers;
-// mapOfOffers    m_mapBids; // The buyers, ordered
-// mapOfOffers    m_mapAsks; // The sellers, ordered
-
 OTOffer* OTMarket::GetOffer(const int64_t& lTransactionNum)
 {
     // See if there's something there with that transaction number.
@@ -554,6 +549,18 @@ OTOffer* OTMarket::GetOffer(const int64_t& lTransactionNum)
 
 bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
                                                            // wasn't found.
+{
+    if (!ForgetOffer(lTransactionNum)) return false;
+
+    m_setChangedOffers.erase(lTransactionNum);
+    AddJournalRecord("remove " + formatLong(lTransactionNum));
+
+    return SaveMarket(); // <====== SAVE since an offer was removed.
+}
+
+// Removes the offer from the market without saving anything.
+//
+bool OTMarket::ForgetOffer(const int64_t& lTransactionNum)
 {
     bool bReturnValue = false;
 
@@ -577,37 +584,10 @@ bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
         // But it's still on one of the other lists...
         m_mapOffers.erase(it);
 
-        // The code operates the same whether ask or bid. Just use a pointer.
-        mapOfOffers* pMap = (pOffer->IsBid() ? &m_mapBids : &m_mapAsks);
-
-        // Future solution here: instead of looping through all the offers and
-        // finding it,
-        // I could just have each Offer store a copy of the iterator that's
-        // returned when
-        // it's first inserted. Later I just erase that iterator from the right
-        // list to remove. Todo.
-        OTOffer* pSameOffer = nullptr;
-
-        for (mapOfOffers::iterator iii = pMap->begin(); iii != pMap->end();
-             ++iii) {
-            pSameOffer = iii->second;
-
-            OT_ASSERT_MSG(nullptr != pSameOffer,
-                          "nullptr offer pointer in OTMarket::RemoveOffer.\n");
-
-            // found it!
-            if (lTransactionNum == pSameOffer->GetTransactionNum()) {
-                pMap->erase(iii);
-                break;
-            }
-
-            // Later on, below this loop, this pointer will be nullptr or not,
-            // and
-            // I will know if it was removed.
-            pSameOffer = nullptr;
-        }
+        // The code operates the same whether ask or bid.
+        OTOrderBook& theBook = pOffer->IsBid() ? m_Bids : m_Asks;
 
-        if (nullptr == pSameOffer) {
+        if (!theBook.RemoveOffer(*pOffer)) {
             otErr << "Removed Offer from offers list, but not found on bid/ask "
                      "list.\n";
         }
@@ -617,23 +597,22 @@ bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
             bReturnValue = true; // Success.
         }
 
-        // pOffer was found on the Offers list.
-        // pSameOffer was found on the Bid or Ask list, with the same
-        // transaction ID.
-        // They SHOULD be pointers to the SAME object.
-        // Therefore I CANNOT delete them both.
-        //
-        OT_ASSERT(pOffer == pSameOffer);
-
         delete pOffer;
         pOffer = nullptr;
-        pSameOffer = nullptr;
     }
 
-    if (bReturnValue)
-        return SaveMarket(); // <====== SAVE since an offer was removed.
-    else
-        return false;
+    return bReturnValue;
+}
+
+void OTMarket::SetOfferChanged(const OTOffer& theOffer)
+{
+    m_setChangedOffers.insert(theOffer.GetTransactionNum());
+
+    // Its amount available may have changed.
+    OTOffer* pOffer = GetOffer(theOffer.GetTransactionNum());
+
+    if (nullptr != pOffer)
+        (pOffer->IsBid() ? m_Bids : m_Asks).OfferChanged(*pOffer);
 }
 
 // This method demands an Offer reference in order to verify that it really
@@ -646,8 +625,7 @@ bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
 bool OTMarket::AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile,
                         time64_t tDateAddedToMarket)
 {
-    const int64_t lTransactionNum = theOffer.GetTransactionNum(),
-                  lPriceLimit = theOffer.GetPriceLimit();
+    const int64_t lTransactionNum = theOffer.GetTransactionNum();
 
     // Make sure the offer is even appropriate for this market...
     if (!ValidateOfferForMarket(theOffer)) {
@@ -685,23 +663,13 @@ bool OTMarket::AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile,
         // So next, let's add it to the lists that are indexed by price:
 
         // Determine if it's a buy or sell, and add it to the right list.
+        // (Last in line at its price.)
         if (theOffer.IsBid()) {
-            // No bother checking if the offer is already on this list,
-            // since the code above basically already verifies that for us.
-
-            m_mapBids.insert(
-                m_mapBids.lower_bound(lPriceLimit), // highest bidders go first,
-                                                    // so I am last in line at
-                                                    // lower bound.
-                std::pair<int64_t, OTOffer*>(lPriceLimit, &theOffer));
+            m_Bids.AddOffer(theOffer);
             otLog4 << "Offer added as a bid to the market.\n";
         }
         else {
-            m_mapAsks.insert(
-                m_mapAsks.upper_bound(lPriceLimit), // lowest price sells first,
-                                                    // so I am last in line at
-                                                    // upper bound.
-                std::pair<int64_t, OTOffer*>(lPriceLimit, &theOffer));
+            m_Asks.AddOffer(theOffer);
             otLog4 << "Offer added as an ask to the market.\n";
         }
 
@@ -710,6 +678,7 @@ bool OTMarket::AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile,
             // being added for the first time.
             //
             theOffer.SetDateAddedToMarket(OTTimeGetCurrentTime());
+            SetOfferChanged(theOffer);
 
             return SaveMarket(); // <====== SAVE since an offer was added to the
                                  // Market.
@@ -744,6 +713,9 @@ bool OTMarket::LoadMarket()
 
     if (bSuccess) bSuccess = VerifySignature(*(GetCron()->GetServerNym()));
 
+    // Whatever changed since the market file was last saved in full.
+    if (bSuccess) bSuccess = LoadJournal();
+
     // Load the list of recent market trades (informational only.)
     //
     if (bSuccess) {
@@ -763,6 +735,12 @@ bool OTMarket::LoadMarket()
     return bSuccess;
 }
 
+// Saving the entire market file means re-serializing and re-signing every
+// offer on the book, so normally we only append what changed since the last
+// save: changed offers are each written to their own file, and the journal
+// records which ones, along with removed offers and the last sale. Once the
+// journal gets long enough, CompactMarket() saves it all in full.
+//
 bool OTMarket::SaveMarket()
 {
     OT_ASSERT(nullptr != GetCron());
@@ -774,6 +752,80 @@ bool OTMarket::SaveMarket()
     const char* szFoldername = OTFolders::Market().Get();
     const char* szFilename = str_MARKET_ID.Get();
 
+    if ((m_nJournalRecords >= OTCron::GetCronJournalMaxRecords()) ||
+        !OTDB::Exists(szFoldername, szFilename))
+        return CompactMarket();
+
+    std::string strRecords;
+    int32_t nRecords = 0;
+
+    // The offer is saved BEFORE the journal refers to it.
+    for (auto& lTransactionNum : m_setChangedOffers) {
+        OTOffer* pOffer = GetOffer(lTransactionNum);
+
+        if (nullptr == pOffer) continue; // Already removed.
+
+        const String strOffer(*pOffer);
+        const std::string str_Filename = formatLong(lTransactionNum) + ".off";
+
+        if (!OTDB::StorePlainString(strOffer.Get(), szFoldername,
+                                    MARKET_OFFER_FOLDER, str_Filename)) {
+            otErr << __FUNCTION__ << ": Error saving market offer: "
+                  << szFoldername << Log::PathSeparator()
+                  << MARKET_OFFER_FOLDER << Log::PathSeparator()
+                  << str_Filename << "\n";
+            return false;
+        }
+        m_setJournaledOffers.insert(lTransactionNum);
+
+        const int64_t lDateAdded =
+            OTTimeGetSecondsFromTime(pOffer->GetDateAddedToMarket());
+
+        strRecords += "offer " + formatLong(lTransactionNum) + " " +
+                      formatLong(lDateAdded) + "\n";
+        nRecords++;
+    }
+
+    strRecords += m_strJournalPending;
+    nRecords += m_nJournalPending;
+
+    if (nRecords > 0) {
+        const std::string strJournal =
+            JournalFilename(str_MARKET_ID, m_lJournalGeneration);
+
+        if (!OTDB::AppendPlainString(strRecords, szFoldername, strJournal)) {
+            otErr << __FUNCTION__ << ": Error appending to market journal:\n"
+                  << szFoldername << Log::PathSeparator() << strJournal
+                  << "\n";
+            return false;
+        }
+
+        m_setChangedOffers.clear();
+        m_strJournalPending.clear();
+        m_nJournalPending = 0;
+        m_nJournalRecords += nRecords;
+    }
+
+    if (m_bTradeListChanged) SaveTradeList(str_MARKET_ID);
+
+    return true;
+}
+
+bool OTMarket::CompactMarket()
+{
+    OT_ASSERT(nullptr != GetCron());
+    OT_ASSERT(nullptr != GetCron()->GetServerNym());
+
+    Identifier MARKET_ID(*this);
+    String str_MARKET_ID(MARKET_ID);
+
+    const char* szFoldername = OTFolders::Market().Get();
+    const char* szFilename = str_MARKET_ID.Get();
+
+    // The new market file starts a new journal. Until it's safely saved, the
+    // old market file and journal are still the ones that get loaded.
+    const int64_t lOldGeneration = m_lJournalGeneration++;
+
     // Remember, if the market has changed, the new contents will not be written
     // anywhere
     // until that market has been signed. So I have to re-sign here, or it would
@@ -787,30 +839,182 @@ bool OTMarket::SaveMarket()
         !SaveContract(szFoldername, szFilename)) {
         otErr << "Error saving Market:\n" << szFoldername
               << Log::PathSeparator() << szFilename << "\n";
+        m_lJournalGeneration = lOldGeneration;
         return false;
     }
 
-    // Save a copy of recent trades.
+    // Everything in the old journal is in the market file now.
+    for (auto& lTransactionNum : m_setJournaledOffers) {
+        const std::string str_Filename = formatLong(lTransactionNum) + ".off";
 
-    if (nullptr != m_pTradeList) {
-        
-        String str_TRADES_FILE;
-        str_TRADES_FILE.Format("%s.bin", str_MARKET_ID.Get());
-        
-        const char* szSubFolder = "recent"; // todo stop hardcoding.
+        if (OTDB::Exists(szFoldername, MARKET_OFFER_FOLDER, str_Filename))
+            OTDB::EraseValueByKey(szFoldername, MARKET_OFFER_FOLDER,
+                                  str_Filename);
+    }
+
+    const std::string strJournal =
+        JournalFilename(str_MARKET_ID, lOldGeneration);
 
-        // If this fails, oh well. It's informational, anyway.
-        if (!OTDB::StoreObject(*m_pTradeList, szFoldername, // markets
-                               szSubFolder,                 // markets/recent
-                               str_TRADES_FILE.Get()))      // markets/recent/<Market_ID>.bin
-            otErr << "Error saving recent trades for Market:\n" << szFoldername
-                  << Log::PathSeparator() << szSubFolder << Log::PathSeparator()
-                  << szFilename << "\n";
+    if (OTDB::Exists(szFoldername, strJournal))
+        OTDB::EraseValueByKey(szFoldername, strJournal);
+
+    m_setJournaledOffers.clear();
+    m_setChangedOffers.clear();
+    m_strJournalPending.clear();
+    m_nJournalPending = 0;
+    m_nJournalRecords = 0;
+
+    if (m_bTradeListChanged) SaveTradeList(str_MARKET_ID);
+
+    return true;
+}
+
+// Save a copy of recent trades.
+//
+bool OTMarket::SaveTradeList(const String& strMarketID)
+{
+    if (nullptr == m_pTradeList) return false;
+
+    const char* szFoldername = OTFolders::Market().Get();
+
+    String str_TRADES_FILE;
+    str_TRADES_FILE.Format("%s.bin", strMarketID.Get());
+
+    const char* szSubFolder = "recent"; // todo stop hardcoding.
+
+    // If this fails, oh well. It's informational, anyway.
+    if (!OTDB::StoreObject(*m_pTradeList, szFoldername, // markets
+                           szSubFolder,                 // markets/recent
+                           str_TRADES_FILE.Get())) { // markets/recent/<ID>.bin
+        otErr << "Error saving recent trades for Market:\n" << szFoldername
+              << Log::PathSeparator() << szSubFolder << Log::PathSeparator()
+              << str_TRADES_FILE << "\n";
+        return false;
     }
 
+    m_bTradeListChanged = false;
+
     return true;
 }
 
+// Each journal record is one newline-terminated line: "offer" followed by a
+// transaction number and the date the offer was added to the market, in
+// seconds; "remove" followed by a transaction number; or "sale" followed by
+// the last sale price and date. A crash while appending can only leave a
+// partial record at the end, which is ignored.
+//
+bool OTMarket::LoadJournal()
+{
+    Identifier MARKET_ID(*this);
+    String str_MARKET_ID(MARKET_ID);
+
+    const char* szFoldername = OTFolders::Market().Get();
+    const std::string strJournal =
+        JournalFilename(str_MARKET_ID, m_lJournalGeneration);
+
+    if (!OTDB::Exists(szFoldername, strJournal)) return true;
+
+    Nym* pServerNym = GetCron()->GetServerNym();
+
+    std::istringstream journal(
+        OTDB::QueryPlainString(szFoldername, strJournal));
+    std::string strLine;
+
+    while (std::getline(journal, strLine) && !journal.eof()) {
+        std::istringstream record(strLine);
+        std::string strType;
+        int64_t lNumber = 0;
+
+        if (!(record >> strType >> lNumber)) {
+            otErr << __FUNCTION__ << ": Skipping bad journal record: "
+                  << strLine << "\n";
+            continue;
+        }
+        m_nJournalRecords++;
+
+        if ("sale" == strType) {
+            record >> m_strLastSaleDate;
+            m_lLastSalePrice = lNumber;
+        }
+        else if ("remove" == strType) {
+            if (nullptr != GetOffer(lNumber)) ForgetOffer(lNumber);
+            m_setJournaledOffers.insert(lNumber); // Its file may still exist.
+        }
+        else if ("offer" == strType) {
+            int64_t lDateAdded = 0;
+            record >> lDateAdded;
+            m_setJournaledOffers.insert(lNumber);
+
+            const std::string str_Filename = formatLong(lNumber) + ".off";
+
+            std::unique_ptr<OTOffer> pOffer(
+                new OTOffer(m_NOTARY_ID, m_INSTRUMENT_DEFINITION_ID,
+                            m_CURRENCY_TYPE_ID, m_lScale));
+
+            // Offers on the market are signed by the server.
+            if (!OTDB::Exists(szFoldername, MARKET_OFFER_FOLDER,
+                              str_Filename) ||
+                !pOffer->LoadContractFromString(
+                    String(OTDB::QueryPlainString(
+                        szFoldername, MARKET_OFFER_FOLDER, str_Filename))) ||
+                (pOffer->GetTransactionNum() != lNumber) ||
+                !pOffer->VerifySignature(*pServerNym)) {
+                otErr << __FUNCTION__ << ": ERROR loading or verifying market "
+                                         "offer from journal: " << lNumber
+                      << " (Keeping the previous version, if any.)\n";
+                continue;
+            }
+
+            // Newer than the version from the market file, so it takes the
+            // place of that one, on the same date.
+            time64_t tDateAdded = OTTimeGetTimeFromSeconds(lDateAdded);
+            OTOffer* pOldOffer = GetOffer(lNumber);
+
+            if (nullptr != pOldOffer) {
+                tDateAdded = pOldOffer->GetDateAddedToMarket();
+
+                // Keeps its place in line.
+                OTOrderBook& theBook = pOldOffer->IsBid() ? m_Bids : m_Asks;
+
+                if ((pOldOffer->IsBid() == pOffer->IsBid()) &&
+                    theBook.ReplaceOffer(*pOldOffer, *pOffer)) {
+                    pOffer->SetDateAddedToMarket(tDateAdded);
+                    m_mapOffers[lNumber] = pOffer.release();
+                    delete pOldOffer;
+                    continue;
+                }
+
+                ForgetOffer(lNumber);
+            }
+
+            if (AddOffer(nullptr, *pOffer, false, tDateAdded))
+                pOffer.release(); // The market owns it now.
+            else
+                otErr << __FUNCTION__ << ": Unable to add offer from journal "
+                                         "to market: " << lNumber << "\n";
+        }
+        else {
+            otErr << __FUNCTION__ << ": Skipping bad journal record: "
+                  << strLine << "\n";
+        }
+    }
+
+    return true;
+}
+
+void OTMarket::AddJournalRecord(const std::string& strRecord)
+{
+    m_strJournalPending += strRecord + "\n";
+    m_nJournalPending++;
+}
+
+std::string OTMarket::JournalFilename(const String& strMarketID,
+                                      int64_t lGeneration) const
+{
+    return std::string(strMarketID.Get()) + "." + formatLong(lGeneration) +
+           ".jrn";
+}
+
 // A Market's ID is based on the instrument definition, the currency type, and
 // the scale.
 //
@@ -834,56 +1038,14 @@ void OTMarket::GetIdentifier(Identifier& theIdentifier) const
 // bid on the market.
 int64_t OTMarket::GetHighestBidPrice()
 {
-    int64_t lPrice = 0;
-
-    mapOfOffers::reverse_iterator rr = m_mapBids.rbegin();
-
-    if (rr != m_mapBids.rend()) {
-        lPrice = rr->first;
-    }
-
-    return lPrice;
+    return m_Bids.GetBestPrice();
 }
 
 // returns 0 if there are no asks. Otherwise returns the value of the lowest ask
-// on the market.
+// on the market. (Market orders have a 0 price, so they aren't counted.)
 int64_t OTMarket::GetLowestAskPrice()
 {
-    int64_t lPrice = 0;
-
-    auto it = m_mapAsks.begin();
-
-    if (it != m_mapAsks.end()) {
-        lPrice = it->first;
-
-        // Market orders have a 0 price, so we need to skip any if they are
-        // here.
-        //
-        // Note that we don't have to do this with the highest bid price (above
-        // function) but in the case of asks, a "0 price" will undercut the
-        // other
-        // actual prices, so we need to skip any that have a 0 price.
-        //
-        while (0 == lPrice) {
-            ++it;
-
-            if (it == m_mapAsks.end()) break;
-
-            lPrice = it->first;
-        }
-    }
-
-    return lPrice;
-}
-
-// This utility function is used directly below (only).
-void OTMarket::cleanup_four_accounts(Account* p1, Account* p2, Account* p3,
-                                     Account* p4)
-{
-    if (p1) delete p1;
-    if (p2) delete p2;
-    if (p3) delete p3;
-    if (p4) delete p4;
+    return m_Asks.GetBestPrice();
 }
 
 // This utility function is used directly below (only).
@@ -961,6 +1123,11 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
 
     const Identifier NOTARY_ID(pCron->GetNotaryID());
 
+    // The Nyms, accounts and inboxes are checked out of here, and whatever
+    // was changed is saved through it too. Every way out of this function
+    // checks them back in.
+    OTVerificationCache& theCache = pCron->GetVerificationCache();
+
     if (pCron->GetTransactionCount() < 1) {
         otOut << "Failed to process trades: Out of transaction numbers!\n";
         return;
@@ -1022,8 +1189,6 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
         NOTARY_NYM_ID(
             *pServerNym); // The Server Nym (could be one or both of the above.)
 
-    Nym theNym, theOtherNym; // We MIGHT use ONE, OR BOTH, of these, or none.
-
     // Find out if either Nym is actually also the server.
     bool bFirstNymIsServerNym =
         ((FIRST_NYM_ID == NOTARY_NYM_ID) ? true : false);
@@ -1034,7 +1199,6 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
     // entity. We'll want to know that later.
     bool bTradersAreSameNym = ((FIRST_NYM_ID == OTHER_NYM_ID) ? true : false);
 
-    // Initially both nym pointers are set to their own blank objects
     Nym* pFirstNym = nullptr;
     Nym* pOtherNym = nullptr;
 
@@ -1045,32 +1209,17 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
     {
         pFirstNym = pServerNym;
     }
-    else // Else load the First Nym from storage.
+    else // Else load the First Nym from storage. (Or from the cache.)
     {
-        theNym.SetIdentifier(FIRST_NYM_ID); // theNym is pFirstNym
+        pFirstNym = theCache.GetNym(FIRST_NYM_ID, *pServerNym);
 
-        if (!theNym.LoadPublicKey()) {
-            String strNymID(FIRST_NYM_ID);
-            otErr << "Failure loading First Nym public key in OTMarket::"
-                  << __FUNCTION__ << ": " << strNymID << "\n";
-            theTrade.FlagForRemoval();
-            return;
-        }
-
-        if (theNym.VerifyPseudonym() && theTrade.VerifySignature(*pServerNym) &&
-            theOffer.VerifySignature(*pServerNym) &&
-            theNym.LoadSignedNymfile(*pServerNym)) // ServerNym here is not
-                                                   // theNym's identity, but
-                                                   // merely the signer on this
-                                                   // file.
-        {
-            pFirstNym = &theNym; //  <=====
-        }
-        else {
+        if ((nullptr == pFirstNym) || !theTrade.VerifySignature(*pServerNym) ||
+            !theOffer.VerifySignature(*pServerNym)) {
             String strNymID(FIRST_NYM_ID);
             otErr << "OTMarket::" << __FUNCTION__
                   << ": Failure verifying trade, offer, or nym, or loading "
                      "signed Nymfile: " << strNymID << "\n";
+            theCache.CheckIn();
             theTrade.FlagForRemoval();
             return;
         }
@@ -1084,30 +1233,19 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
     else if (bTradersAreSameNym) // Else if the Traders are the same Nym,
                                    // point to the one we already loaded.
     {
-        pOtherNym = pFirstNym; // theNym is pFirstNym
+        pOtherNym = pFirstNym;
     }
     else // Otherwise load the Other Nym from Disk and point to that.
     {
-        theOtherNym.SetIdentifier(OTHER_NYM_ID);
+        pOtherNym = theCache.GetNym(OTHER_NYM_ID, *pServerNym);
 
-        if (!theOtherNym.LoadPublicKey()) {
-            String strNymID(OTHER_NYM_ID);
-            otErr << "Failure loading Other Nym public key in OTMarket::"
-                  << __FUNCTION__ << ": " << strNymID << "\n";
-            pOtherTrade->FlagForRemoval();
-            return;
-        }
-
-        if (theOtherNym.VerifyPseudonym() &&
-            pOtherTrade->VerifySignature(*pServerNym) &&
-            theOtherOffer.VerifySignature(*pServerNym) &&
-            theOtherNym.LoadSignedNymfile(*pServerNym)) {
-            pOtherNym = &theOtherNym; //  <=====
-        }
-        else {
+        if ((nullptr == pOtherNym) ||
+            !pOtherTrade->VerifySignature(*pServerNym) ||
+            !theOtherOffer.VerifySignature(*pServerNym)) {
             String strNymID(OTHER_NYM_ID);
             otErr << "Failure loading or verifying Other Nym public key in "
                      "OTMarket::" << __FUNCTION__ << ": " << strNymID << "\n";
+            theCache.CheckIn();
             pOtherTrade->FlagForRemoval();
             return;
         }
@@ -1140,22 +1278,22 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
 
     // Make sure have ALL FOUR accounts loaded and checked out.
     // (first nym's asset/currency, and other nym's asset/currency.)
+    // The cache has already verified their signatures.
 
-    Account* pFirstAssetAcct =
-        Account::LoadExistingAccount(theTrade.GetSenderAcctID(), NOTARY_ID);
-    Account* pFirstCurrencyAcct =
-        Account::LoadExistingAccount(theTrade.GetCurrencyAcctID(), NOTARY_ID);
+    Account* pFirstAssetAcct = theCache.GetAccount(
+        theTrade.GetSenderAcctID(), NOTARY_ID, *pServerNym);
+    Account* pFirstCurrencyAcct = theCache.GetAccount(
+        theTrade.GetCurrencyAcctID(), NOTARY_ID, *pServerNym);
 
-    Account* pOtherAssetAcct =
-        Account::LoadExistingAccount(pOtherTrade->GetSenderAcctID(), NOTARY_ID);
-    Account* pOtherCurrencyAcct = Account::LoadExistingAccount(
-        pOtherTrade->GetCurrencyAcctID(), NOTARY_ID);
+    Account* pOtherAssetAcct = theCache.GetAccount(
+        pOtherTrade->GetSenderAcctID(), NOTARY_ID, *pServerNym);
+    Account* pOtherCurrencyAcct = theCache.GetAccount(
+        pOtherTrade->GetCurrencyAcctID(), NOTARY_ID, *pServerNym);
 
     if ((nullptr == pFirstAssetAcct) || (nullptr == pFirstCurrencyAcct)) {
         otOut << "ERROR verifying existence of one of the first trader's "
                  "accounts during attempted Market trade.\n";
-        cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                              pOtherAssetAcct, pOtherCurrencyAcct);
+        theCache.CheckIn();
         theTrade.FlagForRemoval(); // Removes from Cron.
         return;
     }
@@ -1163,8 +1301,7 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                (nullptr == pOtherCurrencyAcct)) {
         otOut << "ERROR verifying existence of one of the second trader's "
                  "accounts during attempted Market trade.\n";
-        cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                              pOtherAssetAcct, pOtherCurrencyAcct);
+        theCache.CheckIn();
         pOtherTrade->FlagForRemoval(); // Removes from Cron.
         return;
     }
@@ -1185,8 +1322,7 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
              ) {
         otErr << "ERROR - First Trader has accounts of wrong "
                  "instrument definitions in OTMarket::" << __FUNCTION__ << "\n";
-        cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                              pOtherAssetAcct, pOtherCurrencyAcct);
+        theCache.CheckIn();
         theTrade.FlagForRemoval(); // Removes from Cron.
         return;
     }
@@ -1200,36 +1336,26 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
     {
         otErr << "ERROR - Other Trader has accounts of wrong "
                  "instrument definitions in OTMarket::" << __FUNCTION__ << "\n";
-        cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                              pOtherAssetAcct, pOtherCurrencyAcct);
+        theCache.CheckIn();
         pOtherTrade->FlagForRemoval(); // Removes from Cron.
         return;
     }
 
-    // Make sure all accounts are signed by the server and have the owner they
-    // are expected to have.
-
-    // I call VerifySignature here since VerifyContractID was already called in
-    // LoadExistingAccount().
-    else if ((!pFirstAssetAcct->VerifyOwner(*pFirstNym) ||
-              !pFirstAssetAcct->VerifySignature(*pServerNym)) ||
-             (!pFirstCurrencyAcct->VerifyOwner(*pFirstNym) ||
-              !pFirstCurrencyAcct->VerifySignature(*pServerNym))) {
-        otErr << "ERROR verifying ownership or signature on one of first "
-                 "trader's accounts in OTMarket::" << __FUNCTION__ << "\n";
-        cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                              pOtherAssetAcct, pOtherCurrencyAcct);
+    // Make sure all accounts have the owner they are expected to have. (The
+    // cache already verified their signatures and contract IDs.)
+    else if (!pFirstAssetAcct->VerifyOwner(*pFirstNym) ||
+             !pFirstCurrencyAcct->VerifyOwner(*pFirstNym)) {
+        otErr << "ERROR verifying ownership on one of first trader's "
+                 "accounts in OTMarket::" << __FUNCTION__ << "\n";
+        theCache.CheckIn();
         theTrade.FlagForRemoval(); // Removes from Cron.
         return;
     }
-    else if ((!pOtherAssetAcct->VerifyOwner(*pOtherNym) ||
-                !pOtherAssetAcct->VerifySignature(*pServerNym)) ||
-               (!pOtherCurrencyAcct->VerifyOwner(*pOtherNym) ||
-                !pOtherCurrencyAcct->VerifySignature(*pServerNym))) {
-        otErr << "ERROR verifying ownership or signature on one of other "
-                 "trader's accounts in OTMarket::" << __FUNCTION__ << "\n";
-        cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                              pOtherAssetAcct, pOtherCurrencyAcct);
+    else if (!pOtherAssetAcct->VerifyOwner(*pOtherNym) ||
+             !pOtherCurrencyAcct->VerifyOwner(*pOtherNym)) {
+        otErr << "ERROR verifying ownership on one of other trader's "
+                 "accounts in OTMarket::" << __FUNCTION__ << "\n";
+        theCache.CheckIn();
         pOtherTrade->FlagForRemoval(); // Removes from Cron.
         return;
     }
@@ -1247,76 +1373,41 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
         // outbox and the recipient's inbox.
         // IF they can be loaded up from file, or generated, that is.
 
-        // Load the inbox/outbox in case they already exist
-        Ledger theFirstAssetInbox(FIRST_NYM_ID, theTrade.GetSenderAcctID(),
-                                  NOTARY_ID),
-            theFirstCurrencyInbox(FIRST_NYM_ID, theTrade.GetCurrencyAcctID(),
-                                  NOTARY_ID),
-            theOtherAssetInbox(OTHER_NYM_ID, pOtherTrade->GetSenderAcctID(),
-                               NOTARY_ID),
-            theOtherCurrencyInbox(OTHER_NYM_ID,
-                                  pOtherTrade->GetCurrencyAcctID(), NOTARY_ID);
-
-        // ALL inboxes -- no outboxes. All will receive notification of
-        // something ALREADY DONE.
-        bool bSuccessLoadingFirstAsset = theFirstAssetInbox.LoadInbox();
-        bool bSuccessLoadingFirstCurrency = theFirstCurrencyInbox.LoadInbox();
-        bool bSuccessLoadingOtherAsset = theOtherAssetInbox.LoadInbox();
-        bool bSuccessLoadingOtherCurrency = theOtherCurrencyInbox.LoadInbox();
-
-        // ...or generate them otherwise...
-
-        if (true == bSuccessLoadingFirstAsset)
-            bSuccessLoadingFirstAsset =
-                theFirstAssetInbox.VerifyAccount(*pServerNym);
-        else
-            bSuccessLoadingFirstAsset = theFirstAssetInbox.GenerateLedger(
-                theTrade.GetSenderAcctID(), NOTARY_ID, Ledger::inbox,
-                true); // bGenerateFile=true
-
-        if (true == bSuccessLoadingFirstCurrency)
-            bSuccessLoadingFirstCurrency =
-                theFirstCurrencyInbox.VerifyAccount(*pServerNym);
-        else
-            bSuccessLoadingFirstCurrency = theFirstCurrencyInbox.GenerateLedger(
-                theTrade.GetCurrencyAcctID(), NOTARY_ID, Ledger::inbox,
-                true); // bGenerateFile=true
-
-        if (true == bSuccessLoadingOtherAsset)
-            bSuccessLoadingOtherAsset =
-                theOtherAssetInbox.VerifyAccount(*pServerNym);
-        else
-            bSuccessLoadingOtherAsset = theOtherAssetInbox.GenerateLedger(
-                pOtherTrade->GetSenderAcctID(), NOTARY_ID, Ledger::inbox,
-                true); // bGenerateFile=true
-
-        if (true == bSuccessLoadingOtherCurrency)
-            bSuccessLoadingOtherCurrency =
-                theOtherCurrencyInbox.VerifyAccount(*pServerNym);
-        else
-            bSuccessLoadingOtherCurrency = theOtherCurrencyInbox.GenerateLedger(
-                pOtherTrade->GetCurrencyAcctID(), NOTARY_ID, Ledger::inbox,
-                true); // bGenerateFile=true
-
-        if ((false == bSuccessLoadingFirstAsset) ||
-            (false == bSuccessLoadingFirstCurrency)) {
+        // Load the inboxes in case they already exist, or generate them
+        // otherwise. ALL inboxes -- no outboxes. All will receive notification
+        // of something ALREADY DONE.
+        Ledger* pFirstAssetInbox = theCache.GetInbox(
+            FIRST_NYM_ID, theTrade.GetSenderAcctID(), NOTARY_ID, *pServerNym);
+        Ledger* pFirstCurrencyInbox = theCache.GetInbox(
+            FIRST_NYM_ID, theTrade.GetCurrencyAcctID(), NOTARY_ID, *pServerNym);
+        Ledger* pOtherAssetInbox =
+            theCache.GetInbox(OTHER_NYM_ID, pOtherTrade->GetSenderAcctID(),
+                              NOTARY_ID, *pServerNym);
+        Ledger* pOtherCurrencyInbox = theCache.GetInbox(
+            OTHER_NYM_ID, pOtherTrade->GetCurrencyAcctID(), NOTARY_ID,
+            *pServerNym);
+
+        if ((nullptr == pFirstAssetInbox) || (nullptr == pFirstCurrencyInbox)) {
             otErr << "ERROR loading or generating an inbox for first trader in "
                      "OTMarket::" << __FUNCTION__ << ".\n";
-            cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                                  pOtherAssetAcct, pOtherCurrencyAcct);
+            theCache.CheckIn();
             theTrade.FlagForRemoval(); // Removes from Cron.
             return;
         }
-        else if ((false == bSuccessLoadingOtherAsset) ||
-                   (false == bSuccessLoadingOtherCurrency)) {
+        else if ((nullptr == pOtherAssetInbox) ||
+                 (nullptr == pOtherCurrencyInbox)) {
             otErr << "ERROR loading or generating an inbox for other trader in "
                      "OTMarket::" << __FUNCTION__ << ".\n";
-            cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                                  pOtherAssetAcct, pOtherCurrencyAcct);
+            theCache.CheckIn();
             pOtherTrade->FlagForRemoval(); // Removes from Cron.
             return;
         }
         else {
+            Ledger& theFirstAssetInbox = *pFirstAssetInbox;
+            Ledger& theFirstCurrencyInbox = *pFirstCurrencyInbox;
+            Ledger& theOtherAssetInbox = *pOtherAssetInbox;
+            Ledger& theOtherCurrencyInbox = *pOtherCurrencyInbox;
+
             // Generate new transaction numbers for these new transactions
             int64_t lNewTransactionNumber = pCron->GetNextTransactionNumber();
 
@@ -1325,8 +1416,7 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
             if (0 == lNewTransactionNumber) {
                 otOut << "WARNING: Market is unable to process because there "
                          "are no more transaction numbers available.\n";
-                cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct,
-                                      pOtherAssetAcct, pOtherCurrencyAcct);
+                theCache.CheckIn();
                 // (Here I flag neither trade for removal.)
                 return;
             }
@@ -1832,8 +1922,15 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                     while (m_pTradeList->GetTradeDataMarketCount() >
                            MAX_MARKET_QUERY_DEPTH)
                         m_pTradeList->RemoveTradeDataMarket(0);
+
+                    m_bTradeListChanged = true;
                 }
 
+                SetOfferChanged(theOffer);
+                SetOfferChanged(theOtherOffer);
+                AddJournalRecord("sale " + formatLong(m_lLastSalePrice) + " " +
+                                 m_strLastSaleDate);
+
                 // Account balances have changed based on these trades that we
                 // just processed.
                 // Make sure to save the Market since it contains those offers
@@ -1843,6 +1940,8 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                 // The Trade has changed, and it is stored as a CronItem. So I
                 // save Cron as well, for
                 // the same reason I saved the Market.
+                pCron->SetItemChanged(theTrade);
+                pCron->SetItemChanged(*pOtherTrade);
                 pCron->SaveCron();
             }
 
@@ -2074,10 +2173,10 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                 // Save the four inboxes to storage. (File, DB, wherever it
                 // goes.)
 
-                pFirstAssetAcct->SaveInbox(theFirstAssetInbox);
-                pFirstCurrencyAcct->SaveInbox(theFirstCurrencyInbox);
-                pOtherAssetAcct->SaveInbox(theOtherAssetInbox);
-                pOtherCurrencyAcct->SaveInbox(theOtherCurrencyInbox);
+                theCache.SaveInbox(*pFirstAssetAcct, theFirstAssetInbox);
+                theCache.SaveInbox(*pFirstCurrencyAcct, theFirstCurrencyInbox);
+                theCache.SaveInbox(*pOtherAssetAcct, theOtherAssetInbox);
+                theCache.SaveInbox(*pOtherCurrencyAcct, theOtherCurrencyInbox);
 
                 // These correspond to the AddTransaction() calls just above.
                 // The actual receipts are stored in separate files now.
@@ -2100,10 +2199,10 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                 pFirstCurrencyAcct->SaveContract();
                 pOtherAssetAcct->SaveContract();
                 pOtherCurrencyAcct->SaveContract();
-                pFirstAssetAcct->SaveAccount();
-                pFirstCurrencyAcct->SaveAccount();
-                pOtherAssetAcct->SaveAccount();
-                pOtherCurrencyAcct->SaveAccount();
+                theCache.SaveAccount(*pFirstAssetAcct);
+                theCache.SaveAccount(*pFirstCurrencyAcct);
+                theCache.SaveAccount(*pOtherAssetAcct);
+                theCache.SaveAccount(*pOtherCurrencyAcct);
             }
             // If money was short, let's see WHO was short so we can remove his
             // trade.
@@ -2176,7 +2275,7 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                     pTempInbox->ReleaseSignatures();
                     pTempInbox->SignContract(*pServerNym);
                     pTempInbox->SaveContract();
-                    pTempInbox->SaveInbox();
+                    theCache.SaveInbox(*pAssetAccountToDebit, *pTempInbox);
 
                     pTempTransaction->SaveBoxReceipt(*pTempInbox);
                 }
@@ -2236,7 +2335,7 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                     pTempInbox->ReleaseSignatures();
                     pTempInbox->SignContract(*pServerNym);
                     pTempInbox->SaveContract();
-                    pTempInbox->SaveInbox();
+                    theCache.SaveInbox(*pCurrencyAccountToDebit, *pTempInbox);
 
                     pTempTransaction->SaveBoxReceipt(*pTempInbox);
                 }
@@ -2262,8 +2361,7 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
         }     // all four boxes were successfully loaded or generated.
     }         // "this entire function can be divided..."
 
-    cleanup_four_accounts(pFirstAssetAcct, pFirstCurrencyAcct, pOtherAssetAcct,
-                          pOtherCurrencyAcct);
+    theCache.CheckIn();
 }
 // Let's say pBid->Price is $10. He's bidding $10 as his price limit.
 // If I was ALREADY selling at $11, then NOTHING HAPPENS. (If we're the only two
@@ -2402,167 +2500,45 @@ bool OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer)
     // in the market WITHIN THIS TRADE'S PRICE LIMITS. So we're going to go up
     // the list of what's available, and trade.
 
-    if (theOffer.IsAsk()) // If I'm selling,
-    {
-        // rbegin puts us on the upper bound of the highest bidder (any new
-        // bidders at the same price would
-        // be added at the lower bound, where they are last in line.) The upper
-        // bound, on the other hand, is
-        // first in line.  So we start there, and loop backwards until there are
-        // no other bids within my price range.
-        for (mapOfOffers::reverse_iterator rr = m_mapBids.rbegin();
-             rr != m_mapBids.rend(); ++rr) {
-            // then I want to start at the highest bidder and loop DOWN until
-            // hitting my price limit.
-            OTOffer* pBid = rr->second;
-            OT_ASSERT(nullptr != pBid);
-
-            // NOTE: Market orders only process once, and they are processed in
-            // the order they were added to the market.
-            //
-            // If BOTH offers are market orders, we just skip this bid.
-            //
-            // But FURTHERMORE: We ONLY process a market order as theOffer, not
-            // as pBid!
-            // Imagine if pBid is a market order and theOffer isn't -- that
-            // would mean pBid
-            // hasn't been processed yet (since it will only process once.) So
-            // it needs to
-            // wait its turn! It will get its one shot WHEN ITS TURN comes.
-            //
-            if (pBid->IsMarketOrder())
-                //          if (theOffer.IsMarketOrder() &&
-                // pBid->IsMarketOrder())
-                //              continue;
-                break;
-            // NOTE: Why break, instead of continue? Because since we are
-            // looping through the bids,
-            // from the HIGHEST down to the LOWEST, and since market orders have
-            // a ZERO price, we know
-            // for a fact that there are not any other non-zero bids. (So we
-            // might as well break.)
-
-            // I'm selling.
-            //
-            // If the bid is larger than, or equal to, my low-side-limit,
-            // and the amount available is at least my minimum increment, (and
-            // vice versa),
-            // ...then let's trade!
-            //
-            if (theOffer.IsMarketOrder() || // If I don't care about price...
-                (pBid->GetPriceLimit() >=
-                 theOffer.GetPriceLimit())) // Or if this bid is within my price
-                                            // range...
-            {
-                // Notice the above "if" is ONLY based on price... because the
-                // "else" returns!
-                // (Once I am out of my price range, no point to continue
-                // looping.)
-                //
-                // ...So all the other "if"s have to go INSIDE the block here:
-                //
-                if ((pBid->GetAmountAvailable() >=
-                     theOffer.GetMinimumIncrement()) &&
-                    (theOffer.GetAmountAvailable() >=
-                     pBid->GetMinimumIncrement()) &&
-                    (nullptr != pBid->GetTrade()) &&
-                    !pBid->GetTrade()->IsFlaggedForRemoval())
-
-                    ProcessTrade(theTrade, theOffer, *pBid); // <========
-            }
+    // If I'm selling, I go down the bids starting with the highest bidder. If
+    // I'm buying, I go up the asks starting with the lowest seller. At each
+    // price, whoever was first in line goes first.
+    //
+    // NOTE: Market orders only process once, and they are processed in the
+    // order they were added to the market. We ONLY process a market order as
+    // theOffer, never as the other offer: if it's still waiting, it hasn't
+    // had its turn yet. (That's why market orders aren't on the price levels
+    // at all.)
+    //
+    const OTOrderBook& theOtherSide = theOffer.IsAsk() ? m_Bids : m_Asks;
 
-            // Else, the bid is lower than I am willing to sell. (And all the
-            // remaining bids are even lower.)
-            //
-            else if (theOffer.IsLimitOrder()) {
-                pBid = nullptr;
-                return true; // stay on cron for more processing (for now.)
-            }
+    for (auto& theLevel : theOtherSide) {
+        // Once the price is out of my range, all the remaining prices are
+        // even worse. (Market orders don't care about price.)
+        if (theOffer.IsLimitOrder() &&
+            (theOffer.IsAsk() ? (theLevel.lPrice < theOffer.GetPriceLimit())
+                              : (theLevel.lPrice > theOffer.GetPriceLimit())))
+            return true; // stay on the market for now.
 
-            // The offer has no more trading to do--it's done.
-            if (theTrade.IsFlaggedForRemoval() || // during processing, the
-                                                  // trade may have gotten
-                                                  // flagged.
-                (theOffer.GetMinimumIncrement() >
-                 theOffer.GetAmountAvailable())) {
-                    
-                    otInfo << "OTMarket::" << __FUNCTION__ << ": Removing market order: "
-                        << formatLong(theTrade.GetOpeningNum()) << ". IsFlaggedForRemoval: "
-                        << formatBool(theTrade.IsFlaggedForRemoval())
-                        << ". Minimum increment is larger than Amount available: "
-                    <<  (theOffer.GetMinimumIncrement() > theOffer.GetAmountAvailable()) << "\n";
-
-                    return false; // remove this trade from cron
-                }
+        // Nobody at this price has enough available for my minimum increment,
+        // or everybody here needs more than I have available.
+        if (!theLevel.CanFill(theOffer)) continue;
 
-            pBid = nullptr;
-        }
-    }
-    // I'm buying
-    else {
-        // Begin puts us on the lower bound of the lowest seller (any new
-        // sellers at the same price would
-        // be added at the upper bound for that price, where they are last in
-        // line.) The lower bound, on the other hand, is
-        // first in line.  So we start there, and loop forwards until there are
-        // no other asks within my price range.
-        //
-        for (auto& it : m_mapAsks) {
-            // then I want to start at the lowest seller and loop UP until
-            // hitting my price limit.
-            OTOffer* pAsk = it.second;
-            OT_ASSERT(nullptr != pAsk);
-
-            // NOTE: Market orders only process once, and they are processed in
-            // the order they were added to the market.
-            //
-            // If BOTH offers are market orders, we just skip this ask.
-            //
-            // But FURTHERMORE: We ONLY process a market order as theOffer, not
-            // as pAsk!
-            // Imagine if pAsk is a market order and theOffer isn't -- that
-            // would mean pAsk
-            // hasn't been processed yet (since it will only process once.) So
-            // it needs to
-            // wait its turn! It will get its one shot WHEN ITS TURN comes.
-            //
-            if (pAsk->IsMarketOrder())
-                //          if (theOffer.IsMarketOrder() &&
-                // pAsk->IsMarketOrder())
-                continue;
+        for (auto& pOther : theLevel.dequeOffers) {
+            OT_ASSERT(nullptr != pOther);
 
-            // I'm buying.
-            // If the ask price is less than, or equal to, my price limit,
-            // and the amount available for purchase is at least my minimum
-            // increment, (and vice versa),
+            // If the other offer is within my price range, and the amount
+            // available is at least my minimum increment, (and vice versa),
             // ...then let's trade!
             //
-            if (theOffer.IsMarketOrder() || // If I don't care about price...
-                (pAsk->GetPriceLimit() <=
-                 theOffer.GetPriceLimit())) // Or if this ask is within my price
-                                            // range...
-            {
-                // Notice the above "if" is ONLY based on price... because the
-                // "else" returns!
-                // (Once I am out of my price range, no point to continue
-                // looping.)
-                // So all the other "if"s have to go INSIDE the block here:
-                //
-                if ((pAsk->GetAmountAvailable() >=
-                     theOffer.GetMinimumIncrement()) &&
-                    (theOffer.GetAmountAvailable() >=
-                     pAsk->GetMinimumIncrement()) &&
-                    (nullptr != pAsk->GetTrade()) &&
-                    !pAsk->GetTrade()->IsFlaggedForRemoval())
-
-                    ProcessTrade(theTrade, theOffer, *pAsk); // <=======
-            }
-            // Else, the ask price is higher than I am willing to pay. (And all
-            // the remaining sellers are even HIGHER.)
-            else if (theOffer.IsLimitOrder()) {
-                pAsk = nullptr;
-                return true; // stay on the market for now.
-            }
+            if ((pOther->GetAmountAvailable() >=
+                 theOffer.GetMinimumIncrement()) &&
+                (theOffer.GetAmountAvailable() >=
+                 pOther->GetMinimumIncrement()) &&
+                (nullptr != pOther->GetTrade()) &&
+                !pOther->GetTrade()->IsFlaggedForRemoval())
+
+                ProcessTrade(theTrade, theOffer, *pOther); // <========
 
             // The offer has no more trading to do--it's done.
             if (theTrade.IsFlaggedForRemoval() || // during processing, the
@@ -2570,17 +2546,19 @@ bool OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer)
                                                   // flagged.
                 (theOffer.GetMinimumIncrement() >
                  theOffer.GetAmountAvailable())) {
-                    
-                    otInfo << "OTMarket::" << __FUNCTION__ << ": Removing market order: "
-                        << formatLong(theTrade.GetOpeningNum()) << ". IsFlaggedForRemoval: "
-                        << formatBool(theTrade.IsFlaggedForRemoval())
-                        << ". Minimum increment is larger than Amount available: "
-                        <<  (theOffer.GetMinimumIncrement() > theOffer.GetAmountAvailable()) << "\n";
-
-                    return false; // remove this trade from the market.
-                }
 
-            pAsk = nullptr;
+                otInfo << "OTMarket::" << __FUNCTION__
+                       << ": Removing market order: "
+                       << formatLong(theTrade.GetOpeningNum())
+                       << ". IsFlaggedForRemoval: "
+                       << formatBool(theTrade.IsFlaggedForRemoval())
+                       << ". Minimum increment is larger than Amount "
+                          "available: "
+                       << (theOffer.GetMinimumIncrement() >
+                           theOffer.GetAmountAvailable()) << "\n";
+
+                return false; // remove this trade from the market.
+            }
         }
     }
 
@@ -2674,8 +2652,14 @@ OTMarket::OTMarket(const char* szFilename)
     : Contract()
     , m_pCron(nullptr)
     , m_pTradeList(nullptr)
+    , m_Bids(true)
+    , m_Asks(false)
     , m_lScale(1)
     , m_lLastSalePrice(0)
+    , m_lJournalGeneration(0)
+    , m_nJournalRecords(0)
+    , m_nJournalPending(0)
+    , m_bTradeListChanged(false)
 {
     OT_ASSERT(nullptr != szFilename);
 
@@ -2690,8 +2674,14 @@ OTMarket::OTMarket()
     : Contract()
     , m_pCron(nullptr)
     , m_pTradeList(nullptr)
+    , m_Bids(true)
+    , m_Asks(false)
     , m_lScale(1)
     , m_lLastSalePrice(0)
+    , m_lJournalGeneration(0)
+    , m_nJournalRecords(0)
+    , m_nJournalPending(0)
+    , m_bTradeListChanged(false)
 {
     m_pCron = nullptr; // just for convenience, not responsible to delete.
     InitMarket();
@@ -2703,8 +2693,14 @@ OTMarket::OTMarket(const Identifier& NOTARY_ID,
     : Contract()
     , m_pCron(nullptr)
     , m_pTradeList(nullptr)
+    , m_Bids(true)
+    , m_Asks(false)
     , m_lScale(1)
     , m_lLastSalePrice(0)
+    , m_lJournalGeneration(0)
+    , m_nJournalRecords(0)
+    , m_nJournalPending(0)
+    , m_bTradeListChanged(false)
 {
     m_pCron = nullptr; // just for convenience, not responsible to delete.
     InitMarket();
@@ -2743,15 +2739,13 @@ void OTMarket::Release_Market()
     }
 
     // If there were any dynamically allocated objects, clean them up here.
-    while (!m_mapBids.empty()) {
-        OTOffer* pOffer = m_mapBids.begin()->second;
-        m_mapBids.erase(m_mapBids.begin());
-        delete pOffer;
-        pOffer = nullptr;
-    }
-    while (!m_mapAsks.empty()) {
-        OTOffer* pOffer = m_mapAsks.begin()->second;
-        m_mapAsks.erase(m_mapAsks.begin());
+    // (Every offer in the order book is also on the offers map.)
+    m_Bids.Clear();
+    m_Asks.Clear();
+
+    while (!m_mapOffers.empty()) {
+        OTOffer* pOffer = m_mapOffers.begin()->second;
+        m_mapOffers.erase(m_mapOffers.begin());
         delete pOffer;
         pOffer = nullptr;
     }
@@ -0,0 +1,218 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/trade/OTOrderBook.hpp>
+#include <opentxs/core/trade/OTOffer.hpp>
+
+#include <algorithm>
+
+namespace opentxs
+{
+
+bool OTPriceLevel::CanFill(OTOffer& theOffer) const
+{
+    return (lMaxAvailable >= theOffer.GetMinimumIncrement()) &&
+           (theOffer.GetAmountAvailable() >= lMinIncrement);
+}
+
+OTOrderBook::OTOrderBook(bool bBids)
+    : m_bBids(bBids)
+    , m_nCount(0)
+{
+}
+
+// Returns the level at lPrice, or where it would go if there isn't one.
+//
+vectorOfPriceLevels::iterator OTOrderBook::FindLevel(int64_t lPrice)
+{
+    const bool bBids = m_bBids;
+
+    return std::lower_bound(
+        m_vecLevels.begin(), m_vecLevels.end(), lPrice,
+        [bBids](const OTPriceLevel& theLevel, int64_t lValue) {
+            // Sorted from the worst price to the best.
+            return bBids ? (theLevel.lPrice < lValue)
+                         : (theLevel.lPrice > lValue);
+        });
+}
+
+void OTOrderBook::RefreshLevel(OTPriceLevel& theLevel)
+{
+    theLevel.lTotalAvailable = 0;
+    theLevel.lMaxAvailable = 0;
+    theLevel.lMinIncrement =
+        theLevel.dequeOffers.empty()
+            ? 0
+            : theLevel.dequeOffers.front()->GetMinimumIncrement();
+
+    for (auto& pOffer : theLevel.dequeOffers) {
+        const int64_t lAvailable = pOffer->GetAmountAvailable();
+
+        theLevel.lTotalAvailable += lAvailable;
+        theLevel.lMaxAvailable = std::max(theLevel.lMaxAvailable, lAvailable);
+        theLevel.lMinIncrement =
+            std::min(theLevel.lMinIncrement, pOffer->GetMinimumIncrement());
+    }
+}
+
+void OTOrderBook::AddOffer(OTOffer& theOffer)
+{
+    m_nCount++;
+
+    if (theOffer.IsMarketOrder()) {
+        m_dequeMarketOrders.push_back(&theOffer);
+        return;
+    }
+
+    const int64_t lPrice = theOffer.GetPriceLimit();
+    auto it = FindLevel(lPrice);
+
+    if ((m_vecLevels.end() == it) || (it->lPrice != lPrice)) {
+        OTPriceLevel theLevel;
+        theLevel.lPrice = lPrice;
+        theLevel.lTotalAvailable = 0;
+        theLevel.lMaxAvailable = 0;
+        theLevel.lMinIncrement = theOffer.GetMinimumIncrement();
+
+        it = m_vecLevels.insert(it, theLevel);
+    }
+
+    const int64_t lAvailable = theOffer.GetAmountAvailable();
+
+    it->dequeOffers.push_back(&theOffer);
+    it->lTotalAvailable += lAvailable;
+    it->lMaxAvailable = std::max(it->lMaxAvailable, lAvailable);
+    it->lMinIncrement =
+        std::min(it->lMinIncrement, theOffer.GetMinimumIncrement());
+}
+
+bool OTOrderBook::RemoveOffer(const OTOffer& theOffer)
+{
+    if (theOffer.IsMarketOrder()) {
+        auto it = std::find(m_dequeMarketOrders.begin(),
+                            m_dequeMarketOrders.end(), &theOffer);
+
+        if (m_dequeMarketOrders.end() == it) return false;
+
+        m_dequeMarketOrders.erase(it);
+        m_nCount--;
+
+        return true;
+    }
+
+    auto it = FindLevel(theOffer.GetPriceLimit());
+
+    if ((m_vecLevels.end() == it) ||
+        (it->lPrice != theOffer.GetPriceLimit()))
+        return false;
+
+    auto it_offer =
+        std::find(it->dequeOffers.begin(), it->dequeOffers.end(), &theOffer);
+
+    if (it->dequeOffers.end() == it_offer) return false;
+
+    it->dequeOffers.erase(it_offer);
+    m_nCount--;
+
+    if (it->dequeOffers.empty())
+        m_vecLevels.erase(it);
+    else
+        RefreshLevel(*it);
+
+    return true;
+}
+
+bool OTOrderBook::ReplaceOffer(const OTOffer& theOld, OTOffer& theNew)
+{
+    if ((theOld.GetPriceLimit() != theNew.GetPriceLimit()) ||
+        theNew.IsMarketOrder())
+        return false;
+
+    auto it = FindLevel(theOld.GetPriceLimit());
+
+    if ((m_vecLevels.end() == it) || (it->lPrice != theOld.GetPriceLimit()))
+        return false;
+
+    auto it_offer =
+        std::find(it->dequeOffers.begin(), it->dequeOffers.end(), &theOld);
+
+    if (it->dequeOffers.end() == it_offer) return false;
+
+    *it_offer = &theNew;
+    RefreshLevel(*it);
+
+    return true;
+}
+
+void OTOrderBook::OfferChanged(const OTOffer& theOffer)
+{
+    if (theOffer.IsMarketOrder()) return;
+
+    auto it = FindLevel(theOffer.GetPriceLimit());
+
+    if ((m_vecLevels.end() != it) && (it->lPrice == theOffer.GetPriceLimit()))
+        RefreshLevel(*it);
+}
+
+void OTOrderBook::Clear()
+{
+    m_vecLevels.clear();
+    m_dequeMarketOrders.clear();
+    m_nCount = 0;
+}
+
+int64_t OTOrderBook::GetBestPrice() const
+{
+    return m_vecLevels.empty() ? 0 : m_vecLevels.back().lPrice;
+}
+
+int64_t OTOrderBook::GetTotalAvailable() const
+{
+    int64_t lTotal = 0;
+
+    for (auto& theLevel : m_vecLevels) lTotal += theLevel.lTotalAvailable;
+
+    for (auto& pOffer : m_dequeMarketOrders)
+        lTotal += pOffer->GetAmountAvailable();
+
+    return lTotal;
+}
+
+} // namespace opentxs
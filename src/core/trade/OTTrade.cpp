@@ -48,6 +48,7 @@
 
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
 #include <memory>
 
 namespace opentxs
@@ -55,6 +56,9 @@ namespace opentxs
 
 enum { TradeProcessIntervalSeconds = 10 };
 
+// How often an offer resting on the market checks in. (See GetCronDueDate.)
+enum { TradeRestingIntervalSeconds = 3600 };
+
 // This class is like: you are placing an order to do a trade.
 // Your order will continue processing until it is complete.
 // PART of that process is putting an offer on the market. See OTOffer for that.
@@ -497,6 +501,7 @@ OTOffer* OTTrade::GetOffer(Identifier* offerMarketId, OTMarket** market)
             offer_ = offer;
 
             hasTradeActivated_ = true;
+            GetCron()->SetItemChanged(*this);
 
             // The Trade (stored on Cron) has a copy of the Original Offer, with
             // the User's signature on it.
@@ -513,6 +518,7 @@ OTOffer* OTTrade::GetOffer(Identifier* offerMarketId, OTMarket** market)
             offer_->SignContract(*(GetCron()->GetServerNym()));
             offer_->SaveContract();
 
+            pMarket->SetOfferChanged(*offer_);
             pMarket->SaveMarket();
 
             // Now when the market loads next time, it can verify this offer
@@ -564,6 +570,7 @@ OTOffer* OTTrade::GetOffer(Identifier* offerMarketId, OTMarket** market)
 
                 stopActivated_ = true;
                 hasTradeActivated_ = true;
+                GetCron()->SetItemChanged(*this);
 
                 // The Trade (stored on Cron) has a copy of the Original Offer,
                 // with the User's signature on it.
@@ -580,6 +587,7 @@ OTOffer* OTTrade::GetOffer(Identifier* offerMarketId, OTMarket** market)
                 offer_->SignContract(*(GetCron()->GetServerNym()));
                 offer_->SaveContract();
 
+                pMarket->SetOfferChanged(*offer_);
                 pMarket->SaveMarket();
 
                 // Now when the market loads next time, it can verify this offer
@@ -1037,6 +1045,35 @@ void OTTrade::onFinalReceipt(OTCronItem& origCronItem,
 // OTCron calls this regularly, which is my chance to expire, etc.
 // Return True if I should stay on the Cron list for more processing.
 // Return False if I should be removed and deleted.
+// Trades only process once per GetProcessInterval().
+//
+// Once the offer is resting on the market, there's nothing for it to do
+// there: each new offer is matched against the market when it's added, and
+// a resting offer can only become fillable when one is. So until the offer
+// is filled or expires, it only checks in once in a while, in case matching
+// stopped part way (for example, when Cron ran out of transaction numbers.)
+// Offers waiting to activate (such as stop orders) still check every
+// interval.
+time64_t OTTrade::GetCronDueDate() const
+{
+    if (!hasTradeActivated_ || (nullptr == offer_) ||
+        offer_->IsMarketOrder() || IsFlaggedForRemoval() ||
+        (GetLastProcessDate() <= OT_TIME_ZERO))
+        return GetProcessIntervalDueDate();
+
+    if (offer_->GetAmountAvailable() < offer_->GetMinimumIncrement())
+        return GetProcessIntervalDueDate(); // Filled. Due to be removed.
+
+    time64_t tDueDate = OTTimeAddTimeInterval(
+        GetLastProcessDate(),
+        std::max<int64_t>(GetProcessInterval(), TradeRestingIntervalSeconds));
+
+    if ((GetValidTo() > OT_TIME_ZERO) && (GetValidTo() < tDueDate))
+        tDueDate = GetValidTo();
+
+    return tDueDate;
+}
+
 bool OTTrade::ProcessCron()
 {
     // Right now Cron is called 10 times per second.
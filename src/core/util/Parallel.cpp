@@ -0,0 +1,77 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/util/Parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace opentxs
+{
+
+bool ParallelFor(size_t nItems, int32_t nThreads,
+                 const std::function<bool(size_t)>& fnItem)
+{
+    std::atomic<size_t> nNext(0);
+    std::atomic<bool> bSuccess(true);
+
+    auto run = [&]() {
+        for (size_t i = nNext++; bSuccess && (i < nItems); i = nNext++) {
+            if (!fnItem(i)) bSuccess = false;
+        }
+    };
+
+    size_t nCount = (0 < nThreads) ? static_cast<size_t>(nThreads)
+                                   : std::thread::hardware_concurrency();
+    nCount = std::max<size_t>(1, std::min(nCount, nItems));
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nCount; ++i) {
+        threads.emplace_back(run);
+    }
+    run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return bSuccess;
+}
+
+} // namespace opentxs
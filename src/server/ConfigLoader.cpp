@@ -38,11 +38,14 @@
 
 #include <opentxs/server/ConfigLoader.hpp>
 #include <opentxs/server/ServerSettings.hpp>
+#include <opentxs/cash/Mint.hpp>
 #include <opentxs/core/String.hpp>
 #include <opentxs/core/util/OTDataFolder.hpp>
 #include <opentxs/core/OTSettings.hpp>
+#include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/cron/OTCron.hpp>
 #include <opentxs/core/Log.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
 #include <opentxs/core/crypto/OTCachedKey.hpp>
 #include <opentxs/core/crypto/OTKeyring.hpp>
 #include <cstdint>
@@ -164,6 +167,89 @@ bool ConfigLoader::load(String& walletFilename)
         OTCron::SetCronMaxItemsPerNym(static_cast<int32_t>(lValue));
     }
 
+    {
+        const char* szComment = "; journal_max_records is the number of "
+                                "changes cron (and each market) appends\n"
+                                "; to its journal before it saves the "
+                                "entire file again and starts a new "
+                                "journal.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("cron", "journal_max_records", 1000, lValue,
+                                bIsNewKey, szComment);
+        OTCron::SetCronJournalMaxRecords(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment = "; verification_cache_size is the number of "
+                                "Nyms, accounts and inboxes that\n"
+                                "; trades and payment plans keep in memory "
+                                "after verifying them. 0 loads\n"
+                                "; and verifies them again for every "
+                                "settlement.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("cron", "verification_cache_size",
+                                OTCron::GetCronVerificationCacheSize(), lValue,
+                                bIsNewKey, szComment);
+        OTCron::SetCronVerificationCacheSize(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment = "; compression_level is the zlib level (0 to "
+                                "9) for the cron items and offers\n"
+                                "; armored into the cron and market files. "
+                                "Those are rewritten all the\n"
+                                "; time, so the default favors speed.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("cron", "compression_level",
+                                OTCron::GetCronCompressionLevel(), lValue,
+                                bIsNewKey, szComment);
+        OTCron::SetCronCompressionLevel(static_cast<int32_t>(lValue));
+    }
+
+    // ARMOR
+
+    {
+        const char* szComment = ";; ARMOR  (the compressed, base64-encoded "
+                                "form of messages, ledgers and receipts)\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("armor", szComment, bSectionExist);
+    }
+
+    {
+        const char* szComment = "; compression_level is the zlib level (0 to "
+                                "9) everything else is armored with.\n"
+                                "; Any level can be read back by any "
+                                "version.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("armor", "compression_level",
+                                OTASCIIArmor::GetCompressionLevel(), lValue,
+                                bIsNewKey, szComment);
+        OTASCIIArmor::SetCompressionLevel(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment = "; uncompressed_below skips compression for "
+                                "anything shorter than this many\n"
+                                "; bytes. Older clients can't read those, so "
+                                "0 (the default) turns it off.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("armor", "uncompressed_below",
+                                OTASCIIArmor::GetUncompressedBelow(), lValue,
+                                bIsNewKey, szComment);
+        OTASCIIArmor::SetUncompressedBelow(static_cast<int32_t>(lValue));
+    }
+
     // HEARTBEAT
 
     {
@@ -197,6 +283,114 @@ bool ConfigLoader::load(String& walletFilename)
             static_cast<int32_t>(lValue));
     }
 
+    // PROCESSING
+
+    {
+        const char* szComment = ";; PROCESSING\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("processing", szComment, bSectionExist);
+    }
+
+    {
+        const char* szComment = "; token_verify_threads is the number of "
+                                "threads verifying the tokens in a\n"
+                                "; deposited purse. 0 uses one per core.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("processing", "token_verify_threads",
+                                ServerSettings::GetTokenVerifyThreads(), lValue,
+                                bIsNewKey, szComment);
+        ServerSettings::SetTokenVerifyThreads(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment = "; verified_nym_cache_size is how many Nyms "
+                                "are kept in memory after their\n"
+                                "; credentials are verified, so later "
+                                "requests only verify the message\n"
+                                "; signature. 0 verifies the credentials on "
+                                "every request.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("processing", "verified_nym_cache_size",
+                                ServerSettings::GetVerifiedNymCacheSize(),
+                                lValue, bIsNewKey, szComment);
+        ServerSettings::SetVerifiedNymCacheSize(static_cast<int32_t>(lValue));
+    }
+
+    // CASH
+
+    {
+        const char* szComment = ";; CASH\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("cash", szComment, bSectionExist);
+    }
+
+    {
+        const char* szComment = "; mint_key_cache_size is how many mint "
+                                "denomination keys are kept open in\n"
+                                "; memory, so withdrawals and deposits don't "
+                                "decrypt them for every token.\n"
+                                "; 0 decrypts them every time.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("cash", "mint_key_cache_size",
+                                Mint::GetMintKeyCacheSize(), lValue, bIsNewKey,
+                                szComment);
+        Mint::SetMintKeyCacheSize(static_cast<int32_t>(lValue));
+    }
+
+    // STORAGE
+
+    {
+        const char* szComment = ";; STORAGE\n";
+
+        bool bSectionExist;
+        p_Config->CheckSetSection("storage", szComment, bSectionExist);
+    }
+
+    {
+        const char* szComment = "; storage_type is where the server keeps its "
+                                "data. filesystem writes every\n"
+                                "; box, account and contract to a file of its "
+                                "own. log appends them all to\n"
+                                "; one data file, and writes everything a "
+                                "request (or cron item) changes\n"
+                                "; all at once. Anything not written to the "
+                                "log yet is still read from\n"
+                                "; the filesystem.\n";
+
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str("storage", "storage_type",
+                               ServerSettings::GetStorageType().c_str(),
+                               strValue, bIsNewKey, szComment);
+        ServerSettings::SetStorageType(strValue.Get());
+    }
+
+    {
+        const char* szComment = "; sync_writes makes what each request (and "
+                                "each cron item) writes survive a\n"
+                                "; crash. Files are written to a temp file "
+                                "and renamed into place either\n"
+                                "; way, but with sync_writes the data is also "
+                                "synced to disk before the\n"
+                                "; server replies. (Once per request, for all "
+                                "the files it wrote.)\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("storage", "sync_writes",
+                                OTDB::StorageFS::GetSyncWrites(), bValue,
+                                bIsNewKey, szComment);
+        OTDB::StorageFS::SetSyncWrites(bValue);
+    }
+
     // PERMISSIONS
 
     {
@@ -535,6 +535,11 @@ bool MainFile::LoadMainFile(bool bReadOnly)
         }
     }
     if (!bReadOnly) {
+        if (!bFailure && !server_->transactor_.recoverTransactionNumbers()) {
+            Log::vError("%s: Failed recovering reserved transaction numbers.\n",
+                        __FUNCTION__);
+            bFailure = true;
+        }
         {
             String strReason("Converting Server Nym to master key.");
             if (bNeedToConvertUser &&
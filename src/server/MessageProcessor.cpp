@@ -45,6 +45,7 @@
 #include <opentxs/core/Message.hpp>
 #include <opentxs/core/String.hpp>
 #include <opentxs/core/OTSettings.hpp>
+#include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/util/OTDataFolder.hpp>
 #include <opentxs/core/crypto/OTEnvelope.hpp>
 #include <opentxs/core/util/Timer.hpp>
@@ -180,11 +181,24 @@ bool MessageProcessor::processMessage(const std::string& messageString,
     replyMessage.m_bSuccess = false;
 
     ClientConnection client;
-    Nym nym(message.m_strNymID);
 
+    // Everything the request writes is committed together.
+    OTDB::BeginBatch();
     bool processedUserCmd = server_->userCommandProcessor_.ProcessUserCommand(
-        message, replyMessage, &client, &nym);
+        message, replyMessage, &client, nullptr);
+
+    // The notary's Nyms, boxes and transaction numbers in memory have already
+    // moved on from what's on disk, and there's no undoing that here. Going
+    // on would hand out numbers and receipts the disk doesn't know about.
+    if (!OTDB::CommitBatch()) {
+        Log::vError("%s: Failed committing the writes for user command: %s\n",
+                    __FUNCTION__, message.m_strCommand.Get());
+        OT_FAIL;
+    }
 
+    // No Nym is passed in, so ProcessUserCommand can reuse the Nyms it has
+    // already verified.
+    //
     // By optionally passing in &client, the client Nym's public
     // key will be set on it whenever verification is complete. (So
     // for the reply, I'll  have the key and thus I'll be able to
@@ -216,6 +230,7 @@ bool MessageProcessor::processMessage(const std::string& messageString,
         replyMessage.m_bSuccess = false;
         // making sure this here is definitely set to
         // false (even though it probably was already.)
+        replyMessage.ReleaseSignatures(); // (In case it was signed.)
         replyMessage.SignContract(server_->GetServerNym());
         replyMessage.SaveContract();
 
@@ -44,6 +44,7 @@
 #include <opentxs/ext/OTPayment.hpp>
 #include <opentxs/cash/Mint.hpp>
 #include <opentxs/cash/Purse.hpp>
+#include <opentxs/cash/SpentTokens.hpp>
 #include <opentxs/cash/Token.hpp>
 #include <opentxs/basket/BasketItem.hpp>
 #include <opentxs/basket/Basket.hpp>
@@ -61,10 +62,12 @@
 #include <opentxs/core/Item.hpp>
 #include <opentxs/core/trade/OTTrade.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
+#include <opentxs/core/util/Parallel.hpp>
 #include <opentxs/core/Log.hpp>
 #include <deque>
 #include <memory>
 #include <list>
+#include <vector>
 
 namespace opentxs
 {
@@ -72,6 +75,30 @@ namespace opentxs
 typedef std::list<Account*> listOfAccounts;
 typedef std::deque<Token*> dequeOfTokenPtrs;
 
+namespace
+{
+
+// Verifies the Lucre coin data of each token in a deposited purse against
+// the key for its series and denomination, on up to GetTokenVerifyThreads()
+// threads. (The signed and unblinded Lucre coin is verified in Lucre, using
+// the appropriate Mint private key.) True if every token verifies.
+//
+// The tokens were already decrypted, on the request thread: that uses the
+// notary's private key, which can't be shared between threads.
+bool VerifyTokens(Nym& theNotary, const std::vector<Mint*>& listMints,
+                  std::vector<String>& listSpendable,
+                  const std::vector<std::unique_ptr<Token>>& listTokens)
+{
+    return ParallelFor(
+        listTokens.size(), ServerSettings::GetTokenVerifyThreads(),
+        [&](size_t i) {
+            return listMints[i]->VerifyToken(theNotary, listSpendable[i],
+                                             listTokens[i]->GetDenomination());
+        });
+}
+
+} // namespace
+
 Notary::Notary(OTServer* server)
     : server_(server)
 {
@@ -3719,6 +3746,16 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
 
                 bool bSuccess = false;
 
+                // The whole purse is verified first, then checked against the
+                // spent token database and recorded there in one batch. So
+                // either every token is credited, or none of them is.
+                //
+                std::vector<std::unique_ptr<Token>> listTokens;
+                std::vector<Account*> listReserveAccts; // one per token.
+                std::vector<Mint*> listMints;           // one per token.
+                std::vector<String> listSpendable;      // one per token.
+                mapOfSpentTokens theSpentTokens;
+
                 // Pull the token(s) out of the purse that was received from the
                 // client.
                 while (true) {
@@ -3728,6 +3765,8 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                         break;
                     }
 
+                    bSuccess = false;
+
                     pMint = server_->transactor_.getMint(
                         INSTRUMENT_DEFINITION_ID, pToken->GetSeries());
 
@@ -3746,7 +3785,6 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                         if (!bToken) // if failure getting the spendable token
                                      // data from the token object
                         {
-                            bSuccess = false;
                             Log::vOutput(0, "Notary::NotarizeDeposit: "
                                             "ERROR verifying token: Failure "
                                             "retrieving token data. \n");
@@ -3757,7 +3795,6 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                                                                 // verifying
                         // instrument definition
                         {
-                            bSuccess = false;
                             Log::vOutput(0, "Notary::NotarizeDeposit: "
                                             "ERROR verifying token: Wrong "
                                             "instrument definition. \n");
@@ -3767,144 +3804,144 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                                      NOTARY_ID)) // or if failure verifying
                                                  // server ID
                         {
-                            bSuccess = false;
                             Log::vOutput(0, "Notary::NotarizeDeposit: "
                                             "ERROR verifying token: Wrong "
                                             "server ID. \n");
                             break;
                         }
-                        // This call to VerifyToken verifies the token's Series
-                        // and From/To dates against the
-                        // mint's, and also verifies that the CURRENT date is
-                        // inside that valid date range.
-                        //
-                        // It also verifies the Lucre coin data itself against
-                        // the key for that series and
-                        // denomination. (The signed and unblinded Lucre coin is
-                        // finally verified in Lucre
-                        // using the appropriate Mint private key.)
-                        //
-                        else if (!(pMint->VerifyToken(
-                                     server_->m_nymServer, strSpendableToken,
-                                     pToken->GetDenomination()))) {
-                            bSuccess = false;
-                            Log::vOutput(0, "Notary::NotarizeDeposit: "
-                                            "ERROR verifying token: Token "
-                                            "verification failed. \n");
-                            break;
-                        }
-                        // Lookup the token in the SPENT TOKEN DATABASE, and
-                        // make sure
-                        // that it hasn't already been spent...
-                        else if (pToken->IsTokenAlreadySpent(
-                                     strSpendableToken)) {
-                            // TODO!!!! Need to store the spent token database
-                            // in multiple places, on multiple media!
-                            //          Furthermore need to CHECK those multiple
-                            // places inside IsTokenAlreadySpent.
-                            //          In fact, that should all be configurable
-                            // in the server config file!
-                            //          Related: make sure IsTokenAlreadySpent
-                            // differentiates between ACTUALLY not finding
-                            //          a token as spent (successfully), versus
-                            // some error state with the storage.
-                            bSuccess = false;
+
+                        std::string strPartition, strTokenHash;
+                        pToken->GetSpentTokenKey(strSpendableToken,
+                                                 strPartition, strTokenHash);
+
+                        // The same token twice in one purse.
+                        if (!theSpentTokens[strPartition]
+                                 .insert(strTokenHash)
+                                 .second) {
                             Log::vOutput(0, "Notary::NotarizeDeposit: "
                                             "ERROR verifying token: Token "
-                                            "was already spent. \n");
+                                            "appears twice in purse. \n");
                             break;
                         }
-                        else {
-                            Log::Output(3, "Notary::NotarizeDeposit: "
-                                           "SUCCESS verifying token...    "
-                                           "\n");
-
-                            // need to be able to "roll back" if anything inside
-                            // this block fails.
-                            // so unless bSuccess is true, I don't save the
-                            // account below.
-                            //
 
-                            // two defense mechanisms here:  mint cash reserve
-                            // acct, and spent token database
-                            //
-                            if (false ==
-                                pMintCashReserveAcct->Debit(
-                                    pToken->GetDenomination())) {
-                                Log::Error("Notary::NotarizeDeposit: Error "
-                                           "debiting the mint cash reserve "
-                                           "account. "
-                                           "SHOULD NEVER HAPPEN...\n");
-                                bSuccess = false;
-                                break;
-                            }
-                            // CREDIT the amount to the account...
-                            else if (false ==
-                                     theAccount.Credit(
-                                         pToken->GetDenomination())) {
-                                Log::Error("Notary::NotarizeDeposit: Error "
-                                           "crediting the user's asset "
-                                           "account...\n");
+                        listReserveAccts.push_back(pMintCashReserveAcct);
+                        listMints.push_back(pMint);
+                        listSpendable.push_back(strSpendableToken);
+                        listTokens.push_back(std::move(pToken));
+                        bSuccess = true;
+                    }
+                    else {
+                        Log::Error("Notary::NotarizeDeposit: Unable to get "
+                                   "cash reserve account for Mint.\n");
+                        break;
+                    }
+                } // while success popping token from purse
 
-                                if (false ==
-                                    pMintCashReserveAcct->Credit(
-                                        pToken->GetDenomination()))
-                                    Log::Error("Notary::NotarizeDeposit: "
-                                               "Failure crediting-back "
-                                               "mint's cash reserve account "
-                                               "while depositing cash.\n");
-                                bSuccess = false;
-                                break;
-                            }
-                            // Spent token database. This is where the call is
-                            // made to add
-                            // the token to the spent token database.
-                            else if (false ==
-                                     pToken->RecordTokenAsSpent(
-                                         strSpendableToken)) {
-                                Log::Error("Notary::NotarizeDeposit: "
-                                           "Failed recording token as "
-                                           "spent...\n");
+                // Then the coins themselves, all at once.
+                //
+                if (bSuccess) {
+                    if (VerifyTokens(server_->m_nymServer, listMints,
+                                     listSpendable, listTokens))
+                        Log::vOutput(3, "Notary::NotarizeDeposit: "
+                                        "SUCCESS verifying %" PRI_SIZE
+                                        " tokens...    \n",
+                                     listTokens.size());
+                    else {
+                        bSuccess = false;
+                        Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                        "ERROR verifying token: Token "
+                                        "verification failed. \n");
+                    }
+                }
 
-                                if (false ==
-                                    pMintCashReserveAcct->Credit(
-                                        pToken->GetDenomination()))
-                                    Log::Error("Notary::NotarizeDeposit: "
-                                               "Failure crediting-back "
-                                               "mint's cash reserve account "
-                                               "while depositing cash.\n");
+                // Lookup the tokens in the SPENT TOKEN DATABASE, and make sure
+                // that none of them has already been spent...
+                //
+                // TODO!!!! Need to store the spent token database in multiple
+                // places, on multiple media! Furthermore need to CHECK those
+                // multiple places inside SpentTokens. In fact, that should all
+                // be configurable in the server config file!
+                //
+                if (bSuccess && SpentTokens::It()->AnySpent(theSpentTokens)) {
+                    bSuccess = false;
+                    Log::vOutput(0, "Notary::NotarizeDeposit: "
+                                    "ERROR verifying token: Token "
+                                    "was already spent. \n");
+                }
 
-                                if (false ==
-                                    theAccount.Debit(pToken->GetDenomination()))
-                                    Log::Error("Notary::NotarizeDeposit: "
-                                               "Failure debiting-back user's "
-                                               "asset account while "
-                                               "depositing cash.\n");
+                // need to be able to "roll back" if anything inside this block
+                // fails. so unless bSuccess is true, I don't save the accounts
+                // below.
+                //
+                // two defense mechanisms here:  mint cash reserve acct, and
+                // spent token database
+                //
+                size_t nCredited = 0;
 
-                                bSuccess = false;
-                                break;
-                            }
-                            else // SUCCESS!!! (this iteration)
-                            {
-                                Log::vOutput(2, "Notary::NotarizeDeposit: "
-                                                "SUCCESS crediting account "
-                                                "with cash token...\n");
-                                bSuccess = true;
+                while (bSuccess && (nCredited < listTokens.size())) {
+                    const int64_t lDenomination =
+                        listTokens[nCredited]->GetDenomination();
 
-                                // No break here -- we allow the loop to carry
-                                // on through.
-                            }
-                        }
+                    if (false ==
+                        listReserveAccts[nCredited]->Debit(lDenomination)) {
+                        Log::Error("Notary::NotarizeDeposit: Error "
+                                   "debiting the mint cash reserve "
+                                   "account. "
+                                   "SHOULD NEVER HAPPEN...\n");
+                        bSuccess = false;
                     }
-                    else {
-                        Log::Error("Notary::NotarizeDeposit: Unable to get "
-                                   "cash reserve account for Mint.\n");
+                    // CREDIT the amount to the account...
+                    else if (false == theAccount.Credit(lDenomination)) {
+                        Log::Error("Notary::NotarizeDeposit: Error "
+                                   "crediting the user's asset "
+                                   "account...\n");
+
+                        if (false ==
+                            listReserveAccts[nCredited]->Credit(lDenomination))
+                            Log::Error("Notary::NotarizeDeposit: "
+                                       "Failure crediting-back "
+                                       "mint's cash reserve account "
+                                       "while depositing cash.\n");
                         bSuccess = false;
-                        break;
                     }
-                } // while success popping token from purse
+                    else
+                        ++nCredited;
+                }
+
+                // Spent token database. This is where the call is made to add
+                // the tokens to the spent token database.
+                if (bSuccess &&
+                    (false == SpentTokens::It()->RecordSpent(theSpentTokens))) {
+                    Log::Error("Notary::NotarizeDeposit: "
+                               "Failed recording tokens as "
+                               "spent...\n");
+                    bSuccess = false;
+                }
+
+                // Undo the tokens that were already credited.
+                //
+                for (size_t i = 0; !bSuccess && (i < nCredited); ++i) {
+                    const int64_t lDenomination =
+                        listTokens[i]->GetDenomination();
+
+                    if (false == listReserveAccts[i]->Credit(lDenomination))
+                        Log::Error("Notary::NotarizeDeposit: "
+                                   "Failure crediting-back "
+                                   "mint's cash reserve account "
+                                   "while depositing cash.\n");
+
+                    if (false == theAccount.Debit(lDenomination))
+                        Log::Error("Notary::NotarizeDeposit: "
+                                   "Failure debiting-back user's "
+                                   "asset account while "
+                                   "depositing cash.\n");
+                }
 
                 if (bSuccess) {
+                    Log::vOutput(2, "Notary::NotarizeDeposit: "
+                                    "SUCCESS crediting account "
+                                    "with cash tokens...\n");
+
                     // Release any signatures that were there before (They won't
                     // verify anymore anyway, since the content has changed.)
                     theAccount.ReleaseSignatures();
@@ -3926,10 +3963,17 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                     // cash expires, then after the expiry period, if it remains
                     // in the account,
                     // it is now the property of the transaction server.)
-                    pMintCashReserveAcct->ReleaseSignatures();
-                    pMintCashReserveAcct->SignContract(server_->m_nymServer);
-                    pMintCashReserveAcct->SaveContract();
-                    pMintCashReserveAcct->SaveAccount();
+                    // Each mint series has its own reserve account.
+                    //
+                    std::set<Account*> setReserveAccts(
+                        listReserveAccts.begin(), listReserveAccts.end());
+
+                    for (auto& pReserveAcct : setReserveAccts) {
+                        pReserveAcct->ReleaseSignatures();
+                        pReserveAcct->SignContract(server_->m_nymServer);
+                        pReserveAcct->SaveContract();
+                        pReserveAcct->SaveAccount();
+                    }
 
                     pResponseItem->SetStatus(Item::acknowledgement);
 
@@ -7523,9 +7567,7 @@ void Notary::NotarizeProcessNymbox(Nym& theNym, OTTransaction& tranIn,
 
             // Remove all issued nums from theNym that are stored on theTempNym
             // HERE.
-            for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(NOTARY_ID);
-                 i++) {
-                int64_t lTemp = theTempNym.GetIssuedNum(NOTARY_ID, i);
+            for (const int64_t& lTemp : theTempNym.GetIssuedNums(NOTARY_ID)) {
                 theNym.RemoveIssuedNum(server_->m_strNotaryID, lTemp);
             }
         }
@@ -7543,9 +7585,7 @@ void Notary::NotarizeProcessNymbox(Nym& theNym, OTTransaction& tranIn,
 
             // Remove all issued nums from theNym that are stored on theTempNym
             // HERE.
-            for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(NOTARY_ID);
-                 i++) {
-                int64_t lTemp = theTempNym.GetIssuedNum(NOTARY_ID, i);
+            for (const int64_t& lTemp : theTempNym.GetIssuedNums(NOTARY_ID)) {
                 theNym.RemoveIssuedNum(server_->m_strNotaryID, lTemp);
             }
         }
@@ -7553,9 +7593,7 @@ void Notary::NotarizeProcessNymbox(Nym& theNym, OTTransaction& tranIn,
         {
             // Remove all issued nums from theNym that are stored on theTempNym
             // HERE.
-            for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(NOTARY_ID);
-                 i++) {
-                int64_t lTemp = theTempNym.GetIssuedNum(NOTARY_ID, i);
+            for (const int64_t& lTemp : theTempNym.GetIssuedNums(NOTARY_ID)) {
                 theNym.RemoveIssuedNum(server_->m_strNotaryID, lTemp);
             }
 
@@ -8575,9 +8613,7 @@ void Notary::NotarizeProcessInbox(Nym& theNym, Account& theAccount,
             // they were really there.
             // Otherwise it'd be pretty stupid to "re-add" them, eh?
             //
-            for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(NOTARY_ID);
-                 i++) {
-                int64_t lTemp = theTempNym.GetIssuedNum(NOTARY_ID, i);
+            for (const int64_t& lTemp : theTempNym.GetIssuedNums(NOTARY_ID)) {
                 theNym.RemoveIssuedNum(server_->m_strNotaryID, lTemp);
             }
 
@@ -8591,9 +8627,7 @@ void Notary::NotarizeProcessInbox(Nym& theNym, Account& theAccount,
             // Here, add all the issued nums back (that had been temporarily
             // removed from theNym) that were stored on theTempNym for
             // safe-keeping.
-            for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(NOTARY_ID);
-                 i++) {
-                int64_t lTemp = theTempNym.GetIssuedNum(NOTARY_ID, i);
+            for (const int64_t& lTemp : theTempNym.GetIssuedNums(NOTARY_ID)) {
                 theNym.AddIssuedNum(server_->m_strNotaryID, lTemp);
             }
             // (They are removed for real at the bottom of this function, IF
@@ -9432,8 +9466,7 @@ void Notary::NotarizeProcessInbox(Nym& theNym, Account& theAccount,
         // Therefore, remove any relevant issued numbers from theNym (those he's
         // now officially no longer responsible for), and save.
         //
-        for (int32_t i = 0; i < theTempNym.GetIssuedNumCount(NOTARY_ID); i++) {
-            int64_t lTemp = theTempNym.GetIssuedNum(NOTARY_ID, i);
+        for (const int64_t& lTemp : theTempNym.GetIssuedNums(NOTARY_ID)) {
             theNym.RemoveIssuedNum(server_->m_nymServer, server_->m_strNotaryID,
                                    lTemp, false); // bSave = false (saved below)
         }
@@ -9443,9 +9476,8 @@ void Notary::NotarizeProcessInbox(Nym& theNym, Account& theAccount,
         // list.
         //
         std::set<int64_t>& theIDSet = theNym.GetSetOpenCronItems();
-        for (int32_t i = 0;
-             i < theTempClosingNumNym.GetIssuedNumCount(NOTARY_ID); i++) {
-            int64_t lTemp = theTempClosingNumNym.GetIssuedNum(NOTARY_ID, i);
+        for (const int64_t& lTemp :
+             theTempClosingNumNym.GetIssuedNums(NOTARY_ID)) {
             theIDSet.erase(lTemp); // now it's erased from within the Nym.
         }
         theNym.SaveSignedNymfile(server_->m_nymServer);
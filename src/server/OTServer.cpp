@@ -231,6 +231,11 @@ const Nym& OTServer::GetServerNym() const
     return m_nymServer;
 }
 
+const String& OTServer::GetNotaryID() const
+{
+    return m_strNotaryID;
+}
+
 bool OTServer::IsFlaggedForShutdown() const
 {
     return m_bShutdownFlag;
@@ -291,6 +296,9 @@ void OTServer::Init(bool readOnly)
         OT_FAIL;
     }
 
+    // DropMessageToNymbox appends to it.
+    Ledger::SetNymboxJournal(true);
+
     String dataPath;
     bool bGetDataFolderSuccess = OTDataFolder::Get(dataPath);
 
@@ -367,7 +375,10 @@ void OTServer::Init(bool readOnly)
             }
         }
     }
-    OTDB::InitDefaultStorage(OTDB_DEFAULT_STORAGE, OTDB_DEFAULT_PACKER);
+    OTDB::InitDefaultStorage(
+        ("log" == ServerSettings::GetStorageType()) ? OTDB::STORE_LOG
+                                                    : OTDB_DEFAULT_STORAGE,
+        OTDB_DEFAULT_PACKER);
 
     // Load up the transaction number and other OTServer data members.
     bool mainFileExists = m_strWalletFilename.Exists()
@@ -654,14 +665,30 @@ bool OTServer::DropMessageToNymbox(const Identifier& NOTARY_ID,
     const String strInMessage(*pMsg);
     Ledger theLedger(RECIPIENT_NYM_ID, RECIPIENT_NYM_ID,
                      NOTARY_ID); // The recipient's Nymbox.
+
+    // Once the Nymbox has a journal, the message is only appended to that,
+    // and the Nymbox itself isn't loaded at all. Otherwise it's loaded and
+    // saved as usual, and the journal starts from there.
+    const bool bJournaled = theLedger.HasNymboxJournal();
+
+    bool bNymboxReady = false;
+
+    if (bJournaled)
+        bNymboxReady = theLedger.GenerateLedger(RECIPIENT_NYM_ID, NOTARY_ID,
+                                                Ledger::nymbox);
+    else
+        bNymboxReady =
+            (theLedger.LoadNymbox() && // I think this loads the box receipts
+                                       // too, since I didn't call
+                                       // "LoadNymboxNoVerify"
+             //          theLedger.VerifyAccount(m_nymServer)    &&    // This
+             // loads all the Box Receipts, which is unnecessary.
+             theLedger.VerifyContractID() && // Instead, we'll verify the IDs
+                                             // and Signature only.
+             theLedger.VerifySignature(m_nymServer));
+
     // Drop in the Nymbox
-    if ((theLedger.LoadNymbox() && // I think this loads the box receipts too,
-                                   // since I didn't call "LoadNymboxNoVerify"
-         //          theLedger.VerifyAccount(m_nymServer)    &&    // This loads
-         // all the Box Receipts, which is unnecessary.
-         theLedger.VerifyContractID() && // Instead, we'll verify the IDs and
-                                         // Signature only.
-         theLedger.VerifySignature(m_nymServer))) {
+    if (bNymboxReady) {
         // Create the instrumentNotice to put in the Nymbox.
         OTTransaction* pTransaction =
             OTTransaction::GenerateTransaction(theLedger, theType, lTransNum);
@@ -689,6 +716,11 @@ bool OTServer::DropMessageToNymbox(const Identifier& NOTARY_ID,
 
             pTransaction->SignContract(m_nymServer);
             pTransaction->SaveContract();
+
+            // This saves the box receipt, too. (And it will cleanup.)
+            if (bJournaled)
+                return theLedger.AppendNymboxJournal(*pTransaction);
+
             theLedger.AddTransaction(*pTransaction); // Add the message
                                                      // transaction to the
                                                      // nymbox. (It will
@@ -711,6 +743,8 @@ bool OTServer::DropMessageToNymbox(const Identifier& NOTARY_ID,
             //
             pTransaction->SaveBoxReceipt(theLedger);
 
+            theLedger.StartNymboxJournal();
+
             return true;
         }
         else // should never happen
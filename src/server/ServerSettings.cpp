@@ -49,6 +49,12 @@ int64_t ServerSettings::__min_market_scale = 1;
 int32_t ServerSettings::__heartbeat_no_requests = 10;
 // number of ms between each heartbeat.
 int32_t ServerSettings::__heartbeat_ms_between_beats = 100;
+// The number of threads verifying deposited tokens. (0 for one per core.)
+int32_t ServerSettings::__token_verify_threads = 0;
+// The number of verified Nyms kept in memory. (0 for none.)
+int32_t ServerSettings::__verified_nym_cache_size = 1000;
+// Where the server's data is stored. ("filesystem" or "log".)
+std::string ServerSettings::__storage_type = "filesystem";
 // The Nym who's allowed to do certain
 // commands even if they are turned off.
 std::string ServerSettings::__override_nym_id;
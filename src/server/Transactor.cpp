@@ -47,12 +47,19 @@
 #include <opentxs/core/String.hpp>
 #include <opentxs/core/AssetContract.hpp>
 #include <opentxs/core/Log.hpp>
+#include <opentxs/core/OTStorage.hpp>
+
+#include <sstream>
+
+// How many transaction numbers are reserved (and persisted) at a time.
+#define TRANSACTION_NUMBER_BLOCK 1000
 
 namespace opentxs
 {
 
 Transactor::Transactor(OTServer* server)
     : transactionNumber_(0)
+    , transactionNumberCeiling_(0)
     , server_(server)
 {
 }
@@ -89,24 +96,89 @@ Transactor::~Transactor()
 bool Transactor::issueNextTransactionNumber(int64_t& lTransactionNumber)
 {
     // transactionNumber_ stores the last VALID AND ISSUED transaction number.
-    // So first, we increment that, since we don't want to issue the same number
-    // twice.
-    transactionNumber_++;
-
-    // Next, we save it to file.
-    if (!server_->mainFile_.SaveMainFile()) {
-        Log::Error("Error saving main server file.\n");
-        transactionNumber_--;
+    // Numbers are issued out of a block that was reserved in storage ahead of
+    // time, so once the block runs out, we have to reserve the next one
+    // BEFORE issuing anything from it.
+    if ((transactionNumber_ >= transactionNumberCeiling_) &&
+        !reserveTransactionNumbers()) {
+        Log::Error("Error reserving transaction numbers.\n");
         return false;
     }
 
+    // So first, we increment that, since we don't want to issue the same
+    // number twice.
+    transactionNumber_++;
+
     // SUCCESS?
-    // Now the server main file has saved the latest transaction number,
-    // NOW we set it onto the parameter and return true.
+    // The reservation log already covers the latest transaction number,
+    // so we set it onto the parameter and return true.
     lTransactionNumber = transactionNumber_;
     return true;
 }
 
+/// The main file only records the transaction number as of its last save.
+/// Instead of re-saving it for every number issued, we append the new
+/// ceiling to a small reservation log once per block. Each record is a
+/// single newline-terminated number, so a crash can only leave a partial
+/// record at the end, which is ignored when recovering. The record is synced
+/// before any number from the block is issued (even inside a write batch),
+/// or a crash could issue the same numbers again.
+bool Transactor::reserveTransactionNumbers()
+{
+    const int64_t lCeiling = transactionNumber_ + TRANSACTION_NUMBER_BLOCK;
+
+    if (!OTDB::SyncAppendPlainString(formatLong(lCeiling) + "\n", ".",
+                                     reservationFilename())) {
+        Log::vError("%s: Error appending to %s\n", __FUNCTION__,
+                    reservationFilename().c_str());
+        return false;
+    }
+    transactionNumberCeiling_ = lCeiling;
+
+    return true;
+}
+
+bool Transactor::recoverTransactionNumbers()
+{
+    const std::string strFilename = reservationFilename();
+
+    if (!OTDB::Exists(".", strFilename)) return true;
+
+    std::istringstream log(OTDB::QueryPlainString(".", strFilename));
+    std::string strLine;
+    int64_t lCeiling = 0;
+
+    // getline hits eof on a record without its newline: the tail of an append
+    // that never completed. That reservation never succeeded, so skip it.
+    while (std::getline(log, strLine) && !log.eof()) {
+        const int64_t lValue = String(strLine).ToLong();
+        if (lValue > lCeiling) lCeiling = lValue;
+    }
+
+    // Some of the numbers in the last reserved block may have been issued
+    // before shutting down, so we can't issue any of them again.
+    if (lCeiling > transactionNumber_) {
+        Log::vOutput(0, "%s: Skipping from transaction number %" PRId64
+                        " to reserved ceiling %" PRId64 "\n",
+                     __FUNCTION__, transactionNumber_, lCeiling);
+        transactionNumber_ = lCeiling;
+    }
+    transactionNumberCeiling_ = transactionNumber_;
+
+    // Once the main file has the recovered number, the log can start over.
+    if (!server_->mainFile_.SaveMainFile()) {
+        Log::vError("%s: Error saving main server file.\n", __FUNCTION__);
+        return false;
+    }
+
+    return OTDB::EraseValueByKey(".", strFilename);
+}
+
+std::string Transactor::reservationFilename() const
+{
+    return std::string(server_->m_strWalletFilename.Get()) + ".numbers";
+}
+
 bool Transactor::issueNextTransactionNumberToNym(Nym& theNym,
                                                  int64_t& lTransactionNumber)
 {
@@ -138,16 +210,13 @@ bool Transactor::issueNextTransactionNumberToNym(Nym& theNym,
     if (!pNym->AddTransactionNum(server_->m_nymServer, server_->m_strNotaryID,
                                  transactionNumber_, true)) {
         Log::Error("Error adding transaction number to Nym file.\n");
-        transactionNumber_--;
-        server_->mainFile_.SaveMainFile(); // Save it back how it was, since
-                                           // we're not
-                                           // issuing this
-                                           // number after all.
+        transactionNumber_--; // Put it back, since we're not issuing this
+                              // number after all. (It's still reserved.)
         return false;
     }
 
     // SUCCESS?
-    // Now the server main file has saved the latest transaction number,
+    // Now the Nym has the latest transaction number,
     // NOW we set it onto the parameter and return true.
     lTransactionNumber = transactionNumber_;
     return true;
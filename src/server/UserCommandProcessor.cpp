@@ -66,6 +66,55 @@ UserCommandProcessor::UserCommandProcessor(OTServer* server)
 {
 }
 
+std::shared_ptr<Nym> UserCommandProcessor::FindVerifiedNym(
+    const std::string& nymID, uint64_t generation)
+{
+    auto it = verifiedNymIndex_.find(nymID);
+
+    if (verifiedNymIndex_.end() == it) return nullptr;
+
+    // The credentials have changed since it was verified.
+    if (it->second->second.credentialGeneration != generation) {
+        ForgetVerifiedNym(nymID);
+        return nullptr;
+    }
+
+    // Most recently used goes to the front.
+    verifiedNyms_.splice(verifiedNyms_.begin(), verifiedNyms_, it->second);
+
+    return it->second->second.nym;
+}
+
+void UserCommandProcessor::AddVerifiedNym(const std::string& nymID,
+                                          uint64_t generation,
+                                          std::shared_ptr<Nym> nym)
+{
+    ForgetVerifiedNym(nymID);
+
+    VerifiedNym theEntry;
+    theEntry.credentialGeneration = generation;
+    theEntry.nym = nym;
+
+    verifiedNyms_.push_front(std::make_pair(nymID, theEntry));
+    verifiedNymIndex_[nymID] = verifiedNyms_.begin();
+
+    while (verifiedNyms_.size() >
+           static_cast<size_t>(ServerSettings::GetVerifiedNymCacheSize())) {
+        verifiedNymIndex_.erase(verifiedNyms_.back().first);
+        verifiedNyms_.pop_back();
+    }
+}
+
+void UserCommandProcessor::ForgetVerifiedNym(const std::string& nymID)
+{
+    auto it = verifiedNymIndex_.find(nymID);
+
+    if (verifiedNymIndex_.end() == it) return;
+
+    verifiedNyms_.erase(it->second);
+    verifiedNymIndex_.erase(it);
+}
+
 // this function will create the Nym if it's not passed in. We pass it in so the
 // caller has the option to query things about the Nym (like if it actually
 // exists.)
@@ -196,6 +245,9 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
                            "fresh Nym to use. ***\n");
             return false;
         }
+        // Whatever gets registered here replaces what was verified before.
+        ForgetVerifiedNym(theMessage.m_strNymID.Get());
+
         OTASCIIArmor& ascArmor = theMessage.m_ascPayload;
         // First try to get Credentials, if there are any.
         const bool bHasCredentials =
@@ -328,6 +380,7 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
                                          str_cred_id.c_str());
                     }
                 }
+                Nym::CredentialsChanged(theMessage.m_strNymID);
                 // Make sure we are encrypting the message we send
                 // back, if possible.
                 String strPublicEncrKey, strPublicSignKey;
@@ -547,7 +600,32 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
     // If it is, then we read the public key from that Pseudonym and use it to
     // verify any
     // requests bearing that NymID.
-    if (!bNymIsServerNym &&
+    //
+    // Unless a specific Nym was passed in, a Nym whose credentials were
+    // already verified (and haven't changed since) is reused from memory.
+    // That way only the signature on the message is verified each time.
+    //
+    std::shared_ptr<Nym> pVerifiedNym;
+    uint64_t nCredentialGeneration = 0;
+    bool bNymIsVerified = false;
+
+    if (!bNymIsServerNym && (&theNym == pNym) &&
+        (0 < ServerSettings::GetVerifiedNymCacheSize())) {
+        // Read before the credentials are loaded, so a save in the meantime
+        // can only make the entry look older than it is.
+        nCredentialGeneration =
+            Nym::GetCredentialGeneration(theMessage.m_strNymID);
+        pVerifiedNym = FindVerifiedNym(theMessage.m_strNymID.Get(),
+                                       nCredentialGeneration);
+        bNymIsVerified = (nullptr != pVerifiedNym);
+
+        if (!bNymIsVerified)
+            pVerifiedNym.reset(new Nym(theMessage.m_strNymID));
+
+        pNym = pVerifiedNym.get();
+    }
+
+    if (!bNymIsServerNym && !bNymIsVerified &&
         (false == pNym->LoadPublicKey()) // && // Old style. (Deprecated, but
                                          // fine for now since it calls
                                          // LoadCredentials.)
@@ -567,13 +645,22 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
     // signature
     // on the message that we're processing.
 
-    if (!pNym->VerifyPseudonym()) {
+    if (bNymIsVerified) {
+        Log::Output(3, "Pseudonym already verified.\n");
+    }
+    else if (!pNym->VerifyPseudonym()) {
         Log::Output(
             0, "Pseudonym failed to verify. Hash of public key doesn't match "
                "Nym ID that was sent.\n");
         return false;
     }
-    Log::Output(3, "Pseudonym verified!\n");
+    else {
+        Log::Output(3, "Pseudonym verified!\n");
+
+        if (pVerifiedNym)
+            AddVerifiedNym(theMessage.m_strNymID.Get(), nCredentialGeneration,
+                           pVerifiedNym);
+    }
 
     // So far so good. Now let's see if the signature matches...
     if (!theMessage.VerifySignature(*pNym)) {
@@ -916,14 +1003,11 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
     NumList numlist_to_remove; // a temp variable where we will put the
                                // numbers "to be removed" (so we can remove
                                // them all at once, after the loop.)
-    const int32_t nAcknowledgedNumCount =
-        pNym->GetAcknowledgedNumCount(NOTARY_ID);
-
-    if (nAcknowledgedNumCount > 0) {
-        for (int32_t i = 0; i < nAcknowledgedNumCount; i++) {
-            const int64_t lAcknowledgedNum =
-                pNym->GetAcknowledgedNum(NOTARY_ID, i); // index
+    const setOfTransNums& setAcknowledgedNums =
+        pNym->GetAcknowledgedNums(NOTARY_ID);
 
+    if (!setAcknowledgedNums.empty()) {
+        for (const int64_t& lAcknowledgedNum : setAcknowledgedNums) {
             // For any numbers on the server's internal list but NOT on the
             // client's list (according
             // to the incoming message) the server removes them from its
@@ -3605,6 +3689,10 @@ void UserCommandProcessor::UserCmdDeleteUser(Nym& theNym, Message& MsgIn,
                                   // marked for deletion.
         //  It will get cleaned up later, during server maintenance.
 
+        // Nothing verified for this Nym may be used again.
+        Nym::CredentialsChanged(MsgIn.m_strNymID);
+        ForgetVerifiedNym(MsgIn.m_strNymID.Get());
+
         // SAVE the Nym... (now marked for deletion and with all of its
         // transaction numbers removed.)
         //
@@ -4043,12 +4131,14 @@ void UserCommandProcessor::UserCmdGetNymbox(Nym& theNym, Message& MsgIn,
                              theLedger.VerifySignature(server_->m_nymServer));
 
         // If we loaded old data in this file... (when whole receipts were
-        // stored in boxes.)
+        // stored in boxes.) Or receipts from the Nymbox journal, which
+        // aren't in the signed Nymbox until it's signed and saved again.
         //
         if (msgOut.m_bSuccess &&
-            theLedger.LoadedLegacyData()) // (which automatically saves the box
-                                          // receipt as the old data is
-                                          // loaded...)
+            (theLedger.LoadedLegacyData() || // (which automatically saves the
+                                             // box receipt as the old data is
+                                             // loaded...)
+             theLedger.LoadedJournal()))
         {
             theLedger.ReleaseSignatures(); // UPDATE: We do NOT force the
                                            // loading here, since they aren't
@@ -0,0 +1,211 @@
+#include "Bench.hpp"
+
+#include <opentxs/server/ServerLoader.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTCachedKey.hpp>
+#include <opentxs/core/crypto/OTCallback.hpp>
+#include <opentxs/core/crypto/OTCaller.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/util/OTDataFolder.hpp>
+#include <opentxs/core/util/OTPaths.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+// Answers every passphrase request, so nothing ever waits on the console.
+class BenchCallback : public OTCallback
+{
+public:
+    virtual void runOne(const char*, OTPassword& theOutput) const
+    {
+        const char* szPassword = bench::Password();
+        theOutput.setPassword(szPassword,
+                              static_cast<int32_t>(strlen(szPassword)));
+    }
+
+    virtual void runTwo(const char* szDisplay, OTPassword& theOutput) const
+    {
+        runOne(szDisplay, theOutput);
+    }
+};
+
+BenchCallback g_theCallback;
+OTCaller g_theCaller;
+
+std::string g_strHome;
+std::unique_ptr<ServerLoader> g_pNotary;
+std::unique_ptr<Nym> g_pSignerNym;
+
+// Everything runs in a fresh home folder, so nothing in the real data folder
+// is read or written, and every run starts from the same state.
+bool SetUp()
+{
+    char szHome[] = "/tmp/opentxs-bench-XXXXXX";
+    if (nullptr == mkdtemp(szHome)) return false;
+    g_strHome = szHome;
+
+    const char* szNotary = getenv("OPENTXS_BENCH_NOTARY");
+
+    if (nullptr != szNotary) {
+        const std::string strCopy =
+            "cp -R \"" + std::string(szNotary) + "/.\" \"" + g_strHome + "\"";
+
+        if (0 != system(strCopy.c_str())) return false;
+    }
+
+    OTPaths::SetHomeFolder(g_strHome);
+
+    if (!Log::Init(SERVER_CONFIG_KEY, -1)) return false;
+
+    g_theCaller.setCallback(&g_theCallback);
+    if (!OTAsymmetricKey::SetPasswordCaller(g_theCaller)) return false;
+
+    if (nullptr != szNotary) {
+        // This loads the notary's master key, so it has to happen before
+        // any Nym is generated.
+        g_pNotary.reset(new ServerLoader);
+    }
+    else {
+        if (!OTDataFolder::Init(SERVER_CONFIG_KEY)) return false;
+
+        OTCrypto::It()->Init();
+        OTDB::InitDefaultStorage(OTDB_DEFAULT_STORAGE, OTDB_DEFAULT_PACKER);
+    }
+
+    // The notary's config sets its own log level. Logging would only be
+    // measured along with everything else.
+    Log::SetLogLevel(-1);
+
+    return true;
+}
+
+void TearDown()
+{
+    g_pSignerNym.reset();
+
+    // The notary cleans up the crypto along with itself.
+    if (g_pNotary) {
+        g_pNotary.reset();
+    }
+    else {
+        OTCachedKey::Cleanup();
+        OTCrypto::It()->Cleanup();
+    }
+
+    const std::string strRemove = "rm -rf \"" + g_strHome + "\"";
+    if (0 != system(strRemove.c_str()))
+        fprintf(stderr, "opentxs-bench: Failed removing %s\n",
+                g_strHome.c_str());
+}
+
+} // namespace
+
+namespace opentxs
+{
+namespace bench
+{
+
+const char* Password()
+{
+    const char* szPassword = getenv("OPENTXS_BENCH_PASSWORD");
+
+    return (nullptr != szPassword) ? szPassword : "test";
+}
+
+Nym& SignerNym()
+{
+    if (!g_pSignerNym) g_pSignerNym.reset(GenerateNym());
+
+    return *g_pSignerNym;
+}
+
+Nym* GenerateNym()
+{
+    std::unique_ptr<Nym> pNym(new Nym);
+
+    if (!pNym->GenerateNym()) {
+        fprintf(stderr, "opentxs-bench: Failed generating a Nym.\n");
+        exit(1);
+    }
+
+    return pNym.release();
+}
+
+Identifier FixedID(const char* szName)
+{
+    Identifier theID;
+    theID.CalculateDigest(String(szName));
+
+    return theID;
+}
+
+String SamplePayload(int64_t lSize)
+{
+    static const char* szWords[] = {
+        "<transaction type=\"pending\"", " numberOfOrigin=\"",
+        " transactionNum=\"", " inReferenceTo=\"", " amount=\"", "\">\n",
+        "<item type=\"transfer\" status=\"request\"", " />\n",
+        "</transaction>\n", "<note>\n", "Payment for services rendered.",
+        "</note>\n", "notaryID=\"", "nymID=\"", "\"\n"};
+    static const uint32_t nWords = sizeof(szWords) / sizeof(szWords[0]);
+
+    std::string strPayload;
+    strPayload.reserve(static_cast<size_t>(lSize) + 64);
+
+    uint32_t nSeed = 20150101;
+
+    while (static_cast<int64_t>(strPayload.size()) < lSize) {
+        nSeed = nSeed * 1103515245 + 12345;
+
+        strPayload += szWords[(nSeed >> 16) % nWords];
+
+        // IDs and amounts are what doesn't compress.
+        if (0 == ((nSeed >> 8) & 3)) {
+            strPayload += std::to_string(nSeed % 100000000);
+            strPayload += '"';
+        }
+    }
+    strPayload.resize(static_cast<size_t>(lSize));
+
+    return String(strPayload);
+}
+
+ServerLoader* Notary()
+{
+    return g_pNotary.get();
+}
+
+} // namespace bench
+} // namespace opentxs
+
+// Takes the usual Google Benchmark flags. For numbers to compare across
+// commits: --benchmark_out=bench.json --benchmark_out_format=json
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (!SetUp()) {
+        fprintf(stderr, "opentxs-bench: Failed setting up the data folder.\n");
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    TearDown();
+
+    return 0;
+}
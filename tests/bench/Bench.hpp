@@ -0,0 +1,45 @@
+#ifndef OPENTXS_TESTS_BENCH_BENCH_HPP
+#define OPENTXS_TESTS_BENCH_BENCH_HPP
+
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <cstdint>
+
+namespace opentxs
+{
+
+class Nym;
+class ServerLoader;
+
+namespace bench
+{
+
+// The passphrase for every key the benchmarks touch. ("test", unless
+// OPENTXS_BENCH_PASSWORD says otherwise.)
+const char* Password();
+
+// A Nym with fresh credentials, generated on first use and kept for the
+// whole run.
+Nym& SignerNym();
+
+// Another new Nym, for when one has to start out empty. The caller owns it.
+Nym* GenerateNym();
+
+// The same ID on every run, for notaries, instrument definitions and
+// accounts that only need to be consistent.
+Identifier FixedID(const char* szName);
+
+// Contract-like text of about lSize bytes. The same on every run, and about
+// as compressible as real contracts and receipts.
+String SamplePayload(int64_t lSize);
+
+// The notary copied from $OPENTXS_BENCH_NOTARY, or nullptr if that isn't
+// set. (Creating a notary needs its contract pasted in, so the end-to-end
+// benchmarks run against one that was set up beforehand.)
+ServerLoader* Notary();
+
+} // namespace bench
+} // namespace opentxs
+
+#endif // OPENTXS_TESTS_BENCH_BENCH_HPP
@@ -0,0 +1,192 @@
+#include "Bench.hpp"
+
+#include <opentxs/core/OTData.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+
+#include <benchmark/benchmark.h>
+
+#if defined(OT_CRYPTO_USING_OPENSSL)
+#include <openssl/bio.h>
+#include <openssl/buffer.h>
+#include <openssl/evp.h>
+#endif
+
+#include <cstring>
+#include <memory>
+
+using namespace opentxs;
+
+namespace
+{
+
+// Compress and base64-encode, as every contract does when it's saved inside
+// another one.
+void BM_ArmorString(benchmark::State& state)
+{
+    const String strPayload(bench::SamplePayload(state.range(0)));
+
+    while (state.KeepRunning()) {
+        OTASCIIArmor ascArmor;
+        ascArmor.SetString(strPayload);
+        benchmark::DoNotOptimize(ascArmor.Get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_ArmorString)->RangeMultiplier(8)->Range(256, 1 << 20);
+
+void BM_DearmorString(benchmark::State& state)
+{
+    const OTASCIIArmor ascArmor(bench::SamplePayload(state.range(0)));
+
+    while (state.KeepRunning()) {
+        String strOutput;
+        ascArmor.GetString(strOutput);
+        benchmark::DoNotOptimize(strOutput.Get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_DearmorString)->RangeMultiplier(8)->Range(256, 1 << 20);
+
+// Binary data is only base64-encoded.
+void BM_ArmorData(benchmark::State& state)
+{
+    const String strPayload(bench::SamplePayload(state.range(0)));
+    const OTData theData(strPayload.Get(), strPayload.GetLength());
+
+    while (state.KeepRunning()) {
+        OTASCIIArmor ascArmor;
+        ascArmor.SetData(theData);
+        benchmark::DoNotOptimize(ascArmor.Get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_ArmorData)->RangeMultiplier(8)->Range(256, 1 << 20);
+
+void BM_DearmorData(benchmark::State& state)
+{
+    const String strPayload(bench::SamplePayload(state.range(0)));
+    const OTASCIIArmor ascArmor(
+        OTData(strPayload.Get(), strPayload.GetLength()));
+
+    while (state.KeepRunning()) {
+        OTData theData;
+        ascArmor.GetData(theData);
+        benchmark::DoNotOptimize(theData.GetPointer());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_DearmorData)->RangeMultiplier(8)->Range(256, 1 << 20);
+
+// The codec on its own, without the compression.
+void BM_Base64Encode(benchmark::State& state)
+{
+    const String strPayload(bench::SamplePayload(state.range(0)));
+    const uint8_t* pInput = reinterpret_cast<const uint8_t*>(strPayload.Get());
+
+    while (state.KeepRunning()) {
+        std::unique_ptr<char[]> pOutput(OTCrypto::It()->Base64Encode(
+            pInput, strPayload.GetLength(), true));
+        benchmark::DoNotOptimize(pOutput.get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_Base64Encode)->RangeMultiplier(8)->Range(256, 1 << 20);
+
+void BM_Base64Decode(benchmark::State& state)
+{
+    const String strPayload(bench::SamplePayload(state.range(0)));
+    std::unique_ptr<char[]> pEncoded(OTCrypto::It()->Base64Encode(
+        reinterpret_cast<const uint8_t*>(strPayload.Get()),
+        strPayload.GetLength(), true));
+    const size_t lEncoded = strlen(pEncoded.get());
+
+    while (state.KeepRunning()) {
+        OTData theData;
+        OTCrypto::It()->Base64Decode(pEncoded.get(), lEncoded, theData);
+        benchmark::DoNotOptimize(theData.GetPointer());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_Base64Decode)->RangeMultiplier(8)->Range(256, 1 << 20);
+
+#if defined(OT_CRYPTO_USING_OPENSSL)
+// What Base64Encode / Base64Decode did before OT had its own codec: an
+// OpenSSL BIO chain set up on every call. Kept here to compare against.
+char* BIOBase64Encode(const uint8_t* input, int32_t in_len)
+{
+    char* buf = nullptr;
+    BIO* b64 = BIO_push(BIO_new(BIO_f_base64()), BIO_new(BIO_s_mem()));
+
+    if (BIO_write(b64, input, in_len) == in_len) {
+        (void)BIO_flush(b64);
+        BUF_MEM* bptr = nullptr;
+        BIO_get_mem_ptr(b64, &bptr);
+        buf = new char[bptr->length + 1];
+        memcpy(buf, bptr->data, bptr->length);
+        buf[bptr->length] = '\0';
+    }
+
+    BIO_free_all(b64);
+
+    return buf;
+}
+
+uint8_t* BIOBase64Decode(const char* input, size_t* out_len)
+{
+    int32_t in_len = static_cast<int32_t>(strlen(input));
+    int32_t out_max_len = (in_len * 6 + 7) / 8;
+    uint8_t* buf = new uint8_t[out_max_len];
+    memset(buf, 0, out_max_len);
+
+    BIO* b64 = BIO_push(BIO_new(BIO_f_base64()),
+                        BIO_new_mem_buf(const_cast<char*>(input), in_len));
+    *out_len = BIO_read(b64, buf, out_max_len);
+    BIO_free_all(b64);
+
+    return buf;
+}
+
+void BM_Base64EncodeBIO(benchmark::State& state)
+{
+    const String strPayload(bench::SamplePayload(state.range(0)));
+    const uint8_t* pInput = reinterpret_cast<const uint8_t*>(strPayload.Get());
+
+    while (state.KeepRunning()) {
+        std::unique_ptr<char[]> pOutput(
+            BIOBase64Encode(pInput, strPayload.GetLength()));
+        benchmark::DoNotOptimize(pOutput.get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_Base64EncodeBIO)->RangeMultiplier(8)->Range(256, 1 << 20);
+
+// Including the copy into an OTData that OTASCIIArmor::GetData used to make.
+void BM_Base64DecodeBIO(benchmark::State& state)
+{
+    const String strPayload(bench::SamplePayload(state.range(0)));
+    std::unique_ptr<char[]> pEncoded(BIOBase64Encode(
+        reinterpret_cast<const uint8_t*>(strPayload.Get()),
+        strPayload.GetLength()));
+
+    while (state.KeepRunning()) {
+        size_t lSize = 0;
+        std::unique_ptr<uint8_t[]> pDecoded(
+            BIOBase64Decode(pEncoded.get(), &lSize));
+        OTData theData(pDecoded.get(), lSize);
+        benchmark::DoNotOptimize(theData.GetPointer());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+BENCHMARK(BM_Base64DecodeBIO)->RangeMultiplier(8)->Range(256, 1 << 20);
+#endif // defined(OT_CRYPTO_USING_OPENSSL)
+
+} // namespace
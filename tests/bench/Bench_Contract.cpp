@@ -0,0 +1,159 @@
+#include "Bench.hpp"
+
+#include <opentxs/core/Ledger.hpp>
+#include <opentxs/core/Message.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTTransaction.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+using namespace opentxs;
+
+namespace
+{
+
+void SetUpMessage(Message& theMessage, int64_t lPayloadSize)
+{
+    Nym& theNym = bench::SignerNym();
+
+    theMessage.m_strCommand = "sendNymMessage";
+    theNym.GetIdentifier(theMessage.m_strNymID);
+    theMessage.m_strNotaryID = String(bench::FixedID("notary"));
+    theMessage.m_strRequestNum.Format("%d", 2);
+    theMessage.m_ascPayload.SetString(bench::SamplePayload(lPayloadSize));
+}
+
+void BM_SignContract(benchmark::State& state)
+{
+    Nym& theNym = bench::SignerNym();
+    Message theMessage;
+    SetUpMessage(theMessage, state.range(0));
+
+    while (state.KeepRunning()) {
+        theMessage.SignContract(theNym);
+        theMessage.SaveContract();
+    }
+}
+BENCHMARK(BM_SignContract)->Arg(1 << 10)->Arg(1 << 16);
+
+void BM_VerifySignature(benchmark::State& state)
+{
+    Nym& theNym = bench::SignerNym();
+    String strMessage;
+    {
+        Message theMessage;
+        SetUpMessage(theMessage, state.range(0));
+        theMessage.SignContract(theNym);
+        theMessage.SaveContract();
+        theMessage.SaveContractRaw(strMessage);
+    }
+
+    Message theMessage;
+    if (!theMessage.LoadContractFromString(strMessage)) {
+        state.SkipWithError("Failed loading the signed message.");
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        if (!theMessage.VerifySignature(theNym)) {
+            state.SkipWithError("Signature failed to verify.");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_VerifySignature)->Arg(1 << 10)->Arg(1 << 16);
+
+// Checks the Nym's credentials against each other and against its source.
+void BM_VerifyPseudonym(benchmark::State& state)
+{
+    const Nym& theNym = bench::SignerNym();
+
+    while (state.KeepRunning()) {
+        if (!theNym.VerifyPseudonym()) {
+            state.SkipWithError("Nym failed to verify.");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_VerifyPseudonym);
+
+// What the notary does with each request, before it can even check the
+// signature.
+void BM_LoadPublicNym(benchmark::State& state)
+{
+    const Identifier NYM_ID(bench::SignerNym());
+
+    while (state.KeepRunning()) {
+        std::unique_ptr<Nym> pNym(Nym::LoadPublicNym(NYM_ID));
+
+        if (!pNym || !pNym->VerifyPseudonym()) {
+            state.SkipWithError("Failed loading the public Nym.");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_LoadPublicNym);
+
+// A signed ledger holding lCount signed message receipts.
+String LedgerWithReceipts(Ledger::ledgerType theType, int64_t lCount)
+{
+    Nym& theNym = bench::SignerNym();
+    const Identifier NYM_ID(theNym), NOTARY_ID(bench::FixedID("notary"));
+    const String strNote(bench::SamplePayload(1 << 10));
+
+    Ledger theLedger(NYM_ID, NYM_ID, NOTARY_ID);
+    theLedger.GenerateLedger(NYM_ID, NOTARY_ID, theType);
+
+    for (int64_t lTransNum = 1; lTransNum <= lCount; ++lTransNum) {
+        OTTransaction* pTransaction = OTTransaction::GenerateTransaction(
+            theLedger, OTTransaction::message, lTransNum);
+
+        pTransaction->SetReferenceToNum(lTransNum);
+        pTransaction->SetReferenceString(strNote);
+        pTransaction->SignContract(theNym);
+        pTransaction->SaveContract();
+
+        theLedger.AddTransaction(*pTransaction); // Takes ownership.
+    }
+
+    theLedger.SignContract(theNym);
+    theLedger.SaveContract();
+
+    return String(theLedger);
+}
+
+void LoadLedger(benchmark::State& state, Ledger::ledgerType theType)
+{
+    const Identifier NYM_ID(bench::SignerNym()),
+        NOTARY_ID(bench::FixedID("notary"));
+    const String strLedger(LedgerWithReceipts(theType, state.range(0)));
+
+    while (state.KeepRunning()) {
+        Ledger theLedger(NYM_ID, NYM_ID, NOTARY_ID);
+
+        if (!theLedger.LoadLedgerFromString(strLedger)) {
+            state.SkipWithError("Failed loading the ledger.");
+            break;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            state.range(0));
+}
+
+// Message ledgers carry the full receipts.
+void BM_LoadMessageLedger(benchmark::State& state)
+{
+    LoadLedger(state, Ledger::message);
+}
+BENCHMARK(BM_LoadMessageLedger)->RangeMultiplier(8)->Range(8, 512);
+
+// Boxes only carry abbreviated records of them.
+void BM_LoadNymbox(benchmark::State& state)
+{
+    LoadLedger(state, Ledger::nymbox);
+}
+BENCHMARK(BM_LoadNymbox)->RangeMultiplier(8)->Range(8, 512);
+
+} // namespace
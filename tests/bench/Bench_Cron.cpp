@@ -0,0 +1,78 @@
+#include "Bench.hpp"
+
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/cron/OTCronItem.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace opentxs;
+
+namespace
+{
+
+// Stays on Cron, and doesn't do anything when it's processed. So all that's
+// measured is what Cron itself does for each item.
+class BenchCronItem : public OTCronItem
+{
+public:
+    BenchCronItem(int64_t lTransactionNum, time64_t tDueDate)
+        : m_tDueDate(tDueDate)
+    {
+        SetTransactionNum(lTransactionNum);
+    }
+
+    virtual time64_t GetCronDueDate() const
+    {
+        return m_tDueDate;
+    }
+
+private:
+    time64_t m_tDueDate;
+};
+
+// range(0) items are due every time Cron processes, and range(1) more aren't
+// due until tomorrow.
+void BM_ProcessCronItems(benchmark::State& state)
+{
+    const int64_t lDue = state.range(0), lIdle = state.range(1);
+    const time64_t tNow = OTTimeGetCurrentTime();
+
+    OTCron theCron;
+    theCron.SetServerNym(&bench::SignerNym());
+    theCron.SetNotaryID(bench::FixedID("notary"));
+    for (int32_t i = 1; i <= OTCron::GetCronRefillAmount(); ++i)
+        theCron.AddTransactionNumber(i);
+
+    // Cron owns the items.
+    for (int64_t i = 1; i <= lDue + lIdle; ++i) {
+        const time64_t tDueDate =
+            (i <= lDue) ? OT_TIME_ZERO
+                        : OTTimeAddTimeInterval(tNow, 60 * 60 * 24);
+        BenchCronItem* pItem = new BenchCronItem(i, tDueDate);
+
+        if (!theCron.AddCronItem(*pItem, nullptr, false, tNow)) {
+            delete pItem;
+            state.SkipWithError("Failed adding an item to Cron.");
+            return;
+        }
+    }
+    theCron.ActivateCron();
+
+    // Otherwise only the first round would do anything.
+    const int32_t nMsBetweenProcess = OTCron::GetCronMsBetweenProcess();
+    OTCron::SetCronMsBetweenProcess(0);
+
+    while (state.KeepRunning()) {
+        theCron.ProcessCronItems();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * lDue);
+
+    OTCron::SetCronMsBetweenProcess(nMsBetweenProcess);
+}
+BENCHMARK(BM_ProcessCronItems)
+    ->Args({64, 0})
+    ->Args({4096, 0})
+    ->Args({64, 4096})
+    ->Args({64, 1 << 15});
+
+} // namespace
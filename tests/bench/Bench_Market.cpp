@@ -0,0 +1,134 @@
+#include "Bench.hpp"
+
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/trade/OTMarket.hpp>
+#include <opentxs/core/trade/OTOffer.hpp>
+#include <opentxs/core/trade/OTTrade.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+const int64_t BENCH_BASE_PRICE = 100;
+const int64_t BENCH_OFFER_ASSETS = 1000;
+
+// A market, and a book of asks at one price level each.
+//
+// Every trade on the book uses the same accounts as the taker's trade, so
+// each match stops before settlement. (Settling needs real Nyms and
+// accounts, signed by a real notary. That is what the end-to-end benchmarks
+// are for.) What's left is the walk over the book, and the checks made for
+// each offer on it.
+class SyntheticBook
+{
+public:
+    SyntheticBook(int64_t lLevels)
+        : m_NOTARY_ID(bench::FixedID("notary"))
+        , m_INSTRUMENT_ID(bench::FixedID("gold"))
+        , m_CURRENCY_ID(bench::FixedID("dollars"))
+        , m_NYM_ID(bench::SignerNym())
+        , m_ASSET_ACCT_ID(bench::FixedID("gold account"))
+        , m_CURRENCY_ACCT_ID(bench::FixedID("dollar account"))
+        , m_theMarket(m_NOTARY_ID, m_INSTRUMENT_ID, m_CURRENCY_ID, 1)
+    {
+        m_theCron.SetServerNym(&bench::SignerNym());
+        m_theCron.SetNotaryID(m_NOTARY_ID);
+        for (int32_t i = 1; i <= OTCron::GetCronRefillAmount(); ++i)
+            m_theCron.AddTransactionNumber(i);
+
+        m_theMarket.SetCronPointer(m_theCron);
+
+        for (int64_t lLevel = 0; lLevel < lLevels; ++lLevel) {
+            // The market owns the offers on it.
+            OTOffer* pOffer = NewOffer(true, BENCH_BASE_PRICE + lLevel,
+                                       lLevel + 1);
+
+            m_vecTrades.push_back(NewTrade(*pOffer));
+            m_theMarket.AddOffer(m_vecTrades.back().get(), *pOffer, false);
+        }
+    }
+
+    OTOffer* NewOffer(bool bSelling, int64_t lPriceLimit, int64_t lTransNum)
+    {
+        OTOffer* pOffer =
+            new OTOffer(m_NOTARY_ID, m_INSTRUMENT_ID, m_CURRENCY_ID, 1);
+        pOffer->MakeOffer(bSelling, lPriceLimit, BENCH_OFFER_ASSETS, 1,
+                          lTransNum);
+
+        return pOffer;
+    }
+
+    std::unique_ptr<OTTrade> NewTrade(OTOffer& theOffer)
+    {
+        std::unique_ptr<OTTrade> pTrade(
+            new OTTrade(m_NOTARY_ID, m_INSTRUMENT_ID, m_ASSET_ACCT_ID, m_NYM_ID,
+                        m_CURRENCY_ID, m_CURRENCY_ACCT_ID));
+
+        pTrade->SetTransactionNum(theOffer.GetTransactionNum());
+        pTrade->SetCronPointer(m_theCron);
+        theOffer.SetTrade(*pTrade);
+
+        return pTrade;
+    }
+
+    OTMarket& GetMarket()
+    {
+        return m_theMarket;
+    }
+
+private:
+    const Identifier m_NOTARY_ID;
+    const Identifier m_INSTRUMENT_ID;
+    const Identifier m_CURRENCY_ID;
+    const Identifier m_NYM_ID;
+    const Identifier m_ASSET_ACCT_ID;
+    const Identifier m_CURRENCY_ACCT_ID;
+
+    OTCron m_theCron;
+    std::vector<std::unique_ptr<OTTrade>> m_vecTrades;
+    OTMarket m_theMarket;
+};
+
+// A bid that crosses every level on the book.
+void BM_ProcessTrade(benchmark::State& state)
+{
+    const int64_t lLevels = state.range(0);
+    SyntheticBook theBook(lLevels);
+
+    std::unique_ptr<OTOffer> pBid(
+        theBook.NewOffer(false, BENCH_BASE_PRICE + lLevels, lLevels + 1));
+    std::unique_ptr<OTTrade> pTrade(theBook.NewTrade(*pBid));
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(
+            theBook.GetMarket().ProcessTrade(*pTrade, *pBid));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            lLevels);
+}
+BENCHMARK(BM_ProcessTrade)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+// A bid below the best ask, as most new offers are.
+void BM_ProcessTradeNoMatch(benchmark::State& state)
+{
+    const int64_t lLevels = state.range(0);
+    SyntheticBook theBook(lLevels);
+
+    std::unique_ptr<OTOffer> pBid(
+        theBook.NewOffer(false, BENCH_BASE_PRICE - 1, lLevels + 1));
+    std::unique_ptr<OTTrade> pTrade(theBook.NewTrade(*pBid));
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(
+            theBook.GetMarket().ProcessTrade(*pTrade, *pBid));
+    }
+}
+BENCHMARK(BM_ProcessTradeNoMatch)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+} // namespace
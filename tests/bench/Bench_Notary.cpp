@@ -0,0 +1,239 @@
+#include "Bench.hpp"
+
+#include <opentxs/server/MessageProcessor.hpp>
+#include <opentxs/server/ServerLoader.hpp>
+#include <opentxs/core/Message.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cinttypes>
+#include <memory>
+#include <string>
+
+namespace opentxs
+{
+
+// Hands requests to the notary the same way its socket does.
+class MessageProcessorBench
+{
+public:
+    // Returns the reply, if the notary sent one and it says success.
+    static bool Process(MessageProcessor& theProcessor,
+                        const std::string& strRequest, Message& theReply)
+    {
+        std::string strReply;
+
+        // (It returns true when there's no reply.)
+        if (theProcessor.processMessage(strRequest, strReply)) return false;
+
+        OTASCIIArmor ascReply;
+        ascReply.MemSet(strReply.data(),
+                        static_cast<uint32_t>(strReply.size()));
+
+        String strReplyContents;
+        ascReply.GetString(strReplyContents);
+
+        return theReply.LoadContractFromString(strReplyContents) &&
+               theReply.m_bSuccess;
+    }
+};
+
+} // namespace opentxs
+
+using namespace opentxs;
+
+namespace
+{
+
+// Signed and armored, as the client sends it.
+std::string Armored(Message& theMessage, Nym& theNym)
+{
+    theMessage.SignContract(theNym);
+    theMessage.SaveContract();
+
+    const String strMessage(theMessage);
+    const OTASCIIArmor ascMessage(strMessage);
+
+    return std::string(ascMessage.Get(), ascMessage.GetLength());
+}
+
+void SetUpRequest(Message& theMessage, const char* szCommand, Nym& theNym,
+                  int64_t lRequestNum)
+{
+    theMessage.m_strCommand = szCommand;
+    theNym.GetIdentifier(theMessage.m_strNymID);
+    theMessage.m_strNotaryID = bench::Notary()->getServer()->GetNotaryID();
+    theMessage.m_strRequestNum.Format("%" PRId64, lRequestNum);
+}
+
+std::string PingNotary(Nym& theNym)
+{
+    Message theMessage;
+    SetUpRequest(theMessage, "pingNotary", theNym, 1);
+
+    theNym.GetPublicAuthKey().GetPublicKey(theMessage.m_strNymPublicKey);
+    theNym.GetPublicEncrKey().GetPublicKey(theMessage.m_strNymID2);
+
+    return Armored(theMessage, theNym);
+}
+
+std::string RegisterNym(Nym& theNym)
+{
+    Message theMessage;
+    SetUpRequest(theMessage, "registerNym", theNym, 1);
+
+    String strCredList;
+    String::Map theMap;
+    theNym.GetPublicCredentials(strCredList, &theMap);
+
+    theMessage.m_ascPayload.SetString(strCredList);
+    theMessage.credentials.swap(theMap);
+
+    return Armored(theMessage, theNym);
+}
+
+std::string GetRequestNumber(Nym& theNym)
+{
+    Message theMessage;
+    SetUpRequest(theMessage, "getRequestNumber", theNym, 1);
+
+    return Armored(theMessage, theNym);
+}
+
+// The notary doesn't open the envelope, so any payload does.
+std::string SendNymMessage(Nym& theNym, const Nym& theRecipient,
+                           int64_t lRequestNum, const String& strPayload)
+{
+    Message theMessage;
+    SetUpRequest(theMessage, "sendNymMessage", theNym, lRequestNum);
+
+    theRecipient.GetIdentifier(theMessage.m_strNymID2);
+    theMessage.m_ascPayload.SetString(strPayload);
+
+    return Armored(theMessage, theNym);
+}
+
+// Registers theNym (unless it already is), and returns the request number
+// for its next request.
+bool Register(MessageProcessor& theProcessor, Nym& theNym,
+              int64_t& lRequestNum)
+{
+    Message theRegisterReply, theReply;
+    MessageProcessorBench::Process(theProcessor, RegisterNym(theNym),
+                                   theRegisterReply);
+
+    if (!MessageProcessorBench::Process(theProcessor, GetRequestNumber(theNym),
+                                        theReply))
+        return false;
+
+    lRequestNum = theReply.m_lNewRequestNum;
+
+    return true;
+}
+
+// The notary listens on the port in its contract. (Nothing connects to it
+// here, but the port has to be free.)
+std::unique_ptr<MessageProcessor> NewProcessor(benchmark::State& state)
+{
+    if (nullptr == bench::Notary()) {
+        state.SkipWithError("Set OPENTXS_BENCH_NOTARY to the home folder of "
+                            "a notary that's already set up.");
+        return nullptr;
+    }
+
+    return std::unique_ptr<MessageProcessor>(
+        new MessageProcessor(*bench::Notary()));
+}
+
+// Only verifies the signature, against the key in the message itself.
+void BM_ProcessMessagePingNotary(benchmark::State& state)
+{
+    std::unique_ptr<MessageProcessor> pProcessor(NewProcessor(state));
+    if (!pProcessor) return;
+
+    const std::string strRequest(PingNotary(bench::SignerNym()));
+
+    while (state.KeepRunning()) {
+        Message theReply;
+
+        if (!MessageProcessorBench::Process(*pProcessor, strRequest,
+                                            theReply)) {
+            state.SkipWithError("pingNotary failed.");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ProcessMessagePingNotary)->Unit(benchmark::kMicrosecond);
+
+// Loads the Nym and its Nymfile, and verifies the request against them.
+void BM_ProcessMessageGetRequestNumber(benchmark::State& state)
+{
+    std::unique_ptr<MessageProcessor> pProcessor(NewProcessor(state));
+    if (!pProcessor) return;
+
+    Nym& theNym = bench::SignerNym();
+    int64_t lRequestNum = 0;
+
+    if (!Register(*pProcessor, theNym, lRequestNum)) {
+        state.SkipWithError("Failed registering the Nym.");
+        return;
+    }
+
+    const std::string strRequest(GetRequestNumber(theNym));
+
+    while (state.KeepRunning()) {
+        Message theReply;
+
+        if (!MessageProcessorBench::Process(*pProcessor, strRequest,
+                                            theReply)) {
+            state.SkipWithError("getRequestNumber failed.");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ProcessMessageGetRequestNumber)->Unit(benchmark::kMicrosecond);
+
+// Delivers messages into a new Nym's Nymbox, which starts out empty on
+// every run. (So the number of iterations is fixed: each one makes the
+// Nymbox bigger.)
+void BM_ProcessMessageSendNymMessage(benchmark::State& state)
+{
+    std::unique_ptr<MessageProcessor> pProcessor(NewProcessor(state));
+    if (!pProcessor) return;
+
+    Nym& theNym = bench::SignerNym();
+    std::unique_ptr<Nym> pRecipient(bench::GenerateNym());
+    int64_t lRequestNum = 0, lRecipientRequestNum = 0;
+
+    if (!Register(*pProcessor, theNym, lRequestNum) ||
+        !Register(*pProcessor, *pRecipient, lRecipientRequestNum)) {
+        state.SkipWithError("Failed registering the Nyms.");
+        return;
+    }
+
+    const String strPayload(bench::SamplePayload(1 << 10));
+
+    while (state.KeepRunning()) {
+        // Signing is the client's work.
+        state.PauseTiming();
+        const std::string strRequest(
+            SendNymMessage(theNym, *pRecipient, lRequestNum++, strPayload));
+        state.ResumeTiming();
+
+        Message theReply;
+
+        if (!MessageProcessorBench::Process(*pProcessor, strRequest,
+                                            theReply)) {
+            state.SkipWithError("sendNymMessage failed.");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ProcessMessageSendNymMessage)
+    ->Iterations(256)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
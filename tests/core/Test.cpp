@@ -0,0 +1,129 @@
+#include "Test.hpp"
+
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTCachedKey.hpp>
+#include <opentxs/core/crypto/OTCallback.hpp>
+#include <opentxs/core/crypto/OTCaller.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/util/OTDataFolder.hpp>
+#include <opentxs/core/util/OTPaths.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+using namespace opentxs;
+
+namespace
+{
+
+// The same data folder the notary uses, so server-side storage code finds
+// its folders where it expects them.
+const char* g_szConfigKey = "server";
+
+// Answers every passphrase request, so nothing ever waits on the console.
+class TestCallback : public OTCallback
+{
+public:
+    virtual void runOne(const char*, OTPassword& theOutput) const
+    {
+        theOutput.setPassword("test", 4);
+    }
+
+    virtual void runTwo(const char* szDisplay, OTPassword& theOutput) const
+    {
+        runOne(szDisplay, theOutput);
+    }
+};
+
+TestCallback g_theCallback;
+OTCaller g_theCaller;
+
+std::string g_strHome;
+std::unique_ptr<Nym> g_pSignerNym;
+
+class Environment : public ::testing::Environment
+{
+public:
+    virtual void SetUp()
+    {
+        char szHome[] = "/tmp/opentxs-test-XXXXXX";
+        ASSERT_TRUE(nullptr != mkdtemp(szHome));
+        g_strHome = szHome;
+
+        OTPaths::SetHomeFolder(g_strHome);
+
+        ASSERT_TRUE(Log::Init(g_szConfigKey, -1));
+
+        g_theCaller.setCallback(&g_theCallback);
+        ASSERT_TRUE(OTAsymmetricKey::SetPasswordCaller(g_theCaller));
+        ASSERT_TRUE(OTDataFolder::Init(g_szConfigKey));
+
+        OTCrypto::It()->Init();
+        OTDB::InitDefaultStorage(OTDB_DEFAULT_STORAGE, OTDB_DEFAULT_PACKER);
+    }
+
+    virtual void TearDown()
+    {
+        g_pSignerNym.reset();
+
+        OTCachedKey::Cleanup();
+        OTCrypto::It()->Cleanup();
+
+        const std::string strRemove = "rm -rf \"" + g_strHome + "\"";
+        EXPECT_EQ(0, system(strRemove.c_str()));
+    }
+};
+
+::testing::Environment* const g_pEnvironment =
+    ::testing::AddGlobalTestEnvironment(new Environment);
+
+} // namespace
+
+namespace opentxs
+{
+namespace test
+{
+
+std::string DataFolder()
+{
+    String strDataFolder;
+    OTDataFolder::Get(strDataFolder);
+
+    return strDataFolder.Get();
+}
+
+void ClearFolder(const char* szFolder)
+{
+    const std::string strRemove =
+        "rm -rf \"" + DataFolder() + "/" + szFolder + "\"";
+    EXPECT_EQ(0, system(strRemove.c_str()));
+}
+
+Nym& SignerNym()
+{
+    if (!g_pSignerNym) {
+        g_pSignerNym.reset(new Nym);
+        EXPECT_TRUE(g_pSignerNym->GenerateNym());
+    }
+
+    return *g_pSignerNym;
+}
+
+Identifier FixedID(const char* szName)
+{
+    Identifier theID;
+    theID.CalculateDigest(String(szName));
+
+    return theID;
+}
+
+} // namespace test
+} // namespace opentxs
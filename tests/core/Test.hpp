@@ -0,0 +1,35 @@
+#ifndef OPENTXS_TESTS_CORE_TEST_HPP
+#define OPENTXS_TESTS_CORE_TEST_HPP
+
+#include <opentxs/core/Identifier.hpp>
+
+#include <string>
+
+namespace opentxs
+{
+
+class Nym;
+
+namespace test
+{
+
+// Every test runs in a fresh home folder, set up once before the first test
+// and removed after the last. This is its data folder.
+std::string DataFolder();
+
+// Removes szFolder (under the data folder) and everything in it, so a test
+// can start without whatever an earlier one left there.
+void ClearFolder(const char* szFolder);
+
+// A Nym with fresh credentials, generated on first use and kept for the
+// whole run.
+Nym& SignerNym();
+
+// The same ID on every run, for notaries, instrument definitions and
+// accounts that only need to be consistent.
+Identifier FixedID(const char* szName);
+
+} // namespace test
+} // namespace opentxs
+
+#endif // OPENTXS_TESTS_CORE_TEST_HPP
@@ -0,0 +1,106 @@
+#include "Test.hpp"
+
+#include <opentxs/core/AssetContract.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+// The account records are kept in memory once they're loaded, for the rest
+// of the run, so each test uses an instrument definition no other test
+// touches.
+struct Test_AssetContract : public ::testing::Test
+{
+    AssetContract contract_;
+    std::string log_;
+
+    Test_AssetContract()
+    {
+        contract_.SetIdentifier(test::FixedID(
+            ::testing::UnitTest::GetInstance()->current_test_info()->name()));
+
+        String strID;
+        contract_.GetIdentifier(strID);
+        log_ = std::string(strID.Get()) + ".a.log";
+    }
+
+    std::string Log() const
+    {
+        return OTDB::QueryPlainString(OTFolders::Contract().Get(), log_);
+    }
+
+    void WriteLog(const std::string& strLog) const
+    {
+        ASSERT_TRUE(
+            OTDB::StorePlainString(strLog, OTFolders::Contract().Get(), log_));
+    }
+
+    bool Erase(const char* szAcctID)
+    {
+        return contract_.EraseAccountRecord(test::FixedID(szAcctID));
+    }
+
+    static std::string Record(char cType, const char* szAcctID)
+    {
+        return cType + std::string(String(test::FixedID(szAcctID)).Get()) +
+               "\n";
+    }
+};
+
+} // namespace
+
+TEST_F(Test_AssetContract, empty_log_has_no_accounts)
+{
+    WriteLog("");
+
+    ASSERT_TRUE(Erase("account"));
+    EXPECT_EQ("", Log()); // It wasn't there, so there's nothing to erase.
+}
+
+TEST_F(Test_AssetContract, erasing_appends_to_the_log)
+{
+    const std::string strLog = Record('+', "kept") + Record('+', "erased");
+    WriteLog(strLog);
+
+    ASSERT_TRUE(Erase("erased"));
+    ASSERT_TRUE(Erase("erased")); // Already gone.
+
+    EXPECT_EQ(strLog + Record('-', "erased"), Log());
+}
+
+TEST_F(Test_AssetContract, erasing_after_a_partial_record_starts_a_new_line)
+{
+    const std::string strLog = Record('+', "kept") + "+partial";
+    WriteLog(strLog);
+
+    ASSERT_TRUE(Erase("kept"));
+
+    EXPECT_EQ(strLog + "\n" + Record('-', "kept"), Log());
+}
+
+TEST_F(Test_AssetContract, log_is_compacted_once_mostly_erased)
+{
+    // Far more erased records than accounts.
+    std::string strLog = Record('+', "kept") + Record('+', "erased");
+
+    for (int32_t i = 0; i < 1100; ++i)
+        strLog += Record('+', "temporary") + Record('-', "temporary");
+
+    WriteLog(strLog);
+
+    ASSERT_TRUE(Erase("erased"));
+
+    // Rewritten with just the account that's left.
+    EXPECT_EQ(Record('+', "kept"), Log());
+
+    ASSERT_TRUE(Erase("kept"));
+    EXPECT_EQ(Record('+', "kept") + Record('-', "kept"), Log());
+}
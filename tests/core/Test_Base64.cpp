@@ -0,0 +1,155 @@
+#include <opentxs/core/OTData.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+std::string Encode(const std::string& strInput, bool bLineBreaks)
+{
+    char* szEncoded = OTCrypto::It()->Base64Encode(
+        reinterpret_cast<const uint8_t*>(strInput.data()),
+        static_cast<int32_t>(strInput.size()), bLineBreaks);
+    const std::string strEncoded(szEncoded);
+    delete[] szEncoded;
+
+    return strEncoded;
+}
+
+bool Decode(const std::string& strInput, std::string& strOutput)
+{
+    return OTCrypto::It()->Base64Decode(strInput.data(), strInput.size(),
+                                        strOutput);
+}
+
+// The test vectors from RFC 4648.
+const char* g_szVectors[][2] = {{"", ""},
+                                {"f", "Zg=="},
+                                {"fo", "Zm8="},
+                                {"foo", "Zm9v"},
+                                {"foob", "Zm9vYg=="},
+                                {"fooba", "Zm9vYmE="},
+                                {"foobar", "Zm9vYmFy"}};
+
+} // namespace
+
+TEST(Base64, encodes_known_vectors)
+{
+    for (auto& it : g_szVectors) {
+        EXPECT_EQ(it[1], Encode(it[0], false));
+
+        // With line breaks, every line ends with one. (Even the last.)
+        const std::string strLine(it[1]);
+        EXPECT_EQ(strLine.empty() ? strLine : strLine + "\n",
+                  Encode(it[0], true));
+    }
+}
+
+TEST(Base64, decodes_known_vectors)
+{
+    for (auto& it : g_szVectors) {
+        std::string strOutput("not decoded");
+        ASSERT_TRUE(Decode(it[1], strOutput));
+        EXPECT_EQ(it[0], strOutput);
+    }
+}
+
+TEST(Base64, breaks_lines_every_64_characters)
+{
+    const std::string strOne(48, 'x'), strTwo(49, 'x');
+
+    const std::string strOneLine = Encode(strOne, true);
+    ASSERT_EQ(65u, strOneLine.size());
+    EXPECT_EQ('\n', strOneLine[64]);
+
+    const std::string strTwoLines = Encode(strTwo, true);
+    ASSERT_EQ(70u, strTwoLines.size());
+    EXPECT_EQ('\n', strTwoLines[64]);
+    EXPECT_EQ('\n', strTwoLines[69]);
+}
+
+TEST(Base64, round_trips_every_length_and_byte)
+{
+    std::string strInput;
+
+    for (int32_t i = 0; i < 300; ++i) {
+        for (int32_t j = 0; j < 2; ++j) {
+            const bool bLineBreaks = (0 == j);
+            std::string strOutput;
+
+            ASSERT_TRUE(Decode(Encode(strInput, bLineBreaks), strOutput));
+            EXPECT_EQ(strInput, strOutput);
+        }
+
+        strInput.push_back(static_cast<char>((i * 7) & 0xff));
+    }
+}
+
+TEST(Base64, decodes_into_otdata)
+{
+    const std::string strInput("\x00\x01\xfe\xff", 4);
+    const std::string strEncoded = Encode(strInput, true);
+
+    OTData theOutput;
+    ASSERT_TRUE(OTCrypto::It()->Base64Decode(strEncoded.data(),
+                                             strEncoded.size(), theOutput));
+    ASSERT_EQ(strInput.size(), theOutput.GetSize());
+    EXPECT_EQ(0, memcmp(strInput.data(), theOutput.GetPointer(),
+                        strInput.size()));
+}
+
+TEST(Base64, decodes_into_new_buffer)
+{
+    size_t nSize = 0;
+    uint8_t* pOutput = OTCrypto::It()->Base64Decode("Zm9vYmE=\n", &nSize, true);
+
+    ASSERT_TRUE(nullptr != pOutput);
+    ASSERT_EQ(5u, nSize);
+    EXPECT_EQ(0, memcmp("fooba", pOutput, nSize));
+    delete[] pOutput;
+}
+
+TEST(Base64, skips_whitespace_anywhere)
+{
+    const char* szInputs[] = {"Zm9v\nYmFy", "Zm9vYmFy\n", " Zm9v YmFy \r\n",
+                              "Z\tm 9\r\nv\nYmFy", "\n\nZm9vYmFy"};
+
+    for (auto& szInput : szInputs) {
+        std::string strOutput;
+        ASSERT_TRUE(Decode(szInput, strOutput)) << szInput;
+        EXPECT_EQ("foobar", strOutput) << szInput;
+    }
+
+    std::string strOutput;
+    ASSERT_TRUE(Decode("Zm9v\nYg==\n", strOutput));
+    EXPECT_EQ("foob", strOutput);
+}
+
+TEST(Base64, accepts_missing_padding)
+{
+    std::string strOutput;
+
+    ASSERT_TRUE(Decode("Zm9vYg", strOutput));
+    EXPECT_EQ("foob", strOutput);
+
+    ASSERT_TRUE(Decode("Zm9vYmE", strOutput));
+    EXPECT_EQ("fooba", strOutput);
+
+    ASSERT_TRUE(Decode("Zm9vYmE\n", strOutput));
+    EXPECT_EQ("fooba", strOutput);
+}
+
+TEST(Base64, rejects_bad_input)
+{
+    std::string strOutput;
+
+    EXPECT_FALSE(Decode("Zm9v!mFy", strOutput));  // Not base64.
+    EXPECT_FALSE(Decode("Zm9vY", strOutput));     // Not a whole byte.
+    EXPECT_FALSE(Decode("Zg==Zm9v", strOutput));  // Data after the padding.
+}
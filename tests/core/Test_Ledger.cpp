@@ -0,0 +1,272 @@
+#include "Test.hpp"
+
+#include <opentxs/core/Ledger.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTTransaction.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace opentxs;
+
+namespace
+{
+
+struct Test_Ledger : public ::testing::Test
+{
+    Identifier nymID_;
+    Identifier notaryID_;
+    bool journal_;
+
+    Test_Ledger()
+        : nymID_(test::FixedID("recipient"))
+        , notaryID_(test::FixedID("notary"))
+        , journal_(Ledger::GetNymboxJournal())
+    {
+        test::ClearFolder(OTFolders::Nymbox().Get());
+
+        // What the notary does on startup.
+        Ledger::SetNymboxJournal(true);
+    }
+
+    ~Test_Ledger()
+    {
+        Ledger::SetNymboxJournal(journal_);
+    }
+
+    void Sign(Contract& theContract)
+    {
+        theContract.ReleaseSignatures();
+        EXPECT_TRUE(theContract.SignContract(test::SignerNym()));
+        EXPECT_TRUE(theContract.SaveContract());
+    }
+
+    // An empty nymbox, saved, with a journal started on it.
+    void CreateNymbox()
+    {
+        Ledger theNymbox(nymID_, nymID_, notaryID_);
+        ASSERT_TRUE(theNymbox.GenerateLedger(nymID_, notaryID_,
+                                             Ledger::nymbox));
+        Sign(theNymbox);
+        ASSERT_TRUE(theNymbox.SaveNymbox());
+        ASSERT_TRUE(theNymbox.StartNymboxJournal());
+    }
+
+    // The way DropMessageToNymbox delivers to a nymbox with a journal.
+    bool Deliver(int64_t lTransactionNum)
+    {
+        Ledger theNymbox(nymID_, nymID_, notaryID_);
+        EXPECT_TRUE(theNymbox.HasNymboxJournal());
+        EXPECT_TRUE(theNymbox.GenerateLedger(nymID_, notaryID_,
+                                             Ledger::nymbox));
+
+        OTTransaction* pTransaction = OTTransaction::GenerateTransaction(
+            theNymbox, OTTransaction::message, lTransactionNum);
+        pTransaction->SetReferenceToNum(lTransactionNum);
+        pTransaction->SetReferenceString(String("a message"));
+        Sign(*pTransaction);
+
+        return theNymbox.AppendNymboxJournal(*pTransaction);
+    }
+
+    // The nymbox was loaded and its signatures verified.
+    bool Load(Ledger& theNymbox)
+    {
+        return theNymbox.LoadNymbox() && theNymbox.VerifyContractID() &&
+               theNymbox.VerifySignature(test::SignerNym());
+    }
+};
+
+// The indexes a ledger keeps on its transactions, in memory.
+struct Test_LedgerIndex : public ::testing::Test
+{
+    Ledger ledger_;
+
+    Test_LedgerIndex()
+        : ledger_(test::FixedID("recipient"), test::FixedID("recipient"),
+                  test::FixedID("notary"))
+    {
+        EXPECT_TRUE(ledger_.GenerateLedger(test::FixedID("recipient"),
+                                           test::FixedID("notary"),
+                                           Ledger::nymbox));
+    }
+
+    // The ledger owns it once it's added.
+    OTTransaction* Add(int64_t lTransactionNum, int64_t lReferenceNum)
+    {
+        OTTransaction* pTransaction = OTTransaction::GenerateTransaction(
+            ledger_, OTTransaction::message, lTransactionNum);
+        pTransaction->SetReferenceToNum(lReferenceNum);
+        EXPECT_TRUE(ledger_.AddTransaction(*pTransaction));
+
+        return pTransaction;
+    }
+};
+
+} // namespace
+
+TEST_F(Test_Ledger, nymbox_loads_delivered_messages_from_journal)
+{
+    CreateNymbox();
+    ASSERT_TRUE(Deliver(1001));
+    ASSERT_TRUE(Deliver(1002));
+
+    Ledger theNymbox(nymID_, nymID_, notaryID_);
+    ASSERT_TRUE(Load(theNymbox));
+
+    EXPECT_TRUE(theNymbox.LoadedJournal());
+    EXPECT_EQ(2, theNymbox.GetTransactionCount());
+    EXPECT_TRUE(nullptr != theNymbox.GetTransaction(1001));
+    EXPECT_TRUE(nullptr != theNymbox.GetTransaction(1002));
+}
+
+TEST_F(Test_Ledger, saving_the_nymbox_compacts_its_journal)
+{
+    CreateNymbox();
+    ASSERT_TRUE(Deliver(1001));
+
+    {
+        // What getNymbox does with a nymbox that loaded journal records.
+        Ledger theNymbox(nymID_, nymID_, notaryID_);
+        ASSERT_TRUE(Load(theNymbox));
+        ASSERT_TRUE(theNymbox.LoadedJournal());
+
+        Sign(theNymbox);
+        ASSERT_TRUE(theNymbox.SaveNymbox());
+    }
+
+    // The message is in the nymbox itself now, and the journal starts over
+    // from there.
+    Ledger theNymbox(nymID_, nymID_, notaryID_);
+    ASSERT_TRUE(Load(theNymbox));
+    EXPECT_FALSE(theNymbox.LoadedJournal());
+    EXPECT_EQ(1, theNymbox.GetTransactionCount());
+    EXPECT_TRUE(nullptr != theNymbox.GetTransaction(1001));
+
+    // And it keeps taking new messages.
+    ASSERT_TRUE(Deliver(1002));
+
+    Ledger theNewer(nymID_, nymID_, notaryID_);
+    ASSERT_TRUE(Load(theNewer));
+    EXPECT_TRUE(theNewer.LoadedJournal());
+    EXPECT_EQ(2, theNewer.GetTransactionCount());
+}
+
+TEST_F(Test_Ledger, nymbox_hash_covers_the_journal_without_changing_it)
+{
+    CreateNymbox();
+    ASSERT_TRUE(Deliver(1001));
+
+    Ledger theNymbox(nymID_, nymID_, notaryID_);
+    ASSERT_TRUE(Load(theNymbox));
+    ASSERT_TRUE(theNymbox.LoadedJournal());
+
+    String strBefore, strAfter;
+    theNymbox.SaveContractRaw(strBefore);
+
+    Identifier theHash;
+    ASSERT_TRUE(theNymbox.CalculateHash(theHash));
+
+    theNymbox.SaveContractRaw(strAfter);
+    EXPECT_TRUE(strBefore.Compare(strAfter)); // Still the signed contents.
+
+    // The same hash as the nymbox the client ends up with.
+    Sign(theNymbox);
+
+    Identifier theSignedHash;
+    ASSERT_TRUE(theNymbox.CalculateHash(theSignedHash));
+    EXPECT_EQ(theSignedHash, theHash);
+}
+
+TEST_F(Test_Ledger, client_ignores_the_nymbox_journal)
+{
+    CreateNymbox();
+    ASSERT_TRUE(Deliver(1001));
+
+    Ledger::SetNymboxJournal(false);
+
+    Ledger theNymbox(nymID_, nymID_, notaryID_);
+    ASSERT_TRUE(Load(theNymbox));
+    EXPECT_FALSE(theNymbox.LoadedJournal());
+    EXPECT_EQ(0, theNymbox.GetTransactionCount());
+}
+
+TEST_F(Test_LedgerIndex, transactions_are_indexed_by_number)
+{
+    OTTransaction* pThird = Add(1003, 1);
+    OTTransaction* pFirst = Add(1001, 1);
+    OTTransaction* pSecond = Add(1002, 2);
+
+    ASSERT_EQ(3, ledger_.GetTransactionCount());
+    EXPECT_EQ(pFirst, ledger_.GetTransactionByIndex(0));
+    EXPECT_EQ(pSecond, ledger_.GetTransactionByIndex(1));
+    EXPECT_EQ(pThird, ledger_.GetTransactionByIndex(2));
+    EXPECT_TRUE(nullptr == ledger_.GetTransactionByIndex(3));
+
+    EXPECT_EQ(1, ledger_.GetTransactionIndex(1002));
+    EXPECT_EQ(-1, ledger_.GetTransactionIndex(1004));
+
+    EXPECT_EQ(2, ledger_.GetTransactionCountInRefTo(1));
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(2));
+    EXPECT_EQ(0, ledger_.GetTransactionCountInRefTo(3));
+}
+
+TEST_F(Test_LedgerIndex, removing_updates_the_indexes)
+{
+    Add(1001, 1);
+    Add(1002, 1);
+    OTTransaction* pThird = Add(1003, 2);
+
+    // Builds the index vector, so the removal has to throw it out.
+    ASSERT_EQ(2, ledger_.GetTransactionIndex(1003));
+
+    ASSERT_TRUE(ledger_.RemoveTransaction(1002));
+    EXPECT_FALSE(ledger_.RemoveTransaction(1002)); // Not there anymore.
+
+    EXPECT_EQ(2, ledger_.GetTransactionCount());
+    EXPECT_EQ(1, ledger_.GetTransactionIndex(1003));
+    EXPECT_EQ(pThird, ledger_.GetTransactionByIndex(1));
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(1));
+
+    // Still the ledger's, just not in it.
+    ASSERT_TRUE(ledger_.RemoveTransaction(1003, false));
+    EXPECT_EQ(0, ledger_.GetTransactionCountInRefTo(2));
+    delete pThird;
+}
+
+TEST_F(Test_LedgerIndex, changing_the_reference_reindexes)
+{
+    OTTransaction* pTransaction = Add(1001, 1);
+    Add(1002, 1);
+
+    pTransaction->SetReferenceToNum(5);
+
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(1));
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(5));
+
+    // Found under its new number when it's removed.
+    ASSERT_TRUE(ledger_.RemoveTransaction(1001));
+    EXPECT_EQ(0, ledger_.GetTransactionCountInRefTo(5));
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(1));
+}
+
+TEST_F(Test_LedgerIndex, released_transaction_is_reindexed)
+{
+    OTTransaction* pTransaction = Add(1001, 7);
+    Add(1002, 7);
+
+    // What loading it again from a string starts with.
+    pTransaction->Release();
+
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(7));
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(0));
+
+    // The number it loads.
+    pTransaction->SetReferenceToNum(8);
+    EXPECT_EQ(0, ledger_.GetTransactionCountInRefTo(0));
+    EXPECT_EQ(1, ledger_.GetTransactionCountInRefTo(8));
+
+    ASSERT_TRUE(ledger_.RemoveTransaction(1001));
+    EXPECT_EQ(0, ledger_.GetTransactionCountInRefTo(8));
+    EXPECT_EQ(1, ledger_.GetTransactionCount());
+}
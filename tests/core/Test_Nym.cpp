@@ -0,0 +1,110 @@
+#include "Test.hpp"
+
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+// The transaction number bookkeeping, in memory.
+struct Test_Nym : public ::testing::Test
+{
+    Nym nym_;
+    Nym other_;
+    String notary_;
+    String otherNotary_;
+
+    Test_Nym()
+        : notary_(test::FixedID("notary"))
+        , otherNotary_(test::FixedID("other notary"))
+    {
+    }
+
+    static int64_t Missing(Nym& theNym, Nym& theOther,
+                           std::map<std::string, setOfTransNums>& mapMissing)
+    {
+        return Nym::GetMissingNums(theNym.GetMapIssuedNum(),
+                                   theOther.GetMapIssuedNum(), mapMissing);
+    }
+};
+
+} // namespace
+
+TEST_F(Test_Nym, missing_nums_are_the_set_difference)
+{
+    for (int64_t lNum : {1, 2, 3, 5, 8}) nym_.AddIssuedNum(notary_, lNum);
+    for (int64_t lNum : {2, 3, 4, 8}) other_.AddIssuedNum(notary_, lNum);
+
+    std::map<std::string, setOfTransNums> mapMissing;
+    EXPECT_EQ(2, Missing(nym_, other_, mapMissing));
+    ASSERT_EQ(1u, mapMissing.size());
+    EXPECT_EQ(setOfTransNums({1, 5}), mapMissing[notary_.Get()]);
+
+    // The other way around.
+    mapMissing.clear();
+    EXPECT_EQ(1, Missing(other_, nym_, mapMissing));
+    EXPECT_EQ(setOfTransNums({4}), mapMissing[notary_.Get()]);
+
+    EXPECT_TRUE(nym_.VerifyTransactionStatementNumbersOnNym(nym_));
+    EXPECT_FALSE(nym_.VerifyTransactionStatementNumbersOnNym(other_));
+    EXPECT_FALSE(nym_.VerifyIssuedNumbersOnNym(other_));
+}
+
+TEST_F(Test_Nym, missing_nums_are_kept_per_notary)
+{
+    nym_.AddIssuedNum(notary_, 1);
+    nym_.AddIssuedNum(otherNotary_, 2);
+    other_.AddIssuedNum(notary_, 2); // Not the same notary.
+
+    std::map<std::string, setOfTransNums> mapMissing;
+    EXPECT_EQ(2, Missing(nym_, other_, mapMissing));
+    EXPECT_EQ(setOfTransNums({1}), mapMissing[notary_.Get()]);
+    EXPECT_EQ(setOfTransNums({2}), mapMissing[otherNotary_.Get()]);
+}
+
+TEST_F(Test_Nym, subset_has_nothing_missing)
+{
+    other_.AddIssuedNum(notary_, 1);
+    other_.AddIssuedNum(notary_, 2);
+    nym_.AddIssuedNum(notary_, 2);
+
+    // Emptied out, but the notary is still on the map.
+    nym_.AddIssuedNum(otherNotary_, 3);
+    nym_.RemoveIssuedNum(otherNotary_, 3);
+
+    std::map<std::string, setOfTransNums> mapMissing;
+    EXPECT_EQ(0, Missing(nym_, other_, mapMissing));
+    EXPECT_TRUE(mapMissing.empty());
+
+    EXPECT_TRUE(nym_.VerifyTransactionStatementNumbersOnNym(other_));
+    EXPECT_FALSE(nym_.VerifyIssuedNumbersOnNym(other_)); // Not the same.
+
+    nym_.AddIssuedNum(notary_, 1);
+    EXPECT_TRUE(nym_.VerifyIssuedNumbersOnNym(other_));
+}
+
+TEST_F(Test_Nym, oldest_ack_nums_are_trimmed)
+{
+    for (int64_t lNum = 1; lNum <= 150; ++lNum)
+        ASSERT_TRUE(nym_.AddAcknowledgedNum(notary_, lNum));
+
+    // Capped at 100 before each new one is added.
+    const Identifier theNotaryID(notary_);
+    EXPECT_EQ(101, nym_.GetAcknowledgedNumCount(theNotaryID));
+    EXPECT_EQ(50, nym_.GetAcknowledgedNum(theNotaryID, 0));
+
+    EXPECT_FALSE(nym_.VerifyAcknowledgedNum(notary_, 49));
+    EXPECT_TRUE(nym_.VerifyAcknowledgedNum(notary_, 150));
+
+    // Another notary's are kept separately.
+    ASSERT_TRUE(nym_.AddAcknowledgedNum(otherNotary_, 1));
+    EXPECT_TRUE(nym_.VerifyAcknowledgedNum(otherNotary_, 1));
+    EXPECT_EQ(101, nym_.GetAcknowledgedNumCount(theNotaryID));
+}
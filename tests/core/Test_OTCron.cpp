@@ -0,0 +1,304 @@
+#include "Test.hpp"
+
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/cron/OTCronItem.hpp>
+#include <opentxs/core/recurring/OTPaymentPlan.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace opentxs;
+
+namespace
+{
+
+const int64_t PLAN_NUMBER = 1000;
+
+struct Test_OTCron : public ::testing::Test
+{
+    OTCron cron_;
+    int32_t maxRecords_;
+
+    Test_OTCron()
+        : maxRecords_(OTCron::GetCronJournalMaxRecords())
+    {
+        test::ClearFolder(OTFolders::Cron().Get());
+
+        cron_.SetServerNym(&test::SignerNym());
+        cron_.SetNotaryID(test::FixedID("notary"));
+    }
+
+    ~Test_OTCron()
+    {
+        OTCron::SetCronJournalMaxRecords(maxRecords_);
+    }
+
+    // Cron owns the plan once it's added.
+    OTPaymentPlan* AddPlan(OTCron& theCron, int64_t lAmount)
+    {
+        OTPaymentPlan* pPlan = new OTPaymentPlan(
+            test::FixedID("notary"), test::FixedID("instrument"),
+            test::FixedID("sender account"), test::FixedID("sender"),
+            test::FixedID("recipient account"), test::FixedID("recipient"));
+        pPlan->SetTransactionNum(PLAN_NUMBER);
+        EXPECT_TRUE(pPlan->SetPaymentPlan(lAmount));
+        Sign(*pPlan);
+
+        if (!theCron.AddCronItem(*pPlan, nullptr, false,
+                                 OTTimeGetCurrentTime())) {
+            delete pPlan;
+            return nullptr;
+        }
+
+        return pPlan;
+    }
+
+    // Cron items are loaded back only if the notary signed them.
+    void Sign(OTPaymentPlan& thePlan)
+    {
+        thePlan.ReleaseSignatures();
+        EXPECT_TRUE(thePlan.SignContract(test::SignerNym()));
+        EXPECT_TRUE(thePlan.SaveContract());
+    }
+
+    // What a restarted notary would see.
+    int64_t LoadedAmount()
+    {
+        OTCron theLoaded;
+        theLoaded.SetServerNym(&test::SignerNym());
+
+        if (!theLoaded.LoadCron()) return -1;
+
+        OTPaymentPlan* pPlan = dynamic_cast<OTPaymentPlan*>(
+            theLoaded.GetItemByOfficialNum(PLAN_NUMBER));
+
+        return (nullptr == pPlan) ? 0 : pPlan->GetPaymentPlanAmount();
+    }
+};
+
+// Says when it's due, and stays on Cron.
+class DueItem : public OTCronItem
+{
+public:
+    time64_t due_;
+    time64_t dueNext_; // What it says once it's processed.
+    int32_t processed_;
+
+    explicit DueItem(int64_t lTransactionNum)
+        : OTCronItem(test::FixedID("notary"), test::FixedID("instrument"),
+                     test::FixedID("account"), test::FixedID("nym"))
+        , due_(OT_TIME_ZERO)
+        , dueNext_(OT_TIME_ZERO)
+        , processed_(0)
+    {
+        SetTransactionNum(lTransactionNum);
+    }
+
+    virtual bool ProcessCron()
+    {
+        ++processed_;
+        due_ = dueNext_;
+
+        return true;
+    }
+
+    virtual time64_t GetCronDueDate() const
+    {
+        return due_;
+    }
+
+    time64_t IntervalDueDate() const
+    {
+        return GetProcessIntervalDueDate();
+    }
+
+    void Expires(time64_t tValidTo)
+    {
+        SetValidTo(tValidTo);
+    }
+};
+
+// Cron processes whenever it's asked to, as long as something is due.
+struct Test_OTCronSchedule : public ::testing::Test
+{
+    OTCron cron_;
+    int32_t msBetweenProcess_;
+    int32_t refillAmount_;
+
+    Test_OTCronSchedule()
+        : msBetweenProcess_(OTCron::GetCronMsBetweenProcess())
+        , refillAmount_(OTCron::GetCronRefillAmount())
+    {
+        test::ClearFolder(OTFolders::Cron().Get());
+
+        OTCron::SetCronMsBetweenProcess(0);
+        OTCron::SetCronRefillAmount(5);
+
+        cron_.SetServerNym(&test::SignerNym());
+        cron_.SetNotaryID(test::FixedID("notary"));
+        cron_.ActivateCron();
+    }
+
+    ~Test_OTCronSchedule()
+    {
+        OTCron::SetCronMsBetweenProcess(msBetweenProcess_);
+        OTCron::SetCronRefillAmount(refillAmount_);
+    }
+
+    // Cron owns the item once it's added.
+    DueItem* Add(int64_t lTransactionNum, time64_t tDue)
+    {
+        DueItem* pItem = new DueItem(lTransactionNum);
+        pItem->due_ = tDue;
+        pItem->dueNext_ = tDue;
+
+        if (!cron_.AddCronItem(*pItem, nullptr, false,
+                               OTTimeGetCurrentTime())) {
+            delete pItem;
+            return nullptr;
+        }
+
+        return pItem;
+    }
+
+    // Enough that Cron doesn't skip the round.
+    void AddTransactionNumbers()
+    {
+        for (int64_t lNumber = 1; lNumber <= 10; ++lNumber)
+            cron_.AddTransactionNumber(lNumber);
+    }
+
+    static time64_t InAnHour()
+    {
+        return OTTimeAddTimeInterval(OTTimeGetCurrentTime(), 3600);
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTCron, changed_item_is_replayed_from_journal)
+{
+    OTPaymentPlan* pPlan = AddPlan(cron_, 100);
+    ASSERT_TRUE(nullptr != pPlan);
+
+    // The first save writes the cron file in full.
+    ASSERT_TRUE(cron_.SaveCron());
+    ASSERT_EQ(100, LoadedAmount());
+
+    ASSERT_TRUE(pPlan->SetPaymentPlan(250));
+    Sign(*pPlan);
+    cron_.SetItemChanged(*pPlan);
+    ASSERT_TRUE(cron_.SaveCron());
+
+    EXPECT_EQ(250, LoadedAmount());
+}
+
+TEST_F(Test_OTCron, unchanged_item_is_not_journaled)
+{
+    OTPaymentPlan* pPlan = AddPlan(cron_, 100);
+    ASSERT_TRUE(nullptr != pPlan);
+    ASSERT_TRUE(cron_.SaveCron());
+
+    // Without SetItemChanged, Cron doesn't know to write it out.
+    ASSERT_TRUE(pPlan->SetPaymentPlan(250));
+    Sign(*pPlan);
+    ASSERT_TRUE(cron_.SaveCron());
+
+    EXPECT_EQ(100, LoadedAmount());
+}
+
+TEST_F(Test_OTCron, compaction_keeps_journaled_changes)
+{
+    OTCron::SetCronJournalMaxRecords(2);
+
+    OTPaymentPlan* pPlan = AddPlan(cron_, 100);
+    ASSERT_TRUE(nullptr != pPlan);
+    ASSERT_TRUE(cron_.SaveCron());
+
+    // The third of these goes over the limit, and saves the cron file in
+    // full instead.
+    for (int64_t lAmount = 101; lAmount <= 104; ++lAmount) {
+        ASSERT_TRUE(pPlan->SetPaymentPlan(lAmount));
+        Sign(*pPlan);
+        cron_.SetItemChanged(*pPlan);
+        ASSERT_TRUE(cron_.SaveCron());
+
+        EXPECT_EQ(lAmount, LoadedAmount());
+    }
+}
+
+TEST_F(Test_OTCronSchedule, items_not_due_are_skipped)
+{
+    DueItem* pDue = Add(1001, OT_TIME_ZERO);
+    DueItem* pLater = Add(1002, InAnHour());
+    ASSERT_TRUE((nullptr != pDue) && (nullptr != pLater));
+    AddTransactionNumbers();
+
+    // New items are due right away, whatever they say.
+    cron_.ProcessCronItems();
+    EXPECT_EQ(1, pDue->processed_);
+    EXPECT_EQ(1, pLater->processed_);
+
+    cron_.ProcessCronItems();
+    EXPECT_EQ(2, pDue->processed_);
+    EXPECT_EQ(1, pLater->processed_);
+}
+
+TEST_F(Test_OTCronSchedule, processed_items_are_rescheduled)
+{
+    DueItem* pDue = Add(1001, OT_TIME_ZERO);
+    DueItem* pOnce = Add(1002, OT_TIME_ZERO);
+    ASSERT_TRUE((nullptr != pDue) && (nullptr != pOnce));
+    AddTransactionNumbers();
+
+    pOnce->dueNext_ = InAnHour();
+
+    cron_.ProcessCronItems();
+    cron_.ProcessCronItems();
+    EXPECT_EQ(2, pDue->processed_);
+    EXPECT_EQ(1, pOnce->processed_);
+
+    // Until something else changes when it's due.
+    pOnce->due_ = OT_TIME_ZERO;
+    cron_.SetItemChanged(*pOnce);
+
+    cron_.ProcessCronItems();
+    EXPECT_EQ(3, pDue->processed_);
+    EXPECT_EQ(2, pOnce->processed_);
+}
+
+TEST_F(Test_OTCronSchedule, removed_item_is_unscheduled)
+{
+    DueItem* pLater = Add(1001, InAnHour());
+    ASSERT_TRUE(nullptr != pLater);
+    ASSERT_TRUE(nullptr != Add(1002, OT_TIME_ZERO));
+
+    // Without transaction numbers, there's no final receipt to drop.
+    ASSERT_TRUE(cron_.RemoveCronItem(1002, test::SignerNym()));
+    EXPECT_TRUE(nullptr == cron_.GetItemByOfficialNum(1002));
+
+    // Only the later one is left, and once it's processed (since it's new)
+    // nothing is due for a while.
+    AddTransactionNumbers();
+    cron_.ProcessCronItems();
+    EXPECT_EQ(1, pLater->processed_);
+    EXPECT_LT(0, cron_.computeTimeout());
+}
+
+TEST_F(Test_OTCronSchedule, interval_due_date_stops_at_expiry)
+{
+    DueItem theItem(1001);
+    const time64_t tNow = OTTimeGetCurrentTime();
+    theItem.SetLastProcessDate(tNow);
+    theItem.SetProcessInterval(3600);
+
+    EXPECT_EQ(OTTimeAddTimeInterval(tNow, 3601), theItem.IntervalDueDate());
+
+    theItem.Expires(OTTimeAddTimeInterval(tNow, 60));
+    EXPECT_EQ(OTTimeAddTimeInterval(tNow, 60), theItem.IntervalDueDate());
+
+    // Never processed, so it's due right away.
+    theItem.SetLastProcessDate(OT_TIME_ZERO);
+    EXPECT_EQ(OT_TIME_ZERO, theItem.IntervalDueDate());
+}
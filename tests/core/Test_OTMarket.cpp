@@ -0,0 +1,149 @@
+#include "Test.hpp"
+
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/trade/OTMarket.hpp>
+#include <opentxs/core/trade/OTOffer.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace opentxs;
+
+namespace
+{
+
+struct Test_OTMarket : public ::testing::Test
+{
+    OTCron cron_;
+    OTMarket market_;
+    int32_t maxRecords_;
+
+    Test_OTMarket()
+        : market_(test::FixedID("notary"), test::FixedID("instrument"),
+                  test::FixedID("currency"), 1)
+        , maxRecords_(OTCron::GetCronJournalMaxRecords())
+    {
+        test::ClearFolder(OTFolders::Market().Get());
+
+        cron_.SetServerNym(&test::SignerNym());
+        cron_.SetNotaryID(test::FixedID("notary"));
+        market_.SetCronPointer(cron_);
+    }
+
+    ~Test_OTMarket()
+    {
+        OTCron::SetCronJournalMaxRecords(maxRecords_);
+    }
+
+    // The market owns the offer once it's added.
+    OTOffer* AddOffer(int64_t lTransactionNum, int64_t lTotal)
+    {
+        std::unique_ptr<OTOffer> pOffer(
+            new OTOffer(test::FixedID("notary"), test::FixedID("instrument"),
+                        test::FixedID("currency"), 1));
+        EXPECT_TRUE(pOffer->MakeOffer(true, 10, lTotal, 1, lTransactionNum));
+        Sign(*pOffer);
+
+        if (!market_.AddOffer(nullptr, *pOffer)) return nullptr;
+
+        return pOffer.release();
+    }
+
+    // Offers are loaded back only if the notary signed them.
+    void Sign(OTOffer& theOffer)
+    {
+        theOffer.ReleaseSignatures();
+        EXPECT_TRUE(theOffer.SignContract(test::SignerNym()));
+        EXPECT_TRUE(theOffer.SaveContract());
+    }
+
+    void Sell(OTOffer& theOffer, int64_t lAmount)
+    {
+        theOffer.IncrementFinishedSoFar(lAmount);
+        Sign(theOffer);
+        market_.SetOfferChanged(theOffer);
+    }
+
+    // What a restarted notary would see: the amount still available on the
+    // offer, 0 if it isn't on the market, or -1 if the market didn't load.
+    int64_t LoadedAvailable(int64_t lTransactionNum)
+    {
+        OTMarket theLoaded(test::FixedID("notary"),
+                           test::FixedID("instrument"),
+                           test::FixedID("currency"), 1);
+        theLoaded.SetCronPointer(cron_);
+
+        if (!theLoaded.LoadMarket()) return -1;
+
+        OTOffer* pOffer = theLoaded.GetOffer(lTransactionNum);
+
+        return (nullptr == pOffer) ? 0 : pOffer->GetAmountAvailable();
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTMarket, changed_offer_is_replayed_from_journal)
+{
+    // The first save writes the market file in full.
+    OTOffer* pOffer = AddOffer(1, 100);
+    ASSERT_TRUE(nullptr != pOffer);
+    ASSERT_EQ(100, LoadedAvailable(1));
+
+    Sell(*pOffer, 30);
+    ASSERT_TRUE(market_.SaveMarket());
+
+    EXPECT_EQ(70, LoadedAvailable(1));
+}
+
+TEST_F(Test_OTMarket, unchanged_offer_is_not_journaled)
+{
+    OTOffer* pOffer = AddOffer(1, 100);
+    ASSERT_TRUE(nullptr != pOffer);
+
+    // Without SetOfferChanged, the market doesn't know to write it out.
+    pOffer->IncrementFinishedSoFar(30);
+    Sign(*pOffer);
+    ASSERT_TRUE(market_.SaveMarket());
+
+    EXPECT_EQ(100, LoadedAvailable(1));
+}
+
+TEST_F(Test_OTMarket, added_and_removed_offers_are_replayed_from_journal)
+{
+    ASSERT_TRUE(nullptr != AddOffer(1, 100));
+    ASSERT_TRUE(nullptr != AddOffer(2, 200));
+    ASSERT_TRUE(nullptr != AddOffer(3, 300));
+
+    ASSERT_TRUE(market_.RemoveOffer(2));
+
+    EXPECT_EQ(100, LoadedAvailable(1));
+    EXPECT_EQ(0, LoadedAvailable(2));
+    EXPECT_EQ(300, LoadedAvailable(3));
+}
+
+TEST_F(Test_OTMarket, compaction_keeps_journaled_changes)
+{
+    OTCron::SetCronJournalMaxRecords(2);
+
+    OTOffer* pOffer = AddOffer(1, 100);
+    ASSERT_TRUE(nullptr != pOffer);
+    ASSERT_TRUE(nullptr != AddOffer(2, 200));
+
+    // Every few of these goes over the limit, and saves the market file in
+    // full instead.
+    for (int64_t lSold = 1; lSold <= 5; ++lSold) {
+        Sell(*pOffer, 1);
+        ASSERT_TRUE(market_.SaveMarket());
+
+        EXPECT_EQ(100 - lSold, LoadedAvailable(1));
+        EXPECT_EQ(200, LoadedAvailable(2));
+    }
+
+    ASSERT_TRUE(market_.RemoveOffer(2));
+    EXPECT_EQ(95, LoadedAvailable(1));
+    EXPECT_EQ(0, LoadedAvailable(2));
+}
@@ -0,0 +1,205 @@
+#include "Test.hpp"
+
+#include <opentxs/core/trade/OTOffer.hpp>
+#include <opentxs/core/trade/OTOrderBook.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+struct Test_OTOrderBook : public ::testing::Test
+{
+    OTOrderBook bids_;
+    OTOrderBook asks_;
+    std::vector<std::unique_ptr<OTOffer>> offers_; // The books don't own them.
+    int64_t lastNumber_;
+
+    Test_OTOrderBook()
+        : bids_(true)
+        , asks_(false)
+        , lastNumber_(0)
+    {
+    }
+
+    OTOffer& MakeOffer(bool bSelling, int64_t lPrice, int64_t lTotal,
+                       int64_t lMinIncrement = 1)
+    {
+        offers_.emplace_back(new OTOffer(test::FixedID("notary"),
+                                         test::FixedID("instrument"),
+                                         test::FixedID("currency"), 1));
+        OTOffer& theOffer = *offers_.back();
+        EXPECT_TRUE(theOffer.MakeOffer(bSelling, lPrice, lTotal, lMinIncrement,
+                                       ++lastNumber_));
+
+        return theOffer;
+    }
+
+    OTOffer& AddBid(int64_t lPrice, int64_t lTotal, int64_t lMinIncrement = 1)
+    {
+        OTOffer& theOffer = MakeOffer(false, lPrice, lTotal, lMinIncrement);
+        bids_.AddOffer(theOffer);
+
+        return theOffer;
+    }
+
+    OTOffer& AddAsk(int64_t lPrice, int64_t lTotal, int64_t lMinIncrement = 1)
+    {
+        OTOffer& theOffer = MakeOffer(true, lPrice, lTotal, lMinIncrement);
+        asks_.AddOffer(theOffer);
+
+        return theOffer;
+    }
+
+    static std::vector<int64_t> Prices(const OTOrderBook& theBook)
+    {
+        std::vector<int64_t> vecPrices;
+
+        for (auto& theLevel : theBook) vecPrices.push_back(theLevel.lPrice);
+
+        return vecPrices;
+    }
+
+    static const OTPriceLevel& BestLevel(const OTOrderBook& theBook)
+    {
+        return *theBook.begin();
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTOrderBook, empty_book)
+{
+    EXPECT_EQ(0, bids_.GetBestPrice());
+    EXPECT_EQ(0, bids_.GetTotalAvailable());
+    EXPECT_EQ(0u, bids_.GetCount());
+    EXPECT_TRUE(bids_.begin() == bids_.end());
+}
+
+TEST_F(Test_OTOrderBook, bids_start_at_the_highest_price)
+{
+    AddBid(10, 100);
+    AddBid(12, 100);
+    AddBid(11, 100);
+    AddBid(12, 50);
+
+    EXPECT_EQ(12, bids_.GetBestPrice());
+    EXPECT_EQ((std::vector<int64_t>{12, 11, 10}), Prices(bids_));
+    EXPECT_EQ(4u, bids_.GetCount());
+}
+
+TEST_F(Test_OTOrderBook, asks_start_at_the_lowest_price)
+{
+    AddAsk(10, 100);
+    AddAsk(12, 100);
+    AddAsk(11, 100);
+    AddAsk(10, 50);
+
+    EXPECT_EQ(10, asks_.GetBestPrice());
+    EXPECT_EQ((std::vector<int64_t>{10, 11, 12}), Prices(asks_));
+    EXPECT_EQ(4u, asks_.GetCount());
+}
+
+TEST_F(Test_OTOrderBook, level_keeps_offers_in_line_and_totals_them)
+{
+    OTOffer& theFirst = AddBid(10, 100, 20);
+    OTOffer& theSecond = AddBid(10, 300, 5);
+    AddBid(9, 1000, 50);
+
+    const OTPriceLevel& theLevel = BestLevel(bids_);
+    ASSERT_EQ(2u, theLevel.dequeOffers.size());
+    EXPECT_EQ(&theFirst, theLevel.dequeOffers[0]);
+    EXPECT_EQ(&theSecond, theLevel.dequeOffers[1]);
+    EXPECT_EQ(400, theLevel.lTotalAvailable);
+    EXPECT_EQ(300, theLevel.lMaxAvailable);
+    EXPECT_EQ(5, theLevel.lMinIncrement);
+
+    EXPECT_EQ(1400, bids_.GetTotalAvailable());
+}
+
+TEST_F(Test_OTOrderBook, can_fill_only_when_increments_fit)
+{
+    AddAsk(10, 100, 20);
+    AddAsk(10, 40, 10);
+
+    const OTPriceLevel& theLevel = BestLevel(asks_);
+    ASSERT_EQ(100, theLevel.lMaxAvailable);
+    ASSERT_EQ(10, theLevel.lMinIncrement);
+
+    // Wants more in one trade than any offer at this price has.
+    EXPECT_FALSE(theLevel.CanFill(MakeOffer(false, 10, 500, 200)));
+
+    // Has less than the smallest trade any offer at this price allows.
+    EXPECT_FALSE(theLevel.CanFill(MakeOffer(false, 10, 5, 5)));
+
+    EXPECT_TRUE(theLevel.CanFill(MakeOffer(false, 10, 500, 100)));
+    EXPECT_TRUE(theLevel.CanFill(MakeOffer(false, 10, 10, 10)));
+}
+
+TEST_F(Test_OTOrderBook, offer_changed_updates_its_level)
+{
+    OTOffer& theOffer = AddBid(10, 100);
+    AddBid(10, 60);
+
+    theOffer.IncrementFinishedSoFar(70);
+    bids_.OfferChanged(theOffer);
+
+    const OTPriceLevel& theLevel = BestLevel(bids_);
+    EXPECT_EQ(90, theLevel.lTotalAvailable);
+    EXPECT_EQ(60, theLevel.lMaxAvailable);
+    EXPECT_EQ(90, bids_.GetTotalAvailable());
+}
+
+TEST_F(Test_OTOrderBook, removing_the_last_offer_removes_its_level)
+{
+    OTOffer& theBest = AddAsk(10, 100);
+    OTOffer& theNext = AddAsk(11, 100);
+
+    ASSERT_TRUE(asks_.RemoveOffer(theBest));
+    EXPECT_EQ(11, asks_.GetBestPrice());
+    EXPECT_EQ((std::vector<int64_t>{11}), Prices(asks_));
+    EXPECT_EQ(100, asks_.GetTotalAvailable());
+
+    EXPECT_FALSE(asks_.RemoveOffer(theBest)); // Not there anymore.
+
+    ASSERT_TRUE(asks_.RemoveOffer(theNext));
+    EXPECT_EQ(0, asks_.GetBestPrice());
+    EXPECT_EQ(0u, asks_.GetCount());
+    EXPECT_TRUE(asks_.begin() == asks_.end());
+}
+
+TEST_F(Test_OTOrderBook, replace_offer_keeps_its_place_in_line)
+{
+    OTOffer& theFirst = AddBid(10, 100);
+    AddBid(10, 100);
+
+    OTOffer& theNewer = MakeOffer(false, 10, 40);
+    ASSERT_TRUE(bids_.ReplaceOffer(theFirst, theNewer));
+
+    const OTPriceLevel& theLevel = BestLevel(bids_);
+    ASSERT_EQ(2u, theLevel.dequeOffers.size());
+    EXPECT_EQ(&theNewer, theLevel.dequeOffers[0]);
+    EXPECT_EQ(140, theLevel.lTotalAvailable);
+    EXPECT_EQ(2u, bids_.GetCount());
+}
+
+TEST_F(Test_OTOrderBook, market_orders_have_no_price_level)
+{
+    AddAsk(10, 100);
+    OTOffer& theMarketOrder = AddAsk(0, 30);
+    ASSERT_TRUE(theMarketOrder.IsMarketOrder());
+
+    EXPECT_EQ(10, asks_.GetBestPrice());
+    EXPECT_EQ((std::vector<int64_t>{10}), Prices(asks_));
+    ASSERT_EQ(1u, asks_.GetMarketOrders().size());
+    EXPECT_EQ(&theMarketOrder, *asks_.GetMarketOrders().begin());
+    EXPECT_EQ(2u, asks_.GetCount());
+
+    ASSERT_TRUE(asks_.RemoveOffer(theMarketOrder));
+    EXPECT_TRUE(asks_.GetMarketOrders().empty());
+}
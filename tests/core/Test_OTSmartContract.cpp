@@ -0,0 +1,111 @@
+#include "Test.hpp"
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/script/OTBylaw.hpp>
+#include <opentxs/core/script/OTParty.hpp>
+#include <opentxs/core/script/OTScript.hpp>
+#include <opentxs/core/script/OTSmartContract.hpp>
+#include <opentxs/core/script/OTVariable.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#ifdef OT_USE_SCRIPT_CHAI
+
+using namespace opentxs;
+
+namespace
+{
+
+// Reports what it can see of the first clause into "seen".
+const char* SECOND_CLAUSE =
+    "seen = \"param:\" + param_string;\n"
+    "try { leaked; seen = seen + \" var\"; } catch (e) { }\n"
+    "try { leaked_fn(); seen = seen + \" fn\"; } catch (e) { }\n";
+
+// A smart contract on Cron, with one bylaw and its two clauses. Each clause
+// runs on its own, on the same engine.
+struct Test_OTSmartContract : public ::testing::Test
+{
+    OTCron cron_;
+    OTSmartContract* contract_;
+    OTBylaw* bylaw_;
+
+    Test_OTSmartContract()
+        : contract_(new OTSmartContract(test::FixedID("notary")))
+        , bylaw_(new OTBylaw("bylaw", "chai"))
+    {
+        test::ClearFolder(OTFolders::Cron().Get());
+
+        cron_.SetServerNym(&test::SignerNym());
+        cron_.SetNotaryID(test::FixedID("notary"));
+
+        EXPECT_TRUE(bylaw_->AddVariable("seen", std::string("")));
+        EXPECT_TRUE(bylaw_->AddClause("first", "seen = param_string;\n"
+                                               "var leaked = 1;\n"
+                                               "def leaked_fn() { 1 }\n"));
+        EXPECT_TRUE(bylaw_->AddClause("second", SECOND_CLAUSE));
+        EXPECT_TRUE(contract_->AddBylaw(*bylaw_));
+
+        // Cron owns it from here.
+        contract_->SetTransactionNum(1001);
+        EXPECT_TRUE(cron_.AddCronItem(*contract_, nullptr, false,
+                                      OTTimeGetCurrentTime()));
+    }
+
+    std::string Run(const char* szClause, String* pParam = nullptr)
+    {
+        mapOfClauses theClauses;
+        theClauses[szClause] = bylaw_->GetClause(szClause);
+        contract_->ExecuteClauses(theClauses, pParam);
+
+        return bylaw_->GetVariable("seen")->GetValueString();
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTSmartContract, clause_sees_only_its_own_execution)
+{
+    String strParam("first");
+    ASSERT_EQ("first", Run("first", &strParam));
+
+    EXPECT_EQ("param:", Run("second"));
+}
+
+TEST_F(Test_OTSmartContract, clause_runs_the_same_every_time)
+{
+    EXPECT_EQ("param:", Run("second"));
+
+    String strParam("again");
+    ASSERT_EQ("again", Run("first", &strParam));
+    ASSERT_EQ("again", Run("first", &strParam)); // Defines them again.
+
+    EXPECT_EQ("param:", Run("second"));
+}
+
+// The same, below the smart contract: a party registered for one execution
+// is gone from the next.
+TEST(Test_OTScript, reset_drops_the_parties)
+{
+    std::shared_ptr<OTScript> pScript = OTScriptFactory("chai");
+    ASSERT_TRUE(pScript);
+    pScript->SaveBaseline();
+
+    OTParty theParty("alice", true, "owner", "agent");
+    pScript->AddParty("alice", theParty);
+    pScript->SetScript("alice;");
+    EXPECT_TRUE(pScript->ExecuteScript());
+
+    pScript->ResetToBaseline();
+    EXPECT_FALSE(pScript->ExecuteScript());
+}
+
+#endif // OT_USE_SCRIPT_CHAI
@@ -0,0 +1,136 @@
+#include "Test.hpp"
+
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/cron/OTCron.hpp>
+#include <opentxs/core/cron/OTVerificationCache.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+// The signer doubles as the notary: it signs the nymfiles the cache checks.
+struct Test_OTVerificationCache : public ::testing::Test
+{
+    OTVerificationCache cache_;
+    int32_t cacheSize_;
+
+    Test_OTVerificationCache()
+        : cacheSize_(OTCron::GetCronVerificationCacheSize())
+    {
+    }
+
+    ~Test_OTVerificationCache()
+    {
+        OTCron::SetCronVerificationCacheSize(cacheSize_);
+    }
+
+    static void StoreArmored(const String& strContents, const char* szType,
+                             const String& strNymID, const std::string& strFile)
+    {
+        OTASCIIArmor ascContents(strContents);
+        String strOutput;
+        ASSERT_TRUE(ascContents.WriteArmoredString(strOutput, szType));
+        ASSERT_TRUE(OTDB::StorePlainString(strOutput.Get(),
+                                           OTFolders::Pubcred().Get(),
+                                           strNymID.Get(), strFile));
+    }
+
+    // The public credentials and a signed nymfile, the way registerNym
+    // stores them.
+    static void Publish(Nym& theNym)
+    {
+        String strNymID, strCredList;
+        String::Map theCredentials;
+        theNym.GetIdentifier(strNymID);
+        theNym.GetPublicCredentials(strCredList, &theCredentials);
+
+        StoreArmored(strCredList, "CREDENTIAL LIST", strNymID,
+                     std::string(strNymID.Get()) + ".cred");
+
+        for (auto& it : theCredentials)
+            StoreArmored(String(it.second), "CREDENTIAL", strNymID, it.first);
+
+        ASSERT_TRUE(theNym.SaveSignedNymfile(test::SignerNym()));
+    }
+
+    // Anything that reloads the Nym from here on fails, but the cache only
+    // reads the credential list to tell whether it has changed.
+    static void EraseNymfile(const Nym& theNym)
+    {
+        const String strNymID(theNym.GetConstID());
+        ASSERT_TRUE(
+            OTDB::EraseValueByKey(OTFolders::Nym().Get(), strNymID.Get()));
+    }
+
+    Nym* Get(const Nym& theNym)
+    {
+        return cache_.GetNym(theNym.GetConstID(), test::SignerNym());
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTVerificationCache, verified_nym_is_reused)
+{
+    Nym& theNym = test::SignerNym();
+    Publish(theNym);
+
+    Nym* pVerified = Get(theNym);
+    ASSERT_TRUE(nullptr != pVerified);
+    cache_.CheckIn();
+
+    EraseNymfile(theNym);
+    EXPECT_EQ(pVerified, Get(theNym));
+}
+
+TEST_F(Test_OTVerificationCache, changed_credential_list_is_a_miss)
+{
+    Nym& theNym = test::SignerNym();
+    Publish(theNym);
+
+    ASSERT_TRUE(nullptr != Get(theNym));
+    cache_.CheckIn();
+
+    // The same credentials, but not the same file.
+    String strNymID(theNym.GetConstID());
+    const std::string strFile = std::string(strNymID.Get()) + ".cred";
+    const std::string strList = OTDB::QueryPlainString(
+        OTFolders::Pubcred().Get(), strNymID.Get(), strFile);
+    ASSERT_TRUE(OTDB::StorePlainString(strList + "\n",
+                                       OTFolders::Pubcred().Get(),
+                                       strNymID.Get(), strFile));
+
+    // So it's loaded again, and there's no nymfile to load.
+    EraseNymfile(theNym);
+    EXPECT_TRUE(nullptr == Get(theNym));
+}
+
+TEST_F(Test_OTVerificationCache, least_recently_used_is_evicted)
+{
+    OTCron::SetCronVerificationCacheSize(1);
+
+    Nym theOther;
+    ASSERT_TRUE(theOther.GenerateNym());
+    Publish(test::SignerNym());
+    Publish(theOther);
+
+    ASSERT_TRUE(nullptr != Get(test::SignerNym()));
+    cache_.CheckIn();
+    ASSERT_TRUE(nullptr != Get(theOther));
+    cache_.CheckIn();
+
+    EraseNymfile(test::SignerNym());
+    EraseNymfile(theOther);
+
+    EXPECT_TRUE(nullptr == Get(test::SignerNym()));
+    EXPECT_TRUE(nullptr != Get(theOther));
+}
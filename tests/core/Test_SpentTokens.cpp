@@ -0,0 +1,124 @@
+#include "Test.hpp"
+
+#include <opentxs/cash/SpentTokens.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+// SpentTokens is a singleton, and keeps every partition it has loaded for
+// the rest of the run, so each test uses partitions no other test touches.
+struct Test_SpentTokens : public ::testing::Test
+{
+    std::string partition_;
+
+    Test_SpentTokens()
+        : partition_(std::string(::testing::UnitTest::GetInstance()
+                                     ->current_test_info()
+                                     ->name()) +
+                     ".0")
+    {
+    }
+
+    static SpentTokens& Spent()
+    {
+        return *SpentTokens::It();
+    }
+
+    std::string Log() const
+    {
+        return OTDB::QueryPlainString(OTFolders::Spent().Get(), partition_,
+                                      "spent.log");
+    }
+
+    void WriteLog(const std::string& strLog) const
+    {
+        ASSERT_TRUE(OTDB::StorePlainString(strLog, OTFolders::Spent().Get(),
+                                           partition_, "spent.log"));
+    }
+
+    bool Record(const std::string& strTokenHash) const
+    {
+        mapOfSpentTokens theTokens;
+        theTokens[partition_].insert(strTokenHash);
+
+        return Spent().RecordSpent(theTokens);
+    }
+};
+
+} // namespace
+
+TEST_F(Test_SpentTokens, records_tokens_in_a_new_log)
+{
+    EXPECT_FALSE(Spent().IsSpent(partition_, "one"));
+
+    mapOfSpentTokens theTokens;
+    theTokens[partition_] = {"one", "two"};
+    ASSERT_TRUE(Spent().RecordSpent(theTokens));
+
+    EXPECT_TRUE(Spent().IsSpent(partition_, "one"));
+    EXPECT_TRUE(Spent().IsSpent(partition_, "two"));
+    EXPECT_FALSE(Spent().IsSpent(partition_, "three"));
+
+    EXPECT_EQ("# spent tokens\none\ntwo\n", Log());
+}
+
+TEST_F(Test_SpentTokens, batch_with_a_spent_token_records_nothing)
+{
+    ASSERT_TRUE(Record("one"));
+
+    mapOfSpentTokens theTokens;
+    theTokens[partition_] = {"one", "two"};
+    EXPECT_TRUE(Spent().AnySpent(theTokens));
+    EXPECT_FALSE(Spent().RecordSpent(theTokens));
+
+    EXPECT_FALSE(Spent().IsSpent(partition_, "two"));
+    EXPECT_EQ("# spent tokens\none\n", Log());
+}
+
+TEST_F(Test_SpentTokens, empty_log_is_an_empty_partition)
+{
+    WriteLog("");
+
+    EXPECT_FALSE(Spent().IsSpent(partition_, "one"));
+    ASSERT_TRUE(Record("one"));
+
+    // With the folder already there, there's no telling whether it held
+    // tokens before the log did.
+    EXPECT_EQ("# spent tokens (legacy)\none\n", Log());
+}
+
+TEST_F(Test_SpentTokens, loads_an_existing_log)
+{
+    // The last record was cut off by a crash, so it never counted.
+    WriteLog("# spent tokens\none\ntwo\nthr");
+
+    EXPECT_TRUE(Spent().IsSpent(partition_, "one"));
+    EXPECT_TRUE(Spent().IsSpent(partition_, "two"));
+    EXPECT_FALSE(Spent().IsSpent(partition_, "thr"));
+
+    // And the next record doesn't run into it.
+    ASSERT_TRUE(Record("four"));
+    EXPECT_EQ("# spent tokens\none\ntwo\nthr\nfour\n", Log());
+}
+
+TEST_F(Test_SpentTokens, checks_the_files_from_before_the_log)
+{
+    // One file per token, the way they were stored before.
+    ASSERT_TRUE(OTDB::StorePlainString("1", OTFolders::Spent().Get(),
+                                       partition_, "old"));
+
+    EXPECT_TRUE(Spent().IsSpent(partition_, "old"));
+    EXPECT_FALSE(Record("old"));
+
+    ASSERT_TRUE(Record("new"));
+    EXPECT_TRUE(Spent().IsSpent(partition_, "new"));
+    EXPECT_EQ("# spent tokens (legacy)\nnew\n", Log());
+}
@@ -0,0 +1,175 @@
+#include "Test.hpp"
+
+#include <opentxs/core/OTStorage.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+using namespace opentxs;
+
+namespace
+{
+
+// Nothing is stored under this folder on the filesystem, so every value
+// comes out of the data file.
+const char* g_szFolder = "storagelog";
+
+struct Test_StorageLog : public ::testing::Test
+{
+    std::unique_ptr<OTDB::Storage> storage_;
+
+    Test_StorageLog()
+    {
+        std::remove(Filename().c_str());
+        test::ClearFolder(g_szFolder);
+        Reopen();
+    }
+
+    // What a restarted notary would see.
+    void Reopen()
+    {
+        storage_.reset();
+        storage_.reset(OTDB::CreateStorageContext(OTDB::STORE_LOG));
+        ASSERT_TRUE(nullptr != storage_.get());
+    }
+
+    static std::string Filename()
+    {
+        return test::DataFolder() + "/otdb.log";
+    }
+
+    static std::string ReadFile()
+    {
+        std::ifstream file(Filename().c_str(), std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+
+        return buffer.str();
+    }
+
+    static void WriteFile(const std::string& strContents)
+    {
+        std::ofstream file(Filename().c_str(),
+                           std::ios::binary | std::ios::trunc);
+        file << strContents;
+    }
+
+    bool Store(const char* szKey, const char* szValue)
+    {
+        return storage_->StorePlainString(szValue, g_szFolder, szKey);
+    }
+
+    std::string Query(const char* szKey)
+    {
+        return storage_->QueryPlainString(g_szFolder, szKey);
+    }
+
+    bool Exists(const char* szKey)
+    {
+        return storage_->Exists(g_szFolder, szKey);
+    }
+};
+
+} // namespace
+
+TEST_F(Test_StorageLog, replays_stores_appends_and_erases)
+{
+    ASSERT_TRUE(Store("one", "first"));
+    ASSERT_TRUE(Store("two", "second"));
+    ASSERT_TRUE(Store("one", "replaced"));
+    ASSERT_TRUE(storage_->AppendPlainString(" and appended", g_szFolder,
+                                            "one"));
+    ASSERT_TRUE(storage_->EraseValueByKey(g_szFolder, "two"));
+
+    Reopen();
+
+    EXPECT_EQ("replaced and appended", Query("one"));
+    EXPECT_FALSE(Exists("two"));
+}
+
+TEST_F(Test_StorageLog, replays_a_committed_batch)
+{
+    storage_->BeginBatch();
+    ASSERT_TRUE(Store("one", "first"));
+    ASSERT_TRUE(Store("two", "second"));
+    EXPECT_EQ("first", Query("one")); // Reads see the open batch.
+    ASSERT_TRUE(storage_->CommitBatch());
+
+    Reopen();
+
+    EXPECT_EQ("first", Query("one"));
+    EXPECT_EQ("second", Query("two"));
+}
+
+TEST_F(Test_StorageLog, discards_a_torn_record)
+{
+    ASSERT_TRUE(Store("one", "first"));
+    const std::string strComplete = ReadFile();
+
+    storage_->BeginBatch();
+    ASSERT_TRUE(Store("one", "torn"));
+    ASSERT_TRUE(Store("two", "torn"));
+    ASSERT_TRUE(storage_->CommitBatch());
+    storage_.reset();
+
+    // Cut off the batch in the middle, as a crash while writing it would.
+    const std::string strFull = ReadFile();
+    ASSERT_LT(strComplete.size(), strFull.size());
+    WriteFile(strFull.substr(0, (strComplete.size() + strFull.size()) / 2));
+
+    Reopen();
+
+    // None of the batch survives, and the file ends with the last complete
+    // record again.
+    EXPECT_EQ("first", Query("one"));
+    EXPECT_FALSE(Exists("two"));
+    EXPECT_EQ(strComplete, ReadFile());
+
+    // So the next record isn't lost behind the torn one.
+    ASSERT_TRUE(Store("two", "second"));
+
+    Reopen();
+
+    EXPECT_EQ("first", Query("one"));
+    EXPECT_EQ("second", Query("two"));
+}
+
+TEST_F(Test_StorageLog, discards_a_record_that_fails_its_checksum)
+{
+    ASSERT_TRUE(Store("one", "first"));
+    const std::string strComplete = ReadFile();
+    ASSERT_TRUE(Store("one", "corrupted"));
+    storage_.reset();
+
+    // Flip a byte in the last record's value.
+    std::string strFull = ReadFile();
+    const size_t lPos = strFull.rfind("corrupted");
+    ASSERT_NE(std::string::npos, lPos);
+    strFull[lPos] = 'C';
+    WriteFile(strFull);
+
+    Reopen();
+
+    EXPECT_EQ("first", Query("one"));
+    EXPECT_EQ(strComplete, ReadFile());
+}
+
+TEST_F(Test_StorageLog, reads_an_empty_value_as_empty)
+{
+    std::string strValue("not read");
+
+    ASSERT_TRUE(storage_->ReadPlainString(strValue, g_szFolder, "one"));
+    EXPECT_TRUE(strValue.empty());
+
+    ASSERT_TRUE(Store("one", ""));
+
+    Reopen();
+
+    strValue = "not read";
+    ASSERT_TRUE(storage_->ReadPlainString(strValue, g_szFolder, "one"));
+    EXPECT_TRUE(strValue.empty());
+}
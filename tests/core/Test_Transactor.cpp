@@ -0,0 +1,152 @@
+#include "Test.hpp"
+
+#include <opentxs/server/OTServer.hpp>
+#include <opentxs/server/Transactor.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace opentxs
+{
+
+// Reaches into the notary the way its own classes do.
+class TransactorTest
+{
+public:
+    static Transactor& It(OTServer& theServer)
+    {
+        return theServer.transactor_;
+    }
+
+    static void SetMainFile(OTServer& theServer, const char* szFilename)
+    {
+        theServer.m_strWalletFilename.Set(szFilename);
+    }
+};
+
+} // namespace opentxs
+
+using namespace opentxs;
+
+namespace
+{
+
+// A notary whose main file says it last issued number 100, and which never
+// saves it again unless it recovers.
+struct Test_Transactor : public ::testing::Test
+{
+    OTServer server_;
+    std::string mainFile_;
+    std::string log_;
+
+    Test_Transactor()
+        : mainFile_("transactor.xml")
+        , log_(mainFile_ + ".numbers")
+    {
+        OTDB::EraseValueByKey(".", mainFile_);
+        OTDB::EraseValueByKey(".", log_);
+        Start(server_);
+    }
+
+    void Start(OTServer& theServer) const
+    {
+        TransactorTest::SetMainFile(theServer, mainFile_.c_str());
+        TransactorTest::It(theServer).transactionNumber(100);
+    }
+
+    Transactor& Numbers()
+    {
+        return TransactorTest::It(server_);
+    }
+
+    static int64_t Issue(Transactor& theTransactor)
+    {
+        int64_t lNumber = 0;
+        EXPECT_TRUE(theTransactor.issueNextTransactionNumber(lNumber));
+
+        return lNumber;
+    }
+
+    std::string Log() const
+    {
+        return OTDB::QueryPlainString(".", log_);
+    }
+
+    // The ceiling the log reserved first.
+    int64_t Reserved() const
+    {
+        return String(Log()).ToLong();
+    }
+
+    // What the main file was last saved with.
+    String MainFile() const
+    {
+        OTASCIIArmor ascMainFile;
+        String strMainFile;
+        EXPECT_TRUE(ascMainFile.LoadFromFile(".", mainFile_.c_str()));
+        EXPECT_TRUE(ascMainFile.GetString(strMainFile));
+
+        return strMainFile;
+    }
+};
+
+} // namespace
+
+TEST_F(Test_Transactor, numbers_come_from_one_reservation)
+{
+    EXPECT_EQ(101, Issue(Numbers()));
+    const std::string strLog = Log();
+    ASSERT_FALSE(strLog.empty());
+    EXPECT_LT(101, Reserved());
+
+    EXPECT_EQ(102, Issue(Numbers()));
+    EXPECT_EQ(103, Issue(Numbers()));
+
+    // Still the same block, so nothing else was written.
+    EXPECT_EQ(strLog, Log());
+    EXPECT_FALSE(OTDB::Exists(".", mainFile_));
+}
+
+TEST_F(Test_Transactor, restart_skips_the_reserved_block)
+{
+    int64_t lLast = 0;
+    for (int32_t i = 0; i < 3; ++i) lLast = Issue(Numbers());
+    const int64_t lReserved = Reserved();
+
+    // Restarted without saving the main file, so it's back at 100.
+    OTServer theRestarted;
+    Start(theRestarted);
+    Transactor& theNumbers = TransactorTest::It(theRestarted);
+    ASSERT_TRUE(theNumbers.recoverTransactionNumbers());
+
+    EXPECT_EQ(lReserved, theNumbers.transactionNumber());
+    EXPECT_LT(lLast, Issue(theNumbers));
+
+    // The main file has the recovered number, so the log started over.
+    const std::string strNumber =
+        "transactionNum=\"" + std::to_string(lReserved) + "\"";
+    EXPECT_TRUE(MainFile().Contains(strNumber.c_str()));
+    EXPECT_LT(lReserved, Reserved());
+}
+
+TEST_F(Test_Transactor, restart_ignores_a_partial_reservation)
+{
+    // The last reservation was cut off by a crash, so nothing was issued
+    // from it.
+    ASSERT_TRUE(OTDB::StorePlainString("1100\n2100", ".", log_));
+
+    ASSERT_TRUE(Numbers().recoverTransactionNumbers());
+    EXPECT_EQ(1100, Numbers().transactionNumber());
+    EXPECT_FALSE(OTDB::Exists(".", log_));
+}
+
+TEST_F(Test_Transactor, restart_without_a_log_keeps_the_number)
+{
+    ASSERT_TRUE(Numbers().recoverTransactionNumbers());
+    EXPECT_EQ(100, Numbers().transactionNumber());
+    EXPECT_EQ(101, Issue(Numbers()));
+}
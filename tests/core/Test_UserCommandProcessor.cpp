@@ -0,0 +1,216 @@
+#include "Test.hpp"
+
+#include <opentxs/server/OTServer.hpp>
+#include <opentxs/server/ServerSettings.hpp>
+#include <opentxs/server/UserCommandProcessor.hpp>
+#include <opentxs/core/Ledger.hpp>
+#include <opentxs/core/Message.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace opentxs
+{
+
+// Reaches into the notary the way its own classes do.
+class UserCommandProcessorTest
+{
+public:
+    // A notary with a Nym of its own, but no config or contract.
+    static void SetUpNotary(OTServer& theServer, const Identifier& theNotaryID)
+    {
+        ASSERT_TRUE(theServer.m_nymServer.GenerateNym());
+        theServer.m_nymServer.GetIdentifier(theServer.m_strServerNymID);
+        theServer.m_strNotaryID = String(theNotaryID);
+    }
+
+    static Nym& ServerNym(OTServer& theServer)
+    {
+        return theServer.m_nymServer;
+    }
+
+    static void Cache(OTServer& theServer, const String& strNymID,
+                      uint64_t nGeneration)
+    {
+        theServer.userCommandProcessor_.AddVerifiedNym(
+            strNymID.Get(), nGeneration, std::make_shared<Nym>(strNymID));
+    }
+
+    // (A hit counts as a use, for eviction.)
+    static bool IsCached(OTServer& theServer, const String& strNymID,
+                         uint64_t nGeneration)
+    {
+        return nullptr != theServer.userCommandProcessor_.FindVerifiedNym(
+                              strNymID.Get(), nGeneration);
+    }
+
+    static bool Process(OTServer& theServer, Message& msgIn, Message& msgOut)
+    {
+        return theServer.userCommandProcessor_.ProcessUserCommand(
+            msgIn, msgOut, nullptr, nullptr);
+    }
+
+    static void DeleteUser(OTServer& theServer, Nym& theNym, Message& msgIn,
+                           Message& msgOut)
+    {
+        theServer.userCommandProcessor_.UserCmdDeleteUser(theNym, msgIn,
+                                                          msgOut);
+    }
+};
+
+} // namespace opentxs
+
+using namespace opentxs;
+
+namespace
+{
+
+typedef UserCommandProcessorTest TestNotary;
+
+// Every test gets a notary of its own, so the cache starts out empty.
+struct Test_UserCommandProcessor : public ::testing::Test
+{
+    OTServer server_;
+    String nymID_;
+    int32_t cacheSize_;
+
+    Test_UserCommandProcessor()
+        : cacheSize_(ServerSettings::GetVerifiedNymCacheSize())
+    {
+        test::SignerNym().GetIdentifier(nymID_);
+        test::ClearFolder(OTFolders::Nymbox().Get());
+    }
+
+    ~Test_UserCommandProcessor()
+    {
+        ServerSettings::SetVerifiedNymCacheSize(cacheSize_);
+    }
+
+    static String NymID(const char* szName)
+    {
+        return String(test::FixedID(szName));
+    }
+
+    uint64_t Generation() const
+    {
+        return Nym::GetCredentialGeneration(nymID_);
+    }
+
+    // The signer's registerNym request, the way the notary parses it.
+    void RegisterNym(Message& theRequest)
+    {
+        Message theMessage;
+        theMessage.m_strCommand = "registerNym";
+        theMessage.m_strNymID = nymID_;
+        theMessage.m_strNotaryID = String(test::FixedID("notary"));
+        theMessage.m_strRequestNum.Set("1");
+
+        String strCredList;
+        String::Map theMap;
+        test::SignerNym().GetPublicCredentials(strCredList, &theMap);
+        theMessage.m_ascPayload.SetString(strCredList);
+        theMessage.credentials.swap(theMap);
+
+        EXPECT_TRUE(theMessage.SignContract(test::SignerNym()));
+        EXPECT_TRUE(theMessage.SaveContract());
+
+        EXPECT_TRUE(theRequest.LoadContractFromString(String(theMessage)));
+    }
+
+    // An empty nymbox for the signer, signed by the notary.
+    void CreateNymbox()
+    {
+        const Identifier theNymID(nymID_), theNotaryID(test::FixedID("notary"));
+
+        Ledger theNymbox(theNymID, theNymID, theNotaryID);
+        ASSERT_TRUE(theNymbox.GenerateLedger(theNymID, theNotaryID,
+                                             Ledger::nymbox, true));
+        ASSERT_TRUE(theNymbox.SignContract(TestNotary::ServerNym(server_)));
+        ASSERT_TRUE(theNymbox.SaveContract());
+        ASSERT_TRUE(theNymbox.SaveNymbox());
+    }
+};
+
+} // namespace
+
+TEST_F(Test_UserCommandProcessor, verified_nym_is_found_until_evicted)
+{
+    ServerSettings::SetVerifiedNymCacheSize(2);
+
+    TestNotary::Cache(server_, NymID("first"), 1);
+    TestNotary::Cache(server_, NymID("second"), 1);
+
+    EXPECT_FALSE(TestNotary::IsCached(server_, NymID("third"), 1));
+    ASSERT_TRUE(TestNotary::IsCached(server_, NymID("first"), 1));
+
+    // The second one is the least recently used now.
+    TestNotary::Cache(server_, NymID("third"), 1);
+
+    EXPECT_TRUE(TestNotary::IsCached(server_, NymID("first"), 1));
+    EXPECT_FALSE(TestNotary::IsCached(server_, NymID("second"), 1));
+    EXPECT_TRUE(TestNotary::IsCached(server_, NymID("third"), 1));
+}
+
+TEST_F(Test_UserCommandProcessor, other_generation_is_a_miss)
+{
+    TestNotary::Cache(server_, NymID("first"), 1);
+
+    EXPECT_FALSE(TestNotary::IsCached(server_, NymID("first"), 2));
+
+    // And the old entry is gone, not just skipped.
+    EXPECT_FALSE(TestNotary::IsCached(server_, NymID("first"), 1));
+}
+
+TEST_F(Test_UserCommandProcessor, saving_credential_ids_invalidates)
+{
+    const uint64_t nGeneration = Generation();
+    TestNotary::Cache(server_, nymID_, nGeneration);
+
+    ASSERT_TRUE(test::SignerNym().SaveCredentialIDs());
+
+    EXPECT_NE(nGeneration, Generation());
+    EXPECT_FALSE(TestNotary::IsCached(server_, nymID_, Generation()));
+}
+
+TEST_F(Test_UserCommandProcessor, registering_the_nym_invalidates)
+{
+    TestNotary::SetUpNotary(server_, test::FixedID("notary"));
+
+    const uint64_t nGeneration = Generation();
+    TestNotary::Cache(server_, nymID_, nGeneration);
+
+    Message theRequest, theReply;
+    RegisterNym(theRequest);
+    ASSERT_TRUE(TestNotary::Process(server_, theRequest, theReply));
+    EXPECT_TRUE(theReply.m_bSuccess);
+
+    EXPECT_NE(nGeneration, Generation());
+    EXPECT_FALSE(TestNotary::IsCached(server_, nymID_, nGeneration));
+}
+
+TEST_F(Test_UserCommandProcessor, deleting_the_nym_invalidates)
+{
+    TestNotary::SetUpNotary(server_, test::FixedID("notary"));
+    CreateNymbox();
+
+    const uint64_t nGeneration = Generation();
+    TestNotary::Cache(server_, nymID_, nGeneration);
+
+    // No accounts, cron items or open transactions, so it can be deleted.
+    Nym theNym(nymID_);
+    Message theRequest, theReply;
+    theRequest.m_strCommand = "unregisterNym";
+    theRequest.m_strNymID = nymID_;
+    theRequest.m_strNotaryID = String(test::FixedID("notary"));
+
+    TestNotary::DeleteUser(server_, theNym, theRequest, theReply);
+    ASSERT_TRUE(theReply.m_bSuccess);
+    EXPECT_TRUE(theNym.IsMarkedForDeletion());
+
+    EXPECT_NE(nGeneration, Generation());
+    EXPECT_FALSE(TestNotary::IsCached(server_, nymID_, nGeneration));
+}